@@ -0,0 +1,77 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: AllocationCounter.cpp - Counts heap allocations per thread
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	uint64_t GetThreadAllocations();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Replaces the global operator new/delete with ones that count, per thread, then go to malloc/free.
+-- The benchmark reads the count on the receive thread once a transfer is warmed up and again at
+-- the end: anything in between is an allocation per packet that shouldnt be there.
+-- Only code built into this exe is counted. Qt's own allocations happen in its DLLs, which have
+-- their own operator new.
+----------------------------------------------------------------------------------------------------------------------*/
+
+static thread_local uint64_t threadAllocations = 0;
+
+uint64_t GetThreadAllocations()
+{
+	return threadAllocations;
+}
+
+void* operator new(size_t size)
+{
+	++threadAllocations;
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	++threadAllocations;
+	return malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
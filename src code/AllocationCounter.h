@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+//heap allocations made by this program's code on the calling thread so far, for checking loops dont allocate
+uint64_t GetThreadAllocations();
@@ -0,0 +1,284 @@
+#include "AsyncFileReader.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: AsyncFileReader.cpp - Read-ahead of one file with overlapped I/O
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	bool Open();
+	qint64 Read(char*, const size_t);
+	uint64_t GetSize() const;
+	bool IsUncached() const;
+	size_t GetDiskWaits() const;
+	double GetDiskWaitSeconds() const;
+	void Issue(ReadSlot&);
+	bool Fetch();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- A plain QFile::read of a file that isnt cached waits out the whole disk trip each block, and
+-- the batch reader thread only gets one block ahead that way. This keeps READ_AHEAD_DEPTH
+-- overlapped ReadFile calls in flight over a ring of blocks, in file order, and reissues a
+-- block's read as soon as the caller is done copying out of it.
+--
+-- The handle is opened with FILE_FLAG_SEQUENTIAL_SCAN (posix_fadvise SEQUENTIAL). Files from
+-- READ_AHEAD_UNCACHED_MIN up also get FILE_FLAG_NO_BUFFERING, so a file bigger than the page cache
+-- doesnt push everything else out of it (what fadvise DONTNEED is for on Linux). Unbuffered reads
+-- need sector aligned offsets, sizes and buffers: blocks are READ_AHEAD_BLOCK_SIZE at multiples of
+-- it, into VirtualAlloc'd buffers.
+----------------------------------------------------------------------------------------------------------------------*/
+
+AsyncFileReader::AsyncFileReader(const QString& filePath)
+	: path(filePath)
+	, file(INVALID_HANDLE_VALUE)
+	, fileSize(0)
+	, nextOffset(0)
+	, uncached(false)
+	, failed(false)
+	, head(0)
+	, holding(false)
+	, available(0)
+	, consumed(0)
+	, diskWaits(0)
+	, diskWaitNs(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION AsyncFileReader Destructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: ~AsyncFileReader(void)
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+-- Reads still in flight are cancelled and waited out before their buffers are freed.
+----------------------------------------------------------------------------------------------------------------------*/
+AsyncFileReader::~AsyncFileReader()
+{
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CancelIoEx(file, nullptr);
+		for (ReadSlot& slot : blocks)
+		{
+			DWORD bytesRead = 0;
+			if (slot.pending)
+				GetOverlappedResult(file, &slot.overlapped, &bytesRead, TRUE);
+		}
+		CloseHandle(file);
+	}
+	for (ReadSlot& slot : blocks)
+	{
+		if (slot.overlapped.hEvent != nullptr)
+			CloseHandle(slot.overlapped.hEvent);
+		if (slot.buffer != nullptr)
+			VirtualFree(slot.buffer, 0, MEM_RELEASE);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(void)
+--
+-- RETURNS: bool : whether the file opened and the first reads are on their way
+--
+-- NOTES:
+-- Some file systems (network shares mostly) turn down unbuffered handles, then it's opened buffered.
+----------------------------------------------------------------------------------------------------------------------*/
+bool AsyncFileReader::Open()
+{
+	std::wstring widePath = path.toStdWString();
+	file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+		return false;
+	fileSize = (uint64_t)size.QuadPart;
+	if (fileSize >= READ_AHEAD_UNCACHED_MIN)
+	{
+		HANDLE unbuffered = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_NO_BUFFERING, nullptr);
+		if (unbuffered != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file);
+			file = unbuffered;
+			uncached = true;
+		}
+	}
+
+	blocks.resize(READ_AHEAD_DEPTH);
+	for (ReadSlot& slot : blocks)
+	{
+		memset(&slot.overlapped, 0, sizeof(slot.overlapped));
+		slot.pending = false;
+		slot.buffer = (char*)VirtualAlloc(nullptr, READ_AHEAD_BLOCK_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+		slot.overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+		if (slot.buffer == nullptr || slot.overlapped.hEvent == nullptr)
+			return false;
+	}
+	for (ReadSlot& slot : blocks)
+	{
+		Issue(slot);
+	}
+	return !failed;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Read
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: qint64 Read(char* destination, const size_t length)
+		- destination : where the bytes go
+		- length : bytes wanted
+
+-- RETURNS: qint64 : bytes copied, less than length only at the end of the file. -1 if a read failed
+--                   before anything was copied, like QFile::read
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 AsyncFileReader::Read(char* destination, const size_t length)
+{
+	size_t copied = 0;
+	while (copied < length)
+	{
+		if (consumed == available)
+		{
+			if (holding)
+			{
+				Issue(blocks[head]);
+				head = (head + 1) % blocks.size();
+				holding = false;
+			}
+			if (!Fetch() || available == 0)
+				break;
+		}
+		size_t take = std::min(length - copied, available - consumed);
+		memcpy(destination + copied, blocks[head].buffer + consumed, take);
+		consumed += take;
+		copied += take;
+	}
+	return (failed && copied == 0) ? -1 : (qint64)copied;
+}
+
+uint64_t AsyncFileReader::GetSize() const
+{
+	return fileSize;
+}
+
+bool AsyncFileReader::IsUncached() const
+{
+	return uncached;
+}
+
+size_t AsyncFileReader::GetDiskWaits() const
+{
+	return diskWaits;
+}
+
+double AsyncFileReader::GetDiskWaitSeconds() const
+{
+	return diskWaitNs / 1e9;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Issue
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Issue(ReadSlot& slot)
+		- slot : ReadSlot, free slot to read the next block of the file into
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Past the end of the file the slot is left idle, Fetch reads that as the end.
+----------------------------------------------------------------------------------------------------------------------*/
+void AsyncFileReader::Issue(ReadSlot& slot)
+{
+	slot.pending = false;
+	if (failed || nextOffset >= fileSize)
+		return;
+	HANDLE completed = slot.overlapped.hEvent;
+	memset(&slot.overlapped, 0, sizeof(slot.overlapped));
+	slot.overlapped.hEvent = completed;
+	slot.overlapped.Offset = (DWORD)(nextOffset & 0xFFFFFFFF);
+	slot.overlapped.OffsetHigh = (DWORD)(nextOffset >> 32);
+	ResetEvent(completed);
+	if (!ReadFile(file, slot.buffer, READ_AHEAD_BLOCK_SIZE, nullptr, &slot.overlapped) && GetLastError() != ERROR_IO_PENDING)
+	{
+		failed = true;
+		return;
+	}
+	slot.pending = true;
+	nextOffset += READ_AHEAD_BLOCK_SIZE;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Fetch
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Fetch(void)
+--
+-- RETURNS: bool : false at the end of the file or on a failed read
+--
+-- NOTES:
+-- Waits for the head slot's read if the disk hasnt finished it yet, that wait is what the
+-- disk wait counters add up.
+----------------------------------------------------------------------------------------------------------------------*/
+bool AsyncFileReader::Fetch()
+{
+	ReadSlot& slot = blocks[head];
+	if (!slot.pending)
+		return false;
+	DWORD bytesRead = 0;
+	if (!HasOverlappedIoCompleted(&slot.overlapped))
+	{
+		++diskWaits;
+		auto waitStart = std::chrono::steady_clock::now();
+		GetOverlappedResult(file, &slot.overlapped, &bytesRead, TRUE);
+		diskWaitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count();
+	}
+	slot.pending = false;
+	if (!GetOverlappedResult(file, &slot.overlapped, &bytesRead, FALSE) && GetLastError() != ERROR_HANDLE_EOF)
+	{
+		failed = true;
+		return false;
+	}
+	holding = true;
+	available = bytesRead;
+	consumed = 0;
+	return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Windows.h>
+#include <QString>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define READ_AHEAD_DEPTH 8 //reads kept in flight, each one block
+#define READ_AHEAD_BLOCK_SIZE 262144 //same as BATCH_CHUNK_SIZE, a multiple of any sector size
+#define READ_AHEAD_UNCACHED_MIN 268435456 //files from 256MB up skip the page cache
+
+//sequential reader of one file that keeps READ_AHEAD_DEPTH overlapped reads going ahead of the caller
+class AsyncFileReader
+{
+public:
+	AsyncFileReader(const QString&);
+	virtual ~AsyncFileReader();
+	bool Open();
+	qint64 Read(char*, const size_t);
+	uint64_t GetSize() const;
+	bool IsUncached() const;
+	size_t GetDiskWaits() const;
+	double GetDiskWaitSeconds() const;
+
+private:
+	struct ReadSlot
+	{
+		char* buffer; //READ_AHEAD_BLOCK_SIZE, page aligned for unbuffered reads
+		OVERLAPPED overlapped;
+		bool pending;
+	};
+
+	QString path;
+	HANDLE file;
+	uint64_t fileSize;
+	uint64_t nextOffset; //where the next read issued starts
+	bool uncached;
+	bool failed;
+	std::vector<ReadSlot> blocks;
+	size_t head; //slot the caller is reading out of
+	bool holding; //head's block is being read out
+	size_t available; //bytes in head's block
+	size_t consumed; //of those, already handed out
+	size_t diskWaits; //times the caller got to a block before the disk did
+	uint64_t diskWaitNs;
+
+	void Issue(ReadSlot&);
+	bool Fetch();
+};
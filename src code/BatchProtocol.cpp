@@ -0,0 +1,253 @@
+#include "BatchProtocol.h"
+#include <QStringList>
+#include <QDir>
+#include <WinSock2.h>
+#include <Windows.h>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: BatchProtocol.cpp - Framing for many files sent over one TCP connection
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	std::vector<char> EncodeBatchHeader(const std::string&, const uint64_t);
+	bool DecodeBatchHeader(const char*, bool&, uint16_t&, uint64_t&);
+	std::vector<char> EncodePackHeader(const uint16_t, const uint64_t);
+	void AppendPackEntry(std::vector<char>&, const std::string&, const uint64_t);
+	bool DecodePackEntry(const char*, const size_t, size_t&, std::string&, uint64_t&);
+	bool IsSafeRelativePath(const QString&);
+	bool ReplaceWithTempFile(const QString&, const QString&);
+	void WriteLittleEndian(char*, uint64_t, const int);
+	uint64_t ReadLittleEndian(const char*, const int);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Every file in a batch is a fixed 14 byte header, the utf8 relative path, then exactly fileSize
+-- bytes of content. Header is magic "ASNB", name length (uint16) and file size (uint64), all little
+-- endian. A header with an empty name and zero size ends the batch so the receiver knows
+-- the sender didnt just drop the connection half way.
+--
+-- Small files can instead go in a packed frame: same 14 byte header but magic "ASNP", the entry count
+-- where the name length was, and the frame body length where the file size was. The body is an index
+-- (name length, file size, name for every file) followed by every file's content back to back, so a
+-- frame of hundreds of files is one send on the client and one buffer on the server.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION EncodeBatchHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: std::vector<char> EncodeBatchHeader(const std::string& relativeName, const uint64_t fileSize)
+		- relativeName : utf8 path relative to the batch root, empty for the end marker,
+						 at most BATCH_MAX_NAME_LENGTH bytes (callers skip longer ones)
+		- fileSize : number of content bytes that follow the name
+
+-- RETURNS: std::vector<char> : header followed by the name, ready to send
+----------------------------------------------------------------------------------------------------------------------*/
+std::vector<char> EncodeBatchHeader(const std::string& relativeName, const uint64_t fileSize)
+{
+	std::vector<char> header(BATCH_HEADER_SIZE + relativeName.size());
+	WriteLittleEndian(&header[0], BATCH_MAGIC, 4);
+	WriteLittleEndian(&header[4], relativeName.size(), 2);
+	WriteLittleEndian(&header[6], fileSize, 8);
+	std::copy(relativeName.begin(), relativeName.end(), header.begin() + BATCH_HEADER_SIZE);
+	return header;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION DecodeBatchHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool DecodeBatchHeader(const char* header, bool& isPack, uint16_t& nameLength, uint64_t& fileSize)
+		- header : BATCH_HEADER_SIZE bytes read off the socket
+		- isPack : set if this starts a packed frame
+		- nameLength : set to the length of the name that follows, or entry count of a packed frame
+		- fileSize : set to the length of the content after the name, or body length of a packed frame
+
+-- RETURNS: bool : false if the magic doesnt match, stream is out of sync
+----------------------------------------------------------------------------------------------------------------------*/
+bool DecodeBatchHeader(const char* header, bool& isPack, uint16_t& nameLength, uint64_t& fileSize)
+{
+	uint64_t magic = ReadLittleEndian(header, 4);
+	if (magic != BATCH_MAGIC && magic != BATCH_PACK_MAGIC)
+		return false;
+	isPack = (magic == BATCH_PACK_MAGIC);
+	nameLength = (uint16_t)ReadLittleEndian(header + 4, 2);
+	fileSize = ReadLittleEndian(header + 6, 8);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION EncodePackHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: std::vector<char> EncodePackHeader(const uint16_t entryCount, const uint64_t bodyLength)
+		- entryCount : number of files in the frame
+		- bodyLength : bytes of index + content that follow the header
+
+-- RETURNS: std::vector<char> : header of a packed frame
+----------------------------------------------------------------------------------------------------------------------*/
+std::vector<char> EncodePackHeader(const uint16_t entryCount, const uint64_t bodyLength)
+{
+	std::vector<char> header(BATCH_HEADER_SIZE);
+	WriteLittleEndian(&header[0], BATCH_PACK_MAGIC, 4);
+	WriteLittleEndian(&header[4], entryCount, 2);
+	WriteLittleEndian(&header[6], bodyLength, 8);
+	return header;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION AppendPackEntry
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void AppendPackEntry(std::vector<char>& index, const std::string& relativeName, const uint64_t fileSize)
+		- index : index of the frame being built
+		- relativeName : utf8 path relative to the batch root
+		- fileSize : bytes of this file in the frame's content
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void AppendPackEntry(std::vector<char>& index, const std::string& relativeName, const uint64_t fileSize)
+{
+	size_t offset = index.size();
+	index.resize(offset + PACK_ENTRY_SIZE + relativeName.size());
+	WriteLittleEndian(&index[offset], relativeName.size(), 2);
+	WriteLittleEndian(&index[offset + 2], fileSize, 8);
+	std::copy(relativeName.begin(), relativeName.end(), index.begin() + offset + PACK_ENTRY_SIZE);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION DecodePackEntry
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool DecodePackEntry(const char* body, const size_t bodyLength, size_t& offset, std::string& relativeName,
+	uint64_t& fileSize)
+		- body : the frame body
+		- bodyLength : bytes in body
+		- offset : where the entry starts, moved past it
+		- relativeName : set to the entry's name
+		- fileSize : set to the entry's content size
+
+-- RETURNS: bool : false if the entry runs past the end of the frame
+----------------------------------------------------------------------------------------------------------------------*/
+bool DecodePackEntry(const char* body, const size_t bodyLength, size_t& offset, std::string& relativeName, uint64_t& fileSize)
+{
+	if (offset > bodyLength || bodyLength - offset < PACK_ENTRY_SIZE)
+		return false;
+	size_t nameLength = (size_t)ReadLittleEndian(body + offset, 2);
+	fileSize = ReadLittleEndian(body + offset + 2, 8);
+	offset += PACK_ENTRY_SIZE;
+	if (bodyLength - offset < nameLength)
+		return false;
+	relativeName.assign(body + offset, nameLength);
+	offset += nameLength;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION IsSafeRelativePath
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool IsSafeRelativePath(const QString& relativeName)
+		- relativeName : path taken off the wire
+
+-- RETURNS: bool : true if the path stays inside the output directory
+--
+-- NOTES:
+-- Names come from the other end so dont trust them, no absolute paths, drive letters or ".." parts.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IsSafeRelativePath(const QString& relativeName)
+{
+	if (relativeName.isEmpty() || relativeName.startsWith('/') || relativeName.startsWith('\\')
+		|| relativeName.contains(':'))
+		return false;
+
+	QString normalized = relativeName;
+	normalized.replace('\\', '/');
+	const QStringList parts = normalized.split('/');
+	for (const QString& part : parts)
+	{
+		if (part.isEmpty() || part == "." || part == "..")
+			return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReplaceWithTempFile
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReplaceWithTempFile(const QString& tempPath, const QString& targetPath)
+		- tempPath : fully written and closed file to move into place
+		- targetPath : file to replace, doesnt have to exist yet
+
+-- RETURNS: bool : false if the move failed, targetPath is then left as it was
+--
+-- NOTES:
+-- Removing the old file and renaming the new one over it leaves nothing at all if the rename fails or
+-- the process dies in between. MoveFileEx with REPLACE_EXISTING swaps it in one step, WRITE_THROUGH
+-- doesnt return until the move is on disk.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReplaceWithTempFile(const QString& tempPath, const QString& targetPath)
+{
+	std::wstring from = QDir::toNativeSeparators(tempPath).toStdWString();
+	std::wstring to = QDir::toNativeSeparators(targetPath).toStdWString();
+	return MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+void WriteLittleEndian(char* dest, uint64_t value, const int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+	{
+		dest[i] = (char)(value & 0xFF);
+		value >>= 8;
+	}
+}
+
+uint64_t ReadLittleEndian(const char* src, const int bytes)
+{
+	uint64_t value = 0;
+	for (int i = bytes - 1; i >= 0; i--)
+		value = (value << 8) | (unsigned char)src[i];
+	return value;
+}
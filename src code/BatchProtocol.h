@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QString>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define BATCH_MAGIC 0x424E5341 //"ASNB" on the wire
+#define BATCH_PACK_MAGIC 0x504E5341 //"ASNP", a frame of many small files
+#define BATCH_HEADER_SIZE 14 //magic(4) + name length(2) + file size(8)
+#define BATCH_MAX_NAME_LENGTH 65535 //utf8 bytes, what the uint16 name length can hold
+#define BATCH_CHUNK_SIZE 262144 //256KB reads/sends
+#define BATCH_QUEUE_DEPTH 16 //chunks read ahead of the sender, 4MB
+#define PACK_ENTRY_SIZE 10 //name length(2) + file size(8), name follows
+#define PACK_MAX_ENTRIES 65535
+#define PACK_MAX_FRAME_SIZE 67108864 //64MB, receiver refuses bigger frames
+#define PACK_FILE_DIVISOR 8 //files up to 1/8 of the frame size get packed
+
+std::vector<char> EncodeBatchHeader(const std::string&, const uint64_t);
+bool DecodeBatchHeader(const char*, bool&, uint16_t&, uint64_t&);
+std::vector<char> EncodePackHeader(const uint16_t, const uint64_t);
+void AppendPackEntry(std::vector<char>&, const std::string&, const uint64_t);
+bool DecodePackEntry(const char*, const size_t, size_t&, std::string&, uint64_t&);
+bool IsSafeRelativePath(const QString&);
+bool ReplaceWithTempFile(const QString&, const QString&);
+void WriteLittleEndian(char*, uint64_t, const int);
+uint64_t ReadLittleEndian(const char*, const int);
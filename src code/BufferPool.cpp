@@ -0,0 +1,254 @@
+#include "BufferPool.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: BufferPool.cpp - Fixed size buffer pool and per session arena
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	char* Data() const;
+	size_t Size() const;
+	static BufferPool& Shared();
+	PooledBuffer Acquire(const size_t);
+	void Release(char*, const int);
+	size_t GetHeapAllocations() const;
+	char* Allocate(const size_t);
+	void Reset();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Receive and send loops used to malloc their buffers every time they started (2GB of it for a
+-- TCP receive) and build packets in a new std::string. Buffers now come in three sizes from one
+-- shared pool, and a session's odd sized pieces (the packet, a datagram buffer) are cut out of
+-- pool blocks by its SessionArena. Once a transfer or two have run, starting another one doesnt
+-- touch the heap for buffers, and nothing in the loops themselves does.
+----------------------------------------------------------------------------------------------------------------------*/
+
+static const size_t poolSizes[POOL_SIZE_CLASSES] = { POOL_SMALL_SIZE, POOL_MEDIUM_SIZE, POOL_LARGE_SIZE };
+
+PooledBuffer::PooledBuffer()
+	: data(nullptr)
+	, size(0)
+	, sizeClass(-1)
+{
+}
+
+PooledBuffer::PooledBuffer(char* buffer, const size_t bufferSize, const int bufferClass)
+	: data(buffer)
+	, size(bufferSize)
+	, sizeClass(bufferClass)
+{
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer&& other)
+	: data(other.data)
+	, size(other.size)
+	, sizeClass(other.sizeClass)
+{
+	other.data = nullptr;
+	other.size = 0;
+}
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other)
+{
+	if (this != &other)
+	{
+		if (data != nullptr)
+			BufferPool::Shared().Release(data, sizeClass);
+		data = other.data;
+		size = other.size;
+		sizeClass = other.sizeClass;
+		other.data = nullptr;
+		other.size = 0;
+	}
+	return *this;
+}
+
+PooledBuffer::~PooledBuffer()
+{
+	if (data != nullptr)
+		BufferPool::Shared().Release(data, sizeClass);
+}
+
+char* PooledBuffer::Data() const
+{
+	return data;
+}
+
+size_t PooledBuffer::Size() const
+{
+	return size;
+}
+
+BufferPool::BufferPool()
+	: heapAllocations(0)
+{
+	for (std::vector<char*>& freeList : freeBuffers)
+	{
+		freeList.reserve(POOL_MAX_KEPT);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Shared
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: static BufferPool& Shared(void)
+--
+-- RETURNS: BufferPool& : the one pool every session takes from, made on first use
+----------------------------------------------------------------------------------------------------------------------*/
+BufferPool& BufferPool::Shared()
+{
+	static BufferPool pool;
+	return pool;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Acquire
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: PooledBuffer Acquire(const size_t minimumSize)
+		- minimumSize : bytes needed, the buffer is the smallest size class that fits
+
+-- RETURNS: PooledBuffer : the buffer, empty (Data() is nullptr) if the heap is out of memory
+--
+-- NOTES:
+-- Anything bigger than POOL_LARGE_SIZE gets a buffer of exactly that size, not pooled.
+----------------------------------------------------------------------------------------------------------------------*/
+PooledBuffer BufferPool::Acquire(const size_t minimumSize)
+{
+	int sizeClass = 0;
+	while (sizeClass < POOL_SIZE_CLASSES && poolSizes[sizeClass] < minimumSize)
+	{
+		++sizeClass;
+	}
+	if (sizeClass == POOL_SIZE_CLASSES)
+	{
+		++heapAllocations;
+		return PooledBuffer(new (std::nothrow) char[minimumSize], minimumSize, -1);
+	}
+	{
+		std::lock_guard<std::mutex> lock(poolLock);
+		if (!freeBuffers[sizeClass].empty())
+		{
+			char* buffer = freeBuffers[sizeClass].back();
+			freeBuffers[sizeClass].pop_back();
+			return PooledBuffer(buffer, poolSizes[sizeClass], sizeClass);
+		}
+	}
+	++heapAllocations;
+	return PooledBuffer(new (std::nothrow) char[poolSizes[sizeClass]], poolSizes[sizeClass], sizeClass);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Release
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Release(char* buffer, const int sizeClass)
+		- buffer : from Acquire
+		- sizeClass : the class it came from, -1 if it wasnt from one
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called by PooledBuffer, not directly.
+----------------------------------------------------------------------------------------------------------------------*/
+void BufferPool::Release(char* buffer, const int sizeClass)
+{
+	if (sizeClass >= 0)
+	{
+		std::lock_guard<std::mutex> lock(poolLock);
+		if (freeBuffers[sizeClass].size() < POOL_MAX_KEPT)
+		{
+			freeBuffers[sizeClass].push_back(buffer);
+			return;
+		}
+	}
+	delete[] buffer;
+}
+
+size_t BufferPool::GetHeapAllocations() const
+{
+	return heapAllocations;
+}
+
+SessionArena::SessionArena()
+	: used(0)
+{
+	blocks.reserve(ARENA_MAX_BLOCKS);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Allocate
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: char* Allocate(const size_t length)
+		- length : bytes needed
+
+-- RETURNS: char* : ARENA_ALIGNMENT aligned memory that stays good until Reset or the arena goes,
+--                  nullptr if the heap is out of memory
+--
+-- NOTES:
+-- Pieces are cut from POOL_LARGE_SIZE blocks, a piece bigger than that gets a block of its own.
+----------------------------------------------------------------------------------------------------------------------*/
+char* SessionArena::Allocate(const size_t length)
+{
+	size_t start = (used + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+	if (blocks.empty() || start + length > blocks.back().Size())
+	{
+		PooledBuffer block = BufferPool::Shared().Acquire(std::max<size_t>(length, POOL_LARGE_SIZE));
+		if (block.Data() == nullptr)
+			return nullptr;
+		blocks.push_back(std::move(block));
+		start = 0;
+	}
+	used = start + length;
+	return blocks.back().Data() + start;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Reset
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Reset(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Every piece handed out so far is gone, their blocks are back in the pool.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionArena::Reset()
+{
+	blocks.clear();
+	used = 0;
+}
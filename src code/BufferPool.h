@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#define POOL_SIZE_CLASSES 3
+#define POOL_SMALL_SIZE 65536 //a datagram, a dedup chunk
+#define POOL_MEDIUM_SIZE 262144 //a batch chunk
+#define POOL_LARGE_SIZE 1048576 //a tcp receive, an arena block
+#define POOL_MAX_KEPT 64 //free buffers kept per size class, more than that go back to the heap
+#define ARENA_ALIGNMENT 16
+#define ARENA_MAX_BLOCKS 64 //blocks reserved up front so the block list itself doesnt grow mid transfer
+
+//one buffer from BufferPool, handed back when this goes out of scope
+class PooledBuffer
+{
+public:
+	PooledBuffer();
+	PooledBuffer(char*, const size_t, const int);
+	PooledBuffer(PooledBuffer&&);
+	PooledBuffer& operator=(PooledBuffer&&);
+	PooledBuffer(const PooledBuffer&) = delete;
+	PooledBuffer& operator=(const PooledBuffer&) = delete;
+	virtual ~PooledBuffer();
+	char* Data() const;
+	size_t Size() const;
+
+private:
+	char* data;
+	size_t size;
+	int sizeClass; //-1 for a buffer too big for any class, freed instead of kept
+};
+
+//process wide free lists of fixed size buffers, so sessions after the first reuse the last ones' memory
+class BufferPool
+{
+public:
+	static BufferPool& Shared();
+	PooledBuffer Acquire(const size_t);
+	void Release(char*, const int);
+	size_t GetHeapAllocations() const;
+
+private:
+	BufferPool();
+	std::mutex poolLock;
+	std::vector<char*> freeBuffers[POOL_SIZE_CLASSES];
+	std::atomic<size_t> heapAllocations; //buffers the pool had to make, flat once warmed up
+};
+
+//bump allocator for one session's buffers, everything goes back to the pool at once
+class SessionArena
+{
+public:
+	SessionArena();
+	virtual ~SessionArena() = default;
+	char* Allocate(const size_t);
+	void Reset();
+
+private:
+	std::vector<PooledBuffer> blocks;
+	size_t used; //bytes handed out of the last block
+};
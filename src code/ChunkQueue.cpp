@@ -0,0 +1,165 @@
+#include "ChunkQueue.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ChunkQueue.cpp - Bounded hand-off of file data between a reader thread and a send loop
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	bool Push(DataChunk&&);
+	bool Pop(DataChunk&);
+	void Finish();
+	void Cancel();
+	bool IsCancelled();
+	double GetPushWaitSeconds();
+	double GetPopWaitSeconds();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Lets disk reads of the next file overlap the sends of the current one. The reader blocks once
+-- capacity chunks are waiting, so memory stays bounded no matter how big the batch is.
+-- Finish is called by the producer when its done; Cancel by the consumer when it gives up, which
+-- wakes a producer stuck on a full queue.
+-- Time either side spent blocked is added up, so a caller can tell which side held the other up.
+----------------------------------------------------------------------------------------------------------------------*/
+
+ChunkQueue::ChunkQueue(const size_t maxChunks)
+	: capacity(maxChunks)
+	, finished(false)
+	, cancelled(false)
+	, pushWaitNs(0)
+	, popWaitNs(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Push
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Push(DataChunk&& chunk)
+		- chunk : DataChunk, moved into the queue
+
+-- RETURNS: bool : false if the consumer cancelled, producer should stop reading
+----------------------------------------------------------------------------------------------------------------------*/
+bool ChunkQueue::Push(DataChunk&& chunk)
+{
+	std::unique_lock<std::mutex> lock(queueLock);
+	if (chunks.size() >= capacity && !cancelled)
+	{
+		auto waitStart = std::chrono::steady_clock::now();
+		spaceAvailable.wait(lock, [this]() { return chunks.size() < capacity || cancelled; });
+		pushWaitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count();
+	}
+	if (cancelled)
+		return false;
+	chunks.push_back(std::move(chunk));
+	chunkAvailable.notify_one();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Pop
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Pop(DataChunk& chunk)
+		- chunk : DataChunk, set to the oldest chunk
+
+-- RETURNS: bool : false once the producer finished and everything was taken, or on cancel
+----------------------------------------------------------------------------------------------------------------------*/
+bool ChunkQueue::Pop(DataChunk& chunk)
+{
+	std::unique_lock<std::mutex> lock(queueLock);
+	if (chunks.empty() && !finished && !cancelled)
+	{
+		auto waitStart = std::chrono::steady_clock::now();
+		chunkAvailable.wait(lock, [this]() { return !chunks.empty() || finished || cancelled; });
+		popWaitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count();
+	}
+	if (cancelled || chunks.empty())
+		return false;
+	chunk = std::move(chunks.front());
+	chunks.pop_front();
+	spaceAvailable.notify_one();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Finish
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Finish(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Producer is done, Pop drains whats left then returns false.
+----------------------------------------------------------------------------------------------------------------------*/
+void ChunkQueue::Finish()
+{
+	std::lock_guard<std::mutex> lock(queueLock);
+	finished = true;
+	chunkAvailable.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Cancel
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Cancel(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Consumer gave up (send failed), wakes both sides and drops queued chunks.
+----------------------------------------------------------------------------------------------------------------------*/
+void ChunkQueue::Cancel()
+{
+	std::lock_guard<std::mutex> lock(queueLock);
+	cancelled = true;
+	chunks.clear();
+	spaceAvailable.notify_all();
+	chunkAvailable.notify_all();
+}
+
+bool ChunkQueue::IsCancelled()
+{
+	std::lock_guard<std::mutex> lock(queueLock);
+	return cancelled;
+}
+
+double ChunkQueue::GetPushWaitSeconds()
+{
+	std::lock_guard<std::mutex> lock(queueLock);
+	return pushWaitNs / 1e9;
+}
+
+double ChunkQueue::GetPopWaitSeconds()
+{
+	std::lock_guard<std::mutex> lock(queueLock);
+	return popWaitNs / 1e9;
+}
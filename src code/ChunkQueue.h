@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QString>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+struct DataChunk
+{
+	std::vector<char> bytes;
+	QString fileName; //set on the chunk that starts a file, for status output
+	int fileCount = 0; //files that start in this chunk, more than 1 for a packed frame
+};
+
+class ChunkQueue
+{
+public:
+	ChunkQueue(const size_t);
+	virtual ~ChunkQueue() = default;
+	bool Push(DataChunk&&);
+	bool Pop(DataChunk&);
+	void Finish();
+	void Cancel();
+	bool IsCancelled();
+	double GetPushWaitSeconds();
+	double GetPopWaitSeconds();
+
+private:
+	std::deque<DataChunk> chunks;
+	size_t capacity;
+	bool finished;
+	bool cancelled;
+	uint64_t pushWaitNs; //producer blocked on a full queue, the consumer is the bottleneck
+	uint64_t popWaitNs; //consumer blocked on an empty queue, the producer is
+	std::mutex queueLock;
+	std::condition_variable spaceAvailable;
+	std::condition_variable chunkAvailable;
+};
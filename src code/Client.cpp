@@ -1,4 +1,10 @@
 #include "Client.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QTextStream>
+#include <thread>
+#include <climits>
 
 /*------------------------------------------------------------------------------------------------------------------
 -- SOURCE FILE: Client.cpp - An class for handling sending related function calls in the WinSock2 API
@@ -6,8 +12,34 @@
 -- PROGRAM: TcpUdpFileTransfer/PacketLogger
 --
 -- FUNCTIONS:
-	void SendTcpPackets(SOCKET, const QString&, const size_t, const size_t);
-	void SendUdpPackets(SOCKET, const QString&, const size_t, const size_t, struct sockaddr_in);
+	void SendTcpPackets(SOCKET, const QString&, const size_t, const size_t, const TransferOptions&);
+	void SendUdpPackets(SOCKET, const QString&, const size_t, const size_t, struct sockaddr_storage, const TransferOptions&);
+	void SendTcpBatch(SOCKET, const QString&, const TransferOptions&);
+	void PrintPacingSummary(const PacketPacer&);
+	char* BuildPacket(const QString&, const size_t, const TransferOptions&);
+	void SendTcpSealed(SOCKET, const char*, const size_t, const size_t, const QString&, PacketPacer&);
+	void SendTcpElided(SOCKET, const char*, const size_t, const size_t, PacketPacer&);
+	void SendPingPong(SOCKET, const bool, const QString&, const size_t, const size_t, const struct sockaddr_storage&, const TransferOptions&);
+	bool WaitForEcho(SOCKET, char*, const size_t, const bool, const bool, const uint64_t, const uint64_t, uint64_t&);
+	void ReportProgress(std::chrono::steady_clock::time_point&);
+	void SendUdpFec(SOCKET, const char*, const size_t, const size_t, const struct sockaddr_storage&, const int, PacketPacer&);
+	void SendUdpMulticast(SOCKET, const char*, const size_t, const size_t, const struct sockaddr_storage&, PacketPacer&);
+	bool SendUdpRio(const int, char*, const size_t, const size_t, const std::vector<struct sockaddr_storage>&, const bool, PacketPacer&);
+	bool CollectBatchFiles(const QString&, QString&, QStringList&);
+	void ReadBatchFiles(const QString&, const QStringList&, const size_t, ChunkQueue&);
+	bool FlushPackFrame(std::vector<char>&, std::vector<char>&, int&, ChunkQueue&);
+	bool SendAll(SOCKET, const char*, const size_t, const bool);
+	void SendTcpDelta(SOCKET, const QString&, const TransferOptions&);
+	bool ReceiveAll(SOCKET, char*, const size_t);
+	bool ReceiveSignatures(SOCKET, uint32_t&, SignatureIndex&, size_t&);
+	double GetThreadCpuSeconds();
+	void SendTcpDedup(SOCKET, const QString&, const TransferOptions&);
+	void Cancel();
+	size_t GetBytesSent() const;
+	size_t GetPacketsSent() const;
+	size_t GetSendErrors() const;
+	size_t GetRetransmits() const;
+	void ReadLiveTotals(LiveTotals&) const;
 --
 -- DATE: Feb 10, 2018
 --
@@ -19,8 +51,25 @@
 -- This class implements the same WinSock capabilities as WSASocketManager, but
 -- is specific to sending packets, and lives in its own thread instead of main. 
 -- It handles all calls(except for connect) to Sending-related functions of WinSock2 API.
+--
+-- Each TransferSession makes its own Client and runs one send on a pool thread. Bytes/packets sent
+-- are kept in atomics so the session list can show progress while the loop runs, and Cancel lets
+-- the session stop a send early.
+-- File reads, pacing waits and sends are timed with TraceScope for the flight recorder.
 ----------------------------------------------------------------------------------------------------------------------*/
 
+Client::Client()
+	: cancelRequested(false)
+	, totalBytesSent(0)
+	, totalPacketsSent(0)
+	, sendErrors(0)
+	, retransmits(0)
+	, rttTotalNs(0)
+	, rttCount(0)
+	, pingsLost(0)
+{
+}
+
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION SendTcpPackets
 --
@@ -31,11 +80,12 @@
 -- PROGRAMMER: Alex Xia
 --
 -- INTERFACE: void SendTcpPackets(SOCKET clientSocket, const QString& filePath, const size_t packetSize, 
-	const size_t packetCount)
+	const size_t packetCount, const TransferOptions& options)
 		- clientSocket : SOCKET, socket to send packets to, already connected
 		- filePath : QString, absolute path to file to write data to
 		- packetSize : unsigned int, size to make packets at
 		- packetCount : unsigned int, number of times to send packet
+		- options : TransferOptions, target send rate
 
 -- RETURNS: void.
 --
@@ -44,62 +94,99 @@
 -- This function lies on a different thread than main: should be signaled, not directly called.
 --
 -- Makes a packet from a file, then repeated sends it to a socket to a server(with up to 3 retransmits if fail).  
+-- Only a full send buffer (WSAEWOULDBLOCK) is retransmitted, any other error ends the transfer.
+-- Each packet waits on the pacer first if a target rate was set.
+-- With options.shardCount above 1, connections to the next ports up are made too and packets
+-- take turns going over each, so every server shard gets its share.
+-- With options.encrypted the packets go through SendTcpSealed instead, over the one connection.
+-- With options.elideZeros they go through SendTcpElided, zero runs left out.
 ----------------------------------------------------------------------------------------------------------------------*/
-void Client::SendTcpPackets(SOCKET clientSocket, const QString& filePath, const size_t packetSize, const size_t packetCount)
+void Client::SendTcpPackets(SOCKET clientSocket, const QString& filePath, const size_t packetSize, const size_t packetCount, const TransferOptions& options)
 {
 	//this buffer holds all of packet data
-	std::string* packetDataBuffer = new std::string();
-	//~9GB, this number exceeeds upper bounds of int 
-	size_t MAX_BUFFER_SIZE = packetDataBuffer->max_size();
-	if (packetSize > MAX_BUFFER_SIZE)
+	char* packet = BuildPacket(filePath, packetSize, options);
+	if (packet == nullptr)
 	{
-		emit ClientAlertableErrorOccured(QString("PacketSize wayyy too big. Use a number\n smaller than %1").arg(MAX_BUFFER_SIZE));
+		emit ClientAlertableErrorOccured("PacketSize wayyy too big, not enough memory for it.");
 		return;
 	}
-	//make packets
-	std::ifstream packetDataFile(filePath.toStdString());
-	std::streambuf &optmzedBuf = *packetDataFile.rdbuf();
-	while(packetDataBuffer->size() < packetSize )
+	if (options.encrypted)
+	{
+		PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+		pacer.ApplyKernelPacing(clientSocket);
+		SendTcpSealed(clientSocket, packet, packetSize, packetCount, options.encryptionKey, pacer);
+		closesocket(clientSocket);
+		return;
+	}
+	if (options.elideZeros)
 	{
-		char c = optmzedBuf.sbumpc();
-		// pad packet with 0s after reaching eof in file
-		if(c == EOF)
-			c = 0;
-		packetDataBuffer->push_back(c);
+		PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+		pacer.ApplyKernelPacing(clientSocket);
+		SendTcpElided(clientSocket, packet, packetSize, packetCount, pacer);
+		closesocket(clientSocket);
+		return;
+	}
+	std::vector<SOCKET> shardSockets;
+	if (!ConnectShards(clientSocket, options.shardCount, shardSockets))
+	{
+		emit ClientPrintableStatusReady(QString("-only %1 of %2 shard ports took a connection, sending over those")
+			.arg(shardSockets.size()).arg(options.shardCount));
 	}
 	int retrans_count = 0;
+	auto lastProgress = std::chrono::steady_clock::now();
+	PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+	for (SOCKET shardSocket : shardSockets)
+		pacer.ApplyKernelPacing(shardSocket);
+	pacer.Start();
 	//send packets (at least) specified times
-	for (int i = 0; i < packetCount; ++i)
+	for (int i = 0; i < packetCount && !cancelRequested; ++i)
 	{
-		if (send(clientSocket, packetDataBuffer->c_str(), packetDataBuffer->size(), 0) == -1)
+		//retransmits already paid for their tokens
+		if (retrans_count == 0)
+		{
+			TraceScope trace(TraceStage::Pace, packetSize, pacer.IsPaced());
+			pacer.Pace(packetSize);
+		}
+		TraceScope trace(TraceStage::Send, packetSize);
+		int bytesSent = send(shardSockets[i % shardSockets.size()], packet, (int)packetSize, 0);
+		trace.End();
+		if (bytesSent == -1)
 		{
 			int error_code = WSAGetLastError();
-			if (error_code = WSAEWOULDBLOCK) //resource busy, try again
+			if (error_code == WSAEWOULDBLOCK) //resource busy, try again
 			{
 				if (retrans_count < 3)
 				{
 					--i;
 					++retrans_count;
+					++retransmits;
 					emit ClientPrintableStatusReady(QString("-send failed %1 times, retransmiting...").arg(retrans_count));				
 					QThread::msleep(100);
 					continue;
 				}
+				retrans_count = 0;
+				++sendErrors;
 				emit ClientPrintableStatusReady("-send failed, retransmit too many times");				
 				continue;
 			} 
-			emit ClientPrintableStatusReady(QString("-send failed, unexpected error code: %1").arg(WSAGetLastError()));					
+			//reset, not connected and the like, the connection is gone so the rest cant go either
+			++sendErrors;
+			emit ClientPrintableStatusReady(QString("-send failed, unexpected error code: %1").arg(error_code));
+			break;
 		}
 		else
 		{
 			retrans_count = 0;
-			emit ClientPrintableStatusReady("-sent packet.");				
+			totalBytesSent += packetSize;
+			++totalPacketsSent;
+			ReportProgress(lastProgress);
 		}
 	}
-	delete packetDataBuffer;
 	//emit signal print sht to console
-	emit ClientPrintableStatusReady("-Finished sending all packets.");
-	packetDataFile.close();	
-	closesocket(clientSocket);
+	emit ClientPrintableStatusReady(QString("-Finished sending all packets, %1 sent.").arg(totalPacketsSent));
+	PrintPacingSummary(pacer);
+	for (SOCKET shardSocket : shardSockets)
+		closesocket(shardSocket);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -112,12 +199,13 @@ void Client::SendTcpPackets(SOCKET clientSocket, const QString& filePath, const
 -- PROGRAMMER: Alex Xia
 --
 -- INTERFACE: void Client::SendUdpPackets(SOCKET clientSocket, const QString& filePath, const size_t packetSize,
-	 const size_t packetCount, struct sockaddr_in server_socketaddr)
+	 const size_t packetCount, struct sockaddr_storage server_socketaddr, const TransferOptions& options)
 		- clientSocket : SOCKET, socket to send packets to
 		- filePath : QString, absolute path to file to write data to
 		- packetSize : unsigned int, size to make packets at
 		- packetCount : unsigned int, number of times to send packet
-		- server_socketaddr : struct sockaddr_in, struct holding address & port of server
+		- server_socketaddr : struct sockaddr_storage, struct holding IPv4 or IPv6 address & port of server
+		- options : TransferOptions, target send rate
 
 -- RETURNS: void.
 --
@@ -126,50 +214,1684 @@ void Client::SendTcpPackets(SOCKET clientSocket, const QString& filePath, const
 -- This function lies on a different thread than main: should be signaled, not directly called.
 --
 -- Makes a UDP packet from a file, then repeated sends it to a socket to a server(with no retransmits).  
+-- Each datagram waits on the pacer first if a target rate was set, so the server's socket buffer isnt overrun.
+-- In Measure mode the first UDP_MEASURE_HEADER_SIZE bytes of every datagram are its sequence number and
+-- send time instead of file data, stamped after the pacer so pacing waits arent counted as delay.
+-- With options.shardCount above 1, datagrams go round robin to the server's port and the next ones up.
+-- With options.udpOffload, as many copies of the packet as fit in UDP_OFFLOAD_MAX_BYTES go in one
+-- sendto and the stack cuts them back into packetSize datagrams (USO). Measure mode keeps one
+-- datagram per send, so each one's send time is its own.
+-- With options.registeredIo, the packets go out through SendUdpRio instead, if RIO is there.
+-- With options.fecRepair above 0 they go out through SendUdpFec, with repair datagrams in between.
+-- If the server address is a multicast group they go out through SendUdpMulticast instead, once for
+-- every server in the group, and the options above dont apply.
 ----------------------------------------------------------------------------------------------------------------------*/
-void Client::SendUdpPackets(SOCKET clientSocket, const QString& filePath, const size_t packetSize, const size_t packetCount, struct sockaddr_in server_socketaddr)
+void Client::SendUdpPackets(SOCKET clientSocket, const QString& filePath, const size_t packetSize, const size_t packetCount, struct sockaddr_storage server_socketaddr, const TransferOptions& options)
 {
 	//this buffer holds all of packet data
-	std::string* packetDataBuffer = new std::string();
-	//~9GB, this number exceeeds upper bounds of int 
-	size_t MAX_BUFFER_SIZE = packetDataBuffer->max_size();
-	if (packetSize > MAX_BUFFER_SIZE)
+	char* packet = BuildPacket(filePath, packetSize, options);
+	if (packet == nullptr)
 	{
-		ClientAlertableErrorOccured(QString("PacketSize wayyy too big. Use a number\n smaller than %1").arg(MAX_BUFFER_SIZE));
+		emit ClientAlertableErrorOccured("PacketSize wayyy too big, not enough memory for it.");
 		return;
 	}
-	//make packets
-	std::ifstream packetDataFile(filePath.toStdString());
-	while(packetDataBuffer->size() < packetSize )
-	{
-		char c;
-		packetDataFile.get(c);
-		//pad packet after reaching eof in file
-		if(packetDataFile.fail()) {
-			// break;
-			packetDataBuffer->push_back(0);
-			continue;
-		}
-		packetDataBuffer->push_back(c);
+	if (IsMulticastAddress(server_socketaddr))
+	{
+		if (options.shardCount > 1 || options.udpOffload || options.registeredIo || options.fecRepair > 0)
+			emit ClientPrintableStatusReady("-multicast group: shards, offload, Registered I/O and FEC are off for this run");
+		PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+		pacer.ApplyKernelPacing(clientSocket);
+		SendUdpMulticast(clientSocket, packet, packetSize, packetCount, server_socketaddr, pacer);
+		closesocket(clientSocket);
+		return;
+	}
+	if (options.fecRepair > 0)
+	{
+		PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+		pacer.ApplyKernelPacing(clientSocket);
+		SendUdpFec(clientSocket, packet, packetSize, packetCount, server_socketaddr, options.fecRepair, pacer);
+		closesocket(clientSocket);
+		return;
 	}
 	
 	//server_socketaddr
-	size_t server_len = sizeof(server_socketaddr);
-	for (int i = 0; i < packetCount; ++i)
+	int server_len = (server_socketaddr.ss_family == AF_INET6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+	std::vector<struct sockaddr_storage> shardAddresses(1, server_socketaddr);
+	for (int shard = 1; shard < options.shardCount; ++shard)
+	{
+		struct sockaddr_storage shardAddress = server_socketaddr;
+		if (ShardAddress(shardAddress, shard))
+			shardAddresses.push_back(shardAddress);
+	}
+	bool measuring = (options.mode == TransferMode::Measure && packetSize >= UDP_MEASURE_HEADER_SIZE);
+	size_t datagramsPerSend = 1;
+	if (options.udpOffload && !measuring)
+	{
+		size_t fit = UDP_OFFLOAD_MAX_BYTES / packetSize;
+		if (fit >= 2 && EnableSendOffload(clientSocket, packetSize))
+			datagramsPerSend = fit;
+		else
+			emit ClientPrintableStatusReady("-UDP send offload not available for this packet size, sending one datagram at a time");
+	}
+	const char* sendData = packet;
+	if (datagramsPerSend > 1)
+	{
+		char* offloadBuffer = arena.Allocate(datagramsPerSend * packetSize); //datagramsPerSend copies of the packet back to back
+		for (size_t copy = 0; copy < datagramsPerSend; ++copy)
+		{
+			memcpy(offloadBuffer + copy * packetSize, packet, packetSize);
+		}
+		sendData = offloadBuffer;
+	}
+	auto lastProgress = std::chrono::steady_clock::now();
+
+	PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+	pacer.ApplyKernelPacing(clientSocket);
+	pacer.Start();
+	bool sentWithRio = options.registeredIo
+		&& SendUdpRio(server_socketaddr.ss_family, packet, packetSize, packetCount, shardAddresses, measuring, pacer);
+	if (options.registeredIo && !sentWithRio)
 	{
-		if (sendto(clientSocket, packetDataBuffer->c_str(), packetDataBuffer->size(), 0,
-			(struct sockaddr*)& server_socketaddr, server_len) == -1)
+		emit ClientPrintableStatusReady("-Registered I/O not available here, sending through the socket");
+	}
+	for (size_t i = 0; i < packetCount && !cancelRequested && !sentWithRio; )
+	{
+		size_t datagrams = std::min(datagramsPerSend, packetCount - i);
+		size_t sendLength = datagrams * packetSize;
+		TraceScope paceTrace(TraceStage::Pace, sendLength, pacer.IsPaced());
+		pacer.Pace(sendLength);
+		paceTrace.End();
+		if (measuring)
+		{
+			WriteMeasureHeader(packet, i, packetCount);
+		}
+		TraceScope sendTrace(TraceStage::Send, sendLength);
+		int bytesSent = sendto(clientSocket, sendData, (int)sendLength, 0,
+			(struct sockaddr*)& shardAddresses[(i / datagramsPerSend) % shardAddresses.size()], server_len);
+		sendTrace.End();
+		if (bytesSent == -1)
 		{
+			++sendErrors;
 			emit ClientPrintableStatusReady(QString("-sendto'd failed, unexpected error code: %1").arg(WSAGetLastError()));					
 		} 
 		else
 		{
-			emit ClientPrintableStatusReady("-sendto'd packet.");				
+			totalBytesSent += sendLength;
+			totalPacketsSent += datagrams;
+			ReportProgress(lastProgress);
 		}
+		i += datagrams;
 	}
-	delete packetDataBuffer;
 	//emit signal print sht to console
-	emit ClientPrintableStatusReady("-Finished sending all packets.");
-	packetDataFile.close();	
+	emit ClientPrintableStatusReady(QString("-Finished sending all packets, %1 sent.").arg(totalPacketsSent));
+	PrintPacingSummary(pacer);
+	closesocket(clientSocket);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendUdpFec
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendUdpFec(SOCKET clientSocket, const char* packet, const size_t packetSize, const size_t packetCount,
+	const struct sockaddr_storage& serverAddress, const int repairCount, PacketPacer& pacer)
+		- clientSocket : SOCKET, socket to send packets to
+		- packet : the packet SendUdpPackets built
+		- packetSize : unsigned int, its size, up to FEC_MAX_PAYLOAD
+		- packetCount : unsigned int, number of times to send it
+		- serverAddress : struct sockaddr_storage, IPv4 or IPv6 address & port of server
+		- repairCount : repair datagrams per block, 1 to FEC_MAX_REPAIR
+		- pacer : PacketPacer, target send rate, not started yet
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Every datagram is an FEC header then the packet, in blocks of FEC_BLOCK_DATA. Each one is added
+-- into the block's repairs as it goes out, and the repairs follow the block's last datagram.
+-- Repair datagrams are paced and count as bytes sent, but not as packets.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendUdpFec(SOCKET clientSocket, const char* packet, const size_t packetSize, const size_t packetCount,
+	const struct sockaddr_storage& serverAddress, const int repairCount, PacketPacer& pacer)
+{
+	int addressLength = (serverAddress.ss_family == AF_INET6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+	size_t datagramSize = FEC_HEADER_SIZE + packetSize;
+	UdpFecEncoder encoder;
+	char* datagram = (packetSize <= FEC_MAX_PAYLOAD) ? arena.Allocate(datagramSize) : nullptr;
+	if (datagram == nullptr || !encoder.Open(arena, packetSize, repairCount))
+	{
+		emit ClientAlertableErrorOccured(QString("FEC packets can be at most %1 Bytes.").arg(FEC_MAX_PAYLOAD));
+		return;
+	}
+	memcpy(datagram + FEC_HEADER_SIZE, packet, packetSize);
+	emit ClientPrintableStatusReady(QString("-FEC: %1 repair datagrams after every %2").arg(repairCount).arg(FEC_BLOCK_DATA));
+
+	auto lastProgress = std::chrono::steady_clock::now();
+	size_t repairsSent = 0;
+	pacer.Start();
+	for (size_t blockStart = 0; blockStart < packetCount && !cancelRequested; blockStart += FEC_BLOCK_DATA)
+	{
+		uint32_t block = (uint32_t)(blockStart / FEC_BLOCK_DATA);
+		int dataCount = (int)std::min<size_t>(FEC_BLOCK_DATA, packetCount - blockStart);
+		for (int index = 0; index < dataCount + repairCount; ++index)
+		{
+			char* sendData = datagram;
+			if (index < dataCount)
+			{
+				encoder.Add(datagram + FEC_HEADER_SIZE, packetSize, index);
+			}
+			else
+			{
+				sendData = encoder.RepairDatagram(index - dataCount);
+			}
+			WriteFecHeader(sendData, block, index, dataCount, repairCount);
+			pacer.Pace(datagramSize);
+			if (sendto(clientSocket, sendData, (int)datagramSize, 0, (const struct sockaddr*)&serverAddress, addressLength) == -1)
+			{
+				++sendErrors;
+				emit ClientPrintableStatusReady(QString("-sendto'd failed, unexpected error code: %1").arg(WSAGetLastError()));
+				continue;
+			}
+			totalBytesSent += datagramSize;
+			if (index < dataCount)
+				++totalPacketsSent;
+			else
+				++repairsSent;
+		}
+		encoder.Reset();
+		ReportProgress(lastProgress);
+	}
+	emit ClientPrintableStatusReady(QString("-Finished sending all packets, %1 sent, plus %2 FEC repair datagrams.")
+		.arg(totalPacketsSent).arg(repairsSent));
+	PrintPacingSummary(pacer);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendUdpMulticast
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendUdpMulticast(SOCKET clientSocket, const char* packet, const size_t packetSize, const size_t packetCount,
+	const struct sockaddr_storage& groupAddress, PacketPacer& pacer)
+		- clientSocket : SOCKET, socket to send packets to, NACKs come back on it too
+		- packet : the packet SendUdpPackets built
+		- packetSize : unsigned int, its size, up to MULTICAST_MAX_PAYLOAD
+		- packetCount : unsigned int, number of times to send it
+		- groupAddress : struct sockaddr_storage, IPv4 or IPv6 multicast group & port the servers joined
+		- pacer : PacketPacer, target send rate, not started yet
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Every datagram is a multicast header then the packet, sent once to the group (see UdpMulticast.cpp).
+-- Every MULTICAST_POLL_DATAGRAMS sends the socket is drained of NACKs, and anything they ask for
+-- goes out again ahead of the next new datagram. After the last one the loop stays around for
+-- MULTICAST_LINGER_MS past the last send, answering stragglers.
+-- Repairs are paced and count as bytes sent, but not as packets.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendUdpMulticast(SOCKET clientSocket, const char* packet, const size_t packetSize, const size_t packetCount,
+	const struct sockaddr_storage& groupAddress, PacketPacer& pacer)
+{
+	int addressLength = (groupAddress.ss_family == AF_INET6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+	size_t datagramSize = MULTICAST_HEADER_SIZE + packetSize;
+	MulticastRepairQueue repairs;
+	char* datagram = (packetSize <= MULTICAST_MAX_PAYLOAD) ? arena.Allocate(datagramSize) : nullptr;
+	char* nack = arena.Allocate(MULTICAST_NACK_SIZE);
+	if (datagram == nullptr || nack == nullptr)
+	{
+		emit ClientAlertableErrorOccured(QString("Multicast packets can be at most %1 Bytes.").arg(MULTICAST_MAX_PAYLOAD));
+		return;
+	}
+	if (!repairs.Open(arena, packetCount))
+	{
+		emit ClientAlertableErrorOccured(QString("Multicast runs can be at most %1 packets.").arg(MULTICAST_MAX_DATAGRAMS));
+		return;
+	}
+	if (!EnableMulticastSend(clientSocket, groupAddress.ss_family))
+	{
+		emit ClientAlertableErrorOccured(QString("Can't send to a multicast group, error code: %1").arg(WSAGetLastError()));
+		return;
+	}
+	memcpy(datagram + MULTICAST_HEADER_SIZE, packet, packetSize);
+	emit ClientPrintableStatusReady("-multicast: sending to the group once, NACKed datagrams are sent again");
+
+	auto lastProgress = std::chrono::steady_clock::now();
+	auto lastSend = lastProgress;
+	size_t nextSequence = 0;
+	size_t repairsSent = 0;
+	size_t nacksReceived = 0;
+	int sendsSincePoll = MULTICAST_POLL_DATAGRAMS;
+	pacer.Start();
+	while (!cancelRequested)
+	{
+		if (sendsSincePoll >= MULTICAST_POLL_DATAGRAMS || nextSequence >= packetCount)
+		{
+			struct sockaddr_storage receiver;
+			int receiverLength = sizeof(receiver);
+			int nackLength;
+			while ((nackLength = recvfrom(clientSocket, nack, MULTICAST_NACK_SIZE, 0, (struct sockaddr*)&receiver, &receiverLength)) > 0)
+			{
+				repairs.AddNack(nack, nackLength);
+				++nacksReceived;
+				receiverLength = sizeof(receiver);
+			}
+			sendsSincePoll = 0;
+		}
+		uint64_t sequence;
+		bool isRepair = repairs.Next(sequence);
+		if (!isRepair)
+		{
+			if (nextSequence >= packetCount)
+			{
+				if (std::chrono::steady_clock::now() - lastSend >= std::chrono::milliseconds(MULTICAST_LINGER_MS))
+					break;
+				QThread::msleep(MULTICAST_NACK_MS / 5);
+				continue;
+			}
+			sequence = nextSequence++;
+		}
+		WriteMulticastHeader(datagram, sequence, packetCount);
+		pacer.Pace(datagramSize);
+		if (sendto(clientSocket, datagram, (int)datagramSize, 0, (const struct sockaddr*)&groupAddress, addressLength) == -1)
+		{
+			++sendErrors;
+			emit ClientPrintableStatusReady(QString("-sendto'd failed, unexpected error code: %1").arg(WSAGetLastError()));
+		}
+		else
+		{
+			totalBytesSent += datagramSize;
+			if (isRepair)
+				++repairsSent;
+			else
+				++totalPacketsSent;
+			ReportProgress(lastProgress);
+		}
+		lastSend = std::chrono::steady_clock::now();
+		++sendsSincePoll;
+	}
+	emit ClientPrintableStatusReady(QString("-Finished sending all packets, %1 sent, plus %2 repairs for %3 NACKs.")
+		.arg(totalPacketsSent).arg(repairsSent).arg(nacksReceived));
+	PrintPacingSummary(pacer);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendUdpRio
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SendUdpRio(const int family, char* packet, const size_t packetSize, const size_t packetCount,
+--                            const std::vector<struct sockaddr_storage>& destinations, const bool measuring, PacketPacer& pacer)
+		- family : address family of the server
+		- packet : the packet SendUdpPackets built, its measure header is rewritten per datagram
+		- packetSize : unsigned int, size of packet
+		- packetCount : unsigned int, number of times to send packet
+		- destinations : server port and its shards, taken round robin
+		- measuring : bool, stamp a measure header into every datagram
+		- pacer : PacketPacer, already started
+
+-- RETURNS: bool : false if Registered I/O couldnt be set up and nothing was sent
+--
+-- NOTES:
+-- Sends go from a socket of its own, made with WSA_FLAG_REGISTERED_IO, since the one from
+-- HostConnector wasnt. Each datagram is copied into a registered slot and the kernel is told about
+-- them RIO_UDP_SEND_BATCH at a time, so there is no syscall per datagram.
+-- Counts are taken when a send is queued, failed completions are taken off again after the flush.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Client::SendUdpRio(const int family, char* packet, const size_t packetSize, const size_t packetCount,
+	const std::vector<struct sockaddr_storage>& destinations, const bool measuring, PacketPacer& pacer)
+{
+	SOCKET rioSocket = OpenRioSocket(family);
+	if (rioSocket == INVALID_SOCKET)
+		return false;
+	RioUdpChannel channel;
+	if (!channel.Open(rioSocket, packetSize))
+	{
+		closesocket(rioSocket);
+		return false;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	size_t queued = 0;
+	for (size_t i = 0; i < packetCount && !cancelRequested; ++i)
+	{
+		pacer.Pace(packetSize);
+		if (measuring)
+		{
+			WriteMeasureHeader(packet, i, packetCount);
+		}
+		if (channel.Send(packet, packetSize, destinations[i % destinations.size()]))
+		{
+			++queued;
+			totalBytesSent += packetSize;
+			++totalPacketsSent;
+		}
+	}
+	channel.Flush();
+	totalPacketsSent -= channel.GetFailed();
+	totalBytesSent -= channel.GetFailed() * packetSize;
+	closesocket(rioSocket);
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	emit ClientPrintableStatusReady(QString("-Registered I/O: %1 datagrams in %2s, %3 pkt/s, %4 failed")
+		.arg(queued - channel.GetFailed())
+		.arg(seconds, 0, 'f', 3)
+		.arg((seconds > 0) ? (queued - channel.GetFailed()) / seconds : 0.0, 0, 'f', 0)
+		.arg(channel.GetFailed() + (packetCount - queued)));
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION BuildPacket
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: char* BuildPacket(const QString& filePath, const size_t packetSize, const TransferOptions& options)
+		- filePath : QString, file the packet is made from
+		- packetSize : unsigned int, size to make packets at
+		- options : TransferOptions, a payloadSource other than File makes it without the file
+
+-- RETURNS: char* : packetSize bytes from the start of the file, zero padded past its end, in the
+--                  session's arena. nullptr if there isnt memory for it
+--
+-- NOTES:
+-- Read in text mode like the per char loops this replaced, so the bytes are the same.
+-- A generated packet is filled by FillSyntheticPayload instead, the server can make the same one to verify against.
+----------------------------------------------------------------------------------------------------------------------*/
+char* Client::BuildPacket(const QString& filePath, const size_t packetSize, const TransferOptions& options)
+{
+	char* packet = arena.Allocate(packetSize);
+	if (packet == nullptr)
+		return nullptr;
+	if (options.payloadSource != PayloadSource::File)
+	{
+		TraceScope trace(TraceStage::Build, packetSize);
+		FillSyntheticPayload(packet, packetSize, options.payloadSource, options.payloadSeed);
+		trace.End();
+		emit ClientPrintableStatusReady(QString("-payload: %1, no file read").arg(PayloadSourceName(options.payloadSource, options.payloadSeed)));
+		return packet;
+	}
+	TraceScope trace(TraceStage::FileRead, packetSize);
+	std::ifstream packetDataFile(filePath.toStdString());
+	packetDataFile.read(packet, packetSize);
+	size_t bytesRead = (size_t)std::max<std::streamsize>(packetDataFile.gcount(), 0);
+	memset(packet + bytesRead, 0, packetSize - bytesRead);
+	return packet;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendTcpSealed
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendTcpSealed(SOCKET clientSocket, const char* packet, const size_t packetSize,
+	const size_t packetCount, const QString& sharedKey, PacketPacer& pacer)
+		- clientSocket : SOCKET, socket to the server, already connected
+		- packet : the packet from BuildPacket
+		- packetSize : unsigned int, its size
+		- packetCount : unsigned int, number of times to send it
+		- sharedKey : QString, the key entered on both ends, authenticates the handshake
+		- pacer : PacketPacer, target send rate, not started yet
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Swaps hellos and finished values with the server, then seals the packet again for every send,
+-- since each record needs its own nonce. Bytes sent count the record headers and tags, they cross
+-- the wire too.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendTcpSealed(SOCKET clientSocket, const char* packet, const size_t packetSize, const size_t packetCount,
+	const QString& sharedKey, PacketPacer& pacer)
+{
+	SecureChannel channel(true, sharedKey);
+	char hello[SECURE_HELLO_SIZE];
+	if (!channel.WriteHello(hello) || !SendAll(clientSocket, hello, SECURE_HELLO_SIZE, false)
+		|| !ReceiveAll(clientSocket, hello, SECURE_HELLO_SIZE) || !channel.ReadHello(hello))
+	{
+		emit ClientAlertableErrorOccured("Encrypted handshake failed, is the server set to encrypt too?");
+		return;
+	}
+	char finished[SECURE_FINISHED_SIZE];
+	channel.WriteFinished(finished);
+	if (!SendAll(clientSocket, finished, SECURE_FINISHED_SIZE, false) || !ReceiveAll(clientSocket, finished, SECURE_FINISHED_SIZE)
+		|| !channel.CheckFinished(finished))
+	{
+		emit ClientAlertableErrorOccured("Server couldnt prove it has the shared key, check both ends use the same one.");
+		return;
+	}
+	emit ClientPrintableStatusReady(QString("-encrypting with AES-256-GCM (%1)")
+		.arg(HasAesInstructions() ? "AES-NI" : "software AES"));
+
+	char* sealed = arena.Allocate(SecureChannel::SealedSize(packetSize));
+	if (sealed == nullptr)
+	{
+		emit ClientAlertableErrorOccured("PacketSize wayyy too big, not enough memory for it.");
+		return;
+	}
+	auto lastProgress = std::chrono::steady_clock::now();
+	pacer.Start();
+	for (size_t i = 0; i < packetCount && !cancelRequested; ++i)
+	{
+		TraceScope paceTrace(TraceStage::Pace, packetSize, pacer.IsPaced());
+		pacer.Pace(packetSize);
+		paceTrace.End();
+		size_t sealedLength = channel.Seal(packet, packetSize, sealed);
+		if (sealedLength == 0)
+		{
+			emit ClientAlertableErrorOccured("Encrypting a packet failed.");
+			break;
+		}
+		if (!SendAll(clientSocket, sealed, sealedLength))
+		{
+			emit ClientPrintableStatusReady(QString("-send failed, unexpected error code: %1").arg(WSAGetLastError()));
+			break;
+		}
+		ReportProgress(lastProgress);
+	}
+	emit ClientPrintableStatusReady(QString("-Finished sending all packets, %1 sent.").arg(totalPacketsSent));
+	PrintPacingSummary(pacer);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendTcpElided
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendTcpElided(SOCKET clientSocket, const char* packet, const size_t packetSize, const size_t packetCount,
+	PacketPacer& pacer)
+		- clientSocket : SOCKET, connected, the server has to be eliding too
+		- packet : the packet from BuildPacket
+		- packetSize : its size
+		- packetCount : number of times to send it
+		- pacer : PacketPacer, started here
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- The packet is the same every time, so its zero runs are found and it's encoded (see ZeroRuns.cpp)
+-- once up front; the loop sends that. Pacing counts what goes on the wire, not the packet size.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendTcpElided(SOCKET clientSocket, const char* packet, const size_t packetSize, const size_t packetCount, PacketPacer& pacer)
+{
+	std::vector<char> encoded = EncodeZeroRuns(packet, packetSize);
+	char header[ZERO_STREAM_HEADER_SIZE];
+	WriteZeroStreamHeader(header, (uint32_t)packetSize);
+	if (!SendAll(clientSocket, header, ZERO_STREAM_HEADER_SIZE, false))
+	{
+		emit ClientPrintableStatusReady(QString("-send failed, unexpected error code: %1").arg(WSAGetLastError()));
+		return;
+	}
+	emit ClientPrintableStatusReady(QString("-eliding zero runs: each %1B packet goes as %2B").arg(packetSize).arg(encoded.size()));
+
+	auto lastProgress = std::chrono::steady_clock::now();
+	pacer.Start();
+	for (size_t i = 0; i < packetCount && !cancelRequested; ++i)
+	{
+		TraceScope paceTrace(TraceStage::Pace, encoded.size(), pacer.IsPaced());
+		pacer.Pace(encoded.size());
+		paceTrace.End();
+		if (!SendAll(clientSocket, encoded.data(), encoded.size()))
+		{
+			emit ClientPrintableStatusReady(QString("-send failed, unexpected error code: %1").arg(WSAGetLastError()));
+			break;
+		}
+		ReportProgress(lastProgress);
+	}
+	emit ClientPrintableStatusReady(QString("-Finished sending all packets, %1 sent as %2 bytes on the wire instead of %3.")
+		.arg(totalPacketsSent).arg(totalBytesSent).arg(totalPacketsSent * packetSize));
+	PrintPacingSummary(pacer);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendPingPong
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendPingPong(SOCKET clientSocket, const bool tcp, const QString& filePath, const size_t packetSize,
+	const size_t packetCount, const struct sockaddr_storage& serverAddress, const TransferOptions& options)
+		- clientSocket : SOCKET, connected if TCP. Closed here
+		- tcp : bool, TCP or UDP
+		- filePath : QString, file the message is made from, like a single file packet
+		- packetSize : message size, at least PING_HEADER_SIZE
+		- packetCount : messages to send
+		- serverAddress : struct sockaddr_storage, where UDP messages go
+		- options : TransferOptions, busyPoll, the payload source and a target rate to space messages out
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Sends a message, waits for the server to echo it back, records the round trip, then sends the
+-- next; only one is ever in flight. TCP turns Nagle off so a small message goes out at once.
+-- A UDP message whose echo isnt back in PING_TIMEOUT_MS is counted lost and the next one goes.
+-- At the end the histogram's summary is printed and sent out with PingStatsReady.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendPingPong(SOCKET clientSocket, const bool tcp, const QString& filePath, const size_t packetSize, const size_t packetCount,
+	const struct sockaddr_storage& serverAddress, const TransferOptions& options)
+{
+	char* packet = BuildPacket(filePath, packetSize, options);
+	char* echo = arena.Allocate(packetSize);
+	if (packet == nullptr || echo == nullptr)
+	{
+		emit ClientAlertableErrorOccured("PacketSize wayyy too big, not enough memory for it.");
+		closesocket(clientSocket);
+		return;
+	}
+	if (tcp)
+	{
+		BOOL noDelay = TRUE;
+		setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+	}
+	int addressLength = (serverAddress.ss_family == AF_INET6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+	emit ClientPrintableStatusReady(QString("-ping-pong: %1 messages of %2B over %3, %4")
+		.arg(packetCount).arg(packetSize).arg(tcp ? "TCP" : "UDP").arg(options.busyPoll ? "busy polling" : "waiting in select"));
+
+	RttHistogram histogram;
+	uint64_t lost = 0;
+	uint64_t late = 0; //UDP echoes that came back after their message was counted lost
+	auto lastProgress = std::chrono::steady_clock::now();
+	PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+	pacer.Start();
+	for (size_t i = 0; i < packetCount && !cancelRequested; ++i)
+	{
+		pacer.Pace(packetSize);
+		WritePingHeader(packet, i);
+		uint64_t sentNs = MeasureClockNs();
+		bool sent = tcp ? SendAll(clientSocket, packet, packetSize)
+			: sendto(clientSocket, packet, (int)packetSize, 0, (const struct sockaddr*)&serverAddress, addressLength) == (int)packetSize;
+		if (!sent)
+		{
+			if (!tcp)
+				++sendErrors; //SendAll counted its own
+			emit ClientPrintableStatusReady(QString("-send failed, unexpected error code: %1").arg(WSAGetLastError()));
+			break;
+		}
+		if (!tcp)
+		{
+			totalBytesSent += packetSize;
+			++totalPacketsSent;
+		}
+		if (WaitForEcho(clientSocket, echo, packetSize, tcp, options.busyPoll, i, sentNs, late))
+		{
+			uint64_t roundTripNs = MeasureClockNs() - sentNs;
+			histogram.Record(roundTripNs);
+			rttTotalNs += roundTripNs;
+			++rttCount;
+		}
+		else if (tcp)
+		{
+			emit ClientPrintableStatusReady("-echo didnt come back, the connection closed or the server isnt echoing");
+			break;
+		}
+		else
+		{
+			++lost;
+			++pingsLost;
+		}
+		ReportProgress(lastProgress);
+	}
+	QString summary = histogram.Summary();
+	if (!tcp)
+		summary += QString(", %1 lost, %2 late").arg(lost).arg(late);
+	emit ClientPrintableStatusReady(QString("-%1").arg(summary));
+	emit PingStatsReady(summary, histogram.PercentileUs(0.5), histogram.PercentileUs(0.99), histogram.PercentileUs(0.999));
+	PrintPacingSummary(pacer);
 	closesocket(clientSocket);
-}
\ No newline at end of file
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WaitForEcho
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool WaitForEcho(SOCKET clientSocket, char* echo, const size_t packetSize, const bool tcp, const bool busyPoll,
+	const uint64_t sequence, const uint64_t sentNs, uint64_t& late)
+		- clientSocket : SOCKET, non blocking
+		- echo : packetSize bytes to read it into
+		- packetSize : message size
+		- tcp : bool, TCP reads exactly packetSize bytes, UDP one datagram at a time
+		- busyPoll : bool, spin on recv instead of waiting in select
+		- sequence : the message waited for
+		- sentNs : when it went out, for the UDP timeout
+		- late : UDP echoes of earlier messages are counted here and skipped
+
+-- RETURNS: bool : true once the echo of this message is in. False if the TCP connection ended,
+--                 or the UDP one timed out, or the session was cancelled
+--
+-- NOTES:
+-- Busy polling keeps a core at 100% but never waits on the scheduler to wake the thread.
+-- TCP has no timeout, the echo is on its way as long as the connection is up.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Client::WaitForEcho(SOCKET clientSocket, char* echo, const size_t packetSize, const bool tcp, const bool busyPoll,
+	const uint64_t sequence, const uint64_t sentNs, uint64_t& late)
+{
+	const uint64_t timeoutNs = (uint64_t)PING_TIMEOUT_MS * 1000000;
+	size_t received = 0;
+	while (!cancelRequested)
+	{
+		int bytesRead = recv(clientSocket, echo + received, (int)(tcp ? packetSize - received : packetSize), 0);
+		if (bytesRead == 0 && tcp)
+			return false;
+		if (bytesRead < 0)
+		{
+			int error = WSAGetLastError();
+			//a UDP echo longer than packetSize isnt one of ours
+			if (error != WSAEWOULDBLOCK && (tcp || error != WSAEMSGSIZE))
+				return false;
+			if (!tcp && MeasureClockNs() - sentNs > timeoutNs)
+				return false;
+			if (!busyPoll && error == WSAEWOULDBLOCK)
+				WaitForReadable(clientSocket, PING_POLL_US);
+			continue;
+		}
+		uint64_t echoed;
+		if (tcp)
+		{
+			received += bytesRead;
+			if (received < packetSize)
+				continue;
+			return ReadPingHeader(echo, packetSize, echoed) && echoed == sequence;
+		}
+		if (!ReadPingHeader(echo, bytesRead, echoed) || echoed > sequence)
+			continue;
+		if (echoed == sequence)
+			return true;
+		++late;
+	}
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReportProgress
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReportProgress(std::chrono::steady_clock::time_point& lastProgress)
+		- lastProgress : when progress was last printed, updated here
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- The single file loops used to print a line per packet, a QString and a queued signal each time.
+-- Now a line with the running count every SEND_PROGRESS_MS.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::ReportProgress(std::chrono::steady_clock::time_point& lastProgress)
+{
+	auto now = std::chrono::steady_clock::now();
+	if (now - lastProgress < std::chrono::milliseconds(SEND_PROGRESS_MS))
+		return;
+	emit ClientPrintableStatusReady(QString("-sent %1 packets.").arg(totalPacketsSent));
+	lastProgress = now;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PrintPacingSummary
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void PrintPacingSummary(const PacketPacer& pacer)
+		- pacer : PacketPacer, pacer used for the send loop that just finished
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Prints achieved send rate next to the target to console, so user can tell if the
+-- pacer (or the machine) kept up. The target is shown in the unit it was entered in,
+-- and that unit goes first in the achieved rate too.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::PrintPacingSummary(const PacketPacer& pacer)
+{
+	bool inPackets = pacer.GetTargetPacketRate() > 0;
+	QString kbRate = QString("%1 KB/s").arg(pacer.GetAchievedRate() / 1024, 0, 'f', 1);
+	QString packetRate = QString("%1 pkt/s").arg(pacer.GetAchievedPacketRate(), 0, 'f', 1);
+	QString achieved = inPackets ? packetRate + ", " + kbRate : kbRate + ", " + packetRate;
+	QString target("unlimited");
+	if (inPackets)
+	{
+		target = QString("%1 pkt/s").arg(pacer.GetTargetPacketRate(), 0, 'f', 0);
+	}
+	else if (pacer.IsPaced())
+	{
+		target = QString("%1 KB/s").arg(pacer.GetTargetRate() / 1024, 0, 'f', 1);
+	}
+	emit ClientPrintableStatusReady(QString("-Achieved rate: %1 (target: %2)").arg(achieved).arg(target));
+	if (pacer.IsPaced())
+	{
+		emit ClientPrintableStatusReady(QString("-Packets held back by pacer: %1").arg(pacer.GetTimesThrottled()));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendTcpBatch
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendTcpBatch(SOCKET clientSocket, const QString& sourcePath, const TransferOptions& options)
+		- clientSocket : SOCKET, socket to send files to, already connected
+		- sourcePath : QString, directory to send recursively, or a manifest listing one file per line
+		- options : TransferOptions, target send rate
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Sends every file as a header + content over the one connection (see BatchProtocol.cpp), so there is
+-- no connect/teardown per file. A reader thread fills a bounded ChunkQueue while this loop sends,
+-- so the next file is already being read off disk while the current one is on the wire.
+-- If options.packFrameSize is set, small files arrive from the reader already packed into frames,
+-- and each frame goes out as a single send.
+-- At the end prints how long each side sat waiting on the queue: the send loop waiting means the
+-- disk is the bottleneck, the reader waiting means the network is.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendTcpBatch(SOCKET clientSocket, const QString& sourcePath, const TransferOptions& options)
+{
+	QString rootDir;
+	QStringList relativeNames;
+	if (!CollectBatchFiles(sourcePath, rootDir, relativeNames))
+	{
+		closesocket(clientSocket);
+		return;
+	}
+	emit ClientPrintableStatusReady(QString("-Batch of %1 files queued.").arg(relativeNames.size()));
+
+	//keep roughly the same bytes read ahead no matter how big the pack frames are
+	size_t largestChunk = std::max<size_t>(options.packFrameSize, BATCH_CHUNK_SIZE);
+	ChunkQueue chunks(std::max<size_t>(2, (size_t)BATCH_QUEUE_DEPTH * BATCH_CHUNK_SIZE / largestChunk));
+	std::thread reader(&Client::ReadBatchFiles, this, rootDir, relativeNames, options.packFrameSize, std::ref(chunks));
+
+	PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+	pacer.ApplyKernelPacing(clientSocket);
+	pacer.Start();
+	int filesSent = 0;
+	int filesStarted = 0;
+	size_t bytesSent = 0;
+	bool sendFailed = false;
+	QString currentFile;
+	DataChunk chunk;
+	while (chunks.Pop(chunk))
+	{
+		//chunks that start files carry a name for status output, everything before them is fully sent
+		if (chunk.fileCount > 0)
+		{
+			filesSent = filesStarted;
+			filesStarted += chunk.fileCount;
+			currentFile = chunk.fileName;
+			emit ClientPrintableStatusReady(QString("-sending %1").arg(currentFile));
+		}
+		pacer.Pace(chunk.bytes.size());
+		if (!SendAll(clientSocket, chunk.bytes.data(), chunk.bytes.size()))
+		{
+			emit ClientPrintableStatusReady(QString("-send failed on %1, unexpected error code: %2").arg(currentFile).arg(WSAGetLastError()));
+			chunks.Cancel();
+			sendFailed = true;
+			break;
+		}
+		bytesSent += chunk.bytes.size();
+	}
+	reader.join();
+	emit ClientPrintableStatusReady(QString("-stalls: sender waited %1s on disk reads, reader waited %2s on the network")
+		.arg(chunks.GetPopWaitSeconds(), 0, 'f', 3)
+		.arg(chunks.GetPushWaitSeconds(), 0, 'f', 3));
+
+	if (!sendFailed && !chunks.IsCancelled())
+	{
+		filesSent = filesStarted;
+		std::vector<char> endMarker = EncodeBatchHeader(std::string(), 0);
+		SendAll(clientSocket, endMarker.data(), endMarker.size());
+	}
+	emit ClientPrintableStatusReady(QString("-Finished batch: %1 of %2 files, %3 bytes.")
+		.arg(filesSent).arg(relativeNames.size()).arg(bytesSent));
+	PrintPacingSummary(pacer);
+	closesocket(clientSocket);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION CollectBatchFiles
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool CollectBatchFiles(const QString& sourcePath, QString& rootDir, QStringList& relativeNames)
+		- sourcePath : QString, directory or manifest file picked on MainWindow
+		- rootDir : QString, set to the directory names are relative to
+		- relativeNames : QStringList, filled with the files to send, '/' separated
+
+-- RETURNS: bool : false if nothing can be sent
+--
+-- NOTES:
+-- Manifest lines are paths relative to the manifest's own directory, blank lines are skipped.
+-- Entries that point outside that directory are dropped since the server would refuse them anyway.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Client::CollectBatchFiles(const QString& sourcePath, QString& rootDir, QStringList& relativeNames)
+{
+	QFileInfo sourceInfo(sourcePath);
+	if (sourceInfo.isDir())
+	{
+		QDir root(sourcePath);
+		rootDir = root.absolutePath();
+		QDirIterator files(rootDir, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+		while (files.hasNext())
+		{
+			relativeNames.append(root.relativeFilePath(files.next()));
+		}
+		relativeNames.sort();
+	}
+	else
+	{
+		QFile manifest(sourcePath);
+		if (!manifest.open(QIODevice::ReadOnly | QIODevice::Text))
+		{
+			emit ClientAlertableErrorOccured(QString("Could not open manifest %1").arg(sourcePath));
+			return false;
+		}
+		QDir root = sourceInfo.absoluteDir();
+		rootDir = root.absolutePath();
+		QTextStream lines(&manifest);
+		while (!lines.atEnd())
+		{
+			QString line = lines.readLine().trimmed();
+			if (line.isEmpty())
+				continue;
+			QString relativeName = root.relativeFilePath(root.absoluteFilePath(line));
+			if (!IsSafeRelativePath(relativeName) || !QFileInfo(root.absoluteFilePath(relativeName)).isFile())
+			{
+				emit ClientPrintableStatusReady(QString("-skipping manifest entry %1").arg(line));
+				continue;
+			}
+			relativeNames.append(relativeName);
+		}
+	}
+	if (relativeNames.isEmpty())
+	{
+		emit ClientAlertableErrorOccured("Batch has no files to send.");
+		return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadBatchFiles
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReadBatchFiles(const QString& rootDir, const QStringList& relativeNames, const size_t packFrameSize,
+	ChunkQueue& chunks)
+		- rootDir : QString, directory names are relative to
+		- relativeNames : QStringList, files to read in order
+		- packFrameSize : unsigned int, largest packed frame to build, 0 to never pack
+		- chunks : ChunkQueue, where headers and content go for the send loop
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Runs on its own std::thread for the length of a batch. The header's size is taken at open, and
+-- exactly that many bytes follow (zero padded if the file shrank) so the stream never desyncs.
+-- Files whose utf8 name is longer than the header's name length can hold are skipped for the same reason.
+--
+-- Files no bigger than 1/PACK_FILE_DIVISOR of the frame size are appended to the frame being built
+-- instead of getting their own header; the frame is pushed once the next file wouldnt fit.
+-- Bigger files flush the current frame first so files still arrive in order.
+-- Files of more than one chunk are read through an AsyncFileReader, so the next blocks are already
+-- coming off disk while this one is queued. Its disk waits are added up and printed at the end.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::ReadBatchFiles(const QString& rootDir, const QStringList& relativeNames, const size_t packFrameSize, ChunkQueue& chunks)
+{
+	QDir root(rootDir);
+	std::vector<char> packIndex;
+	std::vector<char> packContent;
+	int packCount = 0;
+	size_t diskWaits = 0;
+	double diskWaitSeconds = 0;
+	size_t readAheadFiles = 0;
+	for (const QString& relativeName : relativeNames)
+	{
+		QFile file(root.absoluteFilePath(relativeName));
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			emit ClientPrintableStatusReady(QString("-could not open %1, skipping").arg(relativeName));
+			continue;
+		}
+		uint64_t remaining = file.size();
+		std::string utf8Name = relativeName.toUtf8().toStdString();
+		if (utf8Name.size() > BATCH_MAX_NAME_LENGTH)
+		{
+			//the header only has 16 bits for it, sending the rest anyway would desync the stream
+			emit ClientPrintableStatusReady(QString("-name of %1 is over %2 bytes, skipping").arg(relativeName).arg(BATCH_MAX_NAME_LENGTH));
+			continue;
+		}
+
+		if (packFrameSize > 0 && remaining <= packFrameSize / PACK_FILE_DIVISOR)
+		{
+			size_t entrySize = PACK_ENTRY_SIZE + utf8Name.size() + (size_t)remaining;
+			if (packCount == PACK_MAX_ENTRIES || packIndex.size() + packContent.size() + entrySize > packFrameSize)
+			{
+				if (!FlushPackFrame(packIndex, packContent, packCount, chunks))
+					return;
+			}
+			AppendPackEntry(packIndex, utf8Name, remaining);
+			size_t offset = packContent.size();
+			packContent.resize(offset + (size_t)remaining);
+			TraceScope trace(TraceStage::FileRead, (size_t)remaining);
+			qint64 bytesRead = file.read(packContent.data() + offset, (qint64)remaining);
+			if (bytesRead < (qint64)remaining)
+			{
+				std::fill(packContent.begin() + offset + std::max<qint64>(bytesRead, 0), packContent.end(), 0);
+			}
+			++packCount;
+			continue;
+		}
+
+		if (!FlushPackFrame(packIndex, packContent, packCount, chunks))
+			return;
+		DataChunk header;
+		header.bytes = EncodeBatchHeader(utf8Name, remaining);
+		header.fileName = relativeName;
+		header.fileCount = 1;
+		if (!chunks.Push(std::move(header)))
+			return;
+		std::unique_ptr<AsyncFileReader> readAhead;
+		if (remaining > BATCH_CHUNK_SIZE)
+		{
+			readAhead.reset(new AsyncFileReader(root.absoluteFilePath(relativeName)));
+			if (readAhead->Open())
+				++readAheadFiles;
+			else
+				readAhead.reset();
+		}
+		while (remaining > 0)
+		{
+			DataChunk content;
+			content.bytes.resize((size_t)std::min<uint64_t>(remaining, BATCH_CHUNK_SIZE));
+			TraceScope trace(TraceStage::FileRead, content.bytes.size());
+			qint64 bytesRead = readAhead ? readAhead->Read(content.bytes.data(), content.bytes.size())
+				: file.read(content.bytes.data(), content.bytes.size());
+			trace.End();
+			if (bytesRead < (qint64)content.bytes.size())
+			{
+				std::fill(content.bytes.begin() + std::max<qint64>(bytesRead, 0), content.bytes.end(), 0);
+			}
+			remaining -= content.bytes.size();
+			if (!chunks.Push(std::move(content)))
+				return;
+		}
+		if (readAhead)
+		{
+			diskWaits += readAhead->GetDiskWaits();
+			diskWaitSeconds += readAhead->GetDiskWaitSeconds();
+		}
+	}
+	if (!FlushPackFrame(packIndex, packContent, packCount, chunks))
+		return;
+	chunks.Finish();
+	if (readAheadFiles > 0)
+	{
+		emit ClientPrintableStatusReady(QString("-read-ahead: %1 files, %2 blocks waited on disk for %3s")
+			.arg(readAheadFiles).arg(diskWaits).arg(diskWaitSeconds, 0, 'f', 3));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION FlushPackFrame
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool FlushPackFrame(std::vector<char>& packIndex, std::vector<char>& packContent, int& packCount,
+	ChunkQueue& chunks)
+		- packIndex : index entries of the frame being built, cleared after
+		- packContent : content of the frame being built, cleared after
+		- packCount : number of files in the frame, reset to 0 after
+		- chunks : ChunkQueue, where the finished frame goes
+
+-- RETURNS: bool : false if the send loop cancelled
+--
+-- NOTES:
+-- Header, index and content are laid out in one buffer so the frame is a single send. Does nothing
+-- if the frame is empty.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Client::FlushPackFrame(std::vector<char>& packIndex, std::vector<char>& packContent, int& packCount, ChunkQueue& chunks)
+{
+	if (packCount == 0)
+		return true;
+	DataChunk frame;
+	frame.bytes = EncodePackHeader((uint16_t)packCount, packIndex.size() + packContent.size());
+	frame.bytes.reserve(frame.bytes.size() + packIndex.size() + packContent.size());
+	frame.bytes.insert(frame.bytes.end(), packIndex.begin(), packIndex.end());
+	frame.bytes.insert(frame.bytes.end(), packContent.begin(), packContent.end());
+	frame.fileName = QString("frame of %1 packed files").arg(packCount);
+	frame.fileCount = packCount;
+	packIndex.clear();
+	packContent.clear();
+	packCount = 0;
+	return chunks.Push(std::move(frame));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendAll
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SendAll(SOCKET clientSocket, const char* data, const size_t length, const bool counted)
+		- clientSocket : SOCKET, connected tcp socket
+		- data : bytes to send
+		- length : number of bytes to send
+		- counted : whether this is one of the transfer's packets. Handshakes and headers arent,
+		            their bytes still count but totalPacketsSent is left alone
+
+-- RETURNS: bool : false on a socket error, WSAGetLastError has the reason
+--
+-- NOTES:
+-- Loops over partial sends and waits on select when the send buffer is full, since a batch
+-- cant skip bytes the way the single file loop can skip a packet.
+-- Gives up once the session cancels, which ends batch, delta and dedup sends too.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Client::SendAll(SOCKET clientSocket, const char* data, const size_t length, const bool counted)
+{
+	TraceScope trace(TraceStage::Send, length);
+	size_t offset = 0;
+	while (offset < length)
+	{
+		if (cancelRequested)
+			return false;
+		int sendLength = (int)std::min<size_t>(length - offset, INT_MAX);
+		int bytesSent = send(clientSocket, data + offset, sendLength, 0);
+		if (bytesSent == SOCKET_ERROR)
+		{
+			if (WSAGetLastError() != WSAEWOULDBLOCK)
+			{
+				++sendErrors;
+				return false;
+			}
+			fd_set writeSet;
+			FD_ZERO(&writeSet);
+			FD_SET(clientSocket, &writeSet);
+			struct timeval timeout = { 1, 0 };
+			select(0, NULL, &writeSet, NULL, &timeout);
+			continue;
+		}
+		offset += bytesSent;
+		totalBytesSent += bytesSent;
+	}
+	if (counted)
+		++totalPacketsSent;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendTcpDelta
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendTcpDelta(SOCKET clientSocket, const QString& filePath, const TransferOptions& options)
+		- clientSocket : SOCKET, socket to the server, already connected
+		- filePath : QString, new version of the file
+		- options : TransferOptions, target send rate and block size
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Asks the server for block signatures of its copy, then rolls a block sized window over the
+-- (memory mapped) new file. Where a window matches a server block a copy op is sent, everything
+-- else goes as literal bytes (see DeltaSync.cpp). The tag bitmap check keeps the per byte cost
+-- in changed regions to a couple of adds and one L1 lookup.
+-- Prints bytes on the wire and matching cpu time next to what a full transfer would have sent.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendTcpDelta(SOCKET clientSocket, const QString& filePath, const TransferOptions& options)
+{
+	QFile newFile(filePath);
+	if (!newFile.open(QIODevice::ReadOnly))
+	{
+		emit ClientAlertableErrorOccured(QString("Can't open file at:\n") + filePath);
+		closesocket(clientSocket);
+		return;
+	}
+	uint64_t newSize = newFile.size();
+	const unsigned char* data = (newSize > 0) ? newFile.map(0, newSize) : nullptr;
+	if (newSize > 0 && data == nullptr)
+	{
+		emit ClientAlertableErrorOccured(QString("Can't map file at:\n") + filePath);
+		closesocket(clientSocket);
+		return;
+	}
+
+	//ask for signatures of the server's copy
+	size_t wireBytes = 0;
+	char request[DELTA_HEADER_SIZE];
+	WriteLittleEndian(request, DELTA_REQUEST_MAGIC, 4);
+	WriteLittleEndian(request + 4, options.deltaBlockSize, 4);
+	WriteLittleEndian(request + 8, newSize, 8);
+	uint32_t blockSize = 0;
+	SignatureIndex signatures;
+	if (!SendAll(clientSocket, request, DELTA_HEADER_SIZE) || !ReceiveSignatures(clientSocket, blockSize, signatures, wireBytes))
+	{
+		emit ClientPrintableStatusReady(QString("-delta: no signatures from server, error code: %1").arg(WSAGetLastError()));
+		if (data != nullptr)
+			newFile.unmap((uchar*)data);
+		closesocket(clientSocket);
+		return;
+	}
+	wireBytes += DELTA_HEADER_SIZE;
+	emit ClientPrintableStatusReady(QString("-got %1 signatures of %2 byte blocks").arg(signatures.GetBlockCount()).arg(blockSize));
+
+	double cpuStart = GetThreadCpuSeconds();
+	PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+	pacer.ApplyKernelPacing(clientSocket);
+	pacer.Start();
+	std::vector<char> ops;
+	ops.reserve(DELTA_MAX_LITERAL * 2);
+	bool sendFailed = false;
+	size_t literalBytes = 0;
+	size_t blocksReused = 0;
+	int64_t copyStart = -1;
+	uint32_t copyCount = 0;
+
+	auto flushOps = [&]() {
+		if (ops.empty() || sendFailed)
+			return;
+		pacer.Pace(ops.size());
+		if (!SendAll(clientSocket, ops.data(), ops.size()))
+			sendFailed = true;
+		wireBytes += ops.size();
+		ops.clear();
+	};
+	auto flushCopy = [&]() {
+		if (copyCount == 0)
+			return;
+		size_t offset = ops.size();
+		ops.resize(offset + DELTA_COPY_OP_SIZE);
+		ops[offset] = DELTA_OP_COPY;
+		WriteLittleEndian(&ops[offset + 1], copyStart, 8);
+		WriteLittleEndian(&ops[offset + 9], copyCount, 4);
+		copyCount = 0;
+		if (ops.size() >= DELTA_MAX_LITERAL)
+			flushOps();
+	};
+	auto addLiteral = [&](size_t start, const size_t end) {
+		flushCopy();
+		while (start < end)
+		{
+			size_t length = std::min<size_t>(end - start, DELTA_MAX_LITERAL);
+			size_t offset = ops.size();
+			ops.resize(offset + 5);
+			ops[offset] = DELTA_OP_LITERAL;
+			WriteLittleEndian(&ops[offset + 1], length, 4);
+			ops.insert(ops.end(), (const char*)data + start, (const char*)data + start + length);
+			literalBytes += length;
+			start += length;
+			if (ops.size() >= DELTA_MAX_LITERAL)
+				flushOps();
+		}
+	};
+	auto addCopy = [&](const int64_t block) {
+		if (copyCount > 0 && block == copyStart + copyCount && copyCount < UINT32_MAX)
+		{
+			++copyCount;
+		}
+		else
+		{
+			flushCopy();
+			copyStart = block;
+			copyCount = 1;
+		}
+		++blocksReused;
+	};
+
+	size_t pos = 0;
+	size_t literalStart = 0;
+	if (signatures.GetBlockCount() > 0 && newSize >= blockSize)
+	{
+		uint32_t a, b;
+		uint32_t weak = WeakChecksum(data, blockSize, a, b);
+		int64_t nextBlock = -1;
+		while (!sendFailed)
+		{
+			int64_t block = signatures.MightMatch(weak) ? signatures.Find(weak, data + pos, blockSize, nextBlock) : -1;
+			if (block >= 0)
+			{
+				addLiteral(literalStart, pos);
+				addCopy(block);
+				pos += blockSize;
+				literalStart = pos;
+				nextBlock = block + 1;
+				if (pos + blockSize > newSize)
+					break;
+				//window jumped a whole block, recompute instead of rolling
+				weak = WeakChecksum(data + pos, blockSize, a, b);
+				continue;
+			}
+			if (pos + blockSize >= newSize)
+				break;
+			//roll one byte: drop data[pos], take in data[pos + blockSize]
+			uint32_t outByte = data[pos];
+			a = a - outByte + data[pos + blockSize];
+			b = b - blockSize * outByte + a;
+			weak = (a & 0xFFFF) | (b << 16);
+			++pos;
+		}
+	}
+	addLiteral(literalStart, newSize);
+	flushCopy();
+
+	char endOp[DELTA_END_OP_SIZE];
+	endOp[0] = DELTA_OP_END;
+	WriteLittleEndian(endOp + 1, newSize, 8);
+	WriteLittleEndian(endOp + 9, StrongHash(data, newSize), 8);
+	ops.insert(ops.end(), endOp, endOp + DELTA_END_OP_SIZE);
+	flushOps();
+	double cpuSeconds = GetThreadCpuSeconds() - cpuStart;
+
+	if (sendFailed)
+	{
+		emit ClientPrintableStatusReady(QString("-delta send failed, unexpected error code: %1").arg(WSAGetLastError()));
+	}
+	else
+	{
+		emit ClientPrintableStatusReady(QString("-Finished delta: %1 blocks reused, %2 literal bytes.").arg(blocksReused).arg(literalBytes));
+		double saved = (newSize > 0) ? 100.0 - 100.0 * wireBytes / newSize : 0;
+		emit ClientPrintableStatusReady(QString("-Bytes on wire: %1 vs %2 for a full transfer (%3% saved)")
+			.arg(wireBytes).arg(newSize).arg(saved, 0, 'f', 1));
+		emit ClientPrintableStatusReady(QString("-Matching cpu: %1 ms (%2 MB/s of input)")
+			.arg(cpuSeconds * 1000, 0, 'f', 1).arg((cpuSeconds > 0) ? newSize / (1024.0 * 1024.0) / cpuSeconds : 0, 0, 'f', 1));
+	}
+	PrintPacingSummary(pacer);
+	if (data != nullptr)
+		newFile.unmap((uchar*)data);
+	newFile.close();
+	closesocket(clientSocket);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveSignatures
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReceiveSignatures(SOCKET clientSocket, uint32_t& blockSize, SignatureIndex& signatures,
+	size_t& wireBytes)
+		- clientSocket : SOCKET, connected to the server
+		- blockSize : set to the block size the server chose
+		- signatures : SignatureIndex, built from what the server sent
+		- wireBytes : bytes read are added to this
+
+-- RETURNS: bool : false if the reply is missing or malformed
+----------------------------------------------------------------------------------------------------------------------*/
+bool Client::ReceiveSignatures(SOCKET clientSocket, uint32_t& blockSize, SignatureIndex& signatures, size_t& wireBytes)
+{
+	char header[DELTA_HEADER_SIZE];
+	if (!ReceiveAll(clientSocket, header, DELTA_HEADER_SIZE) || ReadLittleEndian(header, 4) != DELTA_SIGNATURE_MAGIC)
+		return false;
+	blockSize = (uint32_t)ReadLittleEndian(header + 4, 4);
+	uint64_t blockCount = ReadLittleEndian(header + 8, 8);
+	if (blockSize < DELTA_MIN_BLOCK || blockSize > DELTA_MAX_BLOCK || blockCount > DELTA_MAX_BLOCKS)
+		return false;
+
+	std::vector<char> raw((size_t)blockCount * DELTA_SIGNATURE_SIZE);
+	if (!raw.empty() && !ReceiveAll(clientSocket, raw.data(), raw.size()))
+		return false;
+	wireBytes += DELTA_HEADER_SIZE + raw.size();
+
+	std::vector<BlockSignature> received((size_t)blockCount);
+	for (size_t i = 0; i < received.size(); i++)
+	{
+		const char* entry = raw.data() + i * DELTA_SIGNATURE_SIZE;
+		received[i].weak = (uint32_t)ReadLittleEndian(entry, 4);
+		received[i].strong = ReadLittleEndian(entry + 4, 8);
+		received[i].block = (uint32_t)i;
+	}
+	signatures.Build(std::move(received));
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveAll
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReceiveAll(SOCKET clientSocket, char* buffer, const size_t length)
+		- clientSocket : SOCKET, connected tcp socket
+		- buffer : where the bytes go
+		- length : number of bytes to read
+
+-- RETURNS: bool : false if the connection closed, errored, or the server went quiet too long
+--
+-- NOTES:
+-- Server hashes its whole copy before it can reply, so the wait is long (DELTA_REPLY_TIMEOUT_SEC).
+----------------------------------------------------------------------------------------------------------------------*/
+bool Client::ReceiveAll(SOCKET clientSocket, char* buffer, const size_t length)
+{
+	size_t offset = 0;
+	int secondsIdle = 0;
+	while (offset < length)
+	{
+		int recvLength = (int)std::min<size_t>(length - offset, INT_MAX);
+		int bytesRead = recv(clientSocket, buffer + offset, recvLength, 0);
+		if (bytesRead == 0)
+			return false;
+		if (bytesRead < 0)
+		{
+			if (WSAGetLastError() != WSAEWOULDBLOCK || secondsIdle >= DELTA_REPLY_TIMEOUT_SEC)
+				return false;
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(clientSocket, &readSet);
+			struct timeval timeout = { 1, 0 };
+			if (select(0, &readSet, NULL, NULL, &timeout) == 0)
+				++secondsIdle;
+			continue;
+		}
+		secondsIdle = 0;
+		offset += bytesRead;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetThreadCpuSeconds
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: double GetThreadCpuSeconds(void)
+--
+-- RETURNS: double : user + kernel time used by the calling thread so far
+----------------------------------------------------------------------------------------------------------------------*/
+double Client::GetThreadCpuSeconds()
+{
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+		return 0;
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+	//FILETIME counts 100ns ticks
+	return (kernel.QuadPart + user.QuadPart) / 1e7;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendTcpDedup
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SendTcpDedup(SOCKET clientSocket, const QString& filePath, const TransferOptions& options)
+		- clientSocket : SOCKET, socket to the server, already connected
+		- filePath : QString, file to send
+		- options : TransferOptions, target send rate
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Cuts the (memory mapped) file into content defined chunks and offers their SHA-256s, the server
+-- answers with a bitmap of the ones its chunk store doesnt have (see DedupStore.cpp) and only those
+-- are sent, in file order. Ends with the whole file's hash so the server can check what it put together.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::SendTcpDedup(SOCKET clientSocket, const QString& filePath, const TransferOptions& options)
+{
+	QFile sourceFile(filePath);
+	if (!sourceFile.open(QIODevice::ReadOnly))
+	{
+		emit ClientAlertableErrorOccured(QString("Can't open file at:\n") + filePath);
+		closesocket(clientSocket);
+		return;
+	}
+	uint64_t fileSize = sourceFile.size();
+	const unsigned char* data = (fileSize > 0) ? sourceFile.map(0, fileSize) : nullptr;
+	if (fileSize > 0 && data == nullptr)
+	{
+		emit ClientAlertableErrorOccured(QString("Can't map file at:\n") + filePath);
+		closesocket(clientSocket);
+		return;
+	}
+
+	//chunk boundaries depend on the bytes before them so finding them stays on this thread,
+	//kept as (offset, length) to send the missing ones after
+	double cpuStart = GetThreadCpuSeconds();
+	std::vector<std::pair<uint64_t, uint32_t>> chunks;
+	for (uint64_t offset = 0; offset < fileSize; )
+	{
+		uint32_t length = (uint32_t)NextChunkLength(data + offset, (size_t)std::min<uint64_t>(fileSize - offset, CDC_MAX_CHUNK));
+		chunks.push_back({ offset, length });
+		offset += length;
+	}
+	double cpuSeconds = GetThreadCpuSeconds() - cpuStart;
+
+	//hashing the chunks doesnt, so it goes to the scheduler. Task 0 is the whole file hash for the
+	//end marker, the longest job, started first so it overlaps the chunk hashes
+	auto hashStart = std::chrono::steady_clock::now();
+	std::vector<char> offer(DEDUP_HEADER_SIZE + chunks.size() * DEDUP_ENTRY_SIZE);
+	uint64_t fileHash = 0;
+	std::atomic<bool> hashFailed(false);
+	size_t hashTasks = (chunks.size() + DEDUP_HASH_TASK_CHUNKS - 1) / DEDUP_HASH_TASK_CHUNKS;
+	TaskScheduler::Shared().ParallelFor(hashTasks + 1, [&](size_t task) {
+		if (task == 0)
+		{
+			fileHash = StrongHash(data, fileSize);
+			return;
+		}
+		size_t last = std::min(chunks.size(), task * DEDUP_HASH_TASK_CHUNKS);
+		ChunkHash hash;
+		for (size_t i = (task - 1) * DEDUP_HASH_TASK_CHUNKS; i < last; i++)
+		{
+			char* entry = &offer[DEDUP_HEADER_SIZE + i * DEDUP_ENTRY_SIZE];
+			if (!HashChunk(data + chunks[i].first, chunks[i].second, hash))
+				hashFailed = true;
+			memcpy(entry, hash.data(), DEDUP_CHUNK_HASH_SIZE);
+			WriteLittleEndian(entry + DEDUP_CHUNK_HASH_SIZE, chunks[i].second, 4);
+		}
+	});
+	double hashSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - hashStart).count();
+	WriteLittleEndian(&offer[0], DEDUP_OFFER_MAGIC, 4);
+	WriteLittleEndian(&offer[4], chunks.size(), 4);
+	WriteLittleEndian(&offer[8], fileSize, 8);
+	if (hashFailed)
+	{
+		emit ClientPrintableStatusReady("-dedup: could not hash the chunks, nothing sent");
+		if (data != nullptr)
+			sourceFile.unmap((uchar*)data);
+		closesocket(clientSocket);
+		return;
+	}
+
+	size_t wireBytes = offer.size();
+	std::vector<char> missing(DEDUP_REPLY_HEADER_SIZE + (chunks.size() + 7) / 8);
+	if (chunks.size() > DEDUP_MAX_CHUNKS || !SendAll(clientSocket, offer.data(), offer.size())
+		|| !ReceiveAll(clientSocket, missing.data(), missing.size())
+		|| ReadLittleEndian(missing.data(), 4) != DEDUP_MISSING_MAGIC || ReadLittleEndian(missing.data() + 4, 4) != chunks.size())
+	{
+		emit ClientPrintableStatusReady(QString("-dedup: server didnt answer the chunk offer, error code: %1").arg(WSAGetLastError()));
+		if (data != nullptr)
+			sourceFile.unmap((uchar*)data);
+		closesocket(clientSocket);
+		return;
+	}
+	wireBytes += missing.size();
+	offer = std::vector<char>();
+
+	PacketPacer pacer(options.targetRate, 0, options.targetPacketRate);
+	pacer.ApplyKernelPacing(clientSocket);
+	pacer.Start();
+	std::vector<char> pending;
+	pending.reserve(BATCH_CHUNK_SIZE + CDC_MAX_CHUNK);
+	bool sendFailed = false;
+	size_t chunksSent = 0;
+	uint64_t bytesSent = 0;
+	auto flushPending = [&]() {
+		if (pending.empty() || sendFailed)
+			return;
+		pacer.Pace(pending.size());
+		sendFailed = !SendAll(clientSocket, pending.data(), pending.size());
+		wireBytes += pending.size();
+		pending.clear();
+	};
+	const unsigned char* bitmap = (const unsigned char*)missing.data() + DEDUP_REPLY_HEADER_SIZE;
+	for (size_t i = 0; i < chunks.size() && !sendFailed; i++)
+	{
+		if ((bitmap[i / 8] & (1 << (i % 8))) == 0)
+			continue;
+		pending.insert(pending.end(), (const char*)data + chunks[i].first, (const char*)data + chunks[i].first + chunks[i].second);
+		++chunksSent;
+		bytesSent += chunks[i].second;
+		if (pending.size() >= BATCH_CHUNK_SIZE)
+			flushPending();
+	}
+	char endMarker[DEDUP_END_SIZE];
+	WriteLittleEndian(endMarker, fileSize, 8);
+	WriteLittleEndian(endMarker + 8, fileHash, 8);
+	pending.insert(pending.end(), endMarker, endMarker + DEDUP_END_SIZE);
+	flushPending();
+
+	if (sendFailed)
+	{
+		emit ClientPrintableStatusReady(QString("-dedup send failed, unexpected error code: %1").arg(WSAGetLastError()));
+	}
+	else
+	{
+		emit ClientPrintableStatusReady(QString("-Finished dedup: sent %1 of %2 chunks (%3 of %4 bytes), rest were in the server's store.")
+			.arg(chunksSent).arg(chunks.size()).arg(bytesSent).arg(fileSize));
+		double saved = (fileSize > 0) ? 100.0 - 100.0 * wireBytes / fileSize : 0;
+		emit ClientPrintableStatusReady(QString("-Bytes on wire: %1 vs %2 for a full transfer (%3% saved)")
+			.arg(wireBytes).arg(fileSize).arg(saved, 0, 'f', 1));
+		emit ClientPrintableStatusReady(QString("-Chunking cpu: %1 ms (%2 MB/s of input), hashing: %3 ms on %4 workers")
+			.arg(cpuSeconds * 1000, 0, 'f', 1).arg((cpuSeconds > 0) ? fileSize / (1024.0 * 1024.0) / cpuSeconds : 0, 0, 'f', 1)
+			.arg(hashSeconds * 1000, 0, 'f', 1).arg(TaskScheduler::Shared().GetWorkerCount()));
+	}
+	PrintPacingSummary(pacer);
+	if (data != nullptr)
+		sourceFile.unmap((uchar*)data);
+	sourceFile.close();
+	closesocket(clientSocket);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Cancel
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Cancel(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called from the main thread by TransferSession::Stop. The send loop notices at its next packet
+-- (or next SendAll), closes the socket and returns as usual.
+----------------------------------------------------------------------------------------------------------------------*/
+void Client::Cancel()
+{
+	cancelRequested = true;
+}
+
+size_t Client::GetBytesSent() const
+{
+	return totalBytesSent;
+}
+
+size_t Client::GetPacketsSent() const
+{
+	return totalPacketsSent;
+}
+
+size_t Client::GetSendErrors() const
+{
+	return sendErrors;
+}
+
+size_t Client::GetRetransmits() const
+{
+	return retransmits;
+}
+
+//called from the main thread by TransferSession::SampleLive, loss and RTT only come from ping-pong
+void Client::ReadLiveTotals(LiveTotals& totals) const
+{
+	totals.bytes = totalBytesSent;
+	totals.packets = totalPacketsSent;
+	totals.rttCount = rttCount;
+	totals.rttTotalNs = rttTotalNs;
+	totals.lost = pingsLost;
+	totals.lossChecked = totals.rttCount + totals.lost;
+}
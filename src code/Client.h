@@ -3,21 +3,86 @@
 
 #include <QObject>
 #include <QThread>
+#include <QStringList>
 #include <iostream>
 #include <fstream>
+#include <atomic>
 #include <WinSock2.h>
+#include <ws2tcpip.h>
+#include "PacketPacer.h"
+#include "TransferOptions.h"
+#include "ChunkQueue.h"
+#include "AsyncFileReader.h"
+#include "BatchProtocol.h"
+#include "DeltaSync.h"
+#include "DedupStore.h"
+#include "TaskScheduler.h"
+#include "UdpMeasure.h"
+#include "SocketShards.h"
+#include "UdpOffload.h"
+#include "RioUdp.h"
+#include "BufferPool.h"
+#include "SecureChannel.h"
+#include "UdpFec.h"
+#include "UdpMulticast.h"
+#include "SyntheticPayload.h"
+#include "ZeroRuns.h"
+#include "PingPong.h"
+#include "FlightRecorder.h"
+#include "LiveSeries.h"
+
+#define SEND_PROGRESS_MS 500 //how often the single file loops print how many packets are out
 
 class Client : public QObject
 {
 	Q_OBJECT
 
 public:
+	Client();
 	virtual ~Client() = default;
-	void SendTcpPackets(SOCKET, const QString&, const size_t, const size_t);
-	void SendUdpPackets(SOCKET, const QString&, const size_t, const size_t, struct sockaddr_in);
+	void SendTcpPackets(SOCKET, const QString&, const size_t, const size_t, const TransferOptions&);
+	void SendUdpPackets(SOCKET, const QString&, const size_t, const size_t, struct sockaddr_storage, const TransferOptions&);
+	void SendTcpBatch(SOCKET, const QString&, const TransferOptions&);
+	void SendTcpDelta(SOCKET, const QString&, const TransferOptions&);
+	void SendTcpDedup(SOCKET, const QString&, const TransferOptions&);
+	void SendPingPong(SOCKET, const bool, const QString&, const size_t, const size_t, const struct sockaddr_storage&, const TransferOptions&);
+	void Cancel();
+	size_t GetBytesSent() const;
+	size_t GetPacketsSent() const;
+	size_t GetSendErrors() const;
+	size_t GetRetransmits() const;
+	void ReadLiveTotals(LiveTotals&) const;
 
 signals:
 	void ClientAlertableErrorOccured(const QString&);
 	void ClientPrintableStatusReady(const QString&);
+	void PingStatsReady(const QString&, const double, const double, const double);
+
+private:
+	std::atomic<bool> cancelRequested; //set from the main thread, send loops give up at the next packet
+	std::atomic<size_t> totalBytesSent; //read from the main thread for live throughput
+	std::atomic<size_t> totalPacketsSent;
+	std::atomic<size_t> sendErrors; //sends given up on, read from the main thread for the metrics endpoint
+	std::atomic<size_t> retransmits; //TCP single file sends tried again after WSAEWOULDBLOCK
+	std::atomic<uint64_t> rttTotalNs; //ping-pong round trips so far, for the live chart
+	std::atomic<uint64_t> rttCount;
+	std::atomic<uint64_t> pingsLost; //UDP ping-pong messages whose echo didnt come back in time
+	SessionArena arena; //the packet and its offload copies, back to the pool when the session's Client goes
 
+	void PrintPacingSummary(const PacketPacer&);
+	char* BuildPacket(const QString&, const size_t, const TransferOptions&);
+	void ReportProgress(std::chrono::steady_clock::time_point&);
+	void SendTcpSealed(SOCKET, const char*, const size_t, const size_t, const QString&, PacketPacer&);
+	void SendTcpElided(SOCKET, const char*, const size_t, const size_t, PacketPacer&);
+	bool WaitForEcho(SOCKET, char*, const size_t, const bool, const bool, const uint64_t, const uint64_t, uint64_t&);
+	void SendUdpFec(SOCKET, const char*, const size_t, const size_t, const struct sockaddr_storage&, const int, PacketPacer&);
+	void SendUdpMulticast(SOCKET, const char*, const size_t, const size_t, const struct sockaddr_storage&, PacketPacer&);
+	bool SendUdpRio(const int, char*, const size_t, const size_t, const std::vector<struct sockaddr_storage>&, const bool, PacketPacer&);
+	bool CollectBatchFiles(const QString&, QString&, QStringList&);
+	void ReadBatchFiles(const QString&, const QStringList&, const size_t, ChunkQueue&);
+	bool FlushPackFrame(std::vector<char>&, std::vector<char>&, int&, ChunkQueue&);
+	bool SendAll(SOCKET, const char*, const size_t, const bool = true);
+	bool ReceiveAll(SOCKET, char*, const size_t);
+	bool ReceiveSignatures(SOCKET, uint32_t&, SignatureIndex&, size_t&);
+	double GetThreadCpuSeconds();
 };
@@ -0,0 +1,430 @@
+#include "ConsoleLog.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ConsoleLog.cpp - The status console's lines, bounded, batched and filterable
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	int rowCount(const QModelIndex&) const;
+	QVariant data(const QModelIndex&, int) const;
+	void Append(const QString&, const ConsoleLevel);
+	void Flush();
+	void Clear();
+	void SetCapacity(const size_t);
+	size_t GetCapacity() const;
+	uint64_t GetDropped() const;
+	bool SaveToFile(const QString&);
+	void FollowIn(QListView*);
+	ConsoleLevel ClassifyStatus(const QString&);
+	const ConsoleLine& LineAt(const size_t) const;
+	void SetMinimumLevel(const ConsoleLevel);
+	bool filterAcceptsRow(int, const QModelIndex&) const;
+	int RunConsoleStress(const size_t);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- The console used to be a QPlainTextEdit that every status got inserted into. A long run with a
+-- status per packet grew it without bound, and every insert got slower than the last until the
+-- window stopped answering.
+--
+-- Now the lines are kept here, the newest GetCapacity of them in a ring, and shown in a QListView
+-- that only ever lays out the rows on screen. Append doesnt touch the view at all, lines wait in
+-- pending until the flush timer goes off and then go in as one insert, so a burst of thousands of
+-- statuses costs the view one update. If more than the capacity comes in between two flushes, the
+-- oldest are dropped before the view ever sees them, they would have been pushed out anyway.
+--
+-- ConsoleFilter sits between this and the view to show only warnings or errors.
+--
+-- Started with --console-stress, no window is shown. RunConsoleStress pumps messages through a
+-- ConsoleLog into a shown QListView and fails if memory keeps growing or the event loop stalls.
+----------------------------------------------------------------------------------------------------------------------*/
+
+ConsoleLog::ConsoleLog(QObject* parent)
+	: QAbstractListModel(parent)
+	, first(0)
+	, count(0)
+	, capacity(CONSOLE_DEFAULT_CAP)
+	, dropped(0)
+	, flushTimer(new QTimer(this))
+	, followTail(true)
+{
+	flushTimer->setSingleShot(true);
+	flushTimer->setInterval(CONSOLE_FLUSH_MS);
+	connect(flushTimer, &QTimer::timeout, this, &ConsoleLog::Flush);
+}
+
+int ConsoleLog::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : (int)count;
+}
+
+QVariant ConsoleLog::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= (int)count)
+		return QVariant();
+	const ConsoleLine& line = LineAt(index.row());
+	switch (role)
+	{
+	case Qt::DisplayRole:
+		return line.text;
+	case Qt::ForegroundRole:
+		if (line.level == ConsoleLevel::Error)
+			return QColor(200, 0, 0);
+		if (line.level == ConsoleLevel::Warning)
+			return QColor(170, 110, 0);
+		return QVariant();
+	case CONSOLE_LEVEL_ROLE:
+		return (int)line.level;
+	}
+	return QVariant();
+}
+
+//the line on row, row 0 being the oldest kept
+const ConsoleLine& ConsoleLog::LineAt(const size_t row) const
+{
+	return ring[(first + row) % ring.size()];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Append
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Append(const QString& text, const ConsoleLevel level)
+			- text : the status line, without a newline
+			- level : how it is colored and filtered
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Main thread only, statuses from the sessions come in through queued signals already.
+-- The line shows up within CONSOLE_FLUSH_MS.
+----------------------------------------------------------------------------------------------------------------------*/
+void ConsoleLog::Append(const QString& text, const ConsoleLevel level)
+{
+	pending.push_back({ text, level });
+	if (pending.size() > capacity)
+	{
+		pending.pop_front();
+		++dropped;
+	}
+	if (!flushTimer->isActive())
+		flushTimer->start();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Flush
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Flush(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Hands every pending line to the view: one remove for the oldest rows that no longer fit, one
+-- insert for the new ones. Called by the flush timer, or directly before the lines are needed.
+--
+-- Until the ring first fills it only grows, so row 0 is always slot 0 then. The one time rows are
+-- removed before that, the survivors are moved down to slot 0, after that it never moves a line.
+----------------------------------------------------------------------------------------------------------------------*/
+void ConsoleLog::Flush()
+{
+	flushTimer->stop();
+	if (pending.empty())
+		return;
+	size_t overflow = (count + pending.size() > capacity) ? count + pending.size() - capacity : 0;
+	if (overflow > 0)
+	{
+		beginRemoveRows(QModelIndex(), 0, (int)overflow - 1);
+		if (ring.size() < capacity)
+			ring.erase(ring.begin(), ring.begin() + overflow);
+		else
+			first = (first + overflow) % capacity;
+		count -= overflow;
+		dropped += overflow;
+		endRemoveRows();
+	}
+	beginInsertRows(QModelIndex(), (int)count, (int)(count + pending.size()) - 1);
+	for (ConsoleLine& line : pending)
+	{
+		if (ring.size() < capacity)
+			ring.push_back(std::move(line));
+		else
+			ring[(first + count) % capacity] = std::move(line);
+		++count;
+	}
+	pending.clear();
+	endInsertRows();
+	emit LinesAdded();
+}
+
+//empties the console, called before every new transfer
+void ConsoleLog::Clear()
+{
+	flushTimer->stop();
+	beginResetModel();
+	ring.clear();
+	pending.clear();
+	first = 0;
+	count = 0;
+	dropped = 0;
+	endResetModel();
+	followTail = true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SetCapacity
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SetCapacity(const size_t lines)
+			- lines : how many lines to keep, held between CONSOLE_MIN_CAP and CONSOLE_MAX_CAP
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Keeps the newest lines that still fit. The view is reset since every row may have moved.
+----------------------------------------------------------------------------------------------------------------------*/
+void ConsoleLog::SetCapacity(const size_t lines)
+{
+	size_t newCapacity = std::max<size_t>(CONSOLE_MIN_CAP, std::min<size_t>(CONSOLE_MAX_CAP, lines));
+	if (newCapacity == capacity)
+		return;
+	Flush();
+	beginResetModel();
+	size_t kept = std::min(count, newCapacity);
+	std::vector<ConsoleLine> resized;
+	resized.reserve(kept);
+	for (size_t row = count - kept; row < count; row++)
+	{
+		resized.push_back(std::move(ring[(first + row) % ring.size()]));
+	}
+	dropped += count - kept;
+	ring.swap(resized);
+	ring.shrink_to_fit();
+	first = 0;
+	count = kept;
+	capacity = newCapacity;
+	endResetModel();
+}
+
+size_t ConsoleLog::GetCapacity() const
+{
+	return capacity;
+}
+
+uint64_t ConsoleLog::GetDropped() const
+{
+	return dropped;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SaveToFile
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SaveToFile(const QString& path)
+			- path : text file to write, replaced if it exists
+--
+-- RETURNS: bool : false if the file couldnt be written
+--
+-- NOTES:
+-- Writes every kept line whatever the filter shows, oldest first, with a first line saying how many
+-- older ones were dropped if any were.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ConsoleLog::SaveToFile(const QString& path)
+{
+	Flush();
+	QFile logFile(path);
+	if (!logFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return false;
+	QTextStream out(&logFile);
+	if (dropped > 0)
+		out << QString("-(%1 older lines were dropped, the console keeps %2)\n").arg(dropped).arg(capacity);
+	for (size_t row = 0; row < count; row++)
+	{
+		out << LineAt(row).text << "\n";
+	}
+	out.flush();
+	return logFile.error() == QFile::NoError;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION FollowIn
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void FollowIn(QListView* view)
+			- view : list showing this model, directly or through a ConsoleFilter
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Sets the view up for lots of one line rows, and keeps it scrolled to the newest line unless the
+-- user scrolled up to read something, until they scroll back to the bottom.
+----------------------------------------------------------------------------------------------------------------------*/
+void ConsoleLog::FollowIn(QListView* view)
+{
+	view->setUniformItemSizes(true);
+	connect(view->verticalScrollBar(), &QScrollBar::valueChanged, this, [this, view](int value) {
+		followTail = (value >= view->verticalScrollBar()->maximum());
+	});
+	connect(this, &ConsoleLog::LinesAdded, view, [this, view]() {
+		if (followTail)
+			view->scrollToBottom();
+	});
+}
+
+//Error for statuses about something that failed, Warning for fallbacks and skips, Info otherwise
+ConsoleLevel ConsoleLog::ClassifyStatus(const QString& status)
+{
+	static const char* errorWords[] = { "failed,", "failed on", "error code", "could not", "rejected", "corrupt",
+		"dropping", "not enough memory", "receive stopped", "didnt" };
+	static const char* warningWords[] = { "retransmit", "not available", "skipping", "warning", "only " };
+	for (const char* word : errorWords)
+	{
+		if (status.contains(word, Qt::CaseInsensitive))
+			return ConsoleLevel::Error;
+	}
+	for (const char* word : warningWords)
+	{
+		if (status.contains(word, Qt::CaseInsensitive))
+			return ConsoleLevel::Warning;
+	}
+	return ConsoleLevel::Info;
+}
+
+ConsoleFilter::ConsoleFilter(QObject* parent)
+	: QSortFilterProxyModel(parent)
+	, minimumLevel(ConsoleLevel::Info)
+{
+}
+
+void ConsoleFilter::SetMinimumLevel(const ConsoleLevel level)
+{
+	minimumLevel = level;
+	invalidateFilter();
+}
+
+bool ConsoleFilter::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+	if (minimumLevel == ConsoleLevel::Info)
+		return true;
+	return sourceModel()->index(sourceRow, 0, sourceParent).data(CONSOLE_LEVEL_ROLE).toInt() >= (int)minimumLevel;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RunConsoleStress
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int RunConsoleStress(const size_t messageCount)
+			- messageCount : statuses to pump through, CONSOLE_STRESS_DEFAULT_COUNT from main
+--
+-- RETURNS: int : 0 if memory stayed flat and the event loop kept turning, 1 if not, for scripts
+--
+-- NOTES:
+-- Started from main with --console-stress [count]. Sets up a ConsoleLog, ConsoleFilter and a shown
+-- QListView the way MainWindow does, then appends messageCount statuses (every 100th a warning,
+-- every 1000th an error), letting the event loop run every CONSOLE_STRESS_EVENTS_EVERY of them.
+--
+-- A CONSOLE_STRESS_HEARTBEAT_MS timer measures the longest the event loop went without turning,
+-- which is how long a click would have waited. The working set is read once the console is full
+-- and again at the end; with the cap holding it shouldnt grow by more than noise.
+----------------------------------------------------------------------------------------------------------------------*/
+int RunConsoleStress(const size_t messageCount)
+{
+	typedef std::chrono::steady_clock Clock;
+	auto workingSet = []() -> size_t {
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+		return counters.WorkingSetSize;
+	};
+
+	QListView view;
+	ConsoleLog log(&view);
+	ConsoleFilter filter(&view);
+	filter.setSourceModel(&log);
+	view.setModel(&filter);
+	log.FollowIn(&view);
+	view.resize(480, 320);
+	view.show();
+
+	Clock::time_point lastBeat = Clock::now();
+	double longestStallMs = 0;
+	QTimer heartbeat;
+	QObject::connect(&heartbeat, &QTimer::timeout, [&]() {
+		Clock::time_point now = Clock::now();
+		longestStallMs = std::max(longestStallMs, std::chrono::duration<double, std::milli>(now - lastBeat).count());
+		lastBeat = now;
+	});
+	heartbeat.start(CONSOLE_STRESS_HEARTBEAT_MS);
+
+	size_t warmUp = std::min<size_t>(messageCount / 10, (size_t)CONSOLE_DEFAULT_CAP * 10);
+	size_t baselineBytes = 0;
+	Clock::time_point started = Clock::now();
+	for (size_t sent = 0; sent < messageCount; sent++)
+	{
+		ConsoleLevel level = (sent % 1000 == 0) ? ConsoleLevel::Error : (sent % 100 == 0) ? ConsoleLevel::Warning : ConsoleLevel::Info;
+		log.Append(QString("-sent packet %1").arg((qulonglong)sent), level);
+		if (sent % CONSOLE_STRESS_EVENTS_EVERY == 0)
+			QApplication::processEvents();
+		if (sent == warmUp)
+		{
+			log.Flush();
+			QApplication::processEvents();
+			baselineBytes = workingSet();
+			longestStallMs = 0;
+			lastBeat = Clock::now();
+		}
+	}
+	log.Flush();
+	QApplication::processEvents();
+	double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+	size_t finalBytes = workingSet();
+	double growthMb = (finalBytes > baselineBytes) ? (finalBytes - baselineBytes) / 1048576.0 : 0;
+
+	std::cout << "console stress: " << messageCount << " messages in " << seconds << "s ("
+		<< (seconds > 0 ? messageCount / seconds : 0) << " msg/s)" << std::endl;
+	std::cout << "  rows kept " << log.rowCount() << " of cap " << log.GetCapacity() << ", dropped " << log.GetDropped() << std::endl;
+	std::cout << "  working set " << baselineBytes / 1048576.0 << " MB after warm-up, " << finalBytes / 1048576.0
+		<< " MB at the end (+" << growthMb << " MB, limit " << CONSOLE_STRESS_MAX_GROWTH_MB << ")" << std::endl;
+	std::cout << "  longest event loop stall " << longestStallMs << " ms (limit " << CONSOLE_STRESS_MAX_STALL_MS << ")" << std::endl;
+
+	bool bounded = (log.rowCount() <= (int)log.GetCapacity() && growthMb <= CONSOLE_STRESS_MAX_GROWTH_MB);
+	bool responsive = (longestStallMs <= CONSOLE_STRESS_MAX_STALL_MS);
+	std::cout << (bounded && responsive ? "PASS" : "FAIL") << std::endl;
+	return (bounded && responsive) ? 0 : 1;
+}
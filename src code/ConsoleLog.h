@@ -0,0 +1,100 @@
+#pragma once
+#pragma comment(lib, "psapi.lib")
+
+#include <Windows.h>
+#include <Psapi.h>
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QApplication>
+#include <QListView>
+#include <QScrollBar>
+#include <QTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QColor>
+#include <QString>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#define CONSOLE_DEFAULT_CAP 10000 //lines kept before the oldest go
+#define CONSOLE_MIN_CAP 100
+#define CONSOLE_MAX_CAP 1000000
+#define CONSOLE_FLUSH_MS 50 //lines wait this long at most before the view gets them, in one batch
+#define CONSOLE_LEVEL_ROLE (Qt::UserRole + 1)
+#define CONSOLE_STRESS_DEFAULT_COUNT 10000000
+#define CONSOLE_STRESS_EVENTS_EVERY 10000 //messages pumped between two turns of the event loop, like a busy session
+#define CONSOLE_STRESS_HEARTBEAT_MS 10
+#define CONSOLE_STRESS_MAX_GROWTH_MB 64 //--console-stress fails if the working set grows more than this once the log is full
+#define CONSOLE_STRESS_MAX_STALL_MS 250 //or if the event loop was held up longer than this
+
+enum class ConsoleLevel
+{
+	Info,
+	Warning,
+	Error
+};
+
+struct ConsoleLine
+{
+	QString text;
+	ConsoleLevel level;
+};
+
+//status console lines, the newest capacity of them in a ring, handed to the view in batches
+class ConsoleLog : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	ConsoleLog(QObject*);
+	virtual ~ConsoleLog() = default;
+	int rowCount(const QModelIndex& = QModelIndex()) const override;
+	QVariant data(const QModelIndex&, int) const override;
+	void Append(const QString&, const ConsoleLevel);
+	void Flush();
+	void Clear();
+	void SetCapacity(const size_t);
+	size_t GetCapacity() const;
+	uint64_t GetDropped() const;
+	bool SaveToFile(const QString&);
+	void FollowIn(QListView*);
+	static ConsoleLevel ClassifyStatus(const QString&);
+
+signals:
+	void LinesAdded();
+
+private:
+	const ConsoleLine& LineAt(const size_t) const;
+
+	std::vector<ConsoleLine> ring; //grows up to capacity, then the oldest slot is reused
+	size_t first; //slot of row 0
+	size_t count;
+	size_t capacity;
+	std::deque<ConsoleLine> pending; //appended since the last flush, never more than capacity
+	uint64_t dropped; //lines pushed out by newer ones, since the last Clear
+	QTimer* flushTimer; //single shot, started by the first Append after a flush
+	bool followTail; //the view was scrolled to the bottom, keep it there as lines come in
+};
+
+//hides lines below the level picked on MainWindow
+class ConsoleFilter : public QSortFilterProxyModel
+{
+	Q_OBJECT
+
+public:
+	ConsoleFilter(QObject*);
+	virtual ~ConsoleFilter() = default;
+	void SetMinimumLevel(const ConsoleLevel);
+
+protected:
+	bool filterAcceptsRow(int, const QModelIndex&) const override;
+
+private:
+	ConsoleLevel minimumLevel;
+};
+
+int RunConsoleStress(const size_t);
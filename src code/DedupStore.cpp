@@ -0,0 +1,458 @@
+#include "DedupStore.h"
+#include "BatchProtocol.h"
+#include <QFileInfo>
+#include <WinSock2.h>
+#include <Windows.h>
+#include <bcrypt.h>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: DedupStore.cpp - Content defined chunking and the receiver's chunk store
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	size_t NextChunkLength(const unsigned char*, const size_t);
+	bool HashChunk(const unsigned char*, const size_t, ChunkHash&);
+	bool ChunkStore::Open();
+	bool ChunkStore::Contains(const ChunkHash&, const uint32_t) const;
+	bool ChunkStore::Read(const ChunkHash&, const uint32_t, char*);
+	bool ChunkStore::Write(const ChunkHash&, const char*, const uint32_t);
+	bool ChunkStore::Save(const uint64_t, const uint64_t);
+	bool ChunkStore::Append(const ChunkHash&, const char*, const uint32_t);
+	QFile* ChunkStore::GetSegment(const uint32_t);
+	void ChunkStore::EvictOldSegments();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Files are cut into chunks with FastCDC: a gear hash rolls over the bytes and a chunk ends wherever
+-- its low bits hit zero, so an insert only changes the chunks around it instead of shifting every
+-- block after it like fixed size blocks would. Chunks are 2KB min, 8KB on average, 64KB max.
+-- Before 8KB a stricter mask is used and after it a looser one (normalized chunking), which keeps
+-- most chunks close to the average.
+--
+-- The server keeps every chunk it has received in 64MB append only segment files under
+-- .asn2_chunks next to the output file, keyed by the chunk's SHA-256 and length. index.bin lists
+-- them and is rewritten after every session. The hash has to be one nobody can find a collision for:
+-- a chunk stored for one client is handed to whichever later client offers the same hash. When the store is over its size the oldest segment is
+-- dropped whole; a chunk that gets used again while it sits in the oldest segment is copied forward
+-- first, so chunks that keep coming back survive.
+----------------------------------------------------------------------------------------------------------------------*/
+
+namespace
+{
+	//FastCDC paper's masks for an 8KB average: 15 bits before the average, 11 after
+	const uint64_t CDC_MASK_SMALL = 0x0000d9f003530000ULL;
+	const uint64_t CDC_MASK_LARGE = 0x0000d90003530000ULL;
+
+	//random table for the gear hash, both ends have to make the same one so its from a fixed seed
+	std::array<uint64_t, 256> MakeGearTable()
+	{
+		std::array<uint64_t, 256> table;
+		uint64_t state = 0x41534E3243444300ULL;
+		for (uint64_t& entry : table)
+		{
+			//splitmix64
+			state += 0x9E3779B97F4A7C15ULL;
+			uint64_t z = state;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			entry = z ^ (z >> 31);
+		}
+		return table;
+	}
+
+	const std::array<uint64_t, 256> gearTable = MakeGearTable();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION NextChunkLength
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: size_t NextChunkLength(const unsigned char* data, const size_t length)
+		- data : where the next chunk starts
+		- length : bytes left in the file
+
+-- RETURNS: size_t : length of the chunk starting at data
+--
+-- NOTES:
+-- The first CDC_MIN_CHUNK bytes are skipped without hashing, a cut there would only make a tiny chunk.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t NextChunkLength(const unsigned char* data, const size_t length)
+{
+	if (length <= CDC_MIN_CHUNK)
+		return length;
+	size_t normalEnd = std::min<size_t>(length, CDC_AVG_CHUNK);
+	size_t maxEnd = std::min<size_t>(length, CDC_MAX_CHUNK);
+	uint64_t fingerprint = 0;
+	size_t i = CDC_MIN_CHUNK;
+	for (; i < normalEnd; i++)
+	{
+		fingerprint = (fingerprint << 1) + gearTable[data[i]];
+		if ((fingerprint & CDC_MASK_SMALL) == 0)
+			return i + 1;
+	}
+	for (; i < maxEnd; i++)
+	{
+		fingerprint = (fingerprint << 1) + gearTable[data[i]];
+		if ((fingerprint & CDC_MASK_LARGE) == 0)
+			return i + 1;
+	}
+	return maxEnd;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION HashChunk
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool HashChunk(const unsigned char* data, const size_t length, ChunkHash& hash)
+		- data : the chunk
+		- length : bytes in the chunk
+		- hash : set to the chunk's SHA-256
+
+-- RETURNS: bool : false if CNG couldnt hash it
+--
+-- NOTES:
+-- The SHA-256 provider is opened on first use and kept for the life of the process. Its safe to
+-- hash on from several threads at once, the client hashes its chunks on the scheduler.
+----------------------------------------------------------------------------------------------------------------------*/
+bool HashChunk(const unsigned char* data, const size_t length, ChunkHash& hash)
+{
+	static BCRYPT_ALG_HANDLE sha256 = []() {
+		BCRYPT_ALG_HANDLE opened = nullptr;
+		return (BCryptOpenAlgorithmProvider(&opened, BCRYPT_SHA256_ALGORITHM, nullptr, 0) == 0) ? opened : nullptr;
+	}();
+	return sha256 != nullptr
+		&& BCryptHash(sha256, nullptr, 0, (PUCHAR)data, (ULONG)length, hash.data(), DEDUP_CHUNK_HASH_SIZE) == 0;
+}
+
+ChunkStore::ChunkStore(const QString& storePath, const uint64_t maxStoreBytes)
+	: storeDir(storePath)
+	, maxBytes(maxStoreBytes)
+	, opened(false)
+	, logicalBytes(0)
+	, receivedBytes(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(void)
+--
+-- RETURNS: bool : false if the store folder cant be made
+--
+-- NOTES:
+-- Loads index.bin. If its missing or doesnt parse the store starts over empty, its only a cache.
+-- Entries pointing past the end of their segment (segment lost or cut short) are dropped.
+-- Segments can hold chunks the index doesnt know about if a session died before Save, new chunks
+-- are just appended after them.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ChunkStore::Open()
+{
+	index.clear();
+	segmentBytes.clear();
+	openSegments.clear();
+	opened = storeDir.mkpath(".");
+	if (!opened)
+		return false;
+
+	QFile indexFile(storeDir.filePath("index.bin"));
+	QByteArray contents;
+	if (indexFile.open(QIODevice::ReadOnly))
+	{
+		contents = indexFile.readAll();
+		indexFile.close();
+	}
+	const char* data = contents.constData();
+	bool valid = (size_t)contents.size() >= DEDUP_INDEX_HEADER_SIZE && ReadLittleEndian(data, 4) == DEDUP_INDEX_MAGIC;
+	uint64_t entryCount = valid ? ReadLittleEndian(data + 12, 8) : 0;
+	if (!valid || ((size_t)contents.size() - DEDUP_INDEX_HEADER_SIZE) / DEDUP_INDEX_ENTRY_SIZE < entryCount)
+	{
+		//start over, old segments are unreachable without the index
+		for (const QString& name : storeDir.entryList(QStringList() << "seg_*.dat", QDir::Files))
+			storeDir.remove(name);
+		return true;
+	}
+
+	uint32_t firstSegment = (uint32_t)ReadLittleEndian(data + 4, 4);
+	uint32_t currentSegment = (uint32_t)ReadLittleEndian(data + 8, 4);
+	logicalBytes = ReadLittleEndian(data + 20, 8);
+	receivedBytes = ReadLittleEndian(data + 28, 8);
+	for (uint32_t segment = firstSegment; segment <= currentSegment && segment - firstSegment < 1024; segment++)
+	{
+		QFileInfo segmentInfo(SegmentPath(segment));
+		if (segmentInfo.exists())
+			segmentBytes[segment] = segmentInfo.size();
+	}
+	index.reserve((size_t)entryCount);
+	for (uint64_t i = 0; i < entryCount; i++)
+	{
+		const char* entry = data + DEDUP_INDEX_HEADER_SIZE + i * DEDUP_INDEX_ENTRY_SIZE;
+		StoredChunk chunk;
+		ChunkHash hash;
+		memcpy(hash.data(), entry, DEDUP_CHUNK_HASH_SIZE);
+		chunk.length = (uint32_t)ReadLittleEndian(entry + DEDUP_CHUNK_HASH_SIZE, 4);
+		chunk.segment = (uint32_t)ReadLittleEndian(entry + DEDUP_CHUNK_HASH_SIZE + 4, 4);
+		chunk.offset = ReadLittleEndian(entry + DEDUP_CHUNK_HASH_SIZE + 8, 8);
+		auto segment = segmentBytes.find(chunk.segment);
+		if (segment != segmentBytes.end() && chunk.length <= CDC_MAX_CHUNK && chunk.offset + chunk.length <= segment->second)
+			index[hash] = chunk;
+	}
+	return true;
+}
+
+bool ChunkStore::IsOpen() const
+{
+	return opened;
+}
+
+bool ChunkStore::Contains(const ChunkHash& hash, const uint32_t length) const
+{
+	auto found = index.find(hash);
+	return found != index.end() && found->second.length == length;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Read
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Read(const ChunkHash& hash, const uint32_t length, char* buffer)
+		- hash : SHA-256 of the chunk
+		- length : bytes in the chunk
+		- buffer : at least length bytes, filled with the chunk
+
+-- RETURNS: bool : false if the chunk isnt stored or couldnt be read
+--
+-- NOTES:
+-- A chunk read out of the oldest segment is appended again so the next eviction doesnt lose it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ChunkStore::Read(const ChunkHash& hash, const uint32_t length, char* buffer)
+{
+	if (!Contains(hash, length))
+		return false;
+	StoredChunk chunk = index[hash];
+	QFile* segment = GetSegment(chunk.segment);
+	if (segment == nullptr || !segment->seek(chunk.offset) || segment->read(buffer, length) != (qint64)length)
+		return false;
+	if (segmentBytes.size() > 1 && chunk.segment == segmentBytes.begin()->first)
+		Append(hash, buffer, length);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Write
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Write(const ChunkHash& hash, const char* data, const uint32_t length)
+		- hash : SHA-256 of the chunk, checked against data by the caller
+		- data : the chunk
+		- length : bytes in the chunk
+
+-- RETURNS: bool : false if the segment couldnt be written
+----------------------------------------------------------------------------------------------------------------------*/
+bool ChunkStore::Write(const ChunkHash& hash, const char* data, const uint32_t length)
+{
+	if (Contains(hash, length))
+		return true;
+	return Append(hash, data, length);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Save
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Save(const uint64_t sessionLogicalBytes, const uint64_t sessionReceivedBytes)
+		- sessionLogicalBytes : bytes of file the session wrote out
+		- sessionReceivedBytes : bytes of chunk data the session got over the wire
+
+-- RETURNS: bool : whether index.bin was written
+--
+-- NOTES:
+-- Eviction only happens here, between sessions. During a session a chunk the server already said
+-- it has must stay readable, so the store can go over its size by one session's new chunks.
+-- Index is written to a temp file and moved over the old one in one step, so a crash leaves one or the other.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ChunkStore::Save(const uint64_t sessionLogicalBytes, const uint64_t sessionReceivedBytes)
+{
+	logicalBytes += sessionLogicalBytes;
+	receivedBytes += sessionReceivedBytes;
+	EvictOldSegments();
+
+	std::vector<char> contents(DEDUP_INDEX_HEADER_SIZE + index.size() * DEDUP_INDEX_ENTRY_SIZE);
+	WriteLittleEndian(&contents[0], DEDUP_INDEX_MAGIC, 4);
+	WriteLittleEndian(&contents[4], segmentBytes.empty() ? 0 : segmentBytes.begin()->first, 4);
+	WriteLittleEndian(&contents[8], segmentBytes.empty() ? 0 : segmentBytes.rbegin()->first, 4);
+	WriteLittleEndian(&contents[12], index.size(), 8);
+	WriteLittleEndian(&contents[20], logicalBytes, 8);
+	WriteLittleEndian(&contents[28], receivedBytes, 8);
+	size_t offset = DEDUP_INDEX_HEADER_SIZE;
+	for (const auto& entry : index)
+	{
+		memcpy(&contents[offset], entry.first.data(), DEDUP_CHUNK_HASH_SIZE);
+		WriteLittleEndian(&contents[offset + DEDUP_CHUNK_HASH_SIZE], entry.second.length, 4);
+		WriteLittleEndian(&contents[offset + DEDUP_CHUNK_HASH_SIZE + 4], entry.second.segment, 4);
+		WriteLittleEndian(&contents[offset + DEDUP_CHUNK_HASH_SIZE + 8], entry.second.offset, 8);
+		offset += DEDUP_INDEX_ENTRY_SIZE;
+	}
+
+	for (auto& segment : openSegments)
+		segment.second->flush();
+	QString tempPath = storeDir.filePath("index.tmp");
+	QFile tempFile(tempPath);
+	if (!tempFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+		|| tempFile.write(contents.data(), contents.size()) != (qint64)contents.size())
+		return false;
+	tempFile.close();
+	return ReplaceWithTempFile(tempPath, storeDir.filePath("index.bin"));
+}
+
+size_t ChunkStore::GetChunkCount() const
+{
+	return index.size();
+}
+
+uint64_t ChunkStore::GetStoredBytes() const
+{
+	uint64_t total = 0;
+	for (const auto& segment : segmentBytes)
+		total += segment.second;
+	return total;
+}
+
+//logical bytes written per byte received, 0 before anything arrived
+double ChunkStore::GetDedupRatio() const
+{
+	return (receivedBytes > 0) ? (double)logicalBytes / receivedBytes : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Append
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Append(const ChunkHash& hash, const char* data, const uint32_t length)
+		- hash : SHA-256 of the chunk
+		- data : the chunk
+		- length : bytes in the chunk
+
+-- RETURNS: bool : false if the segment couldnt be written
+--
+-- NOTES:
+-- Adds the chunk to the end of the newest segment, starting a new one once it would pass 64MB.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ChunkStore::Append(const ChunkHash& hash, const char* data, const uint32_t length)
+{
+	if (segmentBytes.empty())
+	{
+		segmentBytes[0] = 0;
+	}
+	else if (segmentBytes.rbegin()->second + length > DEDUP_SEGMENT_SIZE)
+	{
+		segmentBytes[segmentBytes.rbegin()->first + 1] = 0;
+	}
+	auto current = std::prev(segmentBytes.end());
+	QFile* segment = GetSegment(current->first);
+	if (segment == nullptr || !segment->seek(current->second) || segment->write(data, length) != (qint64)length)
+		return false;
+	index[hash] = { length, current->first, current->second };
+	current->second += length;
+	return true;
+}
+
+QFile* ChunkStore::GetSegment(const uint32_t segment)
+{
+	auto found = openSegments.find(segment);
+	if (found != openSegments.end())
+		return found->second.get();
+	std::unique_ptr<QFile> segmentFile(new QFile(SegmentPath(segment)));
+	if (!segmentFile->open(QIODevice::ReadWrite))
+		return nullptr;
+	QFile* opened = segmentFile.get();
+	openSegments[segment] = std::move(segmentFile);
+	return opened;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION EvictOldSegments
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void EvictOldSegments(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Drops whole segments oldest first until the store fits, the newest one is always kept.
+----------------------------------------------------------------------------------------------------------------------*/
+void ChunkStore::EvictOldSegments()
+{
+	uint64_t total = GetStoredBytes();
+	while (total > maxBytes && segmentBytes.size() > 1)
+	{
+		uint32_t oldest = segmentBytes.begin()->first;
+		for (auto entry = index.begin(); entry != index.end(); )
+		{
+			if (entry->second.segment == oldest)
+				entry = index.erase(entry);
+			else
+				++entry;
+		}
+		openSegments.erase(oldest);
+		storeDir.remove(QFileInfo(SegmentPath(oldest)).fileName());
+		total -= segmentBytes.begin()->second;
+		segmentBytes.erase(segmentBytes.begin());
+	}
+}
+
+QString ChunkStore::SegmentPath(const uint32_t segment) const
+{
+	return storeDir.filePath(QString("seg_%1.dat").arg(segment, 8, 10, QChar('0')));
+}
@@ -0,0 +1,87 @@
+#pragma once
+#pragma comment(lib, "bcrypt.lib")
+
+#include <QString>
+#include <QFile>
+#include <QDir>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#define DEDUP_OFFER_MAGIC 0x434E5341 //"ASNC", client offers the chunk list of a file
+#define DEDUP_MISSING_MAGIC 0x4D4E5341 //"ASNM", server answers with a bitmap of chunks it needs
+#define DEDUP_INDEX_MAGIC 0x4B4E5341 //"ASNK", on disk index of the chunk store (was "ASNI" when keyed by a 64 bit hash)
+#define DEDUP_HEADER_SIZE 16 //magic(4) + chunk count(4) + file size(8)
+#define DEDUP_REPLY_HEADER_SIZE 8 //magic(4) + chunk count(4), bitmap follows
+#define DEDUP_CHUNK_HASH_SIZE 32 //SHA-256, what chunks are offered and stored under
+#define DEDUP_ENTRY_SIZE 36 //hash(32) + length(4) per chunk
+#define DEDUP_END_SIZE 16 //file size(8) + strong hash of the whole file(8)
+#define DEDUP_MAX_CHUNKS 16777216 //server refuses bigger offers, 576MB of chunk list
+#define DEDUP_HASH_TASK_CHUNKS 256 //chunks the client hashes per scheduler task, ~2MB
+#define DEDUP_INDEX_HEADER_SIZE 36 //magic(4) + first/current segment(4 each) + entries(8) + logical/received bytes(8 each)
+#define DEDUP_INDEX_ENTRY_SIZE 48 //hash(32) + length(4) + segment(4) + offset(8)
+#define DEDUP_SEGMENT_SIZE 67108864 //64MB append only segment files, the unit of eviction
+#define DEDUP_STORE_MAX_BYTES 1073741824ULL //1GB of chunk data kept per output folder
+#define DEDUP_STORE_DIR ".asn2_chunks"
+#define CDC_MIN_CHUNK 2048
+#define CDC_AVG_CHUNK 8192
+#define CDC_MAX_CHUNK 65536
+
+typedef std::array<unsigned char, DEDUP_CHUNK_HASH_SIZE> ChunkHash;
+
+//SHA-256 is already uniform, its first 8 bytes do as the bucket hash
+struct ChunkHashBucket
+{
+	size_t operator()(const ChunkHash& hash) const
+	{
+		uint64_t bucket;
+		memcpy(&bucket, hash.data(), sizeof(bucket));
+		return (size_t)bucket;
+	}
+};
+
+size_t NextChunkLength(const unsigned char*, const size_t);
+bool HashChunk(const unsigned char*, const size_t, ChunkHash&);
+
+struct StoredChunk
+{
+	uint32_t length;
+	uint32_t segment;
+	uint64_t offset;
+};
+
+//content addressed chunks the server has seen, in segment files next to the output file
+class ChunkStore
+{
+public:
+	ChunkStore(const QString&, const uint64_t);
+	virtual ~ChunkStore() = default;
+	bool Open();
+	bool IsOpen() const;
+	bool Contains(const ChunkHash&, const uint32_t) const;
+	bool Read(const ChunkHash&, const uint32_t, char*);
+	bool Write(const ChunkHash&, const char*, const uint32_t);
+	bool Save(const uint64_t, const uint64_t);
+	size_t GetChunkCount() const;
+	uint64_t GetStoredBytes() const;
+	double GetDedupRatio() const;
+
+private:
+	QDir storeDir;
+	uint64_t maxBytes;
+	bool opened; //Open worked, a store that didnt is passed over and every chunk is sent
+	std::unordered_map<ChunkHash, StoredChunk, ChunkHashBucket> index;
+	std::map<uint32_t, uint64_t> segmentBytes; //bytes in each live segment, oldest first
+	std::map<uint32_t, std::unique_ptr<QFile>> openSegments;
+	uint64_t logicalBytes; //every byte ever written out through the store
+	uint64_t receivedBytes; //the part of that which actually came over the wire
+
+	bool Append(const ChunkHash&, const char*, const uint32_t);
+	QFile* GetSegment(const uint32_t);
+	void EvictOldSegments();
+	QString SegmentPath(const uint32_t) const;
+};
@@ -0,0 +1,344 @@
+#include "DeltaSync.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: DeltaSync.cpp - Block checksums for sending only the changed parts of a file
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	uint32_t WeakChecksum(const unsigned char*, const size_t, uint32_t&, uint32_t&);
+	uint64_t StrongHash(const unsigned char*, const size_t);
+	uint32_t ChooseBlockSize(const uint64_t, const uint32_t);
+	void StrongHasher::Update(const char*, size_t);
+	uint64_t StrongHasher::Final();
+	void SignatureIndex::Build(std::vector<BlockSignature>&&);
+	bool SignatureIndex::MightMatch(const uint32_t) const;
+	int64_t SignatureIndex::Find(const uint32_t, const unsigned char*, const size_t, const int64_t) const;
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Same scheme as rsync: the server (which has the old copy) sends a weak rolling checksum and a strong
+-- hash for every block, the client slides a window over the new file one byte at a time and only
+-- checks the strong hash when the weak one hits. Matching blocks go as references, the rest as literals.
+--
+-- Weak checksum is rsync's a/b pair: a = sum of bytes, b = sum of (blockSize - i) * byte i, both mod 2^16.
+-- Computing it from scratch (every server block, and on the client after every match) is done 16 bytes
+-- at a time with SSE2, which every x64 cpu has so theres no runtime check.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WeakChecksum
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: uint32_t WeakChecksum(const unsigned char* data, const size_t length, uint32_t& sumA, uint32_t& sumB)
+		- data : start of the block
+		- length : bytes in the block
+		- sumA : set to the running a sum, for rolling after
+		- sumB : set to the running b sum, for rolling after
+
+-- RETURNS: uint32_t : weak checksum, b in the high 16 bits and a in the low
+--
+-- NOTES:
+-- Per 16 byte chunk: b grows by 16 * (a so far) + sum of (16 - j) * byte j, a by the chunk's byte sum.
+-- _mm_sad_epu8 against zero gives the byte sum, _mm_madd_epi16 the weighted sum.
+-- a and b are kept as full 32 bit values and only masked in the result, wrap around doesnt change the low 16.
+----------------------------------------------------------------------------------------------------------------------*/
+uint32_t WeakChecksum(const unsigned char* data, const size_t length, uint32_t& sumA, uint32_t& sumB)
+{
+	uint32_t a = 0;
+	uint32_t b = 0;
+	size_t i = 0;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i weightsLow = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+	const __m128i weightsHigh = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(data + i));
+		__m128i byteSums = _mm_sad_epu8(bytes, zero);
+		uint32_t chunkSum = (uint32_t)_mm_cvtsi128_si32(byteSums) + (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(byteSums, 8));
+		__m128i weighted = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), weightsLow),
+			_mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), weightsHigh));
+		weighted = _mm_add_epi32(weighted, _mm_srli_si128(weighted, 8));
+		weighted = _mm_add_epi32(weighted, _mm_srli_si128(weighted, 4));
+		b += 16 * a + (uint32_t)_mm_cvtsi128_si32(weighted);
+		a += chunkSum;
+	}
+	for (; i < length; i++)
+	{
+		a += data[i];
+		b += a;
+	}
+	sumA = a;
+	sumB = b;
+	return (a & 0xFFFF) | (b << 16);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StrongHash
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: uint64_t StrongHash(const unsigned char* data, const size_t length)
+		- data : start of the block
+		- length : bytes in the block
+
+-- RETURNS: uint64_t : strong hash of the block
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t StrongHash(const unsigned char* data, const size_t length)
+{
+	StrongHasher hasher;
+	hasher.Update((const char*)data, length);
+	return hasher.Final();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ChooseBlockSize
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: uint32_t ChooseBlockSize(const uint64_t basisSize, const uint32_t requested)
+		- basisSize : size of the server's old copy
+		- requested : block size the client asked for, 0 to pick one
+
+-- RETURNS: uint32_t : block size to use, a multiple of 16 between DELTA_MIN_BLOCK and DELTA_MAX_BLOCK
+--
+-- NOTES:
+-- Picks about sqrt(file size) like rsync, which balances signature bytes against literal bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+uint32_t ChooseBlockSize(const uint64_t basisSize, const uint32_t requested)
+{
+	uint64_t blockSize = (requested > 0) ? requested : (uint64_t)std::sqrt((double)basisSize);
+	blockSize = (blockSize + 15) & ~(uint64_t)15;
+	return (uint32_t)std::min<uint64_t>(std::max<uint64_t>(blockSize, DELTA_MIN_BLOCK), DELTA_MAX_BLOCK);
+}
+
+StrongHasher::StrongHasher()
+	: hash(0x9E3779B97F4A7C15ULL)
+	, totalLength(0)
+	, pendingLength(0)
+{
+}
+
+void StrongHasher::MixWord(uint64_t word)
+{
+	const uint64_t m = 0xC6A4A7935BD1E995ULL;
+	word *= m;
+	word ^= word >> 47;
+	word *= m;
+	hash ^= word;
+	hash *= m;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StrongHasher::Update
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Update(const char* data, size_t length)
+		- data : next piece of the input
+		- length : bytes in the piece
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Pieces dont need to be word aligned, leftover bytes wait in pending for the next call.
+----------------------------------------------------------------------------------------------------------------------*/
+void StrongHasher::Update(const char* data, size_t length)
+{
+	totalLength += length;
+	while (pendingLength > 0 && pendingLength < 8 && length > 0)
+	{
+		pending[pendingLength++] = (unsigned char)*data++;
+		--length;
+	}
+	if (pendingLength == 8)
+	{
+		uint64_t word;
+		memcpy(&word, pending, 8);
+		MixWord(word);
+		pendingLength = 0;
+	}
+	for (; length >= 8; data += 8, length -= 8)
+	{
+		uint64_t word;
+		memcpy(&word, data, 8);
+		MixWord(word);
+	}
+	for (; length > 0; --length)
+	{
+		pending[pendingLength++] = (unsigned char)*data++;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StrongHasher::Final
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: uint64_t Final(void)
+--
+-- RETURNS: uint64_t : hash of everything passed to Update, length included
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t StrongHasher::Final()
+{
+	const uint64_t m = 0xC6A4A7935BD1E995ULL;
+	uint64_t result = hash;
+	if (pendingLength > 0)
+	{
+		uint64_t word = 0;
+		memcpy(&word, pending, pendingLength);
+		result ^= word;
+		result *= m;
+	}
+	result ^= totalLength * m;
+	result ^= result >> 47;
+	result *= m;
+	result ^= result >> 47;
+	return result;
+}
+
+SignatureIndex::SignatureIndex()
+	: tagStart(65537, 0)
+	, tagBits(1024, 0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SignatureIndex::Build
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Build(std::vector<BlockSignature>&& received)
+		- received : signatures from the server, in block order
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void SignatureIndex::Build(std::vector<BlockSignature>&& received)
+{
+	signatures = std::move(received);
+	std::stable_sort(signatures.begin(), signatures.end(), [](const BlockSignature& left, const BlockSignature& right) {
+		return WeakTag(left.weak) < WeakTag(right.weak);
+	});
+	std::fill(tagStart.begin(), tagStart.end(), 0);
+	std::fill(tagBits.begin(), tagBits.end(), 0);
+	blockPosition.assign(signatures.size(), -1);
+	for (size_t i = 0; i < signatures.size(); i++)
+	{
+		uint16_t tag = WeakTag(signatures[i].weak);
+		++tagStart[tag + 1];
+		tagBits[tag >> 6] |= 1ULL << (tag & 63);
+		if (signatures[i].block < blockPosition.size())
+			blockPosition[signatures[i].block] = (int64_t)i;
+	}
+	for (size_t tag = 1; tag < tagStart.size(); tag++)
+	{
+		tagStart[tag] += tagStart[tag - 1];
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SignatureIndex::MightMatch
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool MightMatch(const uint32_t weak) const
+		- weak : weak checksum of the current window
+
+-- RETURNS: bool : false if no block can possibly match, the common case inside changed regions
+----------------------------------------------------------------------------------------------------------------------*/
+bool SignatureIndex::MightMatch(const uint32_t weak) const
+{
+	uint16_t tag = WeakTag(weak);
+	return (tagBits[tag >> 6] >> (tag & 63)) & 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SignatureIndex::Find
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int64_t Find(const uint32_t weak, const unsigned char* window, const size_t blockSize,
+	const int64_t preferredBlock) const
+		- weak : weak checksum of the window
+		- window : the bytes of the window, hashed only if a weak checksum matches
+		- blockSize : bytes in the window
+		- preferredBlock : block right after the last match, tried first so copies coalesce
+
+-- RETURNS: int64_t : matching block number, -1 if none
+----------------------------------------------------------------------------------------------------------------------*/
+int64_t SignatureIndex::Find(const uint32_t weak, const unsigned char* window, const size_t blockSize, const int64_t preferredBlock) const
+{
+	bool strongDone = false;
+	uint64_t strong = 0;
+	if (preferredBlock >= 0 && preferredBlock < (int64_t)blockPosition.size() && blockPosition[preferredBlock] >= 0)
+	{
+		const BlockSignature& preferred = signatures[blockPosition[preferredBlock]];
+		if (preferred.weak == weak)
+		{
+			strong = StrongHash(window, blockSize);
+			strongDone = true;
+			if (preferred.strong == strong)
+				return preferredBlock;
+		}
+	}
+	uint16_t tag = WeakTag(weak);
+	for (uint32_t i = tagStart[tag]; i < tagStart[tag + 1]; i++)
+	{
+		if (signatures[i].weak != weak)
+			continue;
+		if (!strongDone)
+		{
+			strong = StrongHash(window, blockSize);
+			strongDone = true;
+		}
+		if (signatures[i].strong == strong)
+			return signatures[i].block;
+	}
+	return -1;
+}
+
+size_t SignatureIndex::GetBlockCount() const
+{
+	return signatures.size();
+}
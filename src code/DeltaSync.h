@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <emmintrin.h>
+
+#define DELTA_REQUEST_MAGIC 0x444E5341 //"ASND", client asks for signatures
+#define DELTA_SIGNATURE_MAGIC 0x534E5341 //"ASNS", server's block signatures follow
+#define DELTA_HEADER_SIZE 16 //magic(4) + block size(4) + file size or block count(8)
+#define DELTA_SIGNATURE_SIZE 12 //weak(4) + strong(8) per block
+#define DELTA_MIN_BLOCK 512
+#define DELTA_MAX_BLOCK 65536
+#define DELTA_MAX_BLOCKS 16777216 //client refuses more signatures than this, 192MB
+#define DELTA_SIGNATURE_READ 4194304 //server signs its copy 4MB at a time, split over the scheduler
+#define DELTA_SIGNATURE_TASK_BYTES 262144 //blocks signed per scheduler task
+#define DELTA_MAX_LITERAL 262144 //longest single literal op
+#define DELTA_OP_LITERAL 'L' //length(4), then the bytes
+#define DELTA_OP_COPY 'C' //first block(8) + block count(4), taken from the server's copy
+#define DELTA_OP_END 'E' //new file size(8) + strong hash of the whole new file(8)
+#define DELTA_COPY_OP_SIZE 13
+#define DELTA_END_OP_SIZE 17
+#define DELTA_REPLY_TIMEOUT_SEC 60 //client gives up if the server is silent this long while hashing
+
+struct BlockSignature
+{
+	uint32_t weak;
+	uint64_t strong;
+	uint32_t block;
+};
+
+//64 bit MurmurHash2 over 8 byte words, fed in pieces so the server can hash what it writes
+class StrongHasher
+{
+public:
+	StrongHasher();
+	virtual ~StrongHasher() = default;
+	void Update(const char*, size_t);
+	uint64_t Final();
+
+private:
+	uint64_t hash;
+	uint64_t totalLength;
+	unsigned char pending[8];
+	int pendingLength;
+
+	void MixWord(uint64_t);
+};
+
+//the server's signatures, sorted by a 16 bit tag of the weak checksum like rsync
+class SignatureIndex
+{
+public:
+	SignatureIndex();
+	virtual ~SignatureIndex() = default;
+	void Build(std::vector<BlockSignature>&&);
+	bool MightMatch(const uint32_t) const;
+	int64_t Find(const uint32_t, const unsigned char*, const size_t, const int64_t) const;
+	size_t GetBlockCount() const;
+
+private:
+	std::vector<BlockSignature> signatures;
+	std::vector<uint32_t> tagStart; //65537 offsets into signatures
+	std::vector<uint64_t> tagBits; //one bit per tag, 8KB so it stays in L1 during the rolling loop
+	std::vector<int64_t> blockPosition; //block number -> position in signatures
+};
+
+uint32_t WeakChecksum(const unsigned char*, const size_t, uint32_t&, uint32_t&);
+uint64_t StrongHash(const unsigned char*, const size_t);
+uint32_t ChooseBlockSize(const uint64_t, const uint32_t);
+inline uint16_t WeakTag(const uint32_t weak) { return (uint16_t)((weak & 0xFFFF) ^ (weak >> 16)); }
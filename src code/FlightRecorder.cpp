@@ -0,0 +1,344 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <iomanip>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FlightRecorder.cpp - Per thread rings of stage timings, written out as a Chrome trace
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void Push(const TraceEvent&);
+	void Snapshot(std::vector<TraceEvent>&) const;
+	uint64_t GetPushed() const;
+	FlightRecorder& Shared();
+	void SetEnabled(const bool);
+	bool IsEnabled() const;
+	void Record(const TraceStage, const uint64_t, const uint64_t, const size_t);
+	bool WriteChromeTrace(const QString&, size_t&);
+	uint64_t CountRecorded();
+	TraceRingLease& ThreadRing();
+	void ReleaseRing(TraceRing*);
+	const char* StageName(const TraceStage);
+	void SetBytes(const size_t);
+	void Discard();
+	void End();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- The session list only knows when a transfer started and stopped, not whether the time went to
+-- reading the file, pacing, send, recv or writing. The loops put a TraceScope around each of those.
+--
+-- While tracing is off a scope is one relaxed atomic load. While it is on, a scope reads the
+-- TSC twice and copies 32 bytes into its thread's ring: no lock, no allocation, and no other thread
+-- ever writes that ring. The clock reads are most of a scope's cost, and __rdtsc is a fraction of
+-- QueryPerformanceCounter's; ticks are scaled to ns against it once, when the trace is written.
+-- QueryPerformanceCounter itself runs off the TSC on any CPU with an invariant one, which is every
+-- x64 CPU Windows 10 supports, so the two dont drift apart. A thread gets a ring the first time it
+-- records and gives it back when it exits, the next new thread carries on in it, so a benchmark
+-- starting a thread per config uses the same few rings over and over. The events already in a ring
+-- stay until they are written over, each one keeps the id of the thread that recorded it.
+-- No more than TRACE_MAX_RINGS are ever made, a thread that finds them all held doesnt record.
+--
+-- WriteChromeTrace copies every ring while the loops keep going, drops whatever may have been
+-- overwritten during the copy, and writes the JSON chrome://tracing and ui.perfetto.dev open:
+-- one row per thread, one box per stage, bytes in the box's args.
+----------------------------------------------------------------------------------------------------------------------*/
+
+//a thread's hold on a ring, handed back to the pool when the thread exits
+struct TraceRingLease
+{
+	TraceRing* ring = nullptr;
+	uint32_t threadId = 0;
+	bool asked = false; //whether ThreadRing already tried, so a thread turned away doesnt keep locking
+
+	~TraceRingLease()
+	{
+		if (ring != nullptr)
+			FlightRecorder::Shared().ReleaseRing(ring);
+	}
+};
+
+TraceRing::TraceRing()
+	: events(TRACE_RING_EVENTS)
+	, head(0)
+{
+}
+
+//only ever called by the thread holding this ring
+void TraceRing::Push(const TraceEvent& event)
+{
+	uint64_t position = head.load(std::memory_order_relaxed);
+	events[position & (TRACE_RING_EVENTS - 1)] = event;
+	head.store(position + 1, std::memory_order_release);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Snapshot
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Snapshot(std::vector<TraceEvent>& copied) const
+		- copied : the ring's events get appended, oldest first
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Safe to call while the owner keeps pushing. Anything the owner could have written over between
+-- the two reads of head, plus the slot it may be halfway through, is left out rather than locked.
+----------------------------------------------------------------------------------------------------------------------*/
+void TraceRing::Snapshot(std::vector<TraceEvent>& copied) const
+{
+	uint64_t end = head.load(std::memory_order_acquire);
+	uint64_t begin = (end > TRACE_RING_EVENTS) ? end - TRACE_RING_EVENTS : 0;
+	size_t firstCopied = copied.size();
+	for (uint64_t position = begin; position < end; ++position)
+	{
+		copied.push_back(events[position & (TRACE_RING_EVENTS - 1)]);
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t headAfter = head.load(std::memory_order_relaxed);
+	uint64_t firstIntact = (headAfter + 1 > TRACE_RING_EVENTS) ? headAfter + 1 - TRACE_RING_EVENTS : 0;
+	if (firstIntact > begin)
+	{
+		size_t overwritten = (size_t)std::min<uint64_t>(firstIntact - begin, end - begin);
+		copied.erase(copied.begin() + firstCopied, copied.begin() + firstCopied + overwritten);
+	}
+}
+
+//events ever pushed into this ring, by every thread that held it
+uint64_t TraceRing::GetPushed() const
+{
+	return head.load(std::memory_order_acquire);
+}
+
+FlightRecorder::FlightRecorder()
+	: enabled(false)
+	, sinceNs(0)
+	, sinceTicks(0)
+{
+}
+
+FlightRecorder& FlightRecorder::Shared()
+{
+	static FlightRecorder recorder;
+	return recorder;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SetEnabled
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SetEnabled(const bool on)
+		- on : start or stop timing stages
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Turning it on starts a new recording: events from before are still in the rings but wont be written.
+----------------------------------------------------------------------------------------------------------------------*/
+void FlightRecorder::SetEnabled(const bool on)
+{
+	if (on && !enabled)
+	{
+		sinceNs = MeasureClockNs();
+		sinceTicks = __rdtsc();
+	}
+	enabled.store(on, std::memory_order_relaxed);
+}
+
+bool FlightRecorder::IsEnabled() const
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Record
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Record(const TraceStage stage, const uint64_t startTicks, const uint64_t endTicks, const size_t bytes)
+		- stage : what was timed
+		- startTicks : __rdtsc when it started
+		- endTicks : __rdtsc when it ended
+		- bytes : how much it moved, 0 if that doesnt apply
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void FlightRecorder::Record(const TraceStage stage, const uint64_t startTicks, const uint64_t endTicks, const size_t bytes)
+{
+	TraceRingLease& lease = ThreadRing();
+	if (lease.ring == nullptr)
+		return;
+	TraceEvent event = { startTicks, endTicks, bytes, lease.threadId, stage };
+	lease.ring->Push(event);
+}
+
+//the calling thread's lease, on its first event it takes a free ring or makes one if theres room
+TraceRingLease& FlightRecorder::ThreadRing()
+{
+	static thread_local TraceRingLease lease;
+	if (!lease.asked)
+	{
+		lease.asked = true;
+		lease.threadId = GetCurrentThreadId();
+		std::lock_guard<std::mutex> lock(ringsLock);
+		if (!freeRings.empty())
+		{
+			lease.ring = freeRings.back();
+			freeRings.pop_back();
+		}
+		else if (rings.size() < TRACE_MAX_RINGS)
+		{
+			rings.push_back(std::unique_ptr<TraceRing>(new TraceRing));
+			lease.ring = rings.back().get();
+		}
+	}
+	return lease;
+}
+
+//called as a thread that recorded exits, its events stay in the ring for the next thread to write after
+void FlightRecorder::ReleaseRing(TraceRing* ring)
+{
+	std::lock_guard<std::mutex> lock(ringsLock);
+	freeRings.push_back(ring);
+}
+
+//events ever recorded across all rings, the benchmark counts how many a run made from the difference
+uint64_t FlightRecorder::CountRecorded()
+{
+	uint64_t recorded = 0;
+	std::lock_guard<std::mutex> lock(ringsLock);
+	for (const std::unique_ptr<TraceRing>& ring : rings)
+		recorded += ring->GetPushed();
+	return recorded;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteChromeTrace
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool WriteChromeTrace(const QString& path, size_t& eventCount)
+		- path : JSON file to write, replaced if it exists
+		- eventCount : set to the events written
+
+-- RETURNS: bool : false if the file couldnt be written
+--
+-- NOTES:
+-- Trace Event Format: complete ("X") events with ts and dur in us, counted from when tracing was
+-- turned on, and a thread_name entry per thread seen so the rows are labeled with the Windows thread id.
+-- Ticks become ns by how far QueryPerformanceCounter moved against the TSC since tracing was turned on.
+-- Tracing can stay on while this runs.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlightRecorder::WriteChromeTrace(const QString& path, size_t& eventCount)
+{
+	eventCount = 0;
+	std::ofstream traceFile(path.toStdString(), std::ios::binary | std::ios::trunc);
+	if (!traceFile)
+		return false;
+	uint64_t originTicks = sinceTicks;
+	uint64_t elapsedTicks = __rdtsc() - originTicks;
+	double nsPerTick = (elapsedTicks > 0) ? (double)(MeasureClockNs() - sinceNs) / elapsedTicks : 0;
+	traceFile << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	std::vector<TraceEvent> events;
+	events.reserve(TRACE_RING_EVENTS);
+	std::vector<uint32_t> namedThreads;
+	std::lock_guard<std::mutex> lock(ringsLock);
+	for (const std::unique_ptr<TraceRing>& ring : rings)
+	{
+		events.clear();
+		ring->Snapshot(events);
+		for (const TraceEvent& event : events)
+		{
+			if (event.startTicks < originTicks)
+				continue;
+			if (std::find(namedThreads.begin(), namedThreads.end(), event.threadId) == namedThreads.end())
+			{
+				namedThreads.push_back(event.threadId);
+				traceFile << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << TRACE_PROCESS_ID
+					<< ",\"tid\":" << event.threadId << ",\"args\":{\"name\":\"thread " << event.threadId << "\"}}";
+				first = false;
+			}
+			traceFile << ",\n{\"name\":\"" << StageName(event.stage) << "\",\"cat\":\""
+				<< ((event.stage == TraceStage::Receive || event.stage == TraceStage::Write) ? "server" : "client")
+				<< "\",\"ph\":\"X\",\"pid\":" << TRACE_PROCESS_ID << ",\"tid\":" << event.threadId
+				<< ",\"ts\":" << (event.startTicks - originTicks) * nsPerTick / 1000.0
+				<< ",\"dur\":" << (event.endTicks - event.startTicks) * nsPerTick / 1000.0
+				<< ",\"args\":{\"bytes\":" << event.bytes << "}}";
+			++eventCount;
+		}
+	}
+	traceFile << "\n]}\n";
+	return traceFile.good();
+}
+
+const char* FlightRecorder::StageName(const TraceStage stage)
+{
+	switch (stage)
+	{
+	case TraceStage::FileRead: return "file read";
+	case TraceStage::Build: return "packet build";
+	case TraceStage::Pace: return "pace";
+	case TraceStage::Send: return "send";
+	case TraceStage::Receive: return "recv";
+	case TraceStage::Write: return "file write";
+	}
+	return "unknown";
+}
+
+//wanted false leaves the scope out without an if around it, e.g. pacing when theres no target rate
+TraceScope::TraceScope(const TraceStage tracedStage, const size_t tracedBytes, const bool wanted)
+	: stage(tracedStage)
+	, bytes(tracedBytes)
+	, startTicks((wanted && FlightRecorder::Shared().IsEnabled()) ? __rdtsc() : 0)
+{
+}
+
+TraceScope::~TraceScope()
+{
+	End();
+}
+
+void TraceScope::SetBytes(const size_t tracedBytes)
+{
+	bytes = tracedBytes;
+}
+
+//leave this one out, e.g. a recv that would have blocked
+void TraceScope::Discard()
+{
+	startTicks = 0;
+}
+
+//record it now instead of at the end of the scope
+void TraceScope::End()
+{
+	if (startTicks == 0)
+		return;
+	FlightRecorder::Shared().Record(stage, startTicks, __rdtsc(), bytes);
+	startTicks = 0;
+}
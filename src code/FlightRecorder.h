@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Windows.h>
+#include <intrin.h>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "UdpMeasure.h"
+
+#define TRACE_RING_EVENTS 65536 //per thread, power of two, 2MB of the latest events each
+#define TRACE_MAX_RINGS 32 //rings ever made, 64MB. A thread that exits gives its ring back for the next one
+#define TRACE_PROCESS_ID 1 //Chrome trace pid, everything is one process
+
+//which part of a transfer a trace event timed
+enum class TraceStage : uint8_t
+{
+	FileRead, //client reading the file (or a batch file) into memory
+	Build, //client filling a packet that didnt come from a file
+	Pace, //client waiting on the pacer for its target rate, only traced when there is one
+	Send, //send/sendto on the client
+	Receive, //recv/recvfrom on the server, only calls that got data
+	Write //server handing received bytes to its sink or output file
+};
+
+//one timed stage, fixed size so a ring never allocates once it exists
+struct TraceEvent
+{
+	uint64_t startTicks; //TSC, turned into ns only when the trace is written
+	uint64_t endTicks;
+	uint64_t bytes;
+	uint32_t threadId; //in the event rather than the ring, a ring can go from one thread to the next
+	TraceStage stage;
+};
+
+//the latest TRACE_RING_EVENTS events of the thread holding it. Only that thread writes, anyone may read
+class TraceRing
+{
+public:
+	TraceRing();
+	virtual ~TraceRing() = default;
+	void Push(const TraceEvent&);
+	void Snapshot(std::vector<TraceEvent>&) const;
+	uint64_t GetPushed() const;
+
+private:
+	std::vector<TraceEvent> events;
+	std::atomic<uint64_t> head; //events ever pushed, the next goes in head % TRACE_RING_EVENTS
+};
+
+struct TraceRingLease;
+
+//process wide flight recorder: the Client and Server loops time their stages into it while
+//tracing is on, and it is written out as a Chrome trace whenever asked
+class FlightRecorder
+{
+public:
+	static FlightRecorder& Shared();
+	void SetEnabled(const bool);
+	bool IsEnabled() const;
+	void Record(const TraceStage, const uint64_t, const uint64_t, const size_t);
+	bool WriteChromeTrace(const QString&, size_t&);
+	uint64_t CountRecorded();
+
+private:
+	friend struct TraceRingLease;
+
+	FlightRecorder();
+	TraceRingLease& ThreadRing();
+	void ReleaseRing(TraceRing*);
+	static const char* StageName(const TraceStage);
+
+	std::atomic<bool> enabled;
+	std::atomic<uint64_t> sinceNs; //when tracing was last turned on, older events arent written
+	std::atomic<uint64_t> sinceTicks; //the TSC at that same moment, the two together scale ticks to ns
+	std::mutex ringsLock; //only taken when a thread first records or exits, and while writing
+	std::vector<std::unique_ptr<TraceRing>> rings; //at most TRACE_MAX_RINGS
+	std::vector<TraceRing*> freeRings; //in rings, but their thread has exited
+};
+
+//times the code from here to End or the end of the scope, nothing at all while tracing is off
+class TraceScope
+{
+public:
+	TraceScope(const TraceStage, const size_t = 0, const bool = true);
+	virtual ~TraceScope();
+	void SetBytes(const size_t);
+	void Discard();
+	void End();
+
+private:
+	TraceStage stage;
+	size_t bytes;
+	uint64_t startTicks; //0 when tracing is off or the event was already recorded
+};
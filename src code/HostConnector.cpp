@@ -0,0 +1,385 @@
+#include "HostConnector.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: HostConnector.cpp - Resolves a host and opens a client socket to it, off the main thread
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void ResolveAndConnect(const QString&, const QString&, const int, const bool, const int);
+	int Resolve(const QString&, const int, const int, const bool, std::vector<ResolvedAddress>&);
+	void InterleaveFamilies(std::vector<ResolvedAddress>&);
+	SOCKET RaceConnect(const std::vector<ResolvedAddress>&, ResolvedAddress&, int&);
+	SOCKET OpenUdpSocket(const std::vector<ResolvedAddress>&, ResolvedAddress&, int&);
+	QString AddressToString(const ResolvedAddress&);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Replaces the gethostbyname/gethostbyaddr + blocking select that WSASocketManager used to do on the
+-- GUI thread. Like Client and Server, this lives in its own thread and is only ever signaled.
+--
+-- getaddrinfo is used so hosts with IPv6 addresses work, and numeric IPs no longer do a reverse
+-- DNS lookup. Answers are cached for RESOLVE_CACHE_TTL seconds (getaddrinfo does not hand back the
+-- record TTL), so back to back sessions to the same host skip DNS entirely.
+-- TCP connects race every address "happy eyeballs" style (RFC 8305): families are interleaved,
+-- a new attempt starts every 250ms or as soon as one fails, and the first to connect wins.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#define RESOLVE_CACHE_TTL 60
+#define CONNECT_ATTEMPT_DELAY_MS 250
+#define CONNECT_TIMEOUT_MS 5000
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ResolveAndConnect
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ResolveAndConnect(const QString& host, const QString& protocol, const int port, const bool numericOnly,
+	const int sessionId)
+		- host : QString, host name or numeric IPv4/IPv6 address
+		- protocol : QString, TCP or UDP
+		- port : int, server port
+		- numericOnly : bool, host is an IP address, dont touch DNS
+		- sessionId : int, send session waiting on this connect, handed back with the result
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+-- Emits HostConnected with a non blocking socket (connected for TCP, bound for UDP) and the
+-- server's address, or HostConnectFailed with a WinSock error code.
+----------------------------------------------------------------------------------------------------------------------*/
+void HostConnector::ResolveAndConnect(const QString& host, const QString& protocol, const int port, const bool numericOnly, const int sessionId)
+{
+	int socketType = (protocol == "UDP") ? SOCK_DGRAM : SOCK_STREAM;
+	std::vector<ResolvedAddress> addresses;
+	int errorCode = Resolve(host, port, socketType, numericOnly, addresses);
+	if (errorCode != 0)
+	{
+		emit HostConnectFailed(errorCode, sessionId);
+		return;
+	}
+	InterleaveFamilies(addresses);
+
+	ResolvedAddress winner;
+	SOCKET connectedSocket = (socketType == SOCK_DGRAM)
+		? OpenUdpSocket(addresses, winner, errorCode)
+		: RaceConnect(addresses, winner, errorCode);
+	if (connectedSocket == INVALID_SOCKET)
+	{
+		emit HostConnectFailed(errorCode, sessionId);
+		return;
+	}
+	emit ConnectorStatusReady(QString("-Using server address %1").arg(AddressToString(winner)));
+	emit HostConnected(connectedSocket, winner.address, sessionId);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Resolve
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int Resolve(const QString& host, const int port, const int socketType, const bool numericOnly,
+	std::vector<ResolvedAddress>& addresses)
+		- host : QString, host name or numeric address
+		- port : int, server port
+		- socketType : int, SOCK_STREAM or SOCK_DGRAM
+		- numericOnly : bool, fail instead of querying DNS
+		- addresses : std::vector<ResolvedAddress>, filled in order getaddrinfo preferred them
+
+-- RETURNS: int : 0, or the WinSock error code getaddrinfo returned
+----------------------------------------------------------------------------------------------------------------------*/
+int HostConnector::Resolve(const QString& host, const int port, const int socketType, const bool numericOnly, std::vector<ResolvedAddress>& addresses)
+{
+	QString cacheKey = QString("%1|%2|%3").arg(host).arg(port).arg(socketType);
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	auto cached = resolvedHosts.find(cacheKey);
+	if (cached != resolvedHosts.end())
+	{
+		if (cached->second.expiry > now)
+		{
+			addresses = cached->second.addresses;
+			emit ConnectorStatusReady("-Host found in cache");
+			return 0;
+		}
+		resolvedHosts.erase(cached);
+	}
+
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = socketType;
+	hints.ai_flags = numericOnly ? AI_NUMERICHOST : 0;
+	struct addrinfo* results = NULL;
+	std::string hostStr = host.toStdString();
+	std::string portStr = std::to_string(port);
+	int status = getaddrinfo(hostStr.c_str(), portStr.c_str(), &hints, &results);
+	if (status != 0)
+		return status;
+
+	for (struct addrinfo* info = results; info != NULL; info = info->ai_next)
+	{
+		if (info->ai_family != AF_INET && info->ai_family != AF_INET6)
+			continue;
+		ResolvedAddress resolved;
+		memset(&resolved.address, 0, sizeof(resolved.address));
+		memcpy(&resolved.address, info->ai_addr, info->ai_addrlen);
+		resolved.length = (int)info->ai_addrlen;
+		addresses.push_back(resolved);
+	}
+	freeaddrinfo(results);
+	if (addresses.empty())
+		return WSAHOST_NOT_FOUND;
+
+	resolvedHosts[cacheKey] = { addresses, now + std::chrono::seconds(RESOLVE_CACHE_TTL) };
+	return 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION InterleaveFamilies
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void InterleaveFamilies(std::vector<ResolvedAddress>& addresses)
+		- addresses : std::vector<ResolvedAddress>, reordered in place
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Keeps getaddrinfo's first pick first, then alternates IPv6/IPv4 so one broken family
+-- only ever delays the race by one attempt.
+----------------------------------------------------------------------------------------------------------------------*/
+void HostConnector::InterleaveFamilies(std::vector<ResolvedAddress>& addresses)
+{
+	if (addresses.empty())
+		return;
+	int firstFamily = addresses[0].address.ss_family;
+	std::vector<ResolvedAddress> preferred;
+	std::vector<ResolvedAddress> other;
+	for (const ResolvedAddress& resolved : addresses)
+	{
+		(resolved.address.ss_family == firstFamily ? preferred : other).push_back(resolved);
+	}
+	addresses.clear();
+	for (size_t i = 0; i < preferred.size() || i < other.size(); ++i)
+	{
+		if (i < preferred.size())
+			addresses.push_back(preferred[i]);
+		if (i < other.size())
+			addresses.push_back(other[i]);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RaceConnect
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: SOCKET RaceConnect(const std::vector<ResolvedAddress>& addresses, ResolvedAddress& winner, int& errorCode)
+		- addresses : std::vector<ResolvedAddress>, candidates in the order to try them
+		- winner : ResolvedAddress, set to the address that connected first
+		- errorCode : int, set to the last failure if nothing connected
+
+-- RETURNS: SOCKET : connected non blocking socket, or INVALID_SOCKET
+--
+-- NOTES:
+-- All attempts are non blocking connects watched by one select. On windows a refused connect
+-- shows up in the except set, elsewhere the socket turns writable with SO_ERROR set, so both are checked.
+-- Losers are closed as soon as there is a winner.
+----------------------------------------------------------------------------------------------------------------------*/
+SOCKET HostConnector::RaceConnect(const std::vector<ResolvedAddress>& addresses, ResolvedAddress& winner, int& errorCode)
+{
+	struct Attempt
+	{
+		SOCKET socket;
+		size_t addressIndex;
+	};
+	std::vector<Attempt> pending;
+	size_t nextAddress = 0;
+	errorCode = WSAETIMEDOUT;
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CONNECT_TIMEOUT_MS);
+	std::chrono::steady_clock::time_point nextAttempt = std::chrono::steady_clock::now();
+
+	while (nextAddress < addresses.size() || !pending.empty())
+	{
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (nextAddress < addresses.size() && (pending.empty() || now >= nextAttempt))
+		{
+			const ResolvedAddress& candidate = addresses[nextAddress];
+			SOCKET attemptSocket = socket(candidate.address.ss_family, SOCK_STREAM, 0);
+			if (attemptSocket != INVALID_SOCKET)
+			{
+				unsigned long on = 1;
+				ioctlsocket(attemptSocket, FIONBIO, &on);
+				//scope operator: QObject::connect would be picked otherwise
+				int status = ::connect(attemptSocket, (struct sockaddr*)&candidate.address, candidate.length);
+				if (status == 0 || WSAGetLastError() == WSAEWOULDBLOCK || WSAGetLastError() == WSAEINPROGRESS)
+				{
+					pending.push_back({ attemptSocket, nextAddress });
+				}
+				else
+				{
+					errorCode = WSAGetLastError();
+					closesocket(attemptSocket);
+				}
+			}
+			++nextAddress;
+			nextAttempt = now + std::chrono::milliseconds(CONNECT_ATTEMPT_DELAY_MS);
+			continue;
+		}
+		if (now >= deadline)
+			break;
+
+		fd_set writable;
+		fd_set failed;
+		FD_ZERO(&writable);
+		FD_ZERO(&failed);
+		SOCKET highestSocket = 0;
+		for (const Attempt& attempt : pending)
+		{
+			FD_SET(attempt.socket, &writable);
+			FD_SET(attempt.socket, &failed);
+			highestSocket = (attempt.socket > highestSocket) ? attempt.socket : highestSocket;
+		}
+		std::chrono::steady_clock::time_point waitUntil = (nextAddress < addresses.size() && nextAttempt < deadline) ? nextAttempt : deadline;
+		long long waitUs = std::chrono::duration_cast<std::chrono::microseconds>(waitUntil - now).count();
+		struct timeval tv;
+		tv.tv_sec = (long)(waitUs / 1000000);
+		tv.tv_usec = (long)(waitUs % 1000000);
+		//nfds is ignored by winsock, but must be highest socket + 1 everywhere else
+		if (select((int)highestSocket + 1, NULL, &writable, &failed, &tv) < 0)
+		{
+			errorCode = WSAGetLastError();
+			break;
+		}
+
+		for (auto attempt = pending.begin(); attempt != pending.end();)
+		{
+			bool isWritable = FD_ISSET(attempt->socket, &writable) != 0;
+			bool isFailed = FD_ISSET(attempt->socket, &failed) != 0;
+			if (!isWritable && !isFailed)
+			{
+				++attempt;
+				continue;
+			}
+			int socketError = 0;
+			int errorLength = sizeof(socketError);
+			getsockopt(attempt->socket, SOL_SOCKET, SO_ERROR, (char*)&socketError, &errorLength);
+			if (!isFailed && socketError == 0)
+			{
+				SOCKET connectedSocket = attempt->socket;
+				winner = addresses[attempt->addressIndex];
+				pending.erase(attempt);
+				for (const Attempt& loser : pending)
+				{
+					closesocket(loser.socket);
+				}
+				return connectedSocket;
+			}
+			errorCode = (socketError != 0) ? socketError : WSAECONNREFUSED;
+			closesocket(attempt->socket);
+			attempt = pending.erase(attempt);
+			//dont wait out the delay, next address can go right away
+			nextAttempt = std::chrono::steady_clock::now();
+		}
+	}
+
+	for (const Attempt& attempt : pending)
+	{
+		closesocket(attempt.socket);
+	}
+	return INVALID_SOCKET;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION OpenUdpSocket
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: SOCKET OpenUdpSocket(const std::vector<ResolvedAddress>& addresses, ResolvedAddress& winner, int& errorCode)
+		- addresses : std::vector<ResolvedAddress>, candidates in preferred order
+		- winner : ResolvedAddress, set to the address datagrams should go to
+		- errorCode : int, set to the last failure if no socket could be made
+
+-- RETURNS: SOCKET : non blocking socket bound to any local port, or INVALID_SOCKET
+--
+-- NOTES:
+-- UDP has no handshake to race, so the first address whose family this machine can open a socket for wins.
+----------------------------------------------------------------------------------------------------------------------*/
+SOCKET HostConnector::OpenUdpSocket(const std::vector<ResolvedAddress>& addresses, ResolvedAddress& winner, int& errorCode)
+{
+	errorCode = WSAHOST_NOT_FOUND;
+	for (const ResolvedAddress& candidate : addresses)
+	{
+		SOCKET udpSocket = socket(candidate.address.ss_family, SOCK_DGRAM, 0);
+		if (udpSocket == INVALID_SOCKET)
+		{
+			errorCode = WSAGetLastError();
+			continue;
+		}
+		unsigned long on = 1;
+		ioctlsocket(udpSocket, FIONBIO, &on);
+
+		//bind to any available port of the same family
+		struct sockaddr_storage local;
+		memset(&local, 0, sizeof(local));
+		local.ss_family = candidate.address.ss_family;
+		int localLength = (local.ss_family == AF_INET6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+		if (bind(udpSocket, (struct sockaddr*)&local, localLength) == -1)
+		{
+			errorCode = WSAGetLastError();
+			closesocket(udpSocket);
+			continue;
+		}
+		winner = candidate;
+		return udpSocket;
+	}
+	return INVALID_SOCKET;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION AddressToString
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString AddressToString(const ResolvedAddress& resolved)
+		- resolved : ResolvedAddress, address to print
+
+-- RETURNS: QString : numeric form of the address, for console output
+----------------------------------------------------------------------------------------------------------------------*/
+QString HostConnector::AddressToString(const ResolvedAddress& resolved)
+{
+	char hostBuffer[NI_MAXHOST];
+	if (getnameinfo((struct sockaddr*)&resolved.address, resolved.length, hostBuffer, sizeof(hostBuffer), NULL, 0, NI_NUMERICHOST) != 0)
+		return QString("unknown");
+	return QString(hostBuffer);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <QObject>
+#include <QThread>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+
+struct ResolvedAddress
+{
+	struct sockaddr_storage address;
+	int length;
+};
+
+class HostConnector : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~HostConnector() = default;
+	void ResolveAndConnect(const QString&, const QString&, const int, const bool, const int);
+
+signals:
+	void HostConnected(SOCKET, struct sockaddr_storage, const int);
+	void HostConnectFailed(const int, const int);
+	void ConnectorStatusReady(const QString&);
+
+private:
+	struct CachedHost
+	{
+		std::vector<ResolvedAddress> addresses;
+		std::chrono::steady_clock::time_point expiry;
+	};
+	std::map<QString, CachedHost> resolvedHosts;
+
+	int Resolve(const QString&, const int, const int, const bool, std::vector<ResolvedAddress>&);
+	void InterleaveFamilies(std::vector<ResolvedAddress>&);
+	SOCKET RaceConnect(const std::vector<ResolvedAddress>&, ResolvedAddress&, int&);
+	SOCKET OpenUdpSocket(const std::vector<ResolvedAddress>&, ResolvedAddress&, int&);
+	QString AddressToString(const ResolvedAddress&);
+};
@@ -0,0 +1,207 @@
+#include "LiveChart.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: LiveChart.cpp - The Live panel on MainWindow, a session's rates drawn while it runs
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void SetSeries(const LiveSeries&, const QString&);
+	void Clear();
+	void paintEvent(QPaintEvent*);
+	void PaintStrip(QPainter&, const QRectF&, LiveRange LiveBucket::*, const double, const QString&, const QColor&);
+	QString FormatSeconds(const double);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- The ServerSideResults fields only have totals once a transfer is over. This panel shows the
+-- session picked in the session list (or the newest one) as it goes: MB/s, thousands of packets
+-- per second, loss % and round trip time, each in its own strip over the whole session so far.
+--
+-- MainWindowController hands it a fresh copy of the session's LiveSeries every LIVE_SAMPLE_MS.
+-- Each bucket is drawn as a light band from its min to its max with the mean as a line through it,
+-- so a stall that only lasted one sample still shows as a dip to 0 once the bucket holds minutes.
+-- Loss only comes from Measure, FEC and UDP ping-pong sessions and RTT from ping-pong, their
+-- strips say so instead of drawing a flat 0 for everything else.
+----------------------------------------------------------------------------------------------------------------------*/
+
+LiveChart::LiveChart(QWidget* parent)
+	: QWidget(parent)
+{
+}
+
+//shows series from now on, title names the session it belongs to
+void LiveChart::SetSeries(const LiveSeries& sessionSeries, const QString& sessionTitle)
+{
+	series = sessionSeries;
+	title = sessionTitle;
+	update();
+}
+
+void LiveChart::Clear()
+{
+	series.Clear();
+	title.clear();
+	update();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION paintEvent
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void paintEvent(QPaintEvent* event)
+			- event : unused, the whole chart is redrawn every time
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Splits the widget into LIVE_CHART_STRIPS strips with a label line above each, and the time
+-- axis under the last one.
+----------------------------------------------------------------------------------------------------------------------*/
+void LiveChart::paintEvent(QPaintEvent*)
+{
+	QPainter painter(this);
+	painter.fillRect(rect(), Qt::white);
+	QFont font = painter.font();
+	font.setPointSize(8);
+	painter.setFont(font);
+	if (series.IsEmpty())
+	{
+		painter.setPen(Qt::darkGray);
+		painter.drawText(rect(), Qt::AlignCenter, title.isEmpty() ? "No session yet" : title + "\nwaiting for data");
+		return;
+	}
+
+	double stripHeight = (height() - LIVE_CHART_LABEL_HEIGHT) / (double)LIVE_CHART_STRIPS;
+	double plotHeight = stripHeight - LIVE_CHART_LABEL_HEIGHT;
+	for (int strip = 0; strip < LIVE_CHART_STRIPS; strip++)
+	{
+		QRectF plot(0, strip * stripHeight + LIVE_CHART_LABEL_HEIGHT, width() - 1, plotHeight - 4);
+		switch (strip)
+		{
+		case 0:
+			PaintStrip(painter, plot, &LiveBucket::throughput, 1.0 / 1048576, "MB/s", QColor(0, 90, 200));
+			break;
+		case 1:
+			PaintStrip(painter, plot, &LiveBucket::packetRate, 1.0 / 1000, "kpkt/s", QColor(0, 140, 70));
+			break;
+		case 2:
+			PaintStrip(painter, plot, &LiveBucket::lossPercent, 1.0, "loss %", QColor(200, 0, 0));
+			break;
+		case 3:
+			PaintStrip(painter, plot, &LiveBucket::rttUs, 1.0, "RTT us", QColor(140, 60, 170));
+			break;
+		}
+	}
+
+	const std::vector<LiveBucket>& buckets = series.GetBuckets();
+	QRectF axis(0, height() - LIVE_CHART_LABEL_HEIGHT, width() - 1, LIVE_CHART_LABEL_HEIGHT);
+	painter.setPen(Qt::darkGray);
+	painter.drawText(axis, Qt::AlignLeft | Qt::AlignVCenter, FormatSeconds(buckets.front().startSeconds));
+	painter.drawText(axis, Qt::AlignHCenter | Qt::AlignVCenter, QString("%1, %2 ms a point")
+		.arg(title).arg(series.GetSamplesPerBucket() * LIVE_SAMPLE_MS));
+	painter.drawText(axis, Qt::AlignRight | Qt::AlignVCenter, FormatSeconds(buckets.back().endSeconds));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PaintStrip
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void PaintStrip(QPainter& painter, const QRectF& plot, LiveRange LiveBucket::* metric, const double scale,
+			const QString& unit, const QColor& color)
+			- painter : the chart's
+			- plot : where the strip's graph goes, its label goes in the line above
+			- metric : which of the bucket's ranges to draw
+			- scale : multiplies every value, e.g. bytes to MB
+			- unit : label text
+			- color : line color, the band is a lighter version of it
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- The y axis runs from 0 to a bit over the highest max in the series. A bucket without the metric
+-- breaks the line instead of pulling it to 0. The label has the latest and highest values.
+----------------------------------------------------------------------------------------------------------------------*/
+void LiveChart::PaintStrip(QPainter& painter, const QRectF& plot, LiveRange LiveBucket::* metric, const double scale,
+	const QString& unit, const QColor& color)
+{
+	const std::vector<LiveBucket>& buckets = series.GetBuckets();
+	double highest = 0;
+	double latest = LIVE_NO_VALUE;
+	for (const LiveBucket& bucket : buckets)
+	{
+		const LiveRange& range = bucket.*metric;
+		if (range.count == 0)
+			continue;
+		highest = std::max(highest, range.max * scale);
+		latest = range.Mean() * scale;
+	}
+
+	QRectF label(plot.left() + 2, plot.top() - LIVE_CHART_LABEL_HEIGHT, plot.width() - 4, LIVE_CHART_LABEL_HEIGHT);
+	painter.setPen(color);
+	if (latest < 0)
+	{
+		painter.drawText(label, Qt::AlignLeft | Qt::AlignVCenter, QString("%1: not measured by this session").arg(unit));
+		painter.setPen(QColor(220, 220, 220));
+		painter.drawRect(plot);
+		return;
+	}
+	painter.drawText(label, Qt::AlignLeft | Qt::AlignVCenter, QString("%1: %2").arg(unit).arg(latest, 0, 'f', 2));
+	painter.setPen(Qt::darkGray);
+	painter.drawText(label, Qt::AlignRight | Qt::AlignVCenter, QString("max %1").arg(highest, 0, 'f', 2));
+
+	double top = (highest > 0) ? highest * 1.1 : 1.0;
+	double startSeconds = buckets.front().startSeconds;
+	double spanSeconds = std::max(buckets.back().endSeconds - startSeconds, LIVE_SAMPLE_MS / 1000.0);
+	auto x = [&](const double seconds) { return plot.left() + (seconds - startSeconds) / spanSeconds * plot.width(); };
+	auto y = [&](const double value) { return plot.bottom() - value / top * plot.height(); };
+
+	QColor band = color;
+	band.setAlpha(50);
+	QVector<QPointF> line;
+	line.reserve((int)buckets.size());
+	painter.setPen(QPen(color, 1.5));
+	for (const LiveBucket& bucket : buckets)
+	{
+		const LiveRange& range = bucket.*metric;
+		if (range.count == 0)
+		{
+			if (line.size() > 0)
+				painter.drawPolyline(line.data(), line.size());
+			line.clear();
+			continue;
+		}
+		double left = x(bucket.startSeconds);
+		double right = std::max(x(bucket.endSeconds), left + 1);
+		painter.fillRect(QRectF(QPointF(left, y(range.max * scale)), QPointF(right, y(range.min * scale))), band);
+		line.append(QPointF((left + right) / 2, y(range.Mean() * scale)));
+	}
+	if (line.size() > 0)
+		painter.drawPolyline(line.data(), line.size());
+	painter.setPen(QColor(220, 220, 220));
+	painter.drawRect(plot);
+}
+
+//0:07, 12:30 or 1:02:03
+QString LiveChart::FormatSeconds(const double seconds)
+{
+	long long whole = (long long)seconds;
+	if (whole >= 3600)
+		return QString("%1:%2:%3").arg(whole / 3600).arg((whole / 60) % 60, 2, 10, QChar('0')).arg(whole % 60, 2, 10, QChar('0'));
+	return QString("%1:%2").arg(whole / 60).arg(whole % 60, 2, 10, QChar('0'));
+}
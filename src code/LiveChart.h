@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QWidget>
+#include <QPainter>
+#include <QPen>
+#include <QFont>
+#include <QPaintEvent>
+#include <QPointF>
+#include <QVector>
+#include <QColor>
+#include <QString>
+#include "LiveSeries.h"
+
+#define LIVE_CHART_STRIPS 4 //throughput, packet rate, loss, RTT, stacked top to bottom
+#define LIVE_CHART_LABEL_HEIGHT 16 //text line above each strip and under the last one
+
+//draws one session's LiveSeries: per metric a strip with the min to max band and the mean line.
+//Drawing walks the buckets once, so it costs the same however long the session has been going
+class LiveChart : public QWidget
+{
+	Q_OBJECT
+
+public:
+	LiveChart(QWidget* = Q_NULLPTR);
+	virtual ~LiveChart() = default;
+	void SetSeries(const LiveSeries&, const QString&);
+	void Clear();
+
+protected:
+	void paintEvent(QPaintEvent*) override;
+
+private:
+	void PaintStrip(QPainter&, const QRectF&, LiveRange LiveBucket::*, const double, const QString&, const QColor&);
+	static QString FormatSeconds(const double);
+
+	LiveSeries series; //a copy, assigning into it reuses its buckets
+	QString title; //which session it is
+};
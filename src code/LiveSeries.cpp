@@ -0,0 +1,149 @@
+#include "LiveSeries.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: LiveSeries.cpp - A session's sampled rates over time, decimated to a fixed size
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void Add(const double);
+	void Merge(const LiveRange&);
+	double Mean() const;
+	void Add(const LiveSample&);
+	void Clear();
+	const std::vector<LiveBucket>& GetBuckets() const;
+	uint32_t GetSamplesPerBucket() const;
+	bool IsEmpty() const;
+	void Halve();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Every LIVE_SAMPLE_MS each running TransferSession reads its Server's or Client's counters and adds
+-- one LiveSample here. The first LIVE_SERIES_BUCKETS samples get a bucket each. When there is no
+-- room for another, every two neighbours become one and a bucket takes twice as many samples from
+-- then on, so a series is never bigger than LIVE_SERIES_BUCKETS buckets and drawing it costs the
+-- same after an hour as after a second. A halving touches every bucket, but it happens once per
+-- doubling of the session's length, so each sample pays for it about once.
+--
+-- A bucket keeps min, max and mean of each metric rather than one value, the chart draws the
+-- min to max band under the mean so stalls and spikes dont get averaged away.
+----------------------------------------------------------------------------------------------------------------------*/
+
+//skips LIVE_NO_VALUE, which is how a sample says it has nothing for this metric
+void LiveRange::Add(const double value)
+{
+	if (value < 0)
+		return;
+	min = (count == 0) ? value : std::min(min, value);
+	max = (count == 0) ? value : std::max(max, value);
+	sum += value;
+	++count;
+}
+
+void LiveRange::Merge(const LiveRange& other)
+{
+	if (other.count == 0)
+		return;
+	min = (count == 0) ? other.min : std::min(min, other.min);
+	max = (count == 0) ? other.max : std::max(max, other.max);
+	sum += other.sum;
+	count += other.count;
+}
+
+double LiveRange::Mean() const
+{
+	return (count > 0) ? sum / count : LIVE_NO_VALUE;
+}
+
+LiveSeries::LiveSeries()
+	: samplesPerBucket(1)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Add
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Add(const LiveSample& sample)
+			- sample : the latest interval, samples must come in time order
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Goes into the last bucket if it still has room for it, otherwise into a new one, halving the
+-- series first if all LIVE_SERIES_BUCKETS are used. The vector is reserved once, never reallocated.
+----------------------------------------------------------------------------------------------------------------------*/
+void LiveSeries::Add(const LiveSample& sample)
+{
+	if (buckets.empty() || buckets.back().samples >= samplesPerBucket)
+	{
+		if (buckets.size() >= LIVE_SERIES_BUCKETS)
+			Halve();
+		if (buckets.capacity() < LIVE_SERIES_BUCKETS)
+			buckets.reserve(LIVE_SERIES_BUCKETS);
+		LiveBucket bucket = {};
+		bucket.startSeconds = sample.seconds;
+		buckets.push_back(bucket);
+	}
+	LiveBucket& bucket = buckets.back();
+	bucket.endSeconds = sample.seconds;
+	++bucket.samples;
+	bucket.throughput.Add(sample.bytesPerSec);
+	bucket.packetRate.Add(sample.packetsPerSec);
+	bucket.lossPercent.Add(sample.lossPercent);
+	bucket.rttUs.Add(sample.rttUs);
+}
+
+//every pair of neighbours becomes one bucket, an odd one out at the end stays as it is
+void LiveSeries::Halve()
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < buckets.size(); i += 2, ++kept)
+	{
+		LiveBucket merged = buckets[i];
+		if (i + 1 < buckets.size())
+		{
+			const LiveBucket& next = buckets[i + 1];
+			merged.endSeconds = next.endSeconds;
+			merged.samples += next.samples;
+			merged.throughput.Merge(next.throughput);
+			merged.packetRate.Merge(next.packetRate);
+			merged.lossPercent.Merge(next.lossPercent);
+			merged.rttUs.Merge(next.rttUs);
+		}
+		buckets[kept] = merged;
+	}
+	buckets.resize(kept);
+	samplesPerBucket *= 2;
+}
+
+void LiveSeries::Clear()
+{
+	buckets.clear();
+	samplesPerBucket = 1;
+}
+
+const std::vector<LiveBucket>& LiveSeries::GetBuckets() const
+{
+	return buckets;
+}
+
+uint32_t LiveSeries::GetSamplesPerBucket() const
+{
+	return samplesPerBucket;
+}
+
+bool LiveSeries::IsEmpty() const
+{
+	return buckets.empty();
+}
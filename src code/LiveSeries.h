@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#define LIVE_SAMPLE_MS 100 //how often every running session's counters are sampled for the chart
+#define LIVE_SERIES_BUCKETS 512 //buckets a series keeps, whatever the session's length
+#define LIVE_NO_VALUE -1.0 //a sample with nothing to say about loss or RTT, e.g. a plain file send
+
+//counters a Server or Client has bumped so far, read off their atomics when a sample is taken
+struct LiveTotals
+{
+	uint64_t bytes;
+	uint64_t packets; //datagrams, or recv calls that got data on a TCP receive
+	uint64_t lossChecked; //packets whose fate is known yet, lost or not
+	uint64_t lost;
+	uint64_t rttTotalNs;
+	uint64_t rttCount;
+};
+
+//one LIVE_SAMPLE_MS worth of a session, worked out from two LiveTotals
+struct LiveSample
+{
+	double seconds; //since the session started
+	double bytesPerSec;
+	double packetsPerSec;
+	double lossPercent; //or LIVE_NO_VALUE
+	double rttUs; //mean of the round trips in the interval, or LIVE_NO_VALUE
+};
+
+//min, max and mean of one metric over the samples in a bucket
+struct LiveRange
+{
+	double min;
+	double max;
+	double sum;
+	uint32_t count; //0 when none of the bucket's samples had this metric
+
+	void Add(const double);
+	void Merge(const LiveRange&);
+	double Mean() const;
+};
+
+struct LiveBucket
+{
+	double startSeconds;
+	double endSeconds;
+	uint32_t samples;
+	LiveRange throughput; //bytes/s
+	LiveRange packetRate;
+	LiveRange lossPercent;
+	LiveRange rttUs;
+};
+
+//a session's whole history in at most LIVE_SERIES_BUCKETS buckets: once they are all used, neighbours
+//are merged in pairs and each bucket holds twice the samples from then on. Min and max survive the
+//merging, so a one sample stall is still there hours later
+class LiveSeries
+{
+public:
+	LiveSeries();
+	virtual ~LiveSeries() = default;
+	void Add(const LiveSample&);
+	void Clear();
+	const std::vector<LiveBucket>& GetBuckets() const;
+	uint32_t GetSamplesPerBucket() const;
+	bool IsEmpty() const;
+
+private:
+	void Halve();
+
+	std::vector<LiveBucket> buckets;
+	uint32_t samplesPerBucket;
+};
@@ -0,0 +1,1685 @@
+#include "LoopbackBenchmark.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: LoopbackBenchmark.cpp - Headless throughput benchmark of Client/Server over loopback
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	int Run(const QStringList&);
+	std::vector<BenchmarkConfig> BuildSweep(const bool);
+	int CheckTraceOverhead(const bool);
+	bool RunConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunBatchConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunDeltaConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunShardConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunMulticastConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunPingPongConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool OpenMulticastReceivers(const int, struct sockaddr_storage&, std::vector<SOCKET>&);
+	bool OpenShardSenders(const bool, SOCKET, const struct sockaddr_in&, const int, std::vector<SOCKET>&, std::vector<struct sockaddr_storage>&);
+	bool WriteDeltaPair(const BenchmarkConfig&, const QString&, const QString&);
+	void ReadLatencyPercentiles(const QString&, BenchmarkResult&);
+	bool OpenLoopbackSockets(const QString&, SOCKET&, SOCKET&, struct sockaddr_in&);
+	QString GetInputFile(const size_t);
+	QString GetSmallFileSet(const size_t);
+	QJsonObject ResultToJson(const BenchmarkResult&);
+	QString ConfigKey(const QJsonObject&);
+	bool WriteResults(const QString&, const std::vector<BenchmarkResult>&);
+	int CompareWithBaseline(const QString&, const std::vector<BenchmarkResult>&, const double);
+	double GetCpuSeconds();
+	size_t GetPeakRss();
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Started from main with: asn2.exe --benchmark results.json [--baseline old.json] [--tolerance 10] [--quick]
+--                                                           [--trace trace.json]
+--
+-- Runs the real Server and Client classes inside this one process, server on its own thread,
+-- against 127.0.0.1, once for every config BuildSweep lists. For each run it records MB/s and
+-- packets/s as seen by the receiver, process CPU time (user + kernel) and the process peak working
+-- set. Results are written as JSON; if a baseline from an earlier run is given, any config whose MB/s
+-- dropped more than the tolerance is flagged and the exit code is the number of regressions, so it
+-- can be used from a build script. Run lists what else counts against the exit code.
+--
+-- To add a config: name its protocol and say what its fields mean above BenchmarkConfig, add it to
+-- BuildSweep, and if the single file loop in RunConfig cant run it, give it a Run...Config of its own
+-- and branch to that at the top of RunConfig.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION LoopbackBenchmark Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: LoopbackBenchmark(void)
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+-- No WSASocketManager exists in benchmark mode, so WinSock is started here instead.
+----------------------------------------------------------------------------------------------------------------------*/
+LoopbackBenchmark::LoopbackBenchmark()
+{
+	WORD wVersionRequested = MAKEWORD(2, 2);
+	WSADATA wsaData;
+	WSAStartup(wVersionRequested, &wsaData);
+	workDir = QDir::temp().filePath("asn2_benchmark");
+	QDir().mkpath(workDir);
+}
+
+LoopbackBenchmark::~LoopbackBenchmark()
+{
+	for (auto& input : inputFiles)
+	{
+		QFile::remove(input.second);
+	}
+	for (auto& fileSet : smallFileSets)
+	{
+		QDir(fileSet.second).removeRecursively();
+	}
+	QDir().rmdir(workDir);
+	WSACleanup();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Run
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int Run(const QStringList& args)
+		- args : QStringList, command line arguments of the program
+
+-- RETURNS: int : 0 if every config ran and none regressed, otherwise regressions + allocating runs + mismatched
+--                runs + 1 if tracing cost too much (or -1 on bad args)
+--
+-- NOTES:
+-- A single file run whose receive thread still allocated once warmed up counts as a regression
+-- too, with or without a baseline. So does a run whose verify sink found mismatches, counted apart
+-- since a corrupted transfer isnt an allocation problem. And so does tracing going over its budget,
+-- see CheckTraceOverhead, which runs before the sweep with or without --trace.
+-- With --trace the flight recorder is on for the whole sweep and its last events per thread are
+-- written as a Chrome trace at the end.
+----------------------------------------------------------------------------------------------------------------------*/
+int LoopbackBenchmark::Run(const QStringList& args)
+{
+	int benchmarkIndex = args.indexOf("--benchmark");
+	if (benchmarkIndex < 0 || benchmarkIndex + 1 >= args.size())
+	{
+		std::cout << "usage: --benchmark results.json [--baseline old.json] [--tolerance percent] [--quick] [--trace trace.json]" << std::endl;
+		return -1;
+	}
+	QString resultsPath = args.at(benchmarkIndex + 1);
+	int baselineIndex = args.indexOf("--baseline");
+	QString baselinePath = (baselineIndex >= 0 && baselineIndex + 1 < args.size()) ? args.at(baselineIndex + 1) : QString();
+	int toleranceIndex = args.indexOf("--tolerance");
+	double tolerance = (toleranceIndex >= 0 && toleranceIndex + 1 < args.size()) ? args.at(toleranceIndex + 1).toDouble() : 10;
+	bool quick = args.contains("--quick");
+	int traceIndex = args.indexOf("--trace");
+	QString tracePath = (traceIndex >= 0 && traceIndex + 1 < args.size()) ? args.at(traceIndex + 1) : QString();
+	int costlyTracing = CheckTraceOverhead(quick);
+	FlightRecorder::Shared().SetEnabled(!tracePath.isEmpty());
+
+	std::vector<BenchmarkResult> results;
+	int allocatingRuns = 0;
+	int mismatchedRuns = 0;
+	for (const BenchmarkConfig& config : BuildSweep(quick))
+	{
+		BenchmarkResult result;
+		if (!RunConfig(config, result))
+		{
+			std::cout << "skipped " << config.protocol.toStdString() << " " << config.packetSize << "B x" << config.packetCount
+				<< ": could not set up loopback sockets" << std::endl;
+			continue;
+		}
+		std::cout << config.protocol.toStdString() << " size=" << config.packetSize << " count=" << config.packetCount
+			<< " file=" << config.fileSize;
+		if (config.shardCount > 1)
+			std::cout << " shards=" << config.shardCount;
+		if (config.udpOffload)
+			std::cout << " offload";
+		if (config.registeredIo)
+			std::cout << " rio";
+		if (config.encrypted)
+			std::cout << " encrypted";
+		if (config.fecRepair > 0)
+			std::cout << " fec=" << config.fecRepair;
+		if (config.protocol == "UDP-MULTICAST")
+			std::cout << " receivers=" << config.receiverCount;
+		if (config.synthetic)
+			std::cout << " synthetic";
+		if (config.elideZeros)
+			std::cout << " elided";
+		if (config.busyPoll)
+			std::cout << " busy";
+		std::cout << " : " << result.megabytesPerSec << " MB/s, " << result.packetsPerSec << " pkt/s, "
+			<< result.packetsReceived << "/" << config.packetCount << " received, cpu " << result.cpuSeconds << "s";
+		if (result.p99Us > 0)
+			std::cout << (config.protocol.endsWith("-PINGPONG") ? ", rtt p50 " : ", delay p50 ") << result.p50Us << "us p99 " << result.p99Us << "us p99.9 " << result.p999Us << "us";
+		std::cout << std::endl;
+		if (result.steadyAllocations > 0)
+		{
+			++allocatingRuns;
+			std::cout << "ALLOCATIONS " << config.protocol.toStdString() << " size=" << config.packetSize << ": "
+				<< result.steadyAllocations << " heap allocations on the receive thread once warmed up" << std::endl;
+		}
+		if (result.mismatches > 0)
+		{
+			++mismatchedRuns;
+			std::cout << "MISMATCHES " << config.protocol.toStdString() << " size=" << config.packetSize << ": "
+				<< result.mismatches << " writes didnt match the generated payload" << std::endl;
+		}
+		results.push_back(result);
+	}
+	std::cout << TaskScheduler::Shared().GetLoadSummary().toStdString() << std::endl;
+	if (!tracePath.isEmpty())
+	{
+		FlightRecorder::Shared().SetEnabled(false);
+		size_t traceEvents = 0;
+		if (FlightRecorder::Shared().WriteChromeTrace(tracePath, traceEvents))
+			std::cout << traceEvents << " trace events written to " << tracePath.toStdString() << std::endl;
+		else
+			std::cout << "could not write " << tracePath.toStdString() << std::endl;
+	}
+	if (!WriteResults(resultsPath, results))
+	{
+		std::cout << "could not write " << resultsPath.toStdString() << std::endl;
+		return -1;
+	}
+	if (allocatingRuns > 0)
+		std::cout << allocatingRuns << " runs allocated once warmed up" << std::endl;
+	if (mismatchedRuns > 0)
+		std::cout << mismatchedRuns << " runs received data that didnt verify" << std::endl;
+	if (baselinePath.isEmpty())
+		return allocatingRuns + mismatchedRuns + costlyTracing;
+	int regressions = CompareWithBaseline(baselinePath, results, tolerance);
+	return (regressions < 0) ? regressions : regressions + allocatingRuns + mismatchedRuns + costlyTracing;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION CheckTraceOverhead
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int CheckTraceOverhead(const bool quick)
+		- quick : bool, send fewer packets
+
+-- RETURNS: int : 1 if tracing adds more than BENCH_TRACE_OVERHEAD_PERCENT to a UDP run's CPU per packet, else 0
+--
+-- NOTES:
+-- Small datagrams, so the per packet work is as little as it gets and tracing's share as big as it gets.
+-- The run is done untraced and then traced, and both CPU per packet figures are printed, but on
+-- loopback they move by more than 1% from one run to the next on their own, so they arent what's
+-- checked. What's checked is the events the traced run recorded per packet, times what one
+-- enabled scope costs timed back to back on this thread, as a share of the untraced CPU per packet.
+-- Runs before the sweep turns tracing on, SetEnabled starts a new recording so none of this is in --trace's file.
+----------------------------------------------------------------------------------------------------------------------*/
+int LoopbackBenchmark::CheckTraceOverhead(const bool quick)
+{
+	BenchmarkConfig config = { "UDP", 64, quick ? (size_t)100000 : (size_t)1000000, 4096 };
+	FlightRecorder& recorder = FlightRecorder::Shared();
+	recorder.SetEnabled(false);
+	BenchmarkResult untraced;
+	if (!RunConfig(config, untraced) || untraced.packetsReceived == 0)
+	{
+		std::cout << "skipped trace overhead: untraced UDP run received nothing" << std::endl;
+		return 0;
+	}
+
+	recorder.SetEnabled(true);
+	uint64_t recordedBefore = recorder.CountRecorded();
+	BenchmarkResult traced;
+	bool tracedRan = RunConfig(config, traced);
+	uint64_t recorded = recorder.CountRecorded() - recordedBefore;
+
+	uint64_t scopesStartNs = MeasureClockNs();
+	for (int scopes = 0; scopes < BENCH_TRACE_SCOPES; ++scopes)
+	{
+		TraceScope scope(TraceStage::Build, scopes);
+	}
+	double scopeNs = (double)(MeasureClockNs() - scopesStartNs) / BENCH_TRACE_SCOPES;
+	recorder.SetEnabled(false);
+	if (!tracedRan || traced.packetsReceived == 0)
+	{
+		std::cout << "skipped trace overhead: traced UDP run received nothing" << std::endl;
+		return 0;
+	}
+
+	double untracedCpuNs = untraced.cpuSeconds * 1e9 / untraced.packetsReceived;
+	double tracedCpuNs = traced.cpuSeconds * 1e9 / traced.packetsReceived;
+	double eventsPerPacket = (double)recorded / traced.packetsReceived;
+	double overheadPercent = eventsPerPacket * scopeNs / untracedCpuNs * 100;
+	std::cout << "trace overhead UDP size=" << config.packetSize << " count=" << config.packetCount << ": "
+		<< eventsPerPacket << " events/pkt at " << scopeNs << "ns each = " << overheadPercent << "% of "
+		<< untracedCpuNs << "ns cpu/pkt untraced (" << tracedCpuNs << "ns traced)" << std::endl;
+	if (overheadPercent > BENCH_TRACE_OVERHEAD_PERCENT)
+	{
+		std::cout << "TRACE OVERHEAD " << overheadPercent << "% is over the " << BENCH_TRACE_OVERHEAD_PERCENT
+			<< "% budget" << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION BuildSweep
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: std::vector<BenchmarkConfig> BuildSweep(const bool quick)
+		- quick : bool, use a small sweep for a fast sanity run
+
+-- RETURNS: std::vector<BenchmarkConfig> : every combination to run
+--
+-- NOTES:
+-- UDP sizes stay under the 65508 byte datagram limit MainWindowController enforces.
+-- Small files suite is added at the end, quick runs use fewer files.
+-- Then the delta suite, quick runs use a smaller file.
+-- Then the shard suite, doubling the shards up to the cores this machine has.
+-- Then the offload suite, every size once without and once with offload.
+-- Then the Registered I/O suite, small datagrams where the per call cost shows most.
+-- Then the FEC suite, at the 10% and 20% repair points.
+-- Then the encryption suite, from less than a record to several records per packet.
+-- Then the latency suite, for the tail of the one way delay rather than throughput.
+-- Then the multicast suite, the same run fanned out to more and more receivers.
+-- Then the synthetic suite, one mid and one large packet size per protocol.
+-- Then the zero run suite, every size once without and once with elision.
+-- Then the ping-pong suite, a tiny and a full datagram sized message each way of waiting.
+----------------------------------------------------------------------------------------------------------------------*/
+std::vector<BenchmarkConfig> LoopbackBenchmark::BuildSweep(const bool quick)
+{
+	std::vector<QString> protocols = { "TCP", "UDP" };
+	std::vector<size_t> packetSizes = quick ? std::vector<size_t>{ 1024 } : std::vector<size_t>{ 64, 1024, 8192, 60000 };
+	std::vector<size_t> packetCounts = quick ? std::vector<size_t>{ 1000 } : std::vector<size_t>{ 100, 1000, 10000 };
+	std::vector<size_t> fileSizes = quick ? std::vector<size_t>{ 4096 } : std::vector<size_t>{ 4096, 1048576 };
+
+	std::vector<BenchmarkConfig> sweep;
+	for (const QString& protocol : protocols)
+		for (size_t packetSize : packetSizes)
+			for (size_t packetCount : packetCounts)
+				for (size_t fileSize : fileSizes)
+					sweep.push_back({ protocol, packetSize, packetCount, fileSize });
+
+	size_t smallFileCount = quick ? 2000 : 100000;
+	std::vector<size_t> frameSizes = quick ? std::vector<size_t>{ 0, 1048576 } : std::vector<size_t>{ 0, 262144, 1048576, 4194304 };
+	for (size_t frameSize : frameSizes)
+		sweep.push_back({ "TCP-BATCH", frameSize, smallFileCount, 0 });
+
+	size_t deltaFileSize = quick ? 1048576 : 16777216;
+	std::vector<size_t> blockSizes = quick ? std::vector<size_t>{ 0 } : std::vector<size_t>{ 0, 1024, 8192, 65536 };
+	std::vector<size_t> editCounts = quick ? std::vector<size_t>{ 10 } : std::vector<size_t>{ 10, 1000 };
+	for (size_t blockSize : blockSizes)
+		for (size_t editCount : editCounts)
+			sweep.push_back({ "TCP-DELTA", blockSize, editCount, deltaFileSize });
+
+	int maxShards = std::min<int>(std::max<int>(std::thread::hardware_concurrency(), 1), SHARD_MAX_COUNT);
+	size_t shardPacketCount = quick ? 100000 : 1000000;
+	for (const QString& protocol : { QString("UDP-SHARD"), QString("TCP-SHARD") })
+	{
+		for (int shards = 1; shards <= maxShards; shards *= 2)
+		{
+			BenchmarkConfig config = { protocol, 1024, shardPacketCount, 4096 };
+			config.shardCount = shards;
+			sweep.push_back(config);
+		}
+	}
+
+	std::vector<size_t> offloadSizes = quick ? std::vector<size_t>{ 1400 } : std::vector<size_t>{ 512, 1400, 8192 };
+	size_t offloadPacketCount = quick ? 100000 : 1000000;
+	for (size_t packetSize : offloadSizes)
+	{
+		for (bool offload : { false, true })
+		{
+			BenchmarkConfig config = { "UDP-OFFLOAD", packetSize, offloadPacketCount, 4096 };
+			config.udpOffload = offload;
+			sweep.push_back(config);
+		}
+	}
+
+	std::vector<size_t> rioSizes = quick ? std::vector<size_t>{ 64 } : std::vector<size_t>{ 64, 512, 1400 };
+	size_t rioPacketCount = quick ? 100000 : 1000000;
+	for (size_t packetSize : rioSizes)
+	{
+		for (bool registeredIo : { false, true })
+		{
+			BenchmarkConfig config = { "UDP-RIO", packetSize, rioPacketCount, 4096 };
+			config.registeredIo = registeredIo;
+			sweep.push_back(config);
+		}
+	}
+
+	size_t fecPacketCount = quick ? 100000 : 1000000;
+	for (int fecRepair : { 0, 2, 4 })
+	{
+		BenchmarkConfig config = { "UDP-FEC", 1400, fecPacketCount, 4096 };
+		config.fecRepair = fecRepair;
+		sweep.push_back(config);
+	}
+
+	std::vector<size_t> secureSizes = quick ? std::vector<size_t>{ 16384 } : std::vector<size_t>{ 1400, 16384, 65536 };
+	size_t securePacketCount = quick ? 10000 : 100000;
+	for (size_t packetSize : secureSizes)
+	{
+		for (bool encrypted : { false, true })
+		{
+			BenchmarkConfig config = { "TCP-SECURE", packetSize, securePacketCount, 4096 };
+			config.encrypted = encrypted;
+			sweep.push_back(config);
+		}
+	}
+
+	size_t latencyPacketCount = quick ? 20000 : 200000;
+	for (size_t packetSize : { (size_t)64, (size_t)1400 })
+		sweep.push_back({ "UDP-LATENCY", packetSize, latencyPacketCount, 4096 });
+
+	size_t multicastPacketCount = quick ? 20000 : 200000;
+	for (int receiverCount : { 1, 2, 4 })
+	{
+		BenchmarkConfig config = { "UDP-MULTICAST", 1400, multicastPacketCount, 4096 };
+		config.receiverCount = receiverCount;
+		sweep.push_back(config);
+	}
+
+	size_t syntheticPacketCount = quick ? 100000 : 1000000;
+	for (const QString& protocol : { QString("UDP-NULL"), QString("TCP-NULL") })
+	{
+		for (size_t packetSize : { (size_t)1400, (size_t)8192 })
+		{
+			BenchmarkConfig config = { protocol, packetSize, syntheticPacketCount, 4096 };
+			config.synthetic = true;
+			sweep.push_back(config);
+		}
+	}
+
+	size_t sparsePacketCount = quick ? 20000 : 200000;
+	for (size_t packetSize : { (size_t)16384, (size_t)65536 })
+	{
+		for (bool elideZeros : { false, true })
+		{
+			BenchmarkConfig config = { "TCP-SPARSE", packetSize, sparsePacketCount, 4096 };
+			config.elideZeros = elideZeros;
+			sweep.push_back(config);
+		}
+	}
+
+	size_t pingPacketCount = quick ? 10000 : 100000;
+	for (const QString& protocol : { QString("UDP-PINGPONG"), QString("TCP-PINGPONG") })
+	{
+		for (size_t packetSize : { (size_t)64, (size_t)1400 })
+		{
+			for (bool busyPoll : { false, true })
+			{
+				BenchmarkConfig config = { protocol, packetSize, pingPacketCount, 4096 };
+				config.busyPoll = busyPoll;
+				sweep.push_back(config);
+			}
+		}
+	}
+	return sweep;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RunConfig
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool RunConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+		- config : BenchmarkConfig, combination to run
+		- result : BenchmarkResult, filled in with measurements
+
+-- RETURNS: bool : whether the run happened
+--
+-- NOTES:
+-- Server's receive loop runs on a std::thread, Client's send loop runs on this thread, just like
+-- their QThreads would in the GUI. PacketReceived is hooked up as a direct connection so the
+-- counters are updated from the server thread the moment a packet lands.
+-- TCP is done once the server reports the connection closed. UDP is done once every datagram
+-- arrived, or nothing arrived for a second (the rest were lost).
+-- Elapsed time is from the first send until the last packet was seen by the server.
+-- Registered I/O runs swap the server socket for one made for RIO, which ReceiveUdpRio closes itself.
+-- For UDP, the receive thread's allocation count is taken once 10% of the packets are in and at every
+-- report after; PacketReceived is a direct connection so the lambda runs on that thread.
+-- A TCP receive only reports when its connection closes, so it's counted from the accept, when its
+-- buffer is already out of the pool, to the close. Encrypted TCP isnt checked, its handshake sets up
+-- a channel per connection. Batch runs arent either, they open a file per file on purpose, and
+-- neither are shard runs, whose receive threads belong to the Server and never signal.
+-- Synthetic runs hand the server a verify sink and the client a random source, the mismatches
+-- come from the last SinkStatsReady.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::RunConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+{
+	if (config.protocol == "TCP-BATCH")
+		return RunBatchConfig(config, result);
+	if (config.protocol == "TCP-DELTA")
+		return RunDeltaConfig(config, result);
+	if (config.protocol.endsWith("-SHARD"))
+		return RunShardConfig(config, result);
+	if (config.protocol == "UDP-MULTICAST")
+		return RunMulticastConfig(config, result);
+	if (config.protocol.endsWith("-PINGPONG"))
+		return RunPingPongConfig(config, result);
+
+	QString inputPath = GetInputFile(config.fileSize);
+	QString outputPath = QDir(workDir).filePath("received.txt");
+	QFile::remove(outputPath);
+
+	SOCKET serverSocket;
+	SOCKET clientSocket;
+	struct sockaddr_in serverAddr;
+	bool isTcp = config.protocol.startsWith("TCP");
+	if (!OpenLoopbackSockets(isTcp ? "TCP" : "UDP", serverSocket, clientSocket, serverAddr))
+		return false;
+	if (config.registeredIo)
+	{
+		closesocket(serverSocket);
+		serverSocket = OpenRioSocket(AF_INET);
+		int addrLength = sizeof(serverAddr);
+		if (serverSocket == INVALID_SOCKET || getsockname(serverSocket, (struct sockaddr*)&serverAddr, &addrLength) != 0)
+		{
+			closesocket(clientSocket);
+			return false;
+		}
+		serverAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	}
+
+	std::atomic<size_t> packetsReceived(0);
+	std::atomic<bool> connectionClosed(false);
+	std::atomic<long long> lastReceiveNs(0);
+	std::atomic<size_t> warmPackets(0);
+	std::atomic<uint64_t> warmAllocations(0);
+	std::atomic<uint64_t> lastAllocations(0);
+	bool isLatency = (config.protocol == "UDP-LATENCY");
+	auto now = []() {
+		return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	};
+
+	Server server;
+	QObject::connect(&server, &Server::PacketReceived, [&](const size_t packetSize, const size_t packetCount) {
+		if (packetSize == (size_t)-1) //tcp connection accepted marker
+		{
+			warmPackets = 1;
+			warmAllocations = GetThreadAllocations();
+			return;
+		}
+		packetsReceived = packetCount;
+		lastReceiveNs = now();
+		if (isTcp)
+			connectionClosed = true;
+		else if (warmPackets == 0 && packetCount >= config.packetCount / 10)
+		{
+			warmPackets = packetCount;
+			warmAllocations = GetThreadAllocations();
+		}
+		lastAllocations = GetThreadAllocations();
+	});
+	std::atomic<uint64_t> mismatches(0);
+	QObject::connect(&server, &Server::SinkStatsReady, [&](const QString&, const quint64 sinkMismatches) {
+		mismatches = sinkMismatches;
+	});
+	TransferOptions options;
+	if (config.synthetic)
+	{
+		options.payloadSource = PayloadSource::Random;
+		options.payloadSink = PayloadSink::Verify;
+	}
+	options.encryptionKey = config.encrypted ? BENCH_SECURE_KEY : QString();
+	server.UsePayloadSink(options);
+	std::thread serverThread([&]() {
+		if (isTcp)
+			server.ReceiveTcpPackets(serverSocket, outputPath, config.packetSize, config.encrypted, config.elideZeros);
+		else if (isLatency)
+			server.ReceiveUdpMeasure(serverSocket, outputPath);
+		else if (config.fecRepair > 0)
+			server.ReceiveUdpFec(serverSocket, outputPath);
+		else if (config.registeredIo)
+			server.ReceiveUdpRio(serverSocket, outputPath);
+		else
+			server.ReceiveUdpPackets(serverSocket, outputPath, config.udpOffload);
+	});
+
+	struct sockaddr_storage serverStorage;
+	memset(&serverStorage, 0, sizeof(serverStorage));
+	memcpy(&serverStorage, &serverAddr, sizeof(serverAddr));
+
+	double cpuBefore = GetCpuSeconds();
+	long long startNs = now();
+	Client client;
+	options.udpOffload = config.udpOffload;
+	options.registeredIo = config.registeredIo;
+	options.encrypted = config.encrypted;
+	options.elideZeros = config.elideZeros;
+	options.fecRepair = config.fecRepair;
+	if (isLatency)
+	{
+		options.mode = TransferMode::Measure;
+		options.targetRate = BENCH_LATENCY_RATE;
+	}
+	if (isTcp)
+		client.SendTcpPackets(clientSocket, inputPath, config.packetSize, config.packetCount, options);
+	else
+		client.SendUdpPackets(clientSocket, inputPath, config.packetSize, config.packetCount, serverStorage, options);
+
+	//client closes its own socket when done, wait for server side to catch up
+	long long sendEndNs = now();
+	const long long idleLimitNs = 1000000000LL;
+	const long long tcpLimitNs = 30 * idleLimitNs;
+	while (true)
+	{
+		long long lastSeen = lastReceiveNs.load();
+		long long since = now() - ((lastSeen > sendEndNs) ? lastSeen : sendEndNs);
+		if (isTcp ? (connectionClosed || since > tcpLimitNs) : (packetsReceived >= config.packetCount || since > idleLimitNs))
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double cpuAfter = GetCpuSeconds();
+	server.StopPolling();
+	serverThread.join();
+	if (!config.registeredIo)
+		closesocket(serverSocket);
+	long long endNs = lastReceiveNs.load();
+	result.config = config;
+	if (isLatency)
+		ReadLatencyPercentiles(outputPath, result);
+	QFile::remove(outputPath);
+	if (warmPackets > 0 && !config.encrypted)
+		result.steadyAllocations = lastAllocations - warmAllocations;
+	result.mismatches = mismatches;
+	result.packetsReceived = packetsReceived;
+	result.bytesReceived = result.packetsReceived * config.packetSize;
+	result.seconds = (endNs > startNs) ? (endNs - startNs) / 1e9 : 0;
+	result.megabytesPerSec = (result.seconds > 0) ? result.bytesReceived / (1024.0 * 1024.0) / result.seconds : 0;
+	result.packetsPerSec = (result.seconds > 0) ? result.packetsReceived / result.seconds : 0;
+	result.cpuSeconds = cpuAfter - cpuBefore;
+	result.peakRssBytes = GetPeakRss();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RunBatchConfig
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool RunBatchConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+		- config : BenchmarkConfig, TCP-BATCH combination to run
+		- result : BenchmarkResult, filled in with measurements, packets are files here
+
+-- RETURNS: bool : whether the run happened
+--
+-- NOTES:
+-- Same threading as RunConfig but with SendTcpBatch/ReceiveTcpBatch. Done once every file
+-- was written on the server side, or nothing arrived for 30s. Time includes the server's disk writes.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::RunBatchConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+{
+	QString inputDir = GetSmallFileSet(config.packetCount);
+	QString outputDir = QDir(workDir).filePath("received_batch");
+	QDir(outputDir).removeRecursively();
+	QDir().mkpath(outputDir);
+
+	SOCKET serverSocket;
+	SOCKET clientSocket;
+	struct sockaddr_in serverAddr;
+	if (!OpenLoopbackSockets("TCP", serverSocket, clientSocket, serverAddr))
+		return false;
+
+	std::atomic<size_t> filesReceived(0);
+	std::atomic<size_t> bytesReceived(0);
+	std::atomic<long long> lastReceiveNs(0);
+	auto now = []() {
+		return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	};
+
+	Server server;
+	QObject::connect(&server, &Server::PacketReceived, [&](const size_t receivedBytes, const size_t fileCount) {
+		if (receivedBytes == (size_t)-1) //connection accepted marker
+			return;
+		bytesReceived += receivedBytes;
+		filesReceived = fileCount;
+		lastReceiveNs = now();
+	});
+	std::thread serverThread([&]() {
+		server.ReceiveTcpBatch(serverSocket, outputDir);
+	});
+
+	double cpuBefore = GetCpuSeconds();
+	long long startNs = now();
+	Client client;
+	TransferOptions options;
+	options.mode = TransferMode::Batch;
+	options.packFrameSize = config.packetSize;
+	client.SendTcpBatch(clientSocket, inputDir, options);
+
+	long long sendEndNs = now();
+	const long long idleLimitNs = 30 * 1000000000LL;
+	while (filesReceived < config.packetCount)
+	{
+		long long lastSeen = lastReceiveNs.load();
+		if (now() - ((lastSeen > sendEndNs) ? lastSeen : sendEndNs) > idleLimitNs)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double cpuAfter = GetCpuSeconds();
+	server.StopPolling();
+	serverThread.join();
+	closesocket(serverSocket);
+	QDir(outputDir).removeRecursively();
+
+	long long endNs = lastReceiveNs.load();
+	result.config = config;
+	result.packetsReceived = filesReceived;
+	result.bytesReceived = bytesReceived;
+	result.seconds = (endNs > startNs) ? (endNs - startNs) / 1e9 : 0;
+	result.megabytesPerSec = (result.seconds > 0) ? result.bytesReceived / (1024.0 * 1024.0) / result.seconds : 0;
+	result.packetsPerSec = (result.seconds > 0) ? result.packetsReceived / result.seconds : 0;
+	result.cpuSeconds = cpuAfter - cpuBefore;
+	result.peakRssBytes = GetPeakRss();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RunDeltaConfig
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool RunDeltaConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+		- config : BenchmarkConfig, TCP-DELTA combination to run
+		- result : BenchmarkResult, filled in with measurements, one packet is one synced file
+
+-- RETURNS: bool : whether the run happened
+--
+-- NOTES:
+-- Same threading as RunConfig but with SendTcpDelta/ReceiveTcpDelta. The server's old copy is
+-- rewritten before every run since a successful sync replaces it. MB/s is file size over time,
+-- so it can be compared against a TCP run of the same file; bytesReceived is the wire bytes.
+-- Done once the server applied the delta, or nothing happened for 30s.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::RunDeltaConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+{
+	QString newPath = QDir(workDir).filePath("delta_new.bin");
+	QString oldPath = QDir(workDir).filePath("delta_old.bin");
+	if (!WriteDeltaPair(config, newPath, oldPath))
+		return false;
+
+	SOCKET serverSocket;
+	SOCKET clientSocket;
+	struct sockaddr_in serverAddr;
+	if (!OpenLoopbackSockets("TCP", serverSocket, clientSocket, serverAddr))
+		return false;
+
+	std::atomic<size_t> filesUpdated(0);
+	std::atomic<size_t> wireBytes(0);
+	std::atomic<long long> lastReceiveNs(0);
+	auto now = []() {
+		return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	};
+
+	Server server;
+	QObject::connect(&server, &Server::PacketReceived, [&](const size_t receivedBytes, const size_t fileCount) {
+		if (receivedBytes == (size_t)-1) //connection accepted marker
+			return;
+		wireBytes = receivedBytes;
+		filesUpdated = fileCount;
+		lastReceiveNs = now();
+	});
+	std::thread serverThread([&]() {
+		server.ReceiveTcpDelta(serverSocket, oldPath);
+	});
+
+	double cpuBefore = GetCpuSeconds();
+	long long startNs = now();
+	Client client;
+	TransferOptions options;
+	options.mode = TransferMode::Delta;
+	options.deltaBlockSize = config.packetSize;
+	client.SendTcpDelta(clientSocket, newPath, options);
+
+	long long sendEndNs = now();
+	const long long idleLimitNs = 30 * 1000000000LL;
+	while (filesUpdated < 1 && now() - sendEndNs < idleLimitNs)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double cpuAfter = GetCpuSeconds();
+	server.StopPolling();
+	serverThread.join();
+	closesocket(serverSocket);
+	QFile::remove(newPath);
+	QFile::remove(oldPath);
+
+	long long endNs = lastReceiveNs.load();
+	result.config = config;
+	result.packetsReceived = filesUpdated;
+	result.bytesReceived = wireBytes;
+	result.seconds = (endNs > startNs) ? (endNs - startNs) / 1e9 : 0;
+	result.megabytesPerSec = (result.seconds > 0 && filesUpdated > 0) ? config.fileSize / (1024.0 * 1024.0) / result.seconds : 0;
+	result.packetsPerSec = (result.seconds > 0) ? result.packetsReceived / result.seconds : 0;
+	result.cpuSeconds = cpuAfter - cpuBefore;
+	result.peakRssBytes = GetPeakRss();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RunShardConfig
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool RunShardConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+		- config : BenchmarkConfig, UDP-SHARD or TCP-SHARD combination to run
+		- result : BenchmarkResult, filled in with measurements
+
+-- RETURNS: bool : whether the run happened
+--
+-- NOTES:
+-- Server::ReceiveSharded runs on a std::thread like RunConfig's server. The sending side has one
+-- Client per shard on a thread each, so one sending core doesnt cap what the shards can show.
+-- PacketReceived comes from the shards' merger every SHARD_MERGE_MS, so end times are that coarse.
+-- Done like RunConfig: every packet arrived, or nothing arrived for 1s (UDP) / 30s (TCP).
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::RunShardConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+{
+	bool isTcp = config.protocol.startsWith("TCP");
+	QString inputPath = GetInputFile(config.fileSize);
+	QString outputPath = QDir(workDir).filePath("received_shards.txt");
+	QFile::remove(outputPath);
+
+	SOCKET serverSocket;
+	SOCKET clientSocket;
+	struct sockaddr_in serverAddr;
+	if (!OpenLoopbackSockets(isTcp ? "TCP" : "UDP", serverSocket, clientSocket, serverAddr))
+		return false;
+	std::vector<SOCKET> listeners;
+	std::vector<SOCKET> senders;
+	std::vector<struct sockaddr_storage> destinations;
+	if (!OpenShardListeners(serverSocket, config.shardCount, listeners))
+	{
+		closesocket(clientSocket);
+		closesocket(serverSocket);
+		return false;
+	}
+	if (!OpenShardSenders(isTcp, clientSocket, serverAddr, config.shardCount, senders, destinations))
+	{
+		for (SOCKET listener : listeners)
+			closesocket(listener);
+		return false;
+	}
+
+	std::atomic<size_t> packetsReceived(0);
+	std::atomic<size_t> bytesReceived(0);
+	std::atomic<long long> lastReceiveNs(0);
+	auto now = []() {
+		return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	};
+
+	Server server;
+	QObject::connect(&server, &Server::PacketReceived, [&](const size_t receivedBytes, const size_t packetCount) {
+		bytesReceived += receivedBytes;
+		packetsReceived = packetCount;
+		lastReceiveNs = now();
+	});
+	std::thread serverThread([&]() {
+		server.ReceiveSharded(listeners, outputPath, isTcp ? config.packetSize : 0);
+	});
+
+	double cpuBefore = GetCpuSeconds();
+	long long startNs = now();
+	std::vector<std::thread> senderThreads;
+	for (int shard = 0; shard < config.shardCount; ++shard)
+	{
+		size_t shardPackets = config.packetCount / config.shardCount + ((size_t)shard < config.packetCount % config.shardCount ? 1 : 0);
+		senderThreads.emplace_back([&, shard, shardPackets]() {
+			Client client;
+			TransferOptions options;
+			if (isTcp)
+				client.SendTcpPackets(senders[shard], inputPath, config.packetSize, shardPackets, options);
+			else
+				client.SendUdpPackets(senders[shard], inputPath, config.packetSize, shardPackets, destinations[shard], options);
+		});
+	}
+	for (std::thread& senderThread : senderThreads)
+	{
+		senderThread.join();
+	}
+
+	long long sendEndNs = now();
+	const long long idleLimitNs = (isTcp ? 30 : 1) * 1000000000LL;
+	while (packetsReceived < config.packetCount)
+	{
+		long long lastSeen = lastReceiveNs.load();
+		if (now() - ((lastSeen > sendEndNs) ? lastSeen : sendEndNs) > idleLimitNs)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double cpuAfter = GetCpuSeconds();
+	server.StopPolling();
+	serverThread.join();
+	for (SOCKET listener : listeners)
+		closesocket(listener);
+	QFile::remove(outputPath);
+
+	long long endNs = lastReceiveNs.load();
+	result.config = config;
+	result.packetsReceived = packetsReceived;
+	result.bytesReceived = bytesReceived;
+	result.seconds = (endNs > startNs) ? (endNs - startNs) / 1e9 : 0;
+	result.megabytesPerSec = (result.seconds > 0) ? result.bytesReceived / (1024.0 * 1024.0) / result.seconds : 0;
+	result.packetsPerSec = (result.seconds > 0) ? result.packetsReceived / result.seconds : 0;
+	result.cpuSeconds = cpuAfter - cpuBefore;
+	result.peakRssBytes = GetPeakRss();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RunPingPongConfig
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool RunPingPongConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+		- config : BenchmarkConfig, UDP-PINGPONG or TCP-PINGPONG combination to run
+		- result : BenchmarkResult, filled in with measurements, p50Us/p99Us/p999Us are round trips
+
+-- RETURNS: bool : whether the run happened
+--
+-- NOTES:
+-- The server echoes on a std::thread like RunConfig's, the client's SendPingPong runs here and
+-- only returns once the last echo is back (or timed out), so there is nothing to wait for after.
+-- The rates are messages each way, packetsReceived is what the server echoed.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::RunPingPongConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+{
+	QString inputPath = GetInputFile(config.fileSize);
+	SOCKET serverSocket;
+	SOCKET clientSocket;
+	struct sockaddr_in serverAddr;
+	bool isTcp = config.protocol.startsWith("TCP");
+	if (!OpenLoopbackSockets(isTcp ? "TCP" : "UDP", serverSocket, clientSocket, serverAddr))
+		return false;
+
+	std::atomic<size_t> packetsEchoed(0);
+	Server server;
+	QObject::connect(&server, &Server::PacketReceived, [&](const size_t packetSize, const size_t packetCount) {
+		if (packetSize != (size_t)-1) //tcp connection accepted marker
+			packetsEchoed = packetCount;
+	});
+	std::thread serverThread([&]() {
+		if (isTcp)
+			server.EchoTcpPackets(serverSocket, config.packetSize, config.busyPoll);
+		else
+			server.EchoUdpPackets(serverSocket, config.busyPoll);
+	});
+
+	struct sockaddr_storage serverStorage;
+	memset(&serverStorage, 0, sizeof(serverStorage));
+	memcpy(&serverStorage, &serverAddr, sizeof(serverAddr));
+	Client client;
+	QObject::connect(&client, &Client::PingStatsReady, [&](const QString&, const double p50Us, const double p99Us, const double p999Us) {
+		result.p50Us = p50Us;
+		result.p99Us = p99Us;
+		result.p999Us = p999Us;
+	});
+	TransferOptions options;
+	options.mode = TransferMode::PingPong;
+	options.busyPoll = config.busyPoll;
+	double cpuBefore = GetCpuSeconds();
+	auto start = std::chrono::steady_clock::now();
+	client.SendPingPong(clientSocket, isTcp, inputPath, config.packetSize, config.packetCount, serverStorage, options);
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double cpuAfter = GetCpuSeconds();
+	server.StopPolling();
+	serverThread.join();
+	closesocket(serverSocket);
+
+	result.config = config;
+	result.packetsReceived = packetsEchoed;
+	result.bytesReceived = result.packetsReceived * config.packetSize;
+	result.megabytesPerSec = (result.seconds > 0) ? result.bytesReceived / (1024.0 * 1024.0) / result.seconds : 0;
+	result.packetsPerSec = (result.seconds > 0) ? result.packetsReceived / result.seconds : 0;
+	result.cpuSeconds = cpuAfter - cpuBefore;
+	result.peakRssBytes = GetPeakRss();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RunMulticastConfig
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool RunMulticastConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+		- config : BenchmarkConfig, UDP-MULTICAST combination to run
+		- result : BenchmarkResult, filled in with measurements
+
+-- RETURNS: bool : whether the run happened, false if this host has no multicast route to join on
+--
+-- NOTES:
+-- One Client sends to BENCH_MULTICAST_GROUP and receiverCount Servers, each on its own std::thread
+-- and socket, all joined to it on the same port. SendUdpPackets only returns once NACKs stopped
+-- coming for MULTICAST_LINGER_MS, then it's done like RunConfig: every receiver has every packet,
+-- or nothing arrived for a second.
+-- packetsReceived and the rates are the slowest receiver's, bytesReceived is what all of them got.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::RunMulticastConfig(const BenchmarkConfig& config, BenchmarkResult& result)
+{
+	QString inputPath = GetInputFile(config.fileSize);
+	struct sockaddr_storage group;
+	std::vector<SOCKET> receivers;
+	if (!ParseMulticastGroup(BENCH_MULTICAST_GROUP, group) || !OpenMulticastReceivers(config.receiverCount, group, receivers))
+		return false;
+	SOCKET clientSocket = socket(PF_INET, SOCK_DGRAM, 0);
+	if (clientSocket == INVALID_SOCKET)
+	{
+		for (SOCKET receiver : receivers)
+			closesocket(receiver);
+		return false;
+	}
+	unsigned long on = 1;
+	ioctlsocket(clientSocket, FIONBIO, &on);
+
+	std::vector<std::atomic<size_t>> packetsReceived(receivers.size());
+	std::atomic<long long> lastReceiveNs(0);
+	auto now = []() {
+		return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	};
+
+	std::vector<std::unique_ptr<Server>> servers;
+	std::vector<std::thread> serverThreads;
+	std::vector<QString> outputPaths;
+	for (size_t receiver = 0; receiver < receivers.size(); ++receiver)
+	{
+		outputPaths.push_back(QDir(workDir).filePath(QString("received_multicast_%1.txt").arg(receiver)));
+		QFile::remove(outputPaths.back());
+		servers.emplace_back(new Server);
+		QObject::connect(servers.back().get(), &Server::PacketReceived, [&, receiver](const size_t, const size_t packetCount) {
+			packetsReceived[receiver] = packetCount;
+			lastReceiveNs = now();
+		});
+	}
+	for (size_t receiver = 0; receiver < receivers.size(); ++receiver)
+	{
+		serverThreads.emplace_back([&, receiver]() {
+			servers[receiver]->ReceiveUdpMulticast(receivers[receiver], outputPaths[receiver]);
+		});
+	}
+
+	double cpuBefore = GetCpuSeconds();
+	long long startNs = now();
+	Client client;
+	TransferOptions options;
+	options.targetRate = BENCH_MULTICAST_RATE;
+	client.SendUdpPackets(clientSocket, inputPath, config.packetSize, config.packetCount, group, options);
+
+	auto slowest = [&]() {
+		size_t fewest = config.packetCount;
+		for (const std::atomic<size_t>& received : packetsReceived)
+			fewest = std::min<size_t>(fewest, received);
+		return fewest;
+	};
+	long long sendEndNs = now();
+	const long long idleLimitNs = 1000000000LL;
+	while (slowest() < config.packetCount)
+	{
+		long long lastSeen = lastReceiveNs.load();
+		if (now() - ((lastSeen > sendEndNs) ? lastSeen : sendEndNs) > idleLimitNs)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double cpuAfter = GetCpuSeconds();
+	for (size_t receiver = 0; receiver < receivers.size(); ++receiver)
+	{
+		servers[receiver]->StopPolling();
+		serverThreads[receiver].join();
+		closesocket(receivers[receiver]);
+		QFile::remove(outputPaths[receiver]);
+	}
+
+	long long endNs = lastReceiveNs.load();
+	size_t totalReceived = 0;
+	for (const std::atomic<size_t>& received : packetsReceived)
+		totalReceived += received;
+	result.config = config;
+	result.packetsReceived = slowest();
+	result.bytesReceived = totalReceived * config.packetSize;
+	result.seconds = (endNs > startNs) ? (endNs - startNs) / 1e9 : 0;
+	result.megabytesPerSec = (result.seconds > 0) ? result.packetsReceived * config.packetSize / (1024.0 * 1024.0) / result.seconds : 0;
+	result.packetsPerSec = (result.seconds > 0) ? result.packetsReceived / result.seconds : 0;
+	result.cpuSeconds = cpuAfter - cpuBefore;
+	result.peakRssBytes = GetPeakRss();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION OpenMulticastReceivers
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool OpenMulticastReceivers(const int receiverCount, struct sockaddr_storage& group, std::vector<SOCKET>& receivers)
+		- receiverCount : number of sockets wanted
+		- group : the group to join, its port is set to the one they all got
+		- receivers : set to one non blocking socket per receiver
+
+-- RETURNS: bool : whether every socket joined. If not, every socket made is closed
+--
+-- NOTES:
+-- Same as WSASocketManager does for a multicast receive: SO_REUSEADDR so they can share a port,
+-- the first one takes any free port and the rest bind the same.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::OpenMulticastReceivers(const int receiverCount, struct sockaddr_storage& group, std::vector<SOCKET>& receivers)
+{
+	struct sockaddr_in local;
+	memset((char*)&local, 0, sizeof(local));
+	local.sin_family = AF_INET;
+	local.sin_port = htons(0);
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	for (int receiver = 0; receiver < receiverCount; ++receiver)
+	{
+		SOCKET receiveSocket = socket(PF_INET, SOCK_DGRAM, 0);
+		BOOL reuse = TRUE;
+		unsigned long on = 1;
+		int localLength = sizeof(local);
+		bool ready = receiveSocket != INVALID_SOCKET
+			&& setsockopt(receiveSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse)) == 0
+			&& ioctlsocket(receiveSocket, FIONBIO, &on) == 0
+			&& bind(receiveSocket, (struct sockaddr*)&local, sizeof(local)) == 0
+			&& getsockname(receiveSocket, (struct sockaddr*)&local, &localLength) == 0
+			&& JoinMulticastGroup(receiveSocket, group);
+		if (receiveSocket != INVALID_SOCKET)
+			receivers.push_back(receiveSocket);
+		if (!ready)
+		{
+			for (SOCKET opened : receivers)
+				closesocket(opened);
+			receivers.clear();
+			return false;
+		}
+	}
+	((struct sockaddr_in*)&group)->sin_port = local.sin_port;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION OpenShardSenders
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool OpenShardSenders(const bool isTcp, SOCKET clientSocket, const struct sockaddr_in& serverAddr,
+	const int shardCount, std::vector<SOCKET>& senders, std::vector<struct sockaddr_storage>& destinations)
+		- isTcp : bool, TCP or UDP
+		- clientSocket : SOCKET, from OpenLoopbackSockets, becomes sender 0
+		- serverAddr : struct sockaddr_in, shard 0's address
+		- shardCount : number of senders wanted
+		- senders : set to one socket per shard, connected to that shard for TCP
+		- destinations : set to each shard's address
+
+-- RETURNS: bool : whether every sender is ready. If not, every socket made (and clientSocket) is closed
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::OpenShardSenders(const bool isTcp, SOCKET clientSocket, const struct sockaddr_in& serverAddr,
+	const int shardCount, std::vector<SOCKET>& senders, std::vector<struct sockaddr_storage>& destinations)
+{
+	struct sockaddr_storage base;
+	memset(&base, 0, sizeof(base));
+	memcpy(&base, &serverAddr, sizeof(serverAddr));
+	destinations.clear();
+	for (int shard = 0; shard < shardCount; ++shard)
+	{
+		destinations.push_back(base);
+		ShardAddress(destinations.back(), shard);
+	}
+
+	bool ready = true;
+	if (isTcp)
+	{
+		ready = ConnectShards(clientSocket, shardCount, senders);
+	}
+	else
+	{
+		senders.assign(1, clientSocket);
+		unsigned long on = 1;
+		for (int shard = 1; shard < shardCount && ready; ++shard)
+		{
+			SOCKET sender = socket(PF_INET, SOCK_DGRAM, 0);
+			ready = (sender != INVALID_SOCKET);
+			if (ready)
+			{
+				ioctlsocket(sender, FIONBIO, &on);
+				senders.push_back(sender);
+			}
+		}
+	}
+	if (!ready)
+	{
+		for (SOCKET sender : senders)
+			closesocket(sender);
+		senders.clear();
+	}
+	return ready;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteDeltaPair
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool WriteDeltaPair(const BenchmarkConfig& config, const QString& newPath, const QString& oldPath)
+		- config : BenchmarkConfig, fileSize and number of edits
+		- newPath : QString, where the client's new version goes
+		- oldPath : QString, where the server's old copy goes
+
+-- RETURNS: bool : whether both files were written
+--
+-- NOTES:
+-- Random bytes from a fixed seed so the rolling checksum cant match by accident like it would
+-- on repeated text. The new version overwrites packetCount random 64 byte spots of the old one
+-- and inserts 100 bytes in the middle, so every block after the insert is shifted.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::WriteDeltaPair(const BenchmarkConfig& config, const QString& newPath, const QString& oldPath)
+{
+	std::mt19937 generator(1234);
+	std::string oldContent(config.fileSize, '\0');
+	for (char& c : oldContent)
+		c = (char)(generator() & 0xFF);
+
+	std::string newContent = oldContent;
+	std::uniform_int_distribution<size_t> spots(0, (config.fileSize > 64) ? config.fileSize - 64 : 0);
+	for (size_t i = 0; i < config.packetCount; i++)
+	{
+		size_t spot = spots(generator);
+		for (size_t j = 0; j < 64 && spot + j < newContent.size(); j++)
+			newContent[spot + j] = (char)(generator() & 0xFF);
+	}
+	newContent.insert(newContent.size() / 2, std::string(100, 'x'));
+
+	std::ofstream oldFile(oldPath.toStdString(), std::ofstream::binary | std::ofstream::trunc);
+	oldFile.write(oldContent.c_str(), oldContent.size());
+	std::ofstream newFile(newPath.toStdString(), std::ofstream::binary | std::ofstream::trunc);
+	newFile.write(newContent.c_str(), newContent.size());
+	return oldFile.good() && newFile.good();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadLatencyPercentiles
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReadLatencyPercentiles(const QString& logPath, BenchmarkResult& result)
+		- logPath : QString, the log ReceiveUdpMeasure wrote
+		- result : BenchmarkResult, p50Us, p99Us and p999Us are filled in
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Send and receive times are both QueryPerformanceCounter ns on the same machine, so their
+-- difference is the one way delay with no clock offset to take out.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackBenchmark::ReadLatencyPercentiles(const QString& logPath, BenchmarkResult& result)
+{
+	std::ifstream log(logPath.toStdString());
+	std::vector<double> delays;
+	delays.reserve(result.config.packetCount);
+	std::string line;
+	std::getline(log, line); //header
+	while (std::getline(log, line))
+	{
+		unsigned long long sequence, sendNs, receiveNs, bytes;
+		if (sscanf(line.c_str(), "%llu,%llu,%llu,%llu", &sequence, &sendNs, &receiveNs, &bytes) == 4 && receiveNs >= sendNs)
+			delays.push_back((receiveNs - sendNs) / 1000.0);
+	}
+	if (delays.empty())
+		return;
+
+	auto percentile = [&delays](const double fraction) {
+		size_t rank = std::min(delays.size() - 1, (size_t)(fraction * delays.size()));
+		std::nth_element(delays.begin(), delays.begin() + rank, delays.end());
+		return delays[rank];
+	};
+	result.p50Us = percentile(0.5);
+	result.p99Us = percentile(0.99);
+	result.p999Us = percentile(0.999);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION OpenLoopbackSockets
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool OpenLoopbackSockets(const QString& protocol, SOCKET& serverSocket, SOCKET& clientSocket,
+	struct sockaddr_in& serverAddr)
+		- protocol : QString, TCP or UDP
+		- serverSocket : SOCKET, set to the bound (and for TCP, listening) server socket
+		- clientSocket : SOCKET, set to the client socket, connected for TCP
+		- serverAddr : struct sockaddr_in, set to the server's loopback address
+
+-- RETURNS: bool : whether both sockets are ready
+--
+-- NOTES:
+-- Same setup WSASocketManager does (non blocking sockets), but on an ephemeral loopback port
+-- so runs never clash with a GUI instance. listen is called before connecting so the connect
+-- doesnt race the server thread's first listen.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::OpenLoopbackSockets(const QString& protocol, SOCKET& serverSocket, SOCKET& clientSocket, struct sockaddr_in& serverAddr)
+{
+	int protocCode = (protocol == "UDP") ? SOCK_DGRAM : SOCK_STREAM;
+	unsigned long on = 1;
+	serverSocket = socket(PF_INET, protocCode, 0);
+	if (serverSocket == INVALID_SOCKET)
+		return false;
+	ioctlsocket(serverSocket, FIONBIO, &on);
+
+	memset((char*)&serverAddr, 0, sizeof(serverAddr));
+	serverAddr.sin_family = AF_INET;
+	serverAddr.sin_port = htons(0);
+	serverAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	int addrLen = sizeof(serverAddr);
+	if (bind(serverSocket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) == -1
+		|| getsockname(serverSocket, (struct sockaddr*)&serverAddr, &addrLen) == -1
+		|| (protocCode == SOCK_STREAM && listen(serverSocket, 5) == -1))
+	{
+		closesocket(serverSocket);
+		return false;
+	}
+
+	clientSocket = socket(PF_INET, protocCode, 0);
+	if (clientSocket == INVALID_SOCKET)
+	{
+		closesocket(serverSocket);
+		return false;
+	}
+	ioctlsocket(clientSocket, FIONBIO, &on);
+	if (protocCode == SOCK_STREAM && !WinApiConnectToSocket(clientSocket, serverAddr))
+	{
+		closesocket(clientSocket);
+		closesocket(serverSocket);
+		return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetInputFile
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString GetInputFile(const size_t fileSize)
+		- fileSize : unsigned int, size of file in bytes
+
+-- RETURNS: QString : path to a text file of that size, made once and reused for the whole sweep
+----------------------------------------------------------------------------------------------------------------------*/
+QString LoopbackBenchmark::GetInputFile(const size_t fileSize)
+{
+	auto existing = inputFiles.find(fileSize);
+	if (existing != inputFiles.end())
+		return existing->second;
+
+	QString path = QDir(workDir).filePath(QString("input_%1.txt").arg(fileSize));
+	std::ofstream inputFile(path.toStdString(), std::ofstream::trunc);
+	const std::string line = "The quick brown fox jumps over the lazy dog. 0123456789\n";
+	for (size_t written = 0; written < fileSize; written += line.size())
+	{
+		size_t remaining = fileSize - written;
+		inputFile.write(line.c_str(), (remaining < line.size()) ? remaining : line.size());
+	}
+	inputFile.close();
+	inputFiles[fileSize] = path;
+	return path;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetSmallFileSet
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString GetSmallFileSet(const size_t fileCount)
+		- fileCount : unsigned int, number of files in the set
+
+-- RETURNS: QString : folder of fileCount files of 1-4KB, made once and reused for the whole sweep
+--
+-- NOTES:
+-- Sizes come from a fixed seed so every run (and the baseline) sends the same bytes.
+-- Files are spread over folders of 1000 so the filesystem isnt the bottleneck.
+----------------------------------------------------------------------------------------------------------------------*/
+QString LoopbackBenchmark::GetSmallFileSet(const size_t fileCount)
+{
+	auto existing = smallFileSets.find(fileCount);
+	if (existing != smallFileSets.end())
+		return existing->second;
+
+	QDir setDir(QDir(workDir).filePath(QString("small_%1").arg(fileCount)));
+	setDir.removeRecursively();
+	std::mt19937 generator(1234);
+	std::uniform_int_distribution<size_t> sizes(1024, 4096);
+	const std::string line = "The quick brown fox jumps over the lazy dog. 0123456789\n";
+	std::string content;
+	for (size_t i = 0; i < fileCount; i++)
+	{
+		QString folder = QString("d%1").arg(i / 1000);
+		if (i % 1000 == 0)
+			setDir.mkpath(folder);
+		size_t fileSize = sizes(generator);
+		content.clear();
+		while (content.size() < fileSize)
+			content += line;
+		content.resize(fileSize);
+		std::ofstream smallFile(setDir.filePath(QString("%1/f%2.txt").arg(folder).arg(i)).toStdString(), std::ofstream::binary);
+		smallFile.write(content.c_str(), content.size());
+	}
+	smallFileSets[fileCount] = setDir.absolutePath();
+	return setDir.absolutePath();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ResultToJson
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QJsonObject ResultToJson(const BenchmarkResult& result)
+		- result : BenchmarkResult, one finished run
+
+-- RETURNS: QJsonObject : the run as one entry of the results array
+----------------------------------------------------------------------------------------------------------------------*/
+QJsonObject LoopbackBenchmark::ResultToJson(const BenchmarkResult& result)
+{
+	QJsonObject entry;
+	entry["protocol"] = result.config.protocol;
+	entry["packetSize"] = (double)result.config.packetSize;
+	entry["packetCount"] = (double)result.config.packetCount;
+	entry["fileSize"] = (double)result.config.fileSize;
+	entry["shardCount"] = result.config.shardCount;
+	entry["udpOffload"] = result.config.udpOffload;
+	entry["registeredIo"] = result.config.registeredIo;
+	entry["encrypted"] = result.config.encrypted;
+	entry["fecRepair"] = result.config.fecRepair;
+	entry["receiverCount"] = result.config.receiverCount;
+	entry["synthetic"] = result.config.synthetic;
+	entry["mismatches"] = (double)result.mismatches;
+	entry["elideZeros"] = result.config.elideZeros;
+	entry["busyPoll"] = result.config.busyPoll;
+	entry["steadyAllocations"] = (double)result.steadyAllocations;
+	entry["p50Us"] = result.p50Us;
+	entry["p99Us"] = result.p99Us;
+	entry["p999Us"] = result.p999Us;
+	entry["packetsReceived"] = (double)result.packetsReceived;
+	entry["bytesReceived"] = (double)result.bytesReceived;
+	entry["seconds"] = result.seconds;
+	entry["mbPerSec"] = result.megabytesPerSec;
+	entry["packetsPerSec"] = result.packetsPerSec;
+	entry["cpuSeconds"] = result.cpuSeconds;
+	entry["peakRssBytes"] = (double)result.peakRssBytes;
+	return entry;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ConfigKey
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString ConfigKey(const QJsonObject& entry)
+		- entry : QJsonObject, one entry of a results array
+
+-- RETURNS: QString : identifies the config, used to match runs against a baseline
+--
+-- NOTES:
+-- Shard count, offload and rio are only added when set, so baselines from before those runs existed still match.
+----------------------------------------------------------------------------------------------------------------------*/
+QString LoopbackBenchmark::ConfigKey(const QJsonObject& entry)
+{
+	QString key = QString("%1/%2/%3/%4")
+		.arg(entry["protocol"].toString())
+		.arg((qint64)entry["packetSize"].toDouble())
+		.arg((qint64)entry["packetCount"].toDouble())
+		.arg((qint64)entry["fileSize"].toDouble());
+	int shardCount = entry["shardCount"].toInt(1);
+	if (shardCount > 1)
+		key += QString("/x%1").arg(shardCount);
+	if (entry["udpOffload"].toBool())
+		key += "/offload";
+	if (entry["registeredIo"].toBool())
+		key += "/rio";
+	if (entry["encrypted"].toBool())
+		key += "/enc";
+	if (entry["fecRepair"].toInt() > 0)
+		key += QString("/fec%1").arg(entry["fecRepair"].toInt());
+	if (entry["receiverCount"].toInt(1) > 1)
+		key += QString("/rx%1").arg(entry["receiverCount"].toInt());
+	if (entry["synthetic"].toBool())
+		key += "/synthetic";
+	if (entry["elideZeros"].toBool())
+		key += "/elide";
+	if (entry["busyPoll"].toBool())
+		key += "/busy";
+	return key;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteResults
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool WriteResults(const QString& path, const std::vector<BenchmarkResult>& results)
+		- path : QString, file to write to
+		- results : std::vector<BenchmarkResult>, every finished run
+
+-- RETURNS: bool : whether the file was written
+--
+-- NOTES:
+-- The written file can be fed back in later as --baseline.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackBenchmark::WriteResults(const QString& path, const std::vector<BenchmarkResult>& results)
+{
+	QJsonArray entries;
+	for (const BenchmarkResult& result : results)
+	{
+		entries.append(ResultToJson(result));
+	}
+	QJsonObject root;
+	root["results"] = entries;
+
+	QFile resultsFile(path);
+	if (!resultsFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	resultsFile.write(QJsonDocument(root).toJson());
+	resultsFile.close();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION CompareWithBaseline
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int CompareWithBaseline(const QString& path, const std::vector<BenchmarkResult>& results,
+	const double tolerance)
+		- path : QString, results file from an earlier run
+		- results : std::vector<BenchmarkResult>, runs just finished
+		- tolerance : double, percent MB/s is allowed to drop (or p99 delay to rise) before its flagged
+
+-- RETURNS: int : number of regressions, -1 if baseline cant be read
+--
+-- NOTES:
+-- Configs missing from either side are ignored. p99 is only compared when both sides have one.
+----------------------------------------------------------------------------------------------------------------------*/
+int LoopbackBenchmark::CompareWithBaseline(const QString& path, const std::vector<BenchmarkResult>& results, const double tolerance)
+{
+	QFile baselineFile(path);
+	if (!baselineFile.open(QIODevice::ReadOnly))
+	{
+		std::cout << "could not read baseline " << path.toStdString() << std::endl;
+		return -1;
+	}
+	QJsonArray baselineEntries = QJsonDocument::fromJson(baselineFile.readAll()).object()["results"].toArray();
+	baselineFile.close();
+
+	std::map<QString, double> baselineRates;
+	std::map<QString, double> baselineP99s;
+	for (const QJsonValue& value : baselineEntries)
+	{
+		QJsonObject entry = value.toObject();
+		baselineRates[ConfigKey(entry)] = entry["mbPerSec"].toDouble();
+		baselineP99s[ConfigKey(entry)] = entry["p99Us"].toDouble();
+	}
+
+	int regressions = 0;
+	for (const BenchmarkResult& result : results)
+	{
+		QString key = ConfigKey(ResultToJson(result));
+		auto baselineP99 = baselineP99s.find(key);
+		if (baselineP99 != baselineP99s.end() && baselineP99->second > 0 && result.p99Us > 0)
+		{
+			double growth = (result.p99Us - baselineP99->second) / baselineP99->second * 100;
+			if (growth > tolerance)
+			{
+				++regressions;
+				std::cout << "REGRESSION " << key.toStdString() << ": p99 delay " << baselineP99->second << " -> "
+					<< result.p99Us << " us (+" << growth << "%)" << std::endl;
+			}
+		}
+		auto baseline = baselineRates.find(key);
+		if (baseline == baselineRates.end() || baseline->second <= 0)
+			continue;
+		double change = (result.megabytesPerSec - baseline->second) / baseline->second * 100;
+		if (change < -tolerance)
+		{
+			++regressions;
+			std::cout << "REGRESSION " << key.toStdString() << ": " << baseline->second << " -> "
+				<< result.megabytesPerSec << " MB/s (" << change << "%)" << std::endl;
+		}
+	}
+	std::cout << regressions << " regression(s) against " << path.toStdString() << std::endl;
+	return regressions;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetCpuSeconds
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: double GetCpuSeconds(void)
+--
+-- RETURNS: double : user + kernel time used by the whole process so far
+----------------------------------------------------------------------------------------------------------------------*/
+double LoopbackBenchmark::GetCpuSeconds()
+{
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+		return 0;
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+	//FILETIME counts 100ns ticks
+	return (kernel.QuadPart + user.QuadPart) / 1e7;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetPeakRss
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: size_t GetPeakRss(void)
+--
+-- RETURNS: unsigned int : peak working set of the process in bytes
+--
+-- NOTES:
+-- Windows only keeps a lifetime peak, so this never goes down between configs. A config that
+-- raises it is the one that allocated the most.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t LoopbackBenchmark::GetPeakRss()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+}
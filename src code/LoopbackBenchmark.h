@@ -0,0 +1,129 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "psapi.lib")
+
+#include <WinSock2.h>
+#include <Windows.h>
+#include <Psapi.h>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+#include <QDir>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <random>
+#include <memory>
+#include "Server.h"
+#include "Client.h"
+#include "TransferOptions.h"
+#include "AllocationCounter.h"
+#include "FlightRecorder.h"
+
+#define BENCH_LATENCY_RATE 10485760 //UDP-LATENCY runs are paced to 10MB/s, so the delay measured isnt just a full socket buffer
+#define BENCH_MULTICAST_GROUP "239.255.0.77" //UDP-MULTICAST runs send here, organization local scope
+#define BENCH_MULTICAST_RATE 52428800 //UDP-MULTICAST runs are paced to 50MB/s, so every receiver can keep up without repairs
+#define BENCH_SECURE_KEY "loopback benchmark key" //TCP-SECURE runs authenticate their handshake with this
+#define BENCH_TRACE_OVERHEAD_PERCENT 1.0 //most of a UDP run's CPU per packet that tracing may add before it counts against the exit code
+#define BENCH_TRACE_SCOPES 1000000 //scopes timed back to back to get what one traced event costs
+
+bool WinApiConnectToSocket(SOCKET&, struct sockaddr_in&);
+
+//TCP/UDP runs are plain single file transfers: packetCount packets of packetSize, cut from a fileSize file
+//for TCP-BATCH runs packetSize is the pack frame size (0 = unpacked), packetCount the number
+//of files and fileSize 0, since every file is a random 1-4KB. Shows what per-file framing costs
+//for TCP-DELTA runs packetSize is the block size (0 = picked from the file size), packetCount the
+//number of 64 byte edits made to the server's copy and fileSize the size of the file. bytesReceived
+//is what actually went over the wire
+//UDP-SHARD/TCP-SHARD runs are single file transfers spread over shardCount ports and threads, 1, 2, 4...
+//up to the cores, to show how the receive rate scales once it isnt held to one core
+//UDP-OFFLOAD runs are plain UDP runs, done once without and once with udpOffload, for packets/s and CPU per packet
+//UDP-RIO runs are plain UDP runs, done once through the socket and once through Registered I/O
+//UDP-FEC runs are plain UDP runs with 0 (off) or a few FEC repair datagrams per block. Loopback rarely
+//loses anything, so they show what encoding and decoding costs, not the recovery
+//TCP-SECURE runs are plain TCP runs, done once in plaintext and once encrypted, for what sealing every record costs
+//UDP-LATENCY runs are paced Measure mode runs, the one way delay of every datagram is read back from the log.
+//Their p50/p99/p99.9 are checked against a baseline like MB/s
+//UDP-MULTICAST runs are paced single file runs sent once to a group that receiverCount servers joined,
+//the sender's cost should stay flat as receivers are added
+//UDP-NULL/TCP-NULL runs are plain runs with synthetic set, no file at either end, for how much of the plain rate is the disk
+//TCP-SPARSE runs are a 4KB file at packet sizes far past it, mostly padding, sent as is and with elideZeros
+//UDP-PINGPONG/TCP-PINGPONG runs echo packetCount small messages one at a time, checked like UDP-LATENCY's delay
+struct BenchmarkConfig
+{
+	QString protocol;
+	size_t packetSize;
+	size_t packetCount;
+	size_t fileSize;
+	int shardCount = 1;
+	bool udpOffload = false;
+	bool registeredIo = false;
+	bool encrypted = false;
+	int fecRepair = 0;
+	int receiverCount = 1;
+	bool synthetic = false; //client generates a random payload, server verifies it and keeps nothing
+	bool elideZeros = false;
+	bool busyPoll = false; //ping-pong runs, both ends spin instead of waiting in select
+};
+
+struct BenchmarkResult
+{
+	BenchmarkConfig config;
+	size_t packetsReceived;
+	size_t bytesReceived;
+	double seconds;
+	double megabytesPerSec;
+	double packetsPerSec;
+	double cpuSeconds;
+	size_t peakRssBytes;
+	uint64_t steadyAllocations = 0; //heap allocations on the receive thread after the first 10% of packets
+	double p50Us = 0; //one way delay percentiles for UDP-LATENCY, round trip for the ping-pong runs
+	double p99Us = 0;
+	double p999Us = 0;
+	uint64_t mismatches = 0; //writes a verify sink found wrong, synthetic runs only
+};
+
+class LoopbackBenchmark
+{
+public:
+	LoopbackBenchmark();
+	virtual ~LoopbackBenchmark();
+	int Run(const QStringList&);
+
+private:
+	QString workDir;
+	std::map<size_t, QString> inputFiles;
+	std::map<size_t, QString> smallFileSets;
+
+	std::vector<BenchmarkConfig> BuildSweep(const bool);
+	int CheckTraceOverhead(const bool);
+	bool RunConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunBatchConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunDeltaConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunShardConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunMulticastConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool RunPingPongConfig(const BenchmarkConfig&, BenchmarkResult&);
+	bool OpenMulticastReceivers(const int, struct sockaddr_storage&, std::vector<SOCKET>&);
+	bool OpenShardSenders(const bool, SOCKET, const struct sockaddr_in&, const int, std::vector<SOCKET>&, std::vector<struct sockaddr_storage>&);
+	bool WriteDeltaPair(const BenchmarkConfig&, const QString&, const QString&);
+	void ReadLatencyPercentiles(const QString&, BenchmarkResult&);
+	bool OpenLoopbackSockets(const QString&, SOCKET&, SOCKET&, struct sockaddr_in&);
+	QString GetInputFile(const size_t);
+	QString GetSmallFileSet(const size_t);
+	QJsonObject ResultToJson(const BenchmarkResult&);
+	QString ConfigKey(const QJsonObject&);
+	bool WriteResults(const QString&, const std::vector<BenchmarkResult>&);
+	int CompareWithBaseline(const QString&, const std::vector<BenchmarkResult>&, const double);
+	double GetCpuSeconds();
+	size_t GetPeakRss();
+};
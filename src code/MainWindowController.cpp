@@ -12,10 +12,20 @@
 	void ToggleClientServerGuiElements();
 	void Connect();
 	void ClientSend(const int);
+	void ClientSendWholeFile(const int);
 	void ServerReceive(const int);
 	void PrintStatusToConsole(const QString&);
-	void DisplayServerResults(const int, const int, const QString&, const QString&);
+	void DisplayServerResults(const size_t, const size_t, const QString&, const QString&, const QString&);
 	void ToggleDisconnect(const bool);
+	bool ReadTransferOptions(const size_t, TransferOptions&);
+	void DisplaySessions(const std::vector<SessionSnapshot>&);
+	void StopSelectedSession();
+	void ToggleTracing(const bool);
+	void SaveTrace();
+	void FilterConsole(const QString&);
+	void SetConsoleCapacity();
+	void SaveConsole();
+	void ShowLiveChart();
 --
 -- DATE: Feb 10, 2018
 --
@@ -82,6 +92,28 @@ void MainWindowController::InitializeGuiElements()
 	
 	filePathField = ui.FilePathLineEdit;
 
+	rateLimitField = ui.RateLimitLineEdit;
+	rateLimitField->setValidator(intInputEnforcer);
+	rateUnitToggler = ui.RateUnitDropDown;
+	transferModeToggler = ui.TransferModeDropDown;
+	packFrameField = ui.PackFrameLineEdit;
+	packFrameField->setValidator(intInputEnforcer);
+	shardCountField = ui.ShardCountLineEdit;
+	shardCountField->setValidator(intInputEnforcer);
+	udpOffloadToggler = ui.UdpOffloadCheckBox;
+	registeredIoToggler = ui.RegisteredIoCheckBox;
+	encryptToggler = ui.EncryptCheckBox;
+	encryptKeyField = ui.EncryptKeyLineEdit;
+	elideZerosToggler = ui.ElideZerosCheckBox;
+	fecRepairField = ui.FecRepairLineEdit;
+	fecRepairField->setValidator(intInputEnforcer);
+	multicastGroupField = ui.MulticastGroupLineEdit;
+	payloadSourceToggler = ui.PayloadSourceDropDown;
+	payloadSinkToggler = ui.PayloadSinkDropDown;
+	payloadSeedField = ui.PayloadSeedLineEdit;
+	payloadSeedField->setValidator(intInputEnforcer);
+	busyPollToggler = ui.BusyPollCheckBox;
+
 	clientServerToggler = ui.ClientServerDropDown;
 	tcpUdpToggler = ui.TcpUdpDropDown;
 	serverResultFields = ui.ServerSideResults;
@@ -90,8 +122,22 @@ void MainWindowController::InitializeGuiElements()
 	packetCountDisplayField = ui.PacketCountLabel;
 	transmitTimeDisplayField = ui.TransmissionTimeLabel;
 	protocolDisplayField = ui.ProtocolLabel;
-	console = ui.ConsoleTextEdit;
+	measureDisplayField = ui.MeasureResultsLabel;
+	consoleView = ui.ConsoleListView;
+	consoleLog = new ConsoleLog(this);
+	consoleFilter = new ConsoleFilter(this);
+	consoleFilter->setSourceModel(consoleLog);
+	consoleView->setModel(consoleFilter);
+	consoleLog->FollowIn(consoleView);
+	ui.ConsoleCapLineEdit->setValidator(intInputEnforcer);
+	ui.ConsoleCapLineEdit->setText(QString::number(consoleLog->GetCapacity()));
 	ui.DisconnectButton->setEnabled(false);
+
+	traceToggler = ui.TraceCheckBox;
+	sessionTable = ui.SessionTable;
+	liveChart = ui.LiveChartView;
+	sessionTable->setColumnCount(7);
+	sessionTable->setHorizontalHeaderLabels({ "#", "Session", "State", "MB/s", "Bytes", "Count", "ms" });
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -119,10 +165,22 @@ void MainWindowController::InitializeSignals()
 
 	connect(clientServerToggler, &QComboBox::currentTextChanged, this, &MainWindowController::ToggleClientServerGuiElements);
 	connect(tcpUdpToggler, &QComboBox::currentTextChanged, this, &MainWindowController::ToggleClientServerGuiElements);
+	connect(transferModeToggler, &QComboBox::currentTextChanged, this, &MainWindowController::ToggleClientServerGuiElements);
 	connect(socketManager, &WSASocketManager::AlertableErrorOccured, this, &MainWindowController::DisplayAlertMessage);
 	connect(socketManager, &WSASocketManager::PrintableStatusReady, this, &MainWindowController::PrintStatusToConsole);
 	connect(socketManager, &WSASocketManager::ServerResultsReady, this, &MainWindowController::DisplayServerResults);
 	connect(socketManager, &WSASocketManager::DisconnectAllowed, this, &MainWindowController::ToggleDisconnect);
+	connect(socketManager, &WSASocketManager::SessionListReady, this, &MainWindowController::DisplaySessions);
+	connect(socketManager, &WSASocketManager::SchedulerLoadReady, ui.statusBar, [this](const QString& load) {
+		ui.statusBar->showMessage(load);
+	});
+	connect(ui.StopSessionButton, &QPushButton::pressed, this, &MainWindowController::StopSelectedSession);
+	connect(traceToggler, &QCheckBox::toggled, this, &MainWindowController::ToggleTracing);
+	connect(ui.SaveTraceButton, &QPushButton::pressed, this, &MainWindowController::SaveTrace);
+	connect(ui.ConsoleLevelDropDown, &QComboBox::currentTextChanged, this, &MainWindowController::FilterConsole);
+	connect(ui.ConsoleCapLineEdit, &QLineEdit::editingFinished, this, &MainWindowController::SetConsoleCapacity);
+	connect(ui.SaveConsoleButton, &QPushButton::pressed, this, &MainWindowController::SaveConsole);
+	connect(socketManager, &WSASocketManager::LiveSamplesTaken, this, &MainWindowController::ShowLiveChart);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -159,6 +217,8 @@ void MainWindowController::ToggleClientServerGuiElements()
 	packetCountField->setEnabled(!inServerMode);
 	hostNameField->setEnabled(!inServerMode);
 	ipAddrField->setEnabled(!inServerMode);
+	rateLimitField->setEnabled(!inServerMode);
+	rateUnitToggler->setEnabled(!inServerMode);
 	//set sending packet info to N/A if in server mode, or default value of 1
 	//in client mode
 	QString sentPacketInfo = inServerMode ? "N/A" : "1";
@@ -172,6 +232,41 @@ void MainWindowController::ToggleClientServerGuiElements()
 		packetSizeField->setEnabled(true);
 		packetSizeField->setText("1");
 	}
+
+	//batch, delta and dedup send whole files, packet size/count dont apply
+	//measure is single file over udp, with room for its header in each packet
+	bool inBatchMode = (transferModeToggler->currentText() == "Batch");
+	packFrameField->setEnabled(inBatchMode && !inServerMode);
+	shardCountField->setEnabled(transferModeToggler->currentText() == "Single file");
+	udpOffloadToggler->setEnabled(transferModeToggler->currentText() == "Single file" && tcpUdpToggler->currentText() == "UDP");
+	registeredIoToggler->setEnabled(transferModeToggler->currentText() == "Single file" && tcpUdpToggler->currentText() == "UDP");
+	encryptToggler->setEnabled(transferModeToggler->currentText() == "Single file" && tcpUdpToggler->currentText() == "TCP");
+	encryptKeyField->setEnabled(encryptToggler->isEnabled());
+	elideZerosToggler->setEnabled(transferModeToggler->currentText() == "Single file" && tcpUdpToggler->currentText() == "TCP");
+	fecRepairField->setEnabled(transferModeToggler->currentText() == "Single file" && tcpUdpToggler->currentText() == "UDP");
+	//clients send to a group by using it as their host, only servers join one
+	multicastGroupField->setEnabled(inServerMode && transferModeToggler->currentText() == "Single file" && tcpUdpToggler->currentText() == "UDP");
+	//the server needs the source too, a verify sink regenerates it
+	payloadSourceToggler->setEnabled(transferModeToggler->currentText() == "Single file");
+	payloadSinkToggler->setEnabled(inServerMode && transferModeToggler->currentText() == "Single file");
+	payloadSeedField->setEnabled(transferModeToggler->currentText() == "Single file");
+	busyPollToggler->setEnabled(transferModeToggler->currentText() == "Ping-pong");
+	if (transferModeToggler->currentText() == "Measure" && !inServerMode)
+	{
+		packetSizeField->setText(QString::number(UDP_MEASURE_HEADER_SIZE));
+	}
+	else if (transferModeToggler->currentText() == "Ping-pong" && !inServerMode)
+	{
+		packetSizeField->setText(QString::number(PING_HEADER_SIZE));
+	}
+	//ping-pong sends packets like single file, the TCP server needs the size to count them
+	else if (transferModeToggler->currentText() != "Single file" && transferModeToggler->currentText() != "Ping-pong")
+	{
+		packetSizeField->setEnabled(false);
+		packetCountField->setEnabled(false);
+		packetSizeField->setText("N/A");
+		packetCountField->setText("N/A");
+	}
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -190,11 +285,27 @@ void MainWindowController::ToggleClientServerGuiElements()
 -- NOTES:
 -- Opens up a new file explorer-link dialog. Lets user picks a .txt file, and saves
 -- the absolute filePath to a string instance variable.
+-- In Batch mode picks a folder instead: the folder to send, or the folder to receive into.
+-- A manifest file can still be typed into the file path field by hand.
+-- In Delta mode any file can be picked: the new version on the client, the old copy on the server.
+-- Dedup is the same, the server's chunk store goes in the picked file's folder.
 -- */
 void MainWindowController::PickFile()
 {
-	QString filePath = QFileDialog::getOpenFileName(this, "Choose File for Packets", "./",
-		"Text File (*.txt)");
+	QString filePath;
+	if (transferModeToggler->currentText() == "Batch")
+	{
+		filePath = QFileDialog::getExistingDirectory(this, "Choose Folder for Batch", "./");
+	}
+	else if (transferModeToggler->currentText() == "Delta" || transferModeToggler->currentText() == "Dedup")
+	{
+		filePath = QFileDialog::getOpenFileName(this, "Choose File to Sync", "./", "Any File (*)");
+	}
+	else
+	{
+		filePath = QFileDialog::getOpenFileName(this, "Choose File for Packets", "./",
+			"Text File (*.txt)");
+	}
 	filePathField->setText(filePath);
 }
 
@@ -258,18 +369,23 @@ void MainWindowController::Connect()
 void MainWindowController::ServerReceive(const int port)
 {
 	QString protocol = tcpUdpToggler->currentText();
+	TransferOptions options;
+	if (!ReadTransferOptions(0, options))
+	{
+		return;
+	}
 	//pass protocol to func, and let it handle it
 	size_t packetSize = packetSizeField->text().toUInt();
-	if (packetSize <= 0 && protocol == "TCP")
+	if (packetSize <= 0 && protocol == "TCP" && (options.mode == TransferMode::SingleFile || options.mode == TransferMode::PingPong))
 	{
 		DisplayAlertMessage("Packet size must be 1 or greater.");
 		return;
 	}
 
 	QString filePath = filePathField->text().trimmed();
-	if (socketManager->SetupReceiving(protocol, port, filePath, packetSize))
+	if (socketManager->SetupReceiving(protocol, port, filePath, packetSize, options))
 	{
-		console->clear();
+		consoleLog->Clear();
 		socketManager->ReceivePackets();
 	}	
 }
@@ -296,6 +412,12 @@ void MainWindowController::ServerReceive(const int port)
 void MainWindowController::ClientSend(const int port)
 {
 	QString protocol = tcpUdpToggler->currentText();
+	if (transferModeToggler->currentText() != "Single file" && transferModeToggler->currentText() != "Measure"
+		&& transferModeToggler->currentText() != "Ping-pong")
+	{
+		ClientSendWholeFile(port);
+		return;
+	}
 
 	size_t packetSize = packetSizeField->text().toUInt();
 	if (packetSize <= 0)
@@ -314,14 +436,19 @@ void MainWindowController::ClientSend(const int port)
 		DisplayAlertMessage("Times to transmit must be 1 or greater.");
 		return;
 	}
+	TransferOptions options;
+	if (!ReadTransferOptions(packetSize, options))
+	{
+		return;
+	}
 	QString hostName = hostNameField->text().trimmed();
 	QString filePath = filePathField->text().trimmed();
 	if (hostName != "")
 	{
-		if (socketManager->SetupSendingByName(hostName, protocol, port, filePath))
+		if (socketManager->SetupSendingByName(hostName, protocol, port, filePath, options))
 		{
-			console->clear();
-			socketManager->SendPackets(packetSize, packetCount);
+			consoleLog->Clear();
+			socketManager->SendPackets(packetSize, packetCount, options);
 			return;
 		}
 	}
@@ -329,14 +456,238 @@ void MainWindowController::ClientSend(const int port)
 	bool ipValid = socketManager->CheckIPFormat(ipAddrStr);
 	if (ipValid)
 	{
-		if (socketManager->SetupSendingByIp(ipAddrStr, protocol, port, filePath))
+		if (socketManager->SetupSendingByIp(ipAddrStr, protocol, port, filePath, options))
+		{
+			consoleLog->Clear();
+			socketManager->SendPackets(packetSize, packetCount, options);
+		}
+		return;
+	}
+	this->DisplayAlertMessage("Please enter either a host name, or alternatively a \n valid numeric IP address, in \'X.X.X.X\' or IPv6 format");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ClientSendWholeFile
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ClientSendWholeFile(const int port)
+--			- port : integer port number to connect to
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called by ClientSend when Batch, Delta or Dedup is selected. Same host lookup as ClientSend,
+-- but packet size/count are ignored; the file path is a folder or manifest for Batch,
+-- the new version of a file for Delta, or the file to send for Dedup. Rate limits in pkt/s are taken per 256KB chunk.
+-- */
+void MainWindowController::ClientSendWholeFile(const int port)
+{
+	QString protocol = tcpUdpToggler->currentText();
+	TransferOptions options;
+	if (!ReadTransferOptions(BATCH_CHUNK_SIZE, options))
+	{
+		return;
+	}
+	QString hostName = hostNameField->text().trimmed();
+	QString filePath = filePathField->text().trimmed();
+	if (hostName != "")
+	{
+		if (socketManager->SetupSendingByName(hostName, protocol, port, filePath, options))
 		{
-			console->clear();
-			socketManager->SendPackets(packetSize, packetCount);
+			consoleLog->Clear();
+			socketManager->SendPackets(0, 0, options);
+			return;
+		}
+	}
+	QString ipAddrStr = ipAddrField->text().trimmed();
+	if (socketManager->CheckIPFormat(ipAddrStr))
+	{
+		if (socketManager->SetupSendingByIp(ipAddrStr, protocol, port, filePath, options))
+		{
+			consoleLog->Clear();
+			socketManager->SendPackets(0, 0, options);
 		}
 		return;
 	}
-	this->DisplayAlertMessage("Please enter either a host name, or alternatively a \n valid numeric IP address, in \'X.X.X.X\' format");
+	this->DisplayAlertMessage("Please enter either a host name, or alternatively a \n valid numeric IP address, in \'X.X.X.X\' or IPv6 format");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadTransferOptions
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReadTransferOptions(const size_t packetSize, TransferOptions& options)
+--			- packetSize : unsigned int, validated packet size, used to turn pkt/s into bytes/s
+--			- options : TransferOptions, filled in from the Transfer Options fields
+--
+-- RETURNS: bool : whether the entered options are usable
+--
+-- NOTES:
+-- Called by ClientSend/ServerReceive before any socket is set up.
+-- Rate limit of 0 (or blank) means unpaced, anything else that isnt a whole number is refused
+-- rather than quietly sending unpaced. pkt/s is converted to bytes/s here so the pacer only
+-- deals with one unit, a rate whose bytes/s wouldnt fit a size_t is refused too.
+-- Batch, Delta and Dedup modes only run over TCP, since a lost datagram would corrupt everything after it.
+-- Measure is the other way around, its whole point is seeing what UDP loses.
+-- Ping-pong runs over either, the packet size has to hold its header.
+-- Pack frame size is entered in KB and capped to what the server accepts.
+-- Shards only apply to Single file, the other modes stay on the one port. So does UDP offload.
+-- So does a multicast group, which only a UDP server joins.
+-- */
+bool MainWindowController::ReadTransferOptions(const size_t packetSize, TransferOptions& options)
+{
+	QString rateText = rateLimitField->text().trimmed();
+	bool rateValid = true;
+	size_t rateLimit = rateText.isEmpty() ? 0 : rateText.toUInt(&rateValid);
+	if (!rateValid)
+	{
+		DisplayAlertMessage("Rate limit must be a whole number, or 0/blank for unlimited.");
+		return false;
+	}
+	size_t bytesPerUnit = (rateUnitToggler->currentText() == "pkt/s") ? packetSize : 1024;
+	if (bytesPerUnit > 0 && rateLimit > SIZE_MAX / bytesPerUnit)
+	{
+		DisplayAlertMessage("Rate limit is too high, use 0 for unlimited.");
+		return false;
+	}
+	options.targetRate = rateLimit * bytesPerUnit;
+	options.targetPacketRate = (rateUnitToggler->currentText() == "pkt/s") ? rateLimit : 0;
+	QString modeText = transferModeToggler->currentText();
+	if (modeText == "Batch")
+	{
+		options.mode = TransferMode::Batch;
+	}
+	else if (modeText == "Delta")
+	{
+		options.mode = TransferMode::Delta;
+	}
+	else if (modeText == "Dedup")
+	{
+		options.mode = TransferMode::Dedup;
+	}
+	else if (modeText == "Measure")
+	{
+		options.mode = TransferMode::Measure;
+	}
+	else if (modeText == "Ping-pong")
+	{
+		options.mode = TransferMode::PingPong;
+	}
+	else
+	{
+		options.mode = TransferMode::SingleFile;
+	}
+	options.packFrameSize = std::min<size_t>((size_t)packFrameField->text().trimmed().toUInt() * 1024, PACK_MAX_FRAME_SIZE);
+	if (options.mode == TransferMode::SingleFile)
+	{
+		options.shardCount = shardCountField->text().trimmed().toInt();
+		if (options.shardCount < 1 || options.shardCount > SHARD_MAX_COUNT)
+		{
+			DisplayAlertMessage(QString("Shards must be from 1 to %1.").arg(SHARD_MAX_COUNT));
+			return false;
+		}
+		options.udpOffload = udpOffloadToggler->isChecked() && tcpUdpToggler->currentText() == "UDP";
+		options.registeredIo = registeredIoToggler->isChecked() && tcpUdpToggler->currentText() == "UDP";
+		options.encrypted = encryptToggler->isChecked() && tcpUdpToggler->currentText() == "TCP";
+		if (options.encrypted && options.shardCount > 1)
+		{
+			DisplayAlertMessage("Encrypted transfers cant be sharded.");
+			return false;
+		}
+		options.encryptionKey = options.encrypted ? encryptKeyField->text() : QString();
+		if (options.encrypted && options.encryptionKey.size() < SECURE_MIN_KEY_LENGTH)
+		{
+			DisplayAlertMessage(QString("Encrypting needs a shared key of at least %1 characters, the same on both ends.").arg(SECURE_MIN_KEY_LENGTH));
+			return false;
+		}
+		options.elideZeros = elideZerosToggler->isChecked() && tcpUdpToggler->currentText() == "TCP";
+		if (options.elideZeros && (options.shardCount > 1 || options.encrypted))
+		{
+			DisplayAlertMessage("Eliding zeros cant be combined with shards or encryption.");
+			return false;
+		}
+		options.fecRepair = (tcpUdpToggler->currentText() == "UDP") ? fecRepairField->text().trimmed().toInt() : 0;
+		if (options.fecRepair < 0 || options.fecRepair > FEC_MAX_REPAIR)
+		{
+			DisplayAlertMessage(QString("FEC repair must be from 0 to %1.").arg(FEC_MAX_REPAIR));
+			return false;
+		}
+		if (options.fecRepair > 0 && (options.shardCount > 1 || options.udpOffload || options.registeredIo))
+		{
+			DisplayAlertMessage("FEC cant be combined with shards, offload or Registered I/O.");
+			return false;
+		}
+		if (options.fecRepair > 0 && clientServerToggler->currentText() == "Client" && packetSize > FEC_MAX_PAYLOAD)
+		{
+			DisplayAlertMessage(QString("FEC packets can be at most %1 Bytes.").arg(FEC_MAX_PAYLOAD));
+			return false;
+		}
+		bool joinsGroup = clientServerToggler->currentText() == "Server" && tcpUdpToggler->currentText() == "UDP";
+		options.multicastGroup = joinsGroup ? multicastGroupField->text().trimmed() : QString();
+		struct sockaddr_storage group;
+		if (!options.multicastGroup.isEmpty() && !ParseMulticastGroup(options.multicastGroup, group))
+		{
+			DisplayAlertMessage("Multicast group must be a numeric IPv4 (224.0.0.0 to 239.255.255.255) or IPv6 (ff..) group address.");
+			return false;
+		}
+		if (!options.multicastGroup.isEmpty() && (options.shardCount > 1 || options.udpOffload || options.registeredIo || options.fecRepair > 0))
+		{
+			DisplayAlertMessage("Multicast cant be combined with shards, offload, Registered I/O or FEC.");
+			return false;
+		}
+		//combo order is the enum order
+		options.payloadSource = (PayloadSource)payloadSourceToggler->currentIndex();
+		options.payloadSink = (clientServerToggler->currentText() == "Server") ? (PayloadSink)payloadSinkToggler->currentIndex() : PayloadSink::File;
+		options.payloadSeed = payloadSeedField->text().trimmed().toUInt();
+		if (options.payloadSink == PayloadSink::Verify && options.payloadSource == PayloadSource::File)
+		{
+			DisplayAlertMessage("Verify needs the generated source the client sends, not File.");
+			return false;
+		}
+		if (options.payloadSink != PayloadSink::File && options.shardCount > 1)
+		{
+			DisplayAlertMessage("Discard and Verify sinks cant be sharded.");
+			return false;
+		}
+	}
+	if (options.mode == TransferMode::Measure)
+	{
+		if (tcpUdpToggler->currentText() != "UDP")
+		{
+			DisplayAlertMessage("Measure mode needs UDP.");
+			return false;
+		}
+		if (clientServerToggler->currentText() == "Client" && packetSize < UDP_MEASURE_HEADER_SIZE)
+		{
+			DisplayAlertMessage(QString("Measure packets must be at least %1 Bytes.").arg(UDP_MEASURE_HEADER_SIZE));
+			return false;
+		}
+	}
+	else if (options.mode == TransferMode::PingPong)
+	{
+		options.busyPoll = busyPollToggler->isChecked();
+		if (clientServerToggler->currentText() == "Client" && packetSize < PING_HEADER_SIZE)
+		{
+			DisplayAlertMessage(QString("Ping-pong messages must be at least %1 Bytes.").arg(PING_HEADER_SIZE));
+			return false;
+		}
+	}
+	else if (options.mode != TransferMode::SingleFile && tcpUdpToggler->currentText() != "TCP")
+	{
+		DisplayAlertMessage(modeText + " transfers need TCP.");
+		return false;
+	}
+	return true;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -357,12 +708,11 @@ void MainWindowController::ClientSend(const int port)
 -- Called to enable disconnect button (and subsequently, its on click handler)
 -- Should only be called once a Server has connected, and thus able
 -- to be disconnected.
--- Logically, also turns ConnectButton off.
+-- ConnectButton stays on, more sessions can be started while one is receiving.
 -- */
 void MainWindowController::ToggleDisconnect(const bool turnOn) 
 {
 	ui.DisconnectButton->setEnabled(turnOn);
-	ui.ConnectButton->setEnabled(!turnOn);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -383,9 +733,11 @@ void MainWindowController::ToggleDisconnect(const bool turnOn)
 -- Called to create a new popup to alert user with msg.
 -- Should only be called for important connection-breaking messages.
 -- No one likes too many popups. For less important alerts, use PrintStatusToConsole.
+-- The msg is kept in the console as an error too, so it can still be read after the popup is closed.
 -- */
 void MainWindowController::DisplayAlertMessage(const QString& alertMsg)
 {
+	consoleLog->Append("-" + alertMsg, ConsoleLevel::Error);
 	QMessageBox msgBox;
 	msgBox.setText(alertMsg);
 	msgBox.setDefaultButton(QMessageBox::Ok);
@@ -410,10 +762,12 @@ void MainWindowController::DisplayAlertMessage(const QString& alertMsg)
 -- Called to insert a status/msg in the console
 -- Use this to print all frequently reoccuring messages, eg. -sent packet 
 -- User may be less alerted by this. For very important alerts, use DisplayAlertMessage
+-- Lines are colored by what ConsoleLog::ClassifyStatus makes of them, and only the newest
+-- ConsoleLog::GetCapacity are kept, so a status per packet no longer slows the window down.
 -- */
 void MainWindowController::PrintStatusToConsole(const QString& status)
 {
-	console->insertPlainText(status + "\n");
+	consoleLog->Append(status, ConsoleLog::ClassifyStatus(status));
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -425,11 +779,13 @@ void MainWindowController::PrintStatusToConsole(const QString& status)
 --
 -- PROGRAMMER: Alex Xia
 --
--- INTERFACE: void DisplayServerResults(const size_t packetSize, const size_t packetCount, const QString& time, const QString& protocol)
+-- INTERFACE: void DisplayServerResults(const size_t packetSize, const size_t packetCount, const QString& time, const QString& protocol,
+		const QString& measureSummary)
 			- packetSize : unsigned int, size of each packet received for UDP, or if TCP used, expected packet size
 			- packetCount : unsigned int, number of packets received
 			- time : QString, time it took for all packets that arrived to do so, converted to string so its easier to handle
 			- protocol : QString, TCP or UDP
+			- measureSummary : QString, loss/reorder/jitter stats in Measure mode, empty otherwise
 --
 -- RETURNS: void.
 --
@@ -437,10 +793,207 @@ void MainWindowController::PrintStatusToConsole(const QString& status)
 -- This function is either called when server has received updated packet information. 
 -- Or to clear server reults fields by passing in 0s
 -- */
-void MainWindowController::DisplayServerResults(const size_t packetSize, const size_t packetCount, const QString& time, const QString& protocol)
+void MainWindowController::DisplayServerResults(const size_t packetSize, const size_t packetCount, const QString& time, const QString& protocol,
+	const QString& measureSummary)
 {
 	packetSizeDisplayField->setText(QString::number(packetSize));
 	packetCountDisplayField->setText(QString::number(packetCount));
 	transmitTimeDisplayField->setText(time);
 	protocolDisplayField->setText(protocol);
-}
\ No newline at end of file
+	measureDisplayField->setText(measureSummary);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION DisplaySessions
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void DisplaySessions(const std::vector<SessionSnapshot>& snapshots)
+			- snapshots : one per session WSASocketManager still keeps, oldest first
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Signaled every SESSION_STATS_INTERVAL_MS. Refills the session table, keeping the selected
+-- session selected so the Stop button doesnt jump to another row.
+-- */
+void MainWindowController::DisplaySessions(const std::vector<SessionSnapshot>& snapshots)
+{
+	int selectedId = -1;
+	int selectedRow = sessionTable->currentRow();
+	if (selectedRow >= 0 && sessionTable->item(selectedRow, 0) != nullptr)
+	{
+		selectedId = sessionTable->item(selectedRow, 0)->text().toInt();
+	}
+	sessionTable->setRowCount((int)snapshots.size());
+	for (int row = 0; row < (int)snapshots.size(); row++)
+	{
+		const SessionSnapshot& snapshot = snapshots[row];
+		QStringList cells = { QString::number(snapshot.id), snapshot.description, snapshot.state,
+			QString::number(snapshot.bytesPerSec / 1048576.0, 'f', 1), QString::number(snapshot.bytes),
+			QString::number(snapshot.count), QString::number(snapshot.elapsedMs) };
+		for (int column = 0; column < cells.size(); column++)
+		{
+			sessionTable->setItem(row, column, new QTableWidgetItem(cells[column]));
+		}
+		if (snapshot.id == selectedId)
+		{
+			sessionTable->selectRow(row);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StopSelectedSession
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void StopSelectedSession(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called when user clicks Stop session. Stops the session on the selected row of the session table.
+-- */
+void MainWindowController::StopSelectedSession()
+{
+	int selectedRow = sessionTable->currentRow();
+	if (selectedRow < 0 || sessionTable->item(selectedRow, 0) == nullptr)
+	{
+		PrintStatusToConsole("-Select a session to stop");
+		return;
+	}
+	socketManager->StopSession(sessionTable->item(selectedRow, 0)->text().toInt());
+}
+
+//Trace stages checkbox, a new recording starts every time it is checked
+void MainWindowController::ToggleTracing(const bool on)
+{
+	FlightRecorder::Shared().SetEnabled(on);
+	PrintStatusToConsole(on ? "-Tracing stages, Save trace writes what was recorded so far" : "-Tracing stopped");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SaveTrace
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SaveTrace(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called when user clicks Save trace. Writes the flight recorder's events since tracing was turned
+-- on to a JSON file for chrome://tracing or ui.perfetto.dev. Sessions can keep running meanwhile.
+----------------------------------------------------------------------------------------------------------------------*/
+void MainWindowController::SaveTrace()
+{
+	QString tracePath = QFileDialog::getSaveFileName(this, "Save Trace", "./trace.json", "Chrome Trace (*.json)");
+	if (tracePath.isEmpty())
+		return;
+	size_t eventCount = 0;
+	if (!FlightRecorder::Shared().WriteChromeTrace(tracePath, eventCount))
+	{
+		DisplayAlertMessage(QString("Could not write %1").arg(tracePath));
+		return;
+	}
+	PrintStatusToConsole(QString("-Saved %1 trace events to %2").arg(eventCount).arg(tracePath));
+	if (eventCount == 0 && !traceToggler->isChecked())
+		PrintStatusToConsole("-Check Trace stages before a transfer to record one");
+}
+
+//console filter dropdown: All, Warnings (and errors) or Errors
+void MainWindowController::FilterConsole(const QString& shown)
+{
+	if (shown == "Errors")
+		consoleFilter->SetMinimumLevel(ConsoleLevel::Error);
+	else if (shown == "Warnings")
+		consoleFilter->SetMinimumLevel(ConsoleLevel::Warning);
+	else
+		consoleFilter->SetMinimumLevel(ConsoleLevel::Info);
+}
+
+//console line cap field, out of range values are pulled back in and shown as such
+void MainWindowController::SetConsoleCapacity()
+{
+	consoleLog->SetCapacity(ui.ConsoleCapLineEdit->text().toUInt());
+	ui.ConsoleCapLineEdit->setText(QString::number(consoleLog->GetCapacity()));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SaveConsole
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SaveConsole(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called when user clicks the console's Save. Writes every line the console still keeps to a text
+-- file, including the ones the level filter hides.
+----------------------------------------------------------------------------------------------------------------------*/
+void MainWindowController::SaveConsole()
+{
+	QString logPath = QFileDialog::getSaveFileName(this, "Save Console", "./console.txt", "Text (*.txt)");
+	if (logPath.isEmpty())
+		return;
+	if (!consoleLog->SaveToFile(logPath))
+	{
+		DisplayAlertMessage(QString("Could not write %1").arg(logPath));
+		return;
+	}
+	PrintStatusToConsole(QString("-Saved the console to %1").arg(logPath));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ShowLiveChart
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ShowLiveChart(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Signaled every LIVE_SAMPLE_MS once the sessions took their samples. Charts the session selected in
+-- the session table, or the newest one if none is, so picking a row switches the chart to it.
+----------------------------------------------------------------------------------------------------------------------*/
+void MainWindowController::ShowLiveChart()
+{
+	int row = sessionTable->currentRow();
+	if (row < 0 || sessionTable->item(row, 0) == nullptr)
+		row = sessionTable->rowCount() - 1;
+	if (row < 0 || sessionTable->item(row, 0) == nullptr || sessionTable->item(row, 1) == nullptr)
+	{
+		liveChart->Clear();
+		return;
+	}
+	int sessionId = sessionTable->item(row, 0)->text().toInt();
+	if (!socketManager->GetLiveSeries(sessionId, chartedSeries))
+	{
+		liveChart->Clear();
+		return;
+	}
+	liveChart->SetSeries(chartedSeries, QString("#%1 %2").arg(sessionId).arg(sessionTable->item(row, 1)->text()));
+}
@@ -3,8 +3,12 @@
 #include <QtWidgets/QMainWindow>
 #include <QMessagebox>
 #include <QFiledialog>
+#include <QTableWidget>
 #include "GeneratedFiles/ui_MainWindow.h"
 #include "WSASocketManager.h"
+#include "FlightRecorder.h"
+#include "ConsoleLog.h"
+#include "LiveChart.h"
 
 class MainWindowController : public QMainWindow
 {
@@ -30,7 +34,31 @@ private:
 	QLabel* packetCountDisplayField;
 	QLabel* transmitTimeDisplayField;
 	QLabel* protocolDisplayField;
-	QPlainTextEdit* console;
+	QLabel* measureDisplayField;
+	QListView* consoleView;
+	ConsoleLog* consoleLog;
+	ConsoleFilter* consoleFilter;
+	QTableWidget* sessionTable;
+	LiveChart* liveChart;
+	LiveSeries chartedSeries; //reused for every copy handed to liveChart
+
+	QLineEdit* rateLimitField;
+	QComboBox* rateUnitToggler;
+	QComboBox* transferModeToggler;
+	QLineEdit* packFrameField;
+	QLineEdit* shardCountField;
+	QCheckBox* udpOffloadToggler;
+	QCheckBox* registeredIoToggler;
+	QCheckBox* encryptToggler;
+	QLineEdit* encryptKeyField;
+	QCheckBox* elideZerosToggler;
+	QLineEdit* fecRepairField;
+	QLineEdit* multicastGroupField;
+	QComboBox* payloadSourceToggler;
+	QComboBox* payloadSinkToggler;
+	QLineEdit* payloadSeedField;
+	QCheckBox* busyPollToggler;
+	QCheckBox* traceToggler;
 
 	QLineEdit* filePathField;
 	QIntValidator* intInputEnforcer;
@@ -41,8 +69,18 @@ private:
 	void ToggleClientServerGuiElements();
 	void Connect();
 	void ClientSend(const int);
+	void ClientSendWholeFile(const int);
 	void ServerReceive(const int);
 	void PrintStatusToConsole(const QString&);
-	void DisplayServerResults(const int, const int, const QString&, const QString&);
+	void DisplayServerResults(const size_t, const size_t, const QString&, const QString&, const QString&);
+	bool ReadTransferOptions(const size_t, TransferOptions&);
 	void ToggleDisconnect(const bool);
+	void DisplaySessions(const std::vector<SessionSnapshot>&);
+	void StopSelectedSession();
+	void ToggleTracing(const bool);
+	void SaveTrace();
+	void FilterConsole(const QString&);
+	void SetConsoleCapacity();
+	void SaveConsole();
+	void ShowLiveChart();
 };
@@ -0,0 +1,288 @@
+#include "MetricsEndpoint.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: MetricsEndpoint.cpp - Live session counters for monitoring, in Prometheus text format over HTTP
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	MetricsEndpoint& Shared();
+	bool Start(const int);
+	void Stop();
+	bool IsRunning() const;
+	void Publish(const std::vector<SessionSnapshot>&, const TaskScheduler&);
+	void ServeLoop();
+	void Answer(SOCKET);
+	QString LabelValue(const QString&);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Started from main with --metrics-port 9464, then:
+--
+--	curl http://127.0.0.1:9464/metrics
+--
+-- Long running receivers could only be watched on the GUI labels. Now every time WSASocketManager
+-- refreshes the session list it hands the same snapshots here, and they are turned into one page of
+-- text: bytes, packets, send errors and retransmits, live throughput and state per session, plus how
+-- many tasks are queued and running on the TaskScheduler. The snapshots read the Client's atomics and
+-- the Server's reports like the session list does, so the transfer loops never wait on this.
+--
+-- The page is served by its own thread on 127.0.0.1 only, one request per connection, so it is at
+-- most SESSION_STATS_INTERVAL_MS old when read. Finished sessions stay on it until the list drops them.
+----------------------------------------------------------------------------------------------------------------------*/
+
+MetricsEndpoint::MetricsEndpoint()
+	: listenSocket(INVALID_SOCKET)
+	, keepServing(false)
+	, scrapes(0)
+{
+}
+
+MetricsEndpoint& MetricsEndpoint::Shared()
+{
+	static MetricsEndpoint endpoint;
+	return endpoint;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Start
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Start(const int port)
+		- port : TCP port on 127.0.0.1 to serve on
+
+-- RETURNS: bool : false if the port couldnt be bound, WSAGetLastError has the reason
+--
+-- NOTES:
+-- Does its own WSAStartup so it can start before WSASocketManager does. Until the first Publish the
+-- page only has the scheduler's worker count.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MetricsEndpoint::Start(const int port)
+{
+	if (keepServing)
+		return true;
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+	listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons((u_short)port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (listenSocket == INVALID_SOCKET || bind(listenSocket, (struct sockaddr*)&address, sizeof(address)) == SOCKET_ERROR
+		|| listen(listenSocket, SOMAXCONN) == SOCKET_ERROR)
+	{
+		int errorCode = WSAGetLastError();
+		if (listenSocket != INVALID_SOCKET)
+			closesocket(listenSocket);
+		listenSocket = INVALID_SOCKET;
+		WSACleanup();
+		WSASetLastError(errorCode);
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> lock(pageLock);
+		page = QString("# TYPE asn_scheduler_workers gauge\nasn_scheduler_workers %1\n")
+			.arg(TaskScheduler::Shared().GetWorkerCount()).toStdString();
+	}
+	keepServing = true;
+	serveThread = std::thread(&MetricsEndpoint::ServeLoop, this);
+	return true;
+}
+
+void MetricsEndpoint::Stop()
+{
+	if (!keepServing)
+		return;
+	keepServing = false;
+	serveThread.join();
+	closesocket(listenSocket);
+	listenSocket = INVALID_SOCKET;
+	WSACleanup();
+}
+
+bool MetricsEndpoint::IsRunning() const
+{
+	return keepServing;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Publish
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Publish(const std::vector<SessionSnapshot>& snapshots, const TaskScheduler& scheduler)
+		- snapshots : every session as the session list just got them
+		- scheduler : the pool the sessions run on, for its queue depth
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called on the main thread from WSASocketManager::PublishSessions, does nothing unless started.
+-- The page is built here and swapped in, so the serving thread only ever copies a string.
+-- Sessions are labeled with their id and the description the session list shows.
+----------------------------------------------------------------------------------------------------------------------*/
+void MetricsEndpoint::Publish(const std::vector<SessionSnapshot>& snapshots, const TaskScheduler& scheduler)
+{
+	if (!keepServing)
+		return;
+	QString text;
+	auto family = [&](const char* name, const char* type, const char* help, const std::function<QString(const SessionSnapshot&)>& value) {
+		text += QString("# HELP %1 %2\n# TYPE %1 %3\n").arg(name).arg(help).arg(type);
+		for (const SessionSnapshot& snapshot : snapshots)
+		{
+			text += QString("%1{session=\"%2\",kind=\"%3\"} %4\n").arg(name).arg(snapshot.id)
+				.arg(LabelValue(snapshot.description)).arg(value(snapshot));
+		}
+	};
+	family("asn_session_bytes", "counter", "Bytes sent or received by the session so far.",
+		[](const SessionSnapshot& s) { return QString::number(s.bytes); });
+	family("asn_session_packets", "counter", "Packets, files or messages the session sent or received so far.",
+		[](const SessionSnapshot& s) { return QString::number(s.count); });
+	family("asn_session_send_errors", "counter", "Sends the session gave up on, always 0 for receives.",
+		[](const SessionSnapshot& s) { return QString::number(s.errors); });
+	family("asn_session_retransmits", "counter", "TCP single file sends tried again after the buffer was full.",
+		[](const SessionSnapshot& s) { return QString::number(s.retransmits); });
+	family("asn_session_throughput_bytes_per_second", "gauge", "Bytes per second since the previous refresh.",
+		[](const SessionSnapshot& s) { return QString::number(s.bytesPerSec, 'f', 0); });
+	family("asn_session_elapsed_seconds", "gauge", "Time the session has been running, or ran for.",
+		[](const SessionSnapshot& s) { return QString::number(s.elapsedMs / 1000.0, 'f', 3); });
+	text += "# HELP asn_session_state Always 1, the state label is where the session is.\n# TYPE asn_session_state gauge\n";
+	for (const SessionSnapshot& snapshot : snapshots)
+	{
+		text += QString("asn_session_state{session=\"%1\",kind=\"%2\",state=\"%3\"} 1\n").arg(snapshot.id)
+			.arg(LabelValue(snapshot.description)).arg(snapshot.state);
+	}
+	text += QString("# HELP asn_scheduler_queued_tasks Tasks waiting for a free worker, queued sessions among them.\n"
+		"# TYPE asn_scheduler_queued_tasks gauge\nasn_scheduler_queued_tasks %1\n"
+		"# HELP asn_scheduler_running_tasks Tasks on a worker right now.\n"
+		"# TYPE asn_scheduler_running_tasks gauge\nasn_scheduler_running_tasks %2\n"
+		"# TYPE asn_scheduler_workers gauge\nasn_scheduler_workers %3\n")
+		.arg(scheduler.GetQueuedTaskCount()).arg(scheduler.GetRunningTaskCount()).arg(scheduler.GetWorkerCount());
+	text += QString("# TYPE asn_metrics_scrapes counter\nasn_metrics_scrapes %1\n").arg(scrapes.load());
+
+	std::string built = text.toStdString();
+	std::lock_guard<std::mutex> lock(pageLock);
+	page.swap(built);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ServeLoop
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ServeLoop(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Runs on serveThread until Stop. Connections are answered one at a time, scrapes are rare and
+-- the answer is a copy of a few KB.
+----------------------------------------------------------------------------------------------------------------------*/
+void MetricsEndpoint::ServeLoop()
+{
+	while (keepServing)
+	{
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(listenSocket, &readSet);
+		struct timeval timeout = { 0, METRICS_POLL_US };
+		if (select(0, &readSet, NULL, NULL, &timeout) <= 0)
+			continue;
+		SOCKET connection = accept(listenSocket, NULL, NULL);
+		if (connection == INVALID_SOCKET)
+			continue;
+		Answer(connection);
+		closesocket(connection);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Answer
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Answer(SOCKET connection)
+		- connection : SOCKET, just accepted, blocking
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Reads until the end of the request headers, then answers GET /metrics (or /) with the page and
+-- anything else with a 404. The body of a request, if any, is never looked at.
+----------------------------------------------------------------------------------------------------------------------*/
+void MetricsEndpoint::Answer(SOCKET connection)
+{
+	DWORD timeoutMs = METRICS_REQUEST_TIMEOUT_MS;
+	setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeoutMs, sizeof(timeoutMs));
+	setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeoutMs, sizeof(timeoutMs));
+	char request[METRICS_REQUEST_MAX];
+	size_t received = 0;
+	while (received < METRICS_REQUEST_MAX)
+	{
+		int bytesRead = recv(connection, request + received, (int)(METRICS_REQUEST_MAX - received), 0);
+		if (bytesRead <= 0)
+			return;
+		received += bytesRead;
+		if (std::string(request, received).find("\r\n\r\n") != std::string::npos)
+			break;
+	}
+	std::string requestText(request, received);
+	std::string requestLine = requestText.substr(0, requestText.find("\r\n"));
+	bool wanted = (requestLine.compare(0, 13, "GET /metrics ") == 0 || requestLine.compare(0, 6, "GET / ") == 0);
+
+	std::string body;
+	if (wanted)
+	{
+		++scrapes;
+		std::lock_guard<std::mutex> lock(pageLock);
+		body = page;
+	}
+	else
+	{
+		body = "only GET /metrics is served here\n";
+	}
+	std::string response = std::string(wanted ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n")
+		+ "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+		+ "Content-Length: " + std::to_string(body.size()) + "\r\n"
+		+ "Connection: close\r\n\r\n" + body;
+	size_t sent = 0;
+	while (sent < response.size())
+	{
+		int bytesSent = send(connection, response.data() + sent, (int)(response.size() - sent), 0);
+		if (bytesSent <= 0)
+			return;
+		sent += bytesSent;
+	}
+	shutdown(connection, SD_SEND);
+}
+
+//a label value with the characters the text format needs escaped, escaped
+QString MetricsEndpoint::LabelValue(const QString& value)
+{
+	QString escaped = value;
+	escaped.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+	return escaped;
+}
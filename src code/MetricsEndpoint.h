@@ -0,0 +1,43 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TransferSession.h"
+#include "TaskScheduler.h"
+
+#define METRICS_POLL_US 100000 //accept timeout of the serving thread, how quickly Stop is noticed
+#define METRICS_REQUEST_MAX 4096 //request bytes read before answering, a curl or Prometheus GET fits
+#define METRICS_REQUEST_TIMEOUT_MS 1000 //a connection that doesnt finish its request by then is dropped
+
+//Prometheus text format over a tiny HTTP server on 127.0.0.1, one page of every session's counters
+class MetricsEndpoint
+{
+public:
+	static MetricsEndpoint& Shared();
+	bool Start(const int);
+	void Stop();
+	bool IsRunning() const;
+	void Publish(const std::vector<SessionSnapshot>&, const TaskScheduler&);
+
+private:
+	MetricsEndpoint();
+	void ServeLoop();
+	void Answer(SOCKET);
+	static QString LabelValue(const QString&);
+
+	SOCKET listenSocket;
+	std::thread serveThread;
+	std::atomic<bool> keepServing;
+	std::mutex pageLock; //between Publish on the main thread and the serving thread, the transfer loops never take it
+	std::string page; //the latest Publish, what every GET /metrics gets
+	std::atomic<uint64_t> scrapes;
+};
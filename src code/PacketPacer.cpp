@@ -0,0 +1,362 @@
+#include "PacketPacer.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PacketPacer.cpp - A token bucket that spaces out sends to a target rate
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void Start();
+	void Pace(const size_t);
+	bool IsPaced() const;
+	bool ApplyKernelPacing(SOCKET);
+	double GetTargetRate() const;
+	double GetTargetPacketRate() const;
+	double GetAchievedRate() const;
+	double GetAchievedPacketRate() const;
+	size_t GetTimesThrottled() const;
+	void Refill(const double);
+	void WaitUntil(const std::chrono::steady_clock::time_point);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Client used to fire packets as fast as its loop ran, which overruns the receiver's socket buffer
+-- and UDP datagrams get dropped without either side knowing.
+-- The bucket fills at the target rate up to a small burst size; each packet takes its size in tokens
+-- before it is allowed out. Waits longer than a couple ms sleep, the tail is spun off so timing stays
+-- in the microseconds range instead of the ~15ms default Windows timer tick.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PacketPacer Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: PacketPacer(const size_t rate, const size_t burst, const size_t packetRate)
+		- rate : unsigned int, target bytes per second. 0 turns pacing off
+		- burst : unsigned int, bucket size in bytes. 0 picks 10ms worth of the rate
+		- packetRate : unsigned int, pkt/s the user entered rate as, 0 if it was entered in KB/s. Only for reporting
+
+-- RETURNS: N/A
+----------------------------------------------------------------------------------------------------------------------*/
+PacketPacer::PacketPacer(const size_t rate, const size_t burst, const size_t packetRate)
+	: ratePerSec((double)rate)
+	, packetRatePerSec((double)packetRate)
+	, bucketCapacity((double)burst)
+	, tokens(0)
+	, bytesPaced(0)
+	, packetsPaced(0)
+	, timesThrottled(0)
+	, timerResolutionRaised(false)
+{
+	if (bucketCapacity <= 0)
+	{
+		bucketCapacity = ratePerSec / 100;
+	}
+	Start();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PacketPacer Destructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: ~PacketPacer(void)
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+-- Gives back the 1ms system timer resolution asked for in Start.
+----------------------------------------------------------------------------------------------------------------------*/
+PacketPacer::~PacketPacer()
+{
+	if (timerResolutionRaised)
+	{
+		timeEndPeriod(1);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Start
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Start(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Resets counters and fills the bucket. Call right before the first send so setup time
+-- (building the packet from file) doesnt count against the achieved rate.
+----------------------------------------------------------------------------------------------------------------------*/
+void PacketPacer::Start()
+{
+	if (IsPaced() && !timerResolutionRaised)
+	{
+		//default windows sleep granularity is ~15ms, far too coarse to pace with
+		timerResolutionRaised = (timeBeginPeriod(1) == TIMERR_NOERROR);
+	}
+	tokens = bucketCapacity;
+	bytesPaced = 0;
+	packetsPaced = 0;
+	timesThrottled = 0;
+	startTime = std::chrono::steady_clock::now();
+	lastRefill = startTime;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Pace
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Pace(const size_t packetBytes)
+		- packetBytes : unsigned int, size of the packet about to be sent
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Call once per packet, before the send. Blocks until the bucket holds enough tokens for the packet.
+-- Packets bigger than the bucket are let through once the bucket is full, so they still average out
+-- to the target rate.
+----------------------------------------------------------------------------------------------------------------------*/
+void PacketPacer::Pace(const size_t packetBytes)
+{
+	bytesPaced += packetBytes;
+	++packetsPaced;
+	if (!IsPaced())
+		return;
+
+	double needed = (double)packetBytes;
+	double cap = (needed > bucketCapacity) ? needed : bucketCapacity;
+	Refill(cap);
+	if (tokens < needed)
+	{
+		++timesThrottled;
+		double secondsShort = (needed - tokens) / ratePerSec;
+		auto wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(secondsShort));
+		WaitUntil(std::chrono::steady_clock::now() + wait);
+		Refill(cap);
+	}
+	tokens -= needed;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION IsPaced
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool IsPaced(void) const
+--
+-- RETURNS: bool : whether a target rate was set
+----------------------------------------------------------------------------------------------------------------------*/
+bool PacketPacer::IsPaced() const
+{
+	return ratePerSec > 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ApplyKernelPacing
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ApplyKernelPacing(SOCKET socket)
+		- socket : SOCKET, socket packets will be sent on
+
+-- RETURNS: bool : whether the OS took over pacing on top of the bucket
+--
+-- NOTES:
+-- SO_MAX_PACING_RATE only exists on linux stacks. WinSock2 doesnt define it, so on windows this
+-- always returns false and the token bucket does all the work.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PacketPacer::ApplyKernelPacing(SOCKET socket)
+{
+#ifdef SO_MAX_PACING_RATE
+	if (!IsPaced())
+		return false;
+	unsigned int rate = (unsigned int)ratePerSec;
+	return setsockopt(socket, SOL_SOCKET, SO_MAX_PACING_RATE, (const char*)&rate, sizeof(rate)) == 0;
+#else
+	(void)socket;
+	return false;
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetTargetRate
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: double GetTargetRate(void) const
+--
+-- RETURNS: double : target bytes per second, 0 if unpaced
+----------------------------------------------------------------------------------------------------------------------*/
+double PacketPacer::GetTargetRate() const
+{
+	return ratePerSec;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetTargetPacketRate
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: double GetTargetPacketRate(void) const
+--
+-- RETURNS: double : target pkt/s as the user entered it, 0 if unpaced or entered in KB/s
+----------------------------------------------------------------------------------------------------------------------*/
+double PacketPacer::GetTargetPacketRate() const
+{
+	return packetRatePerSec;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetAchievedRate
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: double GetAchievedRate(void) const
+--
+-- RETURNS: double : bytes per second actually let through since Start
+----------------------------------------------------------------------------------------------------------------------*/
+double PacketPacer::GetAchievedRate() const
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return (seconds > 0) ? bytesPaced / seconds : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetAchievedPacketRate
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: double GetAchievedPacketRate(void) const
+--
+-- RETURNS: double : packets per second actually let through since Start
+----------------------------------------------------------------------------------------------------------------------*/
+double PacketPacer::GetAchievedPacketRate() const
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return (seconds > 0) ? packetsPaced / seconds : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetTimesThrottled
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: size_t GetTimesThrottled(void) const
+--
+-- RETURNS: unsigned int : number of packets that had to wait for tokens
+----------------------------------------------------------------------------------------------------------------------*/
+size_t PacketPacer::GetTimesThrottled() const
+{
+	return timesThrottled;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Refill
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Refill(const double cap)
+		- cap : double, most tokens the bucket may hold right now
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Adds tokens for the time passed since last refill.
+----------------------------------------------------------------------------------------------------------------------*/
+void PacketPacer::Refill(const double cap)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(now - lastRefill).count();
+	lastRefill = now;
+	tokens += seconds * ratePerSec;
+	if (tokens > cap)
+		tokens = cap;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WaitUntil
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void WaitUntil(const std::chrono::steady_clock::time_point deadline)
+		- deadline : time_point, when the next packet may go out
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Sleeps for all but the last ~2ms (sleep overshoots), then yields in a loop until the deadline.
+----------------------------------------------------------------------------------------------------------------------*/
+void PacketPacer::WaitUntil(const std::chrono::steady_clock::time_point deadline)
+{
+	const std::chrono::microseconds spinWindow(2000);
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (deadline - now > spinWindow)
+	{
+		long long sleepUs = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now - spinWindow).count();
+		QThread::usleep((unsigned long)sleepUs);
+	}
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		QThread::yieldCurrentThread();
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "winmm.lib")
+
+#include <WinSock2.h>
+#include <Windows.h>
+#include <QThread>
+#include <chrono>
+
+class PacketPacer
+{
+public:
+	PacketPacer(const size_t = 0, const size_t = 0, const size_t = 0);
+	virtual ~PacketPacer();
+	void Start();
+	void Pace(const size_t);
+	bool IsPaced() const;
+	bool ApplyKernelPacing(SOCKET);
+	double GetTargetRate() const;
+	double GetTargetPacketRate() const;
+	double GetAchievedRate() const;
+	double GetAchievedPacketRate() const;
+	size_t GetTimesThrottled() const;
+
+private:
+	double ratePerSec; //bytes per second, 0 is unpaced
+	double packetRatePerSec; //pkt/s the rate was entered as, 0 when it was entered in bytes
+	double bucketCapacity; //max bytes allowed in a single burst
+	double tokens;
+	size_t bytesPaced;
+	size_t packetsPaced;
+	size_t timesThrottled;
+	bool timerResolutionRaised;
+	std::chrono::steady_clock::time_point startTime;
+	std::chrono::steady_clock::time_point lastRefill;
+
+	void Refill(const double);
+	void WaitUntil(const std::chrono::steady_clock::time_point);
+};
@@ -0,0 +1,208 @@
+#include "PingPong.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PingPong.cpp - Ping-pong message header and the round trip time histogram
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void WritePingHeader(char*, const uint64_t);
+	bool ReadPingHeader(const char*, const size_t, uint64_t&);
+	bool WaitForReadable(SOCKET, const long);
+	void Record(const uint64_t);
+	uint64_t GetCount() const;
+	double PercentileUs(const double) const;
+	QString Summary() const;
+	size_t BucketOf(const uint64_t);
+	uint64_t BucketMiddle(const size_t);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Ping-pong mode sends one message, waits for the server to echo it back, then sends the next, so
+-- what it measures is the round trip of a small request rather than how fast bulk data moves.
+-- Every message starts with PING_MAGIC and its sequence number so the client can tell a late UDP
+-- echo of an earlier message from the one it is waiting for; the rest is the packet as usual.
+--
+-- Times go in buckets: exact below 32ns, then 32 per power of two, so any percentile is within
+-- about 3% and a run of any length costs the same 9KB.
+----------------------------------------------------------------------------------------------------------------------*/
+
+void WritePingHeader(char* message, const uint64_t sequence)
+{
+	WriteLittleEndian(message, PING_MAGIC, 4);
+	WriteLittleEndian(message + 4, sequence, 8);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadPingHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReadPingHeader(const char* message, const size_t length, uint64_t& sequence)
+		- message : an echo as it came back
+		- length : its size
+		- sequence : set to the message's sequence number
+
+-- RETURNS: bool : false if it is too short or isnt a ping-pong message
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReadPingHeader(const char* message, const size_t length, uint64_t& sequence)
+{
+	if (length < PING_HEADER_SIZE || (uint32_t)ReadLittleEndian(message, 4) != PING_MAGIC)
+		return false;
+	sequence = ReadLittleEndian(message + 4, 8);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WaitForReadable
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool WaitForReadable(SOCKET socket, const long timeoutUs)
+		- socket : SOCKET, non blocking
+		- timeoutUs : longest to wait
+
+-- RETURNS: bool : true if there is something to read
+--
+-- NOTES:
+-- The bulk loops sleep a millisecond when the socket is empty, which the timer stretches to as much
+-- as 15ms; fine for throughput, but it would be most of a round trip. select wakes as soon as
+-- data lands instead.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WaitForReadable(SOCKET socket, const long timeoutUs)
+{
+	fd_set readSet;
+	FD_ZERO(&readSet);
+	FD_SET(socket, &readSet);
+	struct timeval timeout = { timeoutUs / 1000000, timeoutUs % 1000000 };
+	return select(0, &readSet, NULL, NULL, &timeout) > 0;
+}
+
+RttHistogram::RttHistogram()
+	: count(0), minNs(UINT64_MAX), maxNs(0), sumNs(0)
+{
+	memset(buckets, 0, sizeof(buckets));
+}
+
+void RttHistogram::Record(const uint64_t rttNs)
+{
+	++buckets[BucketOf(rttNs)];
+	++count;
+	sumNs += rttNs;
+	minNs = std::min(minNs, rttNs);
+	maxNs = std::max(maxNs, rttNs);
+}
+
+uint64_t RttHistogram::GetCount() const
+{
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PercentileUs
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: double PercentileUs(const double fraction) const
+		- fraction : 0.5 for the median, 0.999 for p99.9
+
+-- RETURNS: double : the RTT that fraction of the messages came back within, in us. 0 with no messages
+--
+-- NOTES:
+-- The middle of the bucket it lands in, kept inside the real min and max.
+----------------------------------------------------------------------------------------------------------------------*/
+double RttHistogram::PercentileUs(const double fraction) const
+{
+	if (count == 0)
+		return 0;
+	uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(fraction * count));
+	uint64_t seen = 0;
+	size_t bucket = 0;
+	for (; bucket < RTT_BUCKETS - 1; ++bucket)
+	{
+		seen += buckets[bucket];
+		if (seen >= rank)
+			break;
+	}
+	uint64_t rttNs = std::min(std::max(BucketMiddle(bucket), minNs), maxNs);
+	return rttNs / 1000.0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Summary
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString Summary(void) const
+--
+-- RETURNS: QString : min, p50, p99, p99.9, max and mean in us, for the results label and console
+----------------------------------------------------------------------------------------------------------------------*/
+QString RttHistogram::Summary() const
+{
+	if (count == 0)
+		return "RTT: no echoes came back";
+	return QString("RTT over %1: min %2us p50 %3us p99 %4us p99.9 %5us max %6us, mean %7us")
+		.arg(count)
+		.arg(minNs / 1000.0, 0, 'f', 1)
+		.arg(PercentileUs(0.5), 0, 'f', 1)
+		.arg(PercentileUs(0.99), 0, 'f', 1)
+		.arg(PercentileUs(0.999), 0, 'f', 1)
+		.arg(maxNs / 1000.0, 0, 'f', 1)
+		.arg(sumNs / 1000.0 / count, 0, 'f', 1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION BucketOf
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: size_t BucketOf(const uint64_t rttNs)
+		- rttNs : one round trip
+
+-- RETURNS: size_t : its bucket. Below RTT_SUB_BUCKETS a bucket per ns, then the top 6 bits pick it
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RttHistogram::BucketOf(const uint64_t rttNs)
+{
+	if (rttNs < RTT_SUB_BUCKETS)
+		return (size_t)rttNs;
+	unsigned long magnitude;
+	_BitScanReverse64(&magnitude, rttNs);
+	if (magnitude > RTT_MAX_SHIFT)
+		return RTT_BUCKETS - 1;
+	size_t sub = (size_t)(rttNs >> (magnitude - 5)) - RTT_SUB_BUCKETS;
+	return RTT_SUB_BUCKETS + (magnitude - 5) * RTT_SUB_BUCKETS + sub;
+}
+
+uint64_t RttHistogram::BucketMiddle(const size_t bucket)
+{
+	if (bucket < RTT_SUB_BUCKETS)
+		return bucket;
+	size_t shift = (bucket - RTT_SUB_BUCKETS) / RTT_SUB_BUCKETS;
+	uint64_t low = (uint64_t)(RTT_SUB_BUCKETS + (bucket - RTT_SUB_BUCKETS) % RTT_SUB_BUCKETS) << shift;
+	return low + ((1ULL << shift) >> 1);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <intrin.h>
+#include <QString>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "BatchProtocol.h"
+#include "UdpMeasure.h"
+
+#define PING_MAGIC 0x524E5341 //"ASNR", first bytes of every ping-pong message
+#define PING_HEADER_SIZE 12 //magic(4) + sequence(8), smallest message a ping-pong client sends
+#define PING_TIMEOUT_MS 1000 //a UDP message whose echo isnt back by then is counted lost
+#define PING_POLL_US 100000 //select timeout when not busy polling, how quickly a stop is noticed
+#define RTT_SUB_BUCKETS 32 //linear buckets per power of two of ns, within about 3% of the real RTT
+#define RTT_MAX_SHIFT 40 //RTTs up to 2^41ns (36 min) get their own bucket, longer land in the last one
+#define RTT_BUCKETS (RTT_SUB_BUCKETS + (RTT_MAX_SHIFT - 4) * RTT_SUB_BUCKETS)
+
+void WritePingHeader(char*, const uint64_t);
+bool ReadPingHeader(const char*, const size_t, uint64_t&);
+bool WaitForReadable(SOCKET, const long);
+
+//round trip times of a ping-pong run, in fixed log-linear buckets so recording never allocates
+class RttHistogram
+{
+public:
+	RttHistogram();
+	virtual ~RttHistogram() = default;
+	void Record(const uint64_t);
+	uint64_t GetCount() const;
+	double PercentileUs(const double) const;
+	QString Summary() const;
+
+private:
+	static size_t BucketOf(const uint64_t);
+	static uint64_t BucketMiddle(const size_t);
+
+	uint64_t buckets[RTT_BUCKETS];
+	uint64_t count;
+	uint64_t minNs;
+	uint64_t maxNs;
+	uint64_t sumNs;
+};
@@ -0,0 +1,432 @@
+#include "RioUdp.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RioUdp.cpp - Registered I/O backend for the UDP single file send and receive
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	SOCKET OpenRioSocket(const int);
+	uint64_t GetUdpReceiveErrors();
+	bool Open(SOCKET, const size_t);
+	bool Send(const char*, const size_t, const struct sockaddr_storage&);
+	void Flush();
+	bool PostReceives();
+	int Poll(const std::function<void(const char*, const size_t)>&);
+	uint64_t GetFailed() const;
+	void Commit();
+	void Reclaim(size_t, const RIORESULT&);
+	int Dequeue(const std::function<void(size_t, const RIORESULT&)>&, const bool);
+	void Post(const size_t);
+	RIO_BUF SlotData(const size_t, const size_t) const;
+	RIO_BUF SlotAddress(const size_t) const;
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- At the highest rates sendto/recv themselves are the cost: every call locks and maps the user
+-- buffer, and every completion is a syscall. Linux gets around that with AF_XDP, a UMEM shared
+-- with the kernel and rings to pass descriptors through. WinSock's in box equivalent is Registered
+-- I/O: one buffer is registered (locked) up front and cut into slots, requests go into a request
+-- queue and results come back through a completion queue, with sends batched before the kernel is
+-- told about them. It still goes through the normal UDP stack, so it runs on loopback or any NIC.
+--
+-- RIO needs Windows 8 and a socket made with WSA_FLAG_REGISTERED_IO. If either is missing Open
+-- fails and the callers use their socket path instead.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION OpenRioSocket
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: SOCKET OpenRioSocket(const int family)
+		- family : AF_INET or AF_INET6
+
+-- RETURNS: SOCKET : UDP socket that can take RIO requests, bound to any port. INVALID_SOCKET if RIO isnt supported
+--
+-- NOTES:
+-- For the client, the socket HostConnector made was made with socket(), which RIO wont take.
+----------------------------------------------------------------------------------------------------------------------*/
+SOCKET OpenRioSocket(const int family)
+{
+	SOCKET rioSocket = WSASocket(family, SOCK_DGRAM, IPPROTO_UDP, nullptr, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+	if (rioSocket == INVALID_SOCKET)
+		return INVALID_SOCKET;
+	struct sockaddr_storage local;
+	memset(&local, 0, sizeof(local));
+	local.ss_family = family;
+	int localLength = (family == AF_INET6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+	if (family == AF_INET6)
+	{
+		int off = 0;
+		setsockopt(rioSocket, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&off, sizeof(off));
+	}
+	if (bind(rioSocket, (struct sockaddr*)&local, localLength) != 0)
+	{
+		closesocket(rioSocket);
+		return INVALID_SOCKET;
+	}
+	return rioSocket;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetUdpReceiveErrors
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: uint64_t GetUdpReceiveErrors(void)
+--
+-- RETURNS: uint64_t : UDP datagrams the stack dropped on receive so far (full socket buffers mostly),
+--                     IPv4 and IPv6, for the whole machine
+--
+-- NOTES:
+-- WinSock doesnt count drops per socket, so the difference of this over a run is the closest there is.
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t GetUdpReceiveErrors()
+{
+	uint64_t errors = 0;
+	MIB_UDPSTATS stats;
+	if (GetUdpStatisticsEx(&stats, AF_INET) == NO_ERROR)
+		errors += stats.dwInErrors;
+	if (GetUdpStatisticsEx(&stats, AF_INET6) == NO_ERROR)
+		errors += stats.dwInErrors;
+	return errors;
+}
+
+RioUdpChannel::RioUdpChannel()
+	: socket(INVALID_SOCKET)
+	, slotSize(0)
+	, dataBuffer(nullptr)
+	, addressBuffer(nullptr)
+	, dataId(RIO_INVALID_BUFFERID)
+	, addressId(RIO_INVALID_BUFFERID)
+	, completionEvent(nullptr)
+	, completionQueue(RIO_INVALID_CQ)
+	, requestQueue(RIO_INVALID_RQ)
+	, deferred(0)
+	, failed(0)
+{
+	memset(&rio, 0, sizeof(rio));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RioUdpChannel Destructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: ~RioUdpChannel(void)
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+-- The request queue goes with the socket. Close the socket first if receives are still posted,
+-- so nothing lands in the buffer after it's deregistered.
+----------------------------------------------------------------------------------------------------------------------*/
+RioUdpChannel::~RioUdpChannel()
+{
+	if (completionQueue != RIO_INVALID_CQ)
+		rio.RIOCloseCompletionQueue(completionQueue);
+	if (dataId != RIO_INVALID_BUFFERID)
+		rio.RIODeregisterBuffer(dataId);
+	if (addressId != RIO_INVALID_BUFFERID)
+		rio.RIODeregisterBuffer(addressId);
+	if (dataBuffer != nullptr)
+		VirtualFree(dataBuffer, 0, MEM_RELEASE);
+	if (addressBuffer != nullptr)
+		VirtualFree(addressBuffer, 0, MEM_RELEASE);
+	if (completionEvent != nullptr)
+		CloseHandle(completionEvent);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(SOCKET rioSocket, const size_t datagramSize)
+		- rioSocket : SOCKET, UDP socket made with WSA_FLAG_REGISTERED_IO, bound
+		- datagramSize : biggest datagram sent or received, size of each slot
+
+-- RETURNS: bool : whether RIO could be set up on this socket
+--
+-- NOTES:
+-- Buffers come from VirtualAlloc so slots are page aligned and registering doesnt lock more than needed.
+-- The completion queue signals an event instead of being polled, so an idle receive doesnt spin.
+----------------------------------------------------------------------------------------------------------------------*/
+bool RioUdpChannel::Open(SOCKET rioSocket, const size_t datagramSize)
+{
+	socket = rioSocket;
+	slotSize = datagramSize;
+	GUID rioId = WSAID_MULTIPLE_RIO;
+	DWORD bytesReturned = 0;
+	rio.cbSize = sizeof(rio);
+	if (WSAIoctl(socket, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, &rioId, sizeof(rioId),
+		&rio, sizeof(rio), &bytesReturned, nullptr, nullptr) != 0)
+	{
+		return false;
+	}
+
+	dataBuffer = (char*)VirtualAlloc(nullptr, RIO_UDP_SLOTS * slotSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	addressBuffer = (SOCKADDR_INET*)VirtualAlloc(nullptr, RIO_UDP_SLOTS * sizeof(SOCKADDR_INET), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if (dataBuffer == nullptr || addressBuffer == nullptr)
+		return false;
+	dataId = rio.RIORegisterBuffer(dataBuffer, (DWORD)(RIO_UDP_SLOTS * slotSize));
+	addressId = rio.RIORegisterBuffer((PCHAR)addressBuffer, (DWORD)(RIO_UDP_SLOTS * sizeof(SOCKADDR_INET)));
+	if (dataId == RIO_INVALID_BUFFERID || addressId == RIO_INVALID_BUFFERID)
+		return false;
+
+	completionEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	RIO_NOTIFICATION_COMPLETION notification;
+	memset(&notification, 0, sizeof(notification));
+	notification.Type = RIO_EVENT_COMPLETION;
+	notification.Event.EventHandle = completionEvent;
+	notification.Event.NotifyReset = TRUE;
+	completionQueue = rio.RIOCreateCompletionQueue(RIO_UDP_SLOTS, &notification);
+	if (completionQueue == RIO_INVALID_CQ)
+		return false;
+	requestQueue = rio.RIOCreateRequestQueue(socket, RIO_UDP_SLOTS, 1, RIO_UDP_SLOTS, 1, completionQueue, completionQueue, nullptr);
+	if (requestQueue == RIO_INVALID_RQ)
+		return false;
+
+	freeSlots.clear();
+	for (size_t slot = RIO_UDP_SLOTS; slot > 0; --slot)
+	{
+		freeSlots.push_back(slot - 1);
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Send
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Send(const char* datagram, const size_t length, const struct sockaddr_storage& destination)
+		- datagram : bytes to send, copied into a slot so the caller can reuse it right away
+		- length : at most the datagramSize given to Open
+		- destination : IPv4 or IPv6 address to send to
+
+-- RETURNS: bool : whether the send was queued. Whether it went out shows up in GetFailed later
+--
+-- NOTES:
+-- Sends are deferred and handed to the kernel RIO_UDP_SEND_BATCH at a time. When every slot is
+-- in flight this waits for some to complete.
+----------------------------------------------------------------------------------------------------------------------*/
+bool RioUdpChannel::Send(const char* datagram, const size_t length, const struct sockaddr_storage& destination)
+{
+	while (freeSlots.empty())
+	{
+		Commit();
+		if (Dequeue([this](size_t slot, const RIORESULT& result) { Reclaim(slot, result); }, true) < 0)
+			return false;
+	}
+	size_t slot = freeSlots.back();
+	freeSlots.pop_back();
+	memcpy(dataBuffer + slot * slotSize, datagram, length);
+	memcpy(&addressBuffer[slot], &destination, (destination.ss_family == AF_INET6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
+
+	RIO_BUF data = SlotData(slot, length);
+	RIO_BUF address = SlotAddress(slot);
+	if (!rio.RIOSendEx(requestQueue, &data, 1, nullptr, &address, nullptr, nullptr, RIO_MSG_DEFER, (PVOID)slot))
+	{
+		freeSlots.push_back(slot);
+		return false;
+	}
+	if (++deferred >= RIO_UDP_SEND_BATCH)
+	{
+		Commit();
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Flush
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Flush(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Hands any deferred sends to the kernel and waits for every send in flight to complete, so
+-- GetFailed is final and the socket can be closed. Gives up after RIO_UDP_FLUSH_WAITS waits
+-- without a completion.
+----------------------------------------------------------------------------------------------------------------------*/
+void RioUdpChannel::Flush()
+{
+	Commit();
+	int idleWaits = 0;
+	while (freeSlots.size() < RIO_UDP_SLOTS && idleWaits < RIO_UDP_FLUSH_WAITS)
+	{
+		int completed = Dequeue([this](size_t slot, const RIORESULT& result) { Reclaim(slot, result); }, true);
+		if (completed < 0)
+			break;
+		idleWaits = (completed == 0) ? idleWaits + 1 : 0;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PostReceives
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool PostReceives(void)
+--
+-- RETURNS: bool : whether every slot has a receive posted on it
+----------------------------------------------------------------------------------------------------------------------*/
+bool RioUdpChannel::PostReceives()
+{
+	for (size_t slot = 0; slot < RIO_UDP_SLOTS; ++slot)
+	{
+		RIO_BUF data = SlotData(slot, slotSize);
+		RIO_BUF address = SlotAddress(slot);
+		if (!rio.RIOReceiveEx(requestQueue, &data, 1, nullptr, &address, nullptr, nullptr, 0, (PVOID)slot))
+			return false;
+	}
+	freeSlots.clear();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Poll
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int Poll(const std::function<void(const char*, const size_t)>& onDatagram)
+		- onDatagram : called with each datagram received, the bytes are only good during the call
+
+-- RETURNS: int : datagrams completed (failed ones included), 0 if none came within RIO_UDP_WAIT_MS,
+--                -1 if the completion queue broke
+--
+-- NOTES:
+-- Every slot's receive is posted again right after its datagram was handed over.
+----------------------------------------------------------------------------------------------------------------------*/
+int RioUdpChannel::Poll(const std::function<void(const char*, const size_t)>& onDatagram)
+{
+	return Dequeue([&](size_t slot, const RIORESULT& result) {
+		if (result.Status == 0)
+			onDatagram(dataBuffer + slot * slotSize, result.BytesTransferred);
+		Post(slot);
+	}, true);
+}
+
+uint64_t RioUdpChannel::GetFailed() const
+{
+	return failed;
+}
+
+//tell the kernel about the deferred sends
+void RioUdpChannel::Commit()
+{
+	if (deferred == 0)
+		return;
+	rio.RIOSendEx(requestQueue, nullptr, 0, nullptr, nullptr, nullptr, nullptr, RIO_MSG_COMMIT_ONLY, nullptr);
+	deferred = 0;
+}
+
+//a send completed, its slot can take the next datagram
+void RioUdpChannel::Reclaim(size_t slot, const RIORESULT&)
+{
+	freeSlots.push_back(slot);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Dequeue
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int Dequeue(const std::function<void(size_t, const RIORESULT&)>& onResult, const bool wait)
+		- onResult : called with the slot and result of every completion
+		- wait : if nothing is there yet, wait up to RIO_UDP_WAIT_MS for the completion event
+
+-- RETURNS: int : completions taken, -1 if the completion queue broke
+----------------------------------------------------------------------------------------------------------------------*/
+int RioUdpChannel::Dequeue(const std::function<void(size_t, const RIORESULT&)>& onResult, const bool wait)
+{
+	RIORESULT results[RIO_UDP_DEQUEUE_BATCH];
+	ULONG count = rio.RIODequeueCompletion(completionQueue, results, RIO_UDP_DEQUEUE_BATCH);
+	if (count == 0 && wait)
+	{
+		rio.RIONotify(completionQueue);
+		WaitForSingleObject(completionEvent, RIO_UDP_WAIT_MS);
+		count = rio.RIODequeueCompletion(completionQueue, results, RIO_UDP_DEQUEUE_BATCH);
+	}
+	if (count == RIO_CORRUPT_CQ)
+		return -1;
+	for (ULONG i = 0; i < count; ++i)
+	{
+		if (results[i].Status != 0)
+			++failed;
+		onResult((size_t)results[i].RequestContext, results[i]);
+	}
+	return (int)count;
+}
+
+//post the receive of one slot again
+void RioUdpChannel::Post(const size_t slot)
+{
+	RIO_BUF data = SlotData(slot, slotSize);
+	RIO_BUF address = SlotAddress(slot);
+	if (!rio.RIOReceiveEx(requestQueue, &data, 1, nullptr, &address, nullptr, nullptr, 0, (PVOID)slot))
+		++failed;
+}
+
+RIO_BUF RioUdpChannel::SlotData(const size_t slot, const size_t length) const
+{
+	RIO_BUF data;
+	data.BufferId = dataId;
+	data.Offset = (ULONG)(slot * slotSize);
+	data.Length = (ULONG)length;
+	return data;
+}
+
+RIO_BUF RioUdpChannel::SlotAddress(const size_t slot) const
+{
+	RIO_BUF address;
+	address.BufferId = addressId;
+	address.Offset = (ULONG)(slot * sizeof(SOCKADDR_INET));
+	address.Length = sizeof(SOCKADDR_INET);
+	return address;
+}
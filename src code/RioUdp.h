@@ -0,0 +1,59 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "iphlpapi.lib")
+
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <Windows.h>
+#include <mswsock.h>
+#include <iphlpapi.h>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#define RIO_UDP_SLOTS 1024 //datagrams in flight, each has its own slot of the registered buffer
+#define RIO_UDP_SLOT_SIZE 65536 //fits the biggest datagram
+#define RIO_UDP_SEND_BATCH 64 //sends deferred before the kernel is told about them
+#define RIO_UDP_DEQUEUE_BATCH 256 //completions taken off the queue per call
+#define RIO_UDP_WAIT_MS 100 //wait for a completion, how quickly a stop is noticed
+#define RIO_UDP_FLUSH_WAITS 20 //empty waits before Flush gives up on sends still in flight
+
+SOCKET OpenRioSocket(const int);
+uint64_t GetUdpReceiveErrors();
+
+//UDP over Registered I/O: one registered buffer cut into slots, a request queue and a completion queue
+class RioUdpChannel
+{
+public:
+	RioUdpChannel();
+	virtual ~RioUdpChannel();
+	bool Open(SOCKET, const size_t);
+	bool Send(const char*, const size_t, const struct sockaddr_storage&);
+	void Flush();
+	bool PostReceives();
+	int Poll(const std::function<void(const char*, const size_t)>&);
+	uint64_t GetFailed() const;
+
+private:
+	RIO_EXTENSION_FUNCTION_TABLE rio;
+	SOCKET socket;
+	size_t slotSize;
+	char* dataBuffer; //RIO_UDP_SLOTS x slotSize, registered once
+	SOCKADDR_INET* addressBuffer; //one address per slot
+	RIO_BUFFERID dataId;
+	RIO_BUFFERID addressId;
+	HANDLE completionEvent;
+	RIO_CQ completionQueue;
+	RIO_RQ requestQueue;
+	std::vector<size_t> freeSlots; //send side, slots whose send completed
+	size_t deferred; //sends not yet committed
+	uint64_t failed; //completions with an error status
+
+	void Commit();
+	void Reclaim(size_t, const RIORESULT&);
+	int Dequeue(const std::function<void(size_t, const RIORESULT&)>&, const bool);
+	void Post(const size_t);
+	RIO_BUF SlotData(const size_t, const size_t) const;
+	RIO_BUF SlotAddress(const size_t) const;
+};
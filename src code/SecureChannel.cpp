@@ -0,0 +1,431 @@
+#include "SecureChannel.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SecureChannel.cpp - Encrypted records for the TCP single file transfer
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	bool HasAesInstructions();
+	bool WriteHello(char*);
+	bool ReadHello(const char*);
+	void WriteFinished(char*) const;
+	bool CheckFinished(const char*) const;
+	size_t Seal(const char*, const size_t, char*);
+	bool Open(char*, const size_t);
+	static size_t SealedSize(const size_t);
+	bool DeriveBytes(BCRYPT_SECRET_HANDLE, const unsigned char*, const char*, unsigned char*);
+	bool DeriveKey(BCRYPT_SECRET_HANDLE, const unsigned char*, const char*, BCRYPT_KEY_HANDLE&);
+	void MakeNonce(const uint64_t, unsigned char*);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- What TLS does for a stream, cut down to what a transfer between two copies of this program needs.
+-- Right after connecting both sides send a hello with a fresh ECDH P-256 public key. The shared key
+-- typed in on both ends is run through PBKDF2-HMAC-SHA256, salted with both public keys, and that is
+-- the HMAC key the ECDH secret goes through (with a label each) to make two AES-256-GCM keys, one per
+-- direction, and a finished value per side. Client sends its finished value first, the server checks
+-- it before sending its own, so an end that doesnt know the shared key, or a man in the middle who
+-- swapped the public keys, is caught before any file data moves. After that the stream is records:
+-- ciphertext length(4), ciphertext, 16 byte tag. The length is authenticated too, and the nonce is
+-- the record number, which both sides count themselves instead of sending it.
+--
+-- There are no certificates: SChannel would need one installed on every server, which a tool you
+-- run on two lab machines doesnt have. Someone in the middle can still get one finished value and
+-- try guessing the shared key offline, the PBKDF2 rounds slow that down but a long random key is
+-- what really stops it.
+--
+-- Linux could hand the records to the kernel (kTLS) after the handshake, Windows has no such thing
+-- for sockets. CNG's AES-GCM uses AES-NI and PCLMULQDQ when the CPU has them and its own software
+-- AES when it doesnt, HasAesInstructions is only there to say which one a run got.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION HasAesInstructions
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool HasAesInstructions(void)
+--
+-- RETURNS: bool : whether the CPU has AES-NI (CPUID leaf 1, ECX bit 25)
+----------------------------------------------------------------------------------------------------------------------*/
+bool HasAesInstructions()
+{
+	int registers[4] = { 0 };
+	__cpuid(registers, 1);
+	return (registers[2] & (1 << 25)) != 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SecureChannel Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: SecureChannel(const bool client, const QString& key)
+		- client : bool, whether this is the connecting side, picks which key is used for sending
+		- key : QString, the shared key entered on both ends
+
+-- RETURNS: N/A
+--
+-- NOTES:
+-- Only opens the algorithm providers, if that fails WriteHello does too.
+----------------------------------------------------------------------------------------------------------------------*/
+SecureChannel::SecureChannel(const bool client, const QString& key)
+	: isClient(client)
+	, sharedKey(key.toUtf8().toStdString())
+	, ecdhAlgorithm(nullptr)
+	, aesAlgorithm(nullptr)
+	, hmacAlgorithm(nullptr)
+	, ownKey(nullptr)
+	, sendKey(nullptr)
+	, receiveKey(nullptr)
+	, sendSequence(0)
+	, receiveSequence(0)
+{
+	memset(ownPublicKey, 0, sizeof(ownPublicKey));
+	memset(ownFinished, 0, sizeof(ownFinished));
+	memset(peerFinished, 0, sizeof(peerFinished));
+	if (BCryptOpenAlgorithmProvider(&ecdhAlgorithm, BCRYPT_ECDH_P256_ALGORITHM, nullptr, 0) != 0)
+		ecdhAlgorithm = nullptr;
+	if (BCryptOpenAlgorithmProvider(&hmacAlgorithm, BCRYPT_SHA256_ALGORITHM, nullptr, BCRYPT_ALG_HANDLE_HMAC_FLAG) != 0)
+		hmacAlgorithm = nullptr;
+	if (BCryptOpenAlgorithmProvider(&aesAlgorithm, BCRYPT_AES_ALGORITHM, nullptr, 0) != 0)
+		aesAlgorithm = nullptr;
+	else if (BCryptSetProperty(aesAlgorithm, BCRYPT_CHAINING_MODE, (PUCHAR)BCRYPT_CHAIN_MODE_GCM,
+		sizeof(BCRYPT_CHAIN_MODE_GCM), 0) != 0)
+	{
+		BCryptCloseAlgorithmProvider(aesAlgorithm, 0);
+		aesAlgorithm = nullptr;
+	}
+}
+
+SecureChannel::~SecureChannel()
+{
+	for (BCRYPT_KEY_HANDLE key : { ownKey, sendKey, receiveKey })
+	{
+		if (key != nullptr)
+			BCryptDestroyKey(key);
+	}
+	if (ecdhAlgorithm != nullptr)
+		BCryptCloseAlgorithmProvider(ecdhAlgorithm, 0);
+	if (aesAlgorithm != nullptr)
+		BCryptCloseAlgorithmProvider(aesAlgorithm, 0);
+	if (hmacAlgorithm != nullptr)
+		BCryptCloseAlgorithmProvider(hmacAlgorithm, 0);
+	if (!sharedKey.empty())
+		SecureZeroMemory(&sharedKey[0], sharedKey.size());
+	SecureZeroMemory(ownFinished, sizeof(ownFinished));
+	SecureZeroMemory(peerFinished, sizeof(peerFinished));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteHello
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool WriteHello(char* hello)
+		- hello : SECURE_HELLO_SIZE bytes, filled with the magic and a new public key
+
+-- RETURNS: bool : whether CNG made and exported the key pair
+----------------------------------------------------------------------------------------------------------------------*/
+bool SecureChannel::WriteHello(char* hello)
+{
+	if (ecdhAlgorithm == nullptr || aesAlgorithm == nullptr || hmacAlgorithm == nullptr || sharedKey.empty())
+		return false;
+	if (BCryptGenerateKeyPair(ecdhAlgorithm, &ownKey, 256, 0) != 0 || BCryptFinalizeKeyPair(ownKey, 0) != 0)
+		return false;
+	ULONG exported = 0;
+	WriteLittleEndian(hello, SECURE_HELLO_MAGIC, 4);
+	if (BCryptExportKey(ownKey, nullptr, BCRYPT_ECCPUBLIC_BLOB, (PUCHAR)hello + 4, SECURE_PUBLIC_KEY_SIZE, &exported, 0) != 0
+		|| exported != SECURE_PUBLIC_KEY_SIZE)
+		return false;
+	memcpy(ownPublicKey, hello + 4, SECURE_PUBLIC_KEY_SIZE);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadHello
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReadHello(const char* hello)
+		- hello : SECURE_HELLO_SIZE bytes from the other side
+
+-- RETURNS: bool : whether the hello was good and both record keys and finished values are ready
+--
+-- NOTES:
+-- WriteHello has to have been called first. CNG checks the point is on the curve when importing it.
+-- A good hello doesnt mean the other end has the shared key yet, the finished values tell that.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SecureChannel::ReadHello(const char* hello)
+{
+	if (ownKey == nullptr || ReadLittleEndian(hello, 4) != SECURE_HELLO_MAGIC)
+		return false;
+	BCRYPT_KEY_HANDLE peerKey = nullptr;
+	if (BCryptImportKeyPair(ecdhAlgorithm, nullptr, BCRYPT_ECCPUBLIC_BLOB, &peerKey, (PUCHAR)hello + 4, SECURE_PUBLIC_KEY_SIZE, 0) != 0)
+		return false;
+	BCRYPT_SECRET_HANDLE secret = nullptr;
+	bool agreed = (BCryptSecretAgreement(ownKey, peerKey, &secret, 0) == 0);
+	BCryptDestroyKey(peerKey);
+	if (!agreed)
+		return false;
+
+	//client's public key then server's, the same salt on both ends and a new one every connection
+	unsigned char salt[2 * SECURE_PUBLIC_KEY_SIZE];
+	memcpy(salt + (isClient ? 0 : SECURE_PUBLIC_KEY_SIZE), ownPublicKey, SECURE_PUBLIC_KEY_SIZE);
+	memcpy(salt + (isClient ? SECURE_PUBLIC_KEY_SIZE : 0), hello + 4, SECURE_PUBLIC_KEY_SIZE);
+	unsigned char macKey[SECURE_KEY_SIZE];
+	if (BCryptDeriveKeyPBKDF2(hmacAlgorithm, (PUCHAR)sharedKey.data(), (ULONG)sharedKey.size(), salt, sizeof(salt),
+		SECURE_KEY_ITERATIONS, macKey, SECURE_KEY_SIZE, 0) != 0)
+	{
+		BCryptDestroySecret(secret);
+		return false;
+	}
+
+	const char* clientLabel = "asn2 client write";
+	const char* serverLabel = "asn2 server write";
+	const char* clientFinished = "asn2 client finished";
+	const char* serverFinished = "asn2 server finished";
+	bool derived = DeriveKey(secret, macKey, isClient ? clientLabel : serverLabel, sendKey)
+		&& DeriveKey(secret, macKey, isClient ? serverLabel : clientLabel, receiveKey)
+		&& DeriveBytes(secret, macKey, isClient ? clientFinished : serverFinished, ownFinished)
+		&& DeriveBytes(secret, macKey, isClient ? serverFinished : clientFinished, peerFinished);
+	SecureZeroMemory(macKey, sizeof(macKey));
+	BCryptDestroySecret(secret);
+	return derived;
+}
+
+//SECURE_FINISHED_SIZE bytes for the other end's CheckFinished, only good after ReadHello
+void SecureChannel::WriteFinished(char* finished) const
+{
+	memcpy(finished, ownFinished, SECURE_FINISHED_SIZE);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION CheckFinished
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool CheckFinished(const char* finished) const
+		- finished : SECURE_FINISHED_SIZE bytes from the other side
+
+-- RETURNS: bool : whether the other end derived the same keys, i.e. has the same shared key and saw
+--                 the same two public keys
+--
+-- NOTES:
+-- Every byte is compared whatever the first difference, so the time taken doesnt give anything away.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SecureChannel::CheckFinished(const char* finished) const
+{
+	if (sendKey == nullptr || receiveKey == nullptr)
+		return false;
+	unsigned char difference = 0;
+	for (int i = 0; i < SECURE_FINISHED_SIZE; i++)
+	{
+		difference |= (unsigned char)finished[i] ^ peerFinished[i];
+	}
+	return difference == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Seal
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: size_t Seal(const char* plain, const size_t length, char* records)
+		- plain : bytes to send
+		- length : how many
+		- records : at least SealedSize(length) bytes, the records to send go here
+
+-- RETURNS: size_t : bytes of records written, 0 if encrypting failed
+--
+-- NOTES:
+-- Split into records of up to SECURE_RECORD_MAX so the receiver can open one without waiting on
+-- a whole big packet.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t SecureChannel::Seal(const char* plain, const size_t length, char* records)
+{
+	size_t written = 0;
+	for (size_t offset = 0; offset < length; offset += SECURE_RECORD_MAX)
+	{
+		ULONG recordLength = (ULONG)std::min<size_t>(length - offset, SECURE_RECORD_MAX);
+		char* record = records + written;
+		WriteLittleEndian(record, recordLength + SECURE_TAG_SIZE, SECURE_RECORD_HEADER_SIZE);
+
+		unsigned char nonce[SECURE_NONCE_SIZE];
+		MakeNonce(sendSequence++, nonce);
+		BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO authInfo;
+		BCRYPT_INIT_AUTH_MODE_INFO(authInfo);
+		authInfo.pbNonce = nonce;
+		authInfo.cbNonce = SECURE_NONCE_SIZE;
+		authInfo.pbAuthData = (PUCHAR)record;
+		authInfo.cbAuthData = SECURE_RECORD_HEADER_SIZE;
+		authInfo.pbTag = (PUCHAR)record + SECURE_RECORD_HEADER_SIZE + recordLength;
+		authInfo.cbTag = SECURE_TAG_SIZE;
+		ULONG encrypted = 0;
+		if (BCryptEncrypt(sendKey, (PUCHAR)plain + offset, recordLength, &authInfo, nullptr, 0,
+			(PUCHAR)record + SECURE_RECORD_HEADER_SIZE, recordLength, &encrypted, 0) != 0)
+			return 0;
+		written += recordLength + SECURE_RECORD_OVERHEAD;
+	}
+	return written;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(char* record, const size_t length)
+		- record : one whole record, header included. Decrypted in place, the plaintext starts
+		           SECURE_RECORD_HEADER_SIZE in
+		- length : bytes in the record, SECURE_RECORD_HEADER_SIZE + the length in its header
+
+-- RETURNS: bool : whether the tag matched, if not the stream has been tampered with or is out of step
+----------------------------------------------------------------------------------------------------------------------*/
+bool SecureChannel::Open(char* record, const size_t length)
+{
+	if (receiveKey == nullptr || length < SECURE_RECORD_OVERHEAD || length > SECURE_RECORD_MAX + SECURE_RECORD_OVERHEAD)
+		return false;
+	ULONG cipherLength = (ULONG)(length - SECURE_RECORD_OVERHEAD);
+	unsigned char nonce[SECURE_NONCE_SIZE];
+	MakeNonce(receiveSequence++, nonce);
+	BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO authInfo;
+	BCRYPT_INIT_AUTH_MODE_INFO(authInfo);
+	authInfo.pbNonce = nonce;
+	authInfo.cbNonce = SECURE_NONCE_SIZE;
+	authInfo.pbAuthData = (PUCHAR)record;
+	authInfo.cbAuthData = SECURE_RECORD_HEADER_SIZE;
+	authInfo.pbTag = (PUCHAR)record + SECURE_RECORD_HEADER_SIZE + cipherLength;
+	authInfo.cbTag = SECURE_TAG_SIZE;
+	ULONG decrypted = 0;
+	PUCHAR cipher = (PUCHAR)record + SECURE_RECORD_HEADER_SIZE;
+	return BCryptDecrypt(receiveKey, cipher, cipherLength, &authInfo, nullptr, 0, cipher, cipherLength, &decrypted, 0) == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SealedSize
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: static size_t SealedSize(const size_t length)
+		- length : plaintext bytes
+
+-- RETURNS: size_t : bytes Seal writes for them
+----------------------------------------------------------------------------------------------------------------------*/
+size_t SecureChannel::SealedSize(const size_t length)
+{
+	size_t records = (length + SECURE_RECORD_MAX - 1) / SECURE_RECORD_MAX;
+	return length + records * SECURE_RECORD_OVERHEAD;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION DeriveBytes
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool DeriveBytes(BCRYPT_SECRET_HANDLE secret, const unsigned char* macKey, const char* label, unsigned char* bytes)
+		- secret : the ECDH shared secret
+		- macKey : SECURE_KEY_SIZE bytes from the shared key, without it the output cant be worked out
+		- label : what the bytes are for, hashed in ahead of the secret
+		- bytes : SECURE_KEY_SIZE bytes, HMAC-SHA256(macKey, label + secret)
+
+-- RETURNS: bool : whether CNG derived them
+----------------------------------------------------------------------------------------------------------------------*/
+bool SecureChannel::DeriveBytes(BCRYPT_SECRET_HANDLE secret, const unsigned char* macKey, const char* label, unsigned char* bytes)
+{
+	BCryptBuffer parameters[3];
+	parameters[0].BufferType = KDF_HASH_ALGORITHM;
+	parameters[0].cbBuffer = sizeof(BCRYPT_SHA256_ALGORITHM);
+	parameters[0].pvBuffer = (PVOID)BCRYPT_SHA256_ALGORITHM;
+	parameters[1].BufferType = KDF_HMAC_KEY;
+	parameters[1].cbBuffer = SECURE_KEY_SIZE;
+	parameters[1].pvBuffer = (PVOID)macKey;
+	parameters[2].BufferType = KDF_SECRET_PREPEND;
+	parameters[2].cbBuffer = (ULONG)strlen(label);
+	parameters[2].pvBuffer = (PVOID)label;
+	BCryptBufferDesc parameterList;
+	parameterList.ulVersion = BCRYPTBUFFER_VERSION;
+	parameterList.cBuffers = 3;
+	parameterList.pBuffers = parameters;
+
+	ULONG derived = 0;
+	return BCryptDeriveKey(secret, BCRYPT_KDF_HMAC, &parameterList, bytes, SECURE_KEY_SIZE, &derived, 0) == 0
+		&& derived == SECURE_KEY_SIZE;
+}
+
+//AES-GCM key from DeriveBytes, the raw bytes are wiped once CNG has its own copy
+bool SecureChannel::DeriveKey(BCRYPT_SECRET_HANDLE secret, const unsigned char* macKey, const char* label, BCRYPT_KEY_HANDLE& key)
+{
+	UCHAR keyBytes[SECURE_KEY_SIZE];
+	if (!DeriveBytes(secret, macKey, label, keyBytes))
+		return false;
+	bool made = (BCryptGenerateSymmetricKey(aesAlgorithm, &key, nullptr, 0, keyBytes, SECURE_KEY_SIZE, 0) == 0);
+	SecureZeroMemory(keyBytes, sizeof(keyBytes));
+	return made;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION MakeNonce
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void MakeNonce(const uint64_t sequence, unsigned char* nonce)
+		- sequence : record number in this direction
+		- nonce : SECURE_NONCE_SIZE bytes, 4 zero bytes then the record number
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Every key only ever sees each record number once, which is all GCM needs of a nonce.
+----------------------------------------------------------------------------------------------------------------------*/
+void SecureChannel::MakeNonce(const uint64_t sequence, unsigned char* nonce)
+{
+	memset(nonce, 0, SECURE_NONCE_SIZE);
+	WriteLittleEndian((char*)nonce + 4, sequence, 8);
+}
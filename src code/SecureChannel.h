@@ -0,0 +1,62 @@
+#pragma once
+#pragma comment(lib, "bcrypt.lib")
+
+#include <Windows.h>
+#include <bcrypt.h>
+#include <intrin.h>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <QString>
+#include "BatchProtocol.h"
+
+#define SECURE_HELLO_MAGIC 0x454E5341 //"ASNE", each side's ECDH public key follows
+#define SECURE_PUBLIC_KEY_SIZE 72 //BCRYPT_ECCPUBLIC_BLOB of a P-256 key: magic(4) + key length(4) + X(32) + Y(32)
+#define SECURE_HELLO_SIZE (4 + SECURE_PUBLIC_KEY_SIZE)
+#define SECURE_FINISHED_SIZE 32 //HMAC-SHA256 each side sends after the hellos, proves it has the shared key
+#define SECURE_KEY_SIZE 32 //AES-256
+#define SECURE_MIN_KEY_LENGTH 8 //characters of shared key MainWindow asks for
+#define SECURE_KEY_ITERATIONS 100000 //PBKDF2 rounds on the shared key, slows down guessing it
+#define SECURE_NONCE_SIZE 12
+#define SECURE_TAG_SIZE 16
+#define SECURE_RECORD_HEADER_SIZE 4 //ciphertext length(4), also authenticated
+#define SECURE_RECORD_OVERHEAD (SECURE_RECORD_HEADER_SIZE + SECURE_TAG_SIZE)
+#define SECURE_RECORD_MAX 16384 //plaintext per record, the TLS record limit
+
+bool HasAesInstructions();
+
+//ECDH P-256 handshake authenticated by a shared key, then AES-256-GCM records both ways,
+//one key per direction, all through CNG
+class SecureChannel
+{
+public:
+	SecureChannel(const bool, const QString&);
+	virtual ~SecureChannel();
+	bool WriteHello(char*);
+	bool ReadHello(const char*);
+	void WriteFinished(char*) const;
+	bool CheckFinished(const char*) const;
+	size_t Seal(const char*, const size_t, char*);
+	bool Open(char*, const size_t);
+	static size_t SealedSize(const size_t);
+
+private:
+	bool isClient;
+	std::string sharedKey; //utf8, wiped when the channel goes
+	unsigned char ownPublicKey[SECURE_PUBLIC_KEY_SIZE];
+	unsigned char ownFinished[SECURE_FINISHED_SIZE];
+	unsigned char peerFinished[SECURE_FINISHED_SIZE];
+	BCRYPT_ALG_HANDLE ecdhAlgorithm;
+	BCRYPT_ALG_HANDLE aesAlgorithm;
+	BCRYPT_ALG_HANDLE hmacAlgorithm;
+	BCRYPT_KEY_HANDLE ownKey;
+	BCRYPT_KEY_HANDLE sendKey;
+	BCRYPT_KEY_HANDLE receiveKey;
+	uint64_t sendSequence; //record number, the nonce, so a dropped or replayed record fails its tag
+	uint64_t receiveSequence;
+
+	bool DeriveBytes(BCRYPT_SECRET_HANDLE, const unsigned char*, const char*, unsigned char*);
+	bool DeriveKey(BCRYPT_SECRET_HANDLE, const unsigned char*, const char*, BCRYPT_KEY_HANDLE&);
+	void MakeNonce(const uint64_t, unsigned char*);
+};
@@ -5,9 +5,37 @@
 -- PROGRAM: TcpUdpFileTransfer/PacketLogger
 --
 -- FUNCTIONS:
-	void ReceiveUdpPackets(SOCKET, const QString&);
-	void ReceiveTcpPackets(SOCKET, const QString&, const size_t);
+	Server();
+	void ReceiveUdpPackets(SOCKET, const QString&, const bool);
+	void ReceiveUdpRio(SOCKET, const QString&);
+	void ReceiveUdpMeasure(SOCKET, const QString&);
+	void ReceiveUdpFec(SOCKET, const QString&);
+	void ReceiveUdpMulticast(SOCKET, const QString&);
+	void ReceiveTcpPackets(SOCKET, const QString&, const size_t, const bool, const bool);
+	void ReceiveTcpBatch(SOCKET, const QString&);
+	void EchoUdpPackets(SOCKET, const bool);
+	void EchoTcpPackets(SOCKET, const size_t, const bool);
+	void UsePayloadSink(const TransferOptions&);
 	void StopPolling();
+	bool ReceiveExact(SOCKET, char*, const size_t);
+	bool ReceiveSealed(SOCKET, ReceiveSink&, char*, const size_t, size_t&);
+	bool ReceiveElided(SOCKET, ReceiveSink&, char*, const size_t, const size_t, size_t&);
+	bool OpenSink(ReceiveSink&, const QString&, const size_t);
+	void ReportSink(ReceiveSink&);
+	bool ReceiveBatchFile(SOCKET, QFile&, char*, const size_t);
+	bool ReceivePackFrame(SOCKET, const QDir&, std::vector<char>&, const uint16_t, const uint64_t, size_t&, size_t&);
+	void ReceiveTcpDelta(SOCKET, const QString&);
+	bool SendExact(SOCKET, const char*, const size_t);
+	bool SendSignatures(SOCKET, QFile&, const uint32_t, uint64_t&, size_t&);
+	bool ApplyDelta(SOCKET, const QString&, char*, size_t&, uint64_t&);
+	void ReceiveTcpDedup(SOCKET, const QString&);
+	bool ApplyDedup(SOCKET, const QString&, ChunkStore&, char*, size_t&, uint64_t&, uint64_t&);
+	void ReceiveSharded(const std::vector<SOCKET>&, const QString&, const size_t);
+	void MergeShardFiles(const QString&, const size_t);
+	void ReportReceived(size_t&, const size_t, std::chrono::steady_clock::time_point&, const bool);
+	void CountReceived(const size_t, const size_t);
+	void CountLoss(const uint64_t, const uint64_t);
+	void ReadLiveTotals(LiveTotals&) const;
 --
 -- DATE: Feb 10, 2018
 --
@@ -19,7 +47,36 @@
 -- This class implements the same WinSock capabilities as WSASocketManager, but
 -- is specific to receiving packets, and lives in its own thread instead of main. 
 -- It handles most calls(except for bind) to Receiving-related functions of WinSock2 API
+--
+-- Receives that got data and file writes are timed with TraceScope for the flight recorder.
+-- Every loop also counts what it got with CountReceived, for the live chart to sample.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Server Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: Server(void)
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+-- Every TransferSession makes a fresh Server, so polling starts on here instead of at the top of each
+-- receive loop. That way a session stopped while still queued in the pool doesnt start polling after.
 ----------------------------------------------------------------------------------------------------------------------*/
+Server::Server()
+	: keepPolling(true)
+	, liveBytes(0)
+	, livePackets(0)
+	, liveLossChecked(0)
+	, liveLost(0)
+{
+}
 
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION Server Destructor
@@ -35,7 +92,7 @@
 -- RETURNS: N/A
 --
 -- NOTES:
--- Server lives and dies with ServerThread
+-- Server lives and dies with its TransferSession
 -- Sets polling to false as extra precaution.
 ----------------------------------------------------------------------------------------------------------------------*/
 Server::~Server()
@@ -53,9 +110,10 @@ Server::~Server()
 --
 -- PROGRAMMER: Alex Xia
 --
--- INTERFACE: void ReceiveUdpPackets(SOCKET serverSocket, const QString& filePath)
+-- INTERFACE: void ReceiveUdpPackets(SOCKET serverSocket, const QString& filePath, const bool coalesce)
 		- serverSocket : SOCKET, socket to receive packets from 
 		- filePath : QString, absolute path to file to write data to
+		- coalesce : bool, let the stack hand over several datagrams per receive (URO)
 
 -- RETURNS: void.
 --
@@ -64,27 +122,47 @@ Server::~Server()
 -- This function lies on a different thread than main: should be signaled, not directly called.
 --
 -- Enters a loop which repeatedly gets any available datagrams from a socket, and prints it to a file.
+-- A coalesced receive is split back into its datagrams, each is printed and counted like it
+-- came on its own.
+-- The file is opened once and flushed whenever the socket runs dry, instead of opened per datagram.
+-- Datagrams go to whatever sink UsePayloadSink picked, the file unless told otherwise.
+-- Nothing in the loop allocates: the buffer is from the session's arena and PacketReceived goes
+-- out through ReportReceived, not once per datagram.
 ----------------------------------------------------------------------------------------------------------------------*/
-void Server::ReceiveUdpPackets(SOCKET serverSocket, const QString& filePath)
+void Server::ReceiveUdpPackets(SOCKET serverSocket, const QString& filePath, const bool coalesce)
 {
-	keepPolling = true;
 	size_t packetsReceived = 0;
+	size_t unreportedBytes = 0;
+	auto lastReport = std::chrono::steady_clock::now();
 	// actual max size of a datagram is 65508 bytes, next higher power of 2 up -> 64x2^10 = 64KB = 65536B
 	size_t MAX_BUFFER_SIZE = 65536; 
-	char* packetBuffer = (char*)malloc(MAX_BUFFER_SIZE * sizeof(char));
+	char* packetBuffer = arena.Allocate(MAX_BUFFER_SIZE * sizeof(char));
+	UdpCoalescedReceiver receiver(serverSocket, coalesce);
+	if (coalesce && !receiver.IsCoalescing())
+	{
+		emit ServerPrintableStatusReady("-UDP receive coalescing not available here, receiving one datagram at a time");
+	}
+	ReceiveSink sink;
+	if (!OpenSink(sink, filePath, 0))
+		return;
 
 	while(keepPolling)
 	{
 		int bytesRead = 0;
-		struct sockaddr_in client;
-		int client_len = sizeof(client); 
-		memset(packetBuffer, 0, MAX_BUFFER_SIZE * sizeof(char));
+		size_t datagramSize = 0;
 
-		bytesRead = recvfrom(serverSocket, packetBuffer, MAX_BUFFER_SIZE, 0, (struct sockaddr *)&client, &client_len);
+		TraceScope trace(TraceStage::Receive);
+		bytesRead = receiver.Receive(packetBuffer, MAX_BUFFER_SIZE - 1, datagramSize);
+		if (bytesRead > 0)
+			trace.SetBytes(bytesRead);
+		else
+			trace.Discard();
+		trace.End();
 		if( bytesRead < 0)
 		{
-			QThread* curr = QThread::currentThread();
-			QString currStr = curr->objectName();
+			ReportReceived(unreportedBytes, packetsReceived, lastReport, true);
+			sink.Flush();
+			ReportSink(sink);
 			QThread::msleep(100); //smallest interrupt possible without taking too much cpu resources
 			continue;
 		}
@@ -92,14 +170,472 @@ void Server::ReceiveUdpPackets(SOCKET serverSocket, const QString& filePath)
 		{
 			continue; //dont wait, transmission started
 		}
+		//a size of 0 would never move offset on, take the whole receive as one datagram then
+		size_t splitSize = (datagramSize > 0) ? datagramSize : (size_t)bytesRead;
+		for (int offset = 0; offset < bytesRead; offset += (int)splitSize)
+		{
+			size_t length = std::min<size_t>(splitSize, bytesRead - offset);
+			++packetsReceived;
+			unreportedBytes += length;
+			CountReceived(length, 1);
+			sink.Write(packetBuffer + offset, length);
+		}
+		ReportReceived(unreportedBytes, packetsReceived, lastReport, false);
+	}
+	ReportReceived(unreportedBytes, packetsReceived, lastReport, true);
+	ReportSink(sink);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReportReceived
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReportReceived(size_t& unreportedBytes, const size_t packetsReceived,
+--                                std::chrono::steady_clock::time_point& lastReport, const bool force)
+		- unreportedBytes : bytes since the last PacketReceived, reset once it goes out
+		- packetsReceived : running datagram count
+		- lastReport : when PacketReceived last went out, updated here
+		- force : send it now if anything is unreported, for when the socket ran dry or the loop ends
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- A queued signal is a heap allocated event, one per datagram was the biggest allocation left in
+-- the UDP loops. Now it's at most one every RECEIVE_REPORT_MS, carrying the bytes since the last
+-- one like the shard merger's.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReportReceived(size_t& unreportedBytes, const size_t packetsReceived, std::chrono::steady_clock::time_point& lastReport, const bool force)
+{
+	if (unreportedBytes == 0)
+		return;
+	auto now = std::chrono::steady_clock::now();
+	if (!force && now - lastReport < std::chrono::milliseconds(RECEIVE_REPORT_MS))
+		return;
+	emit PacketReceived(unreportedBytes, packetsReceived);
+	unreportedBytes = 0;
+	lastReport = now;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION CountReceived
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void CountReceived(const size_t bytes, const size_t packets)
+		- bytes : just received
+		- packets : datagrams they were, or 1 for a TCP recv
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Only the receive loop's thread calls this (the merger's, when sharded), so a relaxed load and
+-- store does instead of a locked add. The main thread reads them with ReadLiveTotals.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::CountReceived(const size_t bytes, const size_t packets)
+{
+	liveBytes.store(liveBytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+	livePackets.store(livePackets.load(std::memory_order_relaxed) + packets, std::memory_order_relaxed);
+}
+
+//loss so far of a Measure or FEC receive: checked is how many packets it knows about, lost how many of those never came
+void Server::CountLoss(const uint64_t checked, const uint64_t lost)
+{
+	liveLossChecked.store(checked, std::memory_order_relaxed);
+	liveLost.store(lost, std::memory_order_relaxed);
+}
+
+//called from the main thread by TransferSession::SampleLive
+void Server::ReadLiveTotals(LiveTotals& totals) const
+{
+	totals.bytes = liveBytes.load(std::memory_order_relaxed);
+	totals.packets = livePackets.load(std::memory_order_relaxed);
+	totals.lossChecked = liveLossChecked.load(std::memory_order_relaxed);
+	totals.lost = liveLost.load(std::memory_order_relaxed);
+	totals.rttTotalNs = 0;
+	totals.rttCount = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveUdpRio
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveUdpRio(SOCKET serverSocket, const QString& filePath)
+		- serverSocket : SOCKET, made with WSA_FLAG_REGISTERED_IO. Closed here, not by the session
+		- filePath : QString, absolute path to file to write data to
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- ReceiveUdpPackets over Registered I/O: every slot has a receive posted, and completions are
+-- taken in batches off the completion queue instead of one recv per datagram. The file stays open
+-- for the whole receive. The socket has to be closed before the channel goes, so the posted
+-- receives are gone before their buffer is.
+-- At the end prints the datagram rate and the UDP receive errors the system counted meanwhile.
+-- Falls back to ReceiveUdpPackets if RIO cant be set up on the socket.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveUdpRio(SOCKET serverSocket, const QString& filePath)
+{
+	RioUdpChannel channel;
+	if (!channel.Open(serverSocket, RIO_UDP_SLOT_SIZE) || !channel.PostReceives())
+	{
+		emit ServerPrintableStatusReady("-Registered I/O not available here, receiving through the socket");
+		ReceiveUdpPackets(serverSocket, filePath);
+		closesocket(serverSocket);
+		return;
+	}
+
+	size_t packetsReceived = 0;
+	size_t unreportedBytes = 0;
+	uint64_t errorsBefore = GetUdpReceiveErrors();
+	std::chrono::steady_clock::time_point first;
+	std::chrono::steady_clock::time_point last;
+	auto lastReport = std::chrono::steady_clock::now();
+	ReceiveSink sink;
+	if (!OpenSink(sink, filePath, 0))
+	{
+		closesocket(serverSocket);
+		return;
+	}
+	while (keepPolling)
+	{
+		int completed = channel.Poll([&](const char* datagram, const size_t length) {
+			last = std::chrono::steady_clock::now();
+			if (packetsReceived == 0)
+				first = last;
+			++packetsReceived;
+			unreportedBytes += length;
+			CountReceived(length, 1);
+			sink.Write(datagram, length);
+		});
+		if (completed < 0)
+		{
+			emit ServerPrintableStatusReady("-Registered I/O completion queue failed, receive stopped");
+			break;
+		}
+		ReportReceived(unreportedBytes, packetsReceived, lastReport, completed == 0);
+		if (completed == 0)
+			sink.Flush();
+	}
+	ReportReceived(unreportedBytes, packetsReceived, lastReport, true);
+	ReportSink(sink);
+	closesocket(serverSocket);
+
+	double seconds = std::chrono::duration<double>(last - first).count();
+	emit ServerPrintableStatusReady(QString("-Registered I/O: %1 datagrams, %2 pkt/s, %3 failed receives, %4 UDP receive errors system wide")
+		.arg(packetsReceived)
+		.arg((seconds > 0) ? packetsReceived / seconds : 0.0, 0, 'f', 0)
+		.arg(channel.GetFailed())
+		.arg(GetUdpReceiveErrors() - errorsBefore));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveUdpMeasure
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveUdpMeasure(SOCKET serverSocket, const QString& filePath)
+		- serverSocket : SOCKET, socket to receive packets from 
+		- filePath : QString, a line per datagram is logged here: sequence,send ns,receive ns,bytes
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Measure mode counterpart of ReceiveUdpPackets. Waits in select instead of sleeping 100ms
+-- after an empty recv, so receive times arent off by however long the sleep was.
+-- Payload isnt written out, the per datagram log is what's kept for looking at afterwards.
+-- Stats go out through MeasureStatsReady every UDP_MEASURE_REPORT_MS, if anything is connected to it,
+-- and once more when stopped.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveUdpMeasure(SOCKET serverSocket, const QString& filePath)
+{
+	size_t packetsReceived = 0;
+	size_t unreportedBytes = 0;
+	auto lastReceivedReport = std::chrono::steady_clock::now();
+	const size_t packetBufferSize = 65536;
+	char* packetBuffer = arena.Allocate(packetBufferSize);
+	std::ofstream log(filePath.toStdString(), std::ofstream::trunc);
+	log << "sequence,send_ns,receive_ns,bytes\n";
+
+	UdpTimestampReceiver receiver(serverSocket);
+	UdpMeasureStats stats;
+	emit ServerPrintableStatusReady(receiver.HasKernelTimestamps() ? "-measuring with kernel receive timestamps"
+		: "-kernel receive timestamps not available, measuring with the user space clock");
+	auto lastReport = std::chrono::steady_clock::now();
+	while (keepPolling)
+	{
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(serverSocket, &readable);
+		struct timeval timeout = { 0, UDP_MEASURE_POLL_US };
+		if (select(0, &readable, nullptr, nullptr, &timeout) <= 0)
+		{
+			ReportReceived(unreportedBytes, packetsReceived, lastReceivedReport, true);
+			continue;
+		}
+
+		uint64_t receiveNs = 0;
+		int bytesRead = receiver.Receive(packetBuffer, packetBufferSize, receiveNs);
+		if (bytesRead <= 0)
+			continue;
+		++packetsReceived;
+		unreportedBytes += bytesRead;
+		CountReceived(bytesRead, 1);
+		ReportReceived(unreportedBytes, packetsReceived, lastReceivedReport, false);
+
+		uint64_t sequence, sendNs, datagramCount;
+		if (ReadMeasureHeader(packetBuffer, bytesRead, sequence, sendNs, datagramCount))
+		{
+			stats.Record(sequence, datagramCount, sendNs, receiveNs);
+			CountLoss(stats.GetSpan(), stats.GetGaps());
+			log << sequence << ',' << sendNs << ',' << receiveNs << ',' << bytesRead << '\n';
+		}
+		else
+		{
+			stats.RecordForeign();
+		}
+		auto now = std::chrono::steady_clock::now();
+		if (now - lastReport >= std::chrono::milliseconds(UDP_MEASURE_REPORT_MS))
+		{
+			//the summary is a few heap allocations, not worth it when nothing is listening (the benchmark)
+			if (isSignalConnected(QMetaMethod::fromSignal(&Server::MeasureStatsReady)))
+				emit MeasureStatsReady(stats.Summary(receiver.HasKernelTimestamps()));
+			lastReport = now;
+		}
+	}
+	ReportReceived(unreportedBytes, packetsReceived, lastReceivedReport, true);
+	log.close();
+	emit MeasureStatsReady(stats.Summary(receiver.HasKernelTimestamps()));
+	emit ServerPrintableStatusReady(QString("-measure: %1").arg(stats.Summary(receiver.HasKernelTimestamps())));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveUdpFec
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveUdpFec(SOCKET serverSocket, const QString& filePath)
+		- serverSocket : SOCKET, socket to receive packets from
+		- filePath : QString, absolute path to file to write data to
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- ReceiveUdpPackets for a client sending with FEC (see UdpFec.cpp). Datagrams go through the
+-- decoder first, which rebuilds what it can of each block and hands the data on in order, and
+-- only then are they written and counted, so rebuilt datagrams look like they arrived.
+-- An empty socket on its own means nothing, a paced or slower sender leaves it empty between most
+-- datagrams, so the block being held keeps collecting. Only once nothing has come for FEC_IDLE_FINISH_MS
+-- is it closed with what it has, the sender has stopped or paused. Recovered vs lost counts go out
+-- with FecStatsReady then and at the end.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveUdpFec(SOCKET serverSocket, const QString& filePath)
+{
+	size_t packetsReceived = 0;
+	size_t unreportedBytes = 0;
+	auto lastReport = std::chrono::steady_clock::now();
+	size_t MAX_BUFFER_SIZE = 65536;
+	char* packetBuffer = arena.Allocate(MAX_BUFFER_SIZE * sizeof(char));
+	UdpFecDecoder decoder;
+	if (packetBuffer == nullptr || !decoder.Open(arena))
+	{
+		emit ServerPrintableStatusReady("-not enough memory to hold an FEC block");
+		return;
+	}
+	ReceiveSink sink;
+	if (!OpenSink(sink, filePath, 0))
+		return;
+	std::function<void(const char*, const size_t)> deliver = [&](const char* payload, const size_t length) {
+		++packetsReceived;
+		unreportedBytes += length;
+		CountReceived(length, 1);
+		sink.Write(payload, length);
+	};
+
+	bool active = false;
+	auto lastDatagram = std::chrono::steady_clock::now();
+	while (keepPolling)
+	{
+		int bytesRead = recv(serverSocket, packetBuffer, (int)MAX_BUFFER_SIZE, 0);
+		if (bytesRead < 0)
+		{
+			if (active && std::chrono::steady_clock::now() - lastDatagram >= std::chrono::milliseconds(FEC_IDLE_FINISH_MS))
+			{
+				decoder.Finish(deliver);
+				emit FecStatsReady(decoder.Summary());
+				active = false;
+			}
+			ReportReceived(unreportedBytes, packetsReceived, lastReport, true);
+			sink.Flush();
+			ReportSink(sink);
+			QThread::msleep(100);
+			continue;
+		}
+		if (bytesRead == 0)
+		{
+			continue;
+		}
+		active = true;
+		lastDatagram = std::chrono::steady_clock::now();
+		decoder.Add(packetBuffer, bytesRead, deliver);
+		CountLoss(packetsReceived + decoder.GetLost(), decoder.GetLost());
+		ReportReceived(unreportedBytes, packetsReceived, lastReport, false);
+	}
+	decoder.Finish(deliver);
+	ReportReceived(unreportedBytes, packetsReceived, lastReport, true);
+	ReportSink(sink);
+	emit FecStatsReady(decoder.Summary());
+	emit ServerPrintableStatusReady(QString("-%1").arg(decoder.Summary()));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveUdpMulticast
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveUdpMulticast(SOCKET serverSocket, const QString& filePath)
+		- serverSocket : SOCKET, already joined to the group by WSASocketManager
+		- filePath : QString, absolute path to file to write data to
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- ReceiveUdpPackets for a client sending to a multicast group (see UdpMulticast.cpp). Each
+-- datagram is written and counted the first time its sequence number comes in, duplicates from
+-- repairs other receivers asked for are dropped.
+-- Gaps are NACKed to whoever the datagrams came from every MULTICAST_NACK_MS while they keep
+-- coming, and the end of the run too once they stop for MULTICAST_TAIL_WAIT_MS. A run is over once
+-- every datagram is in, or MULTICAST_GIVE_UP_ROUNDS of those NACKs got nothing back; the counts
+-- go out with MulticastStatsReady then. A datagram after that, once the group has been quiet for
+-- twice MULTICAST_LINGER_MS, starts the next run.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveUdpMulticast(SOCKET serverSocket, const QString& filePath)
+{
+	size_t packetsReceived = 0;
+	size_t unreportedBytes = 0;
+	auto lastReport = std::chrono::steady_clock::now();
+	size_t MAX_BUFFER_SIZE = 65536;
+	char* packetBuffer = arena.Allocate(MAX_BUFFER_SIZE * sizeof(char));
+	char* nack = arena.Allocate(MULTICAST_NACK_SIZE);
+	if (packetBuffer == nullptr || nack == nullptr)
+	{
+		emit ServerPrintableStatusReady("-not enough memory for a multicast receive buffer");
+		return;
+	}
+	ReceiveSink sink;
+	if (!OpenSink(sink, filePath, 0))
+		return;
+	MulticastGapTracker tracker;
+	struct sockaddr_storage sender;
+	int senderLength = 0;
+	bool finished = false;
+	auto lastDatagram = std::chrono::steady_clock::now();
+	auto lastNack = lastDatagram;
+	auto sendNack = [&](const bool toEnd) {
+		size_t nackLength = tracker.BuildNack(nack, toEnd);
+		if (nackLength > 0)
+			sendto(serverSocket, nack, (int)nackLength, 0, (const struct sockaddr*)&sender, senderLength);
+		lastNack = std::chrono::steady_clock::now();
+	};
+
+	while (keepPolling)
+	{
+		struct sockaddr_storage from;
+		int fromLength = sizeof(from);
+		int bytesRead = recvfrom(serverSocket, packetBuffer, (int)MAX_BUFFER_SIZE, 0, (struct sockaddr*)&from, &fromLength);
+		auto now = std::chrono::steady_clock::now();
+		if (bytesRead < 0)
+		{
+			bool waiting = tracker.IsOpen() && !finished;
+			if (waiting && (tracker.IsComplete() || tracker.GetQuietRounds() >= MULTICAST_GIVE_UP_ROUNDS))
+			{
+				if (!tracker.IsComplete())
+					tracker.GiveUp();
+				finished = true;
+				waiting = false;
+				emit MulticastStatsReady(tracker.Summary());
+				emit ServerPrintableStatusReady(QString("-%1").arg(tracker.Summary()));
+			}
+			else if (waiting && now - lastNack >= std::chrono::milliseconds(MULTICAST_NACK_MS))
+			{
+				sendNack(now - lastDatagram >= std::chrono::milliseconds(MULTICAST_TAIL_WAIT_MS));
+			}
+			ReportReceived(unreportedBytes, packetsReceived, lastReport, true);
+			sink.Flush();
+			ReportSink(sink);
+			QThread::msleep(waiting ? MULTICAST_NACK_MS / 5 : 100);
+			continue;
+		}
+		uint64_t sequence, datagramCount;
+		if (!ReadMulticastHeader(packetBuffer, bytesRead, sequence, datagramCount))
+		{
+			tracker.RecordForeign();
+			continue;
+		}
+		bool restart = !tracker.IsOpen()
+			|| (finished && now - lastDatagram >= std::chrono::milliseconds(2 * MULTICAST_LINGER_MS));
+		if (restart)
+		{
+			if (!tracker.Open(arena, datagramCount))
+			{
+				emit ServerPrintableStatusReady("-not enough memory to track a multicast run that long");
+				continue;
+			}
+			finished = false;
+		}
+		lastDatagram = now;
+		memcpy(&sender, &from, sizeof(from));
+		senderLength = fromLength;
+		if (finished || sequence >= tracker.GetExpected() || !tracker.Add(sequence))
+			continue;
+		size_t payloadLength = bytesRead - MULTICAST_HEADER_SIZE;
+		const char* payload = packetBuffer + MULTICAST_HEADER_SIZE;
 		++packetsReceived;
-		emit PacketReceived(bytesRead, packetsReceived);
-		// open & print to file & close
-		std::ofstream outputFile(filePath.toStdString(), std::ofstream::app);
-		outputFile << packetBuffer;
-		outputFile.close(); //actually optional in c++
+		unreportedBytes += payloadLength;
+		CountReceived(payloadLength, 1);
+		sink.Write(payload, payloadLength);
+		if (now - lastNack >= std::chrono::milliseconds(MULTICAST_NACK_MS))
+		{
+			sendNack(false);
+		}
+		ReportReceived(unreportedBytes, packetsReceived, lastReport, false);
+	}
+	ReportReceived(unreportedBytes, packetsReceived, lastReport, true);
+	ReportSink(sink);
+	if (tracker.IsOpen())
+	{
+		emit MulticastStatsReady(tracker.Summary());
+		emit ServerPrintableStatusReady(QString("-%1").arg(tracker.Summary()));
 	}
-	free(packetBuffer);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -111,10 +647,13 @@ void Server::ReceiveUdpPackets(SOCKET serverSocket, const QString& filePath)
 --
 -- PROGRAMMER: Alex Xia
 --
--- INTERFACE: void ReceiveTcpPackets(SOCKET serverSocket, const QString& filePath, const size_t expectedPacketSize)
+-- INTERFACE: void ReceiveTcpPackets(SOCKET serverSocket, const QString& filePath, const size_t expectedPacketSize,
+	const bool encrypted, const bool elideZeros)
 		- serverSocket : SOCKET, socket to listen for connections on 
 		- filePath : QString, absolute path to file to write data to
 		- expectedPacketSize : unsigned int, used to calculate packetCount  
+		- encrypted : bool, whether clients send AES-GCM records (ReceiveSealed) instead of plaintext
+		- elideZeros : bool, whether clients send packets as zero run extents (ReceiveElided)
 
 -- RETURNS: void.
 --
@@ -124,16 +663,18 @@ void Server::ReceiveUdpPackets(SOCKET serverSocket, const QString& filePath)
 --
 -- Enters a loop which repeatedly listens, then accepts any connections using a new client socket.
 -- If any bytes are read from that socket, prints it to a file.
+-- recv takes what's buffered up to POOL_LARGE_SIZE at a time from a pooled buffer, the stream is
+-- the same either way. It used to be a fresh 2GB malloc, zeroed on every connection.
+-- An eliding connection also prints how big the file is on disk after it.
 ----------------------------------------------------------------------------------------------------------------------*/
-void Server::ReceiveTcpPackets(SOCKET serverSocket, const QString& filePath, const size_t expectedPacketSize)
+void Server::ReceiveTcpPackets(SOCKET serverSocket, const QString& filePath, const size_t expectedPacketSize, const bool encrypted, const bool elideZeros)
 {
-	keepPolling = true;
 	size_t packetsReceived = 0;
-	size_t bytesReadTotal = 0;
-	size_t MAX_BUFFER_SIZE = 2147483648; //2GB, 2 x 2^30 B  for now
-	QThread* curr = QThread::currentThread(); //debugging
-	QString currStr = curr->objectName(); //debugging
-	char* packetBuffer = (char*)malloc(MAX_BUFFER_SIZE * sizeof(char));
+	size_t MAX_BUFFER_SIZE = POOL_LARGE_SIZE;
+	char* packetBuffer = arena.Allocate(MAX_BUFFER_SIZE * sizeof(char));
+	ReceiveSink sink;
+	if (!OpenSink(sink, filePath, expectedPacketSize))
+		return;
 
 	while(keepPolling)
 	{
@@ -144,9 +685,8 @@ void Server::ReceiveTcpPackets(SOCKET serverSocket, const QString& filePath, con
 		}
 
 		SOCKET clientSocket;
-		struct sockaddr_in client;
+		struct sockaddr_storage client; //server socket may be IPv6
 		int client_len = sizeof(client); 
-		memset(packetBuffer, 0, MAX_BUFFER_SIZE * sizeof(char));
 
 		if ((clientSocket = accept (serverSocket, (struct sockaddr *)&client, &client_len)) == -1)
 		{
@@ -157,44 +697,1411 @@ void Server::ReceiveTcpPackets(SOCKET serverSocket, const QString& filePath, con
 		//connection accepted, start timing
 		emit PacketReceived(-1, -1);
 
-		//this might block this thread, new socket did not set non_blocking 
-		size_t bytesRead = 0;
-		std::ofstream outputFile(filePath.toStdString(), std::ofstream::app);
-		while( (bytesRead = recv(clientSocket, packetBuffer, MAX_BUFFER_SIZE, 0)) >= 0)
+		//accepted socket inherits non blocking from the listening socket
+		//recv takes an int length, leave room for the terminating 0 printed below
+		int bytesRead = 0;
+		int recvLength = (int)(MAX_BUFFER_SIZE - 1);
+		size_t bytesReadTotal = 0; //this connection's, packetsReceived carries the earlier ones
+		sink.StartStream();
+		if (encrypted)
 		{
-			bytesReadTotal += bytesRead;
-			if (bytesRead == 0)
-				break;
-			outputFile << packetBuffer;
-			//outputBinFile.write(packetBuffer, bytesRead); 
-			// only way to write \0 to file is binary mode
-			// but all chars printed becomes binary too
+			ReceiveSealed(clientSocket, sink, packetBuffer, MAX_BUFFER_SIZE, bytesReadTotal);
+		}
+		else if (elideZeros)
+		{
+			ReceiveElided(clientSocket, sink, packetBuffer, MAX_BUFFER_SIZE, expectedPacketSize, bytesReadTotal);
+		}
+		else
+		{
+			while (true)
+			{
+				TraceScope trace(TraceStage::Receive);
+				bytesRead = recv(clientSocket, packetBuffer, recvLength, 0);
+				if (bytesRead <= 0)
+					trace.Discard();
+				if (bytesRead == 0)
+					break;
+				if (bytesRead < 0)
+				{
+					if (WSAGetLastError() == WSAEWOULDBLOCK && keepPolling)
+					{
+						QThread::msleep(1); //nothing buffered yet, client still sending
+						continue;
+					}
+					break;
+				}
+				trace.SetBytes(bytesRead);
+				trace.End();
+				bytesReadTotal += bytesRead;
+				CountReceived(bytesRead, 1);
+				packetBuffer[bytesRead] = 0;
+				sink.Write(packetBuffer, bytesRead);
+				//outputBinFile.write(packetBuffer, bytesRead); 
+				// only way to write \0 to file is binary mode
+				// but all chars printed becomes binary too
+			}
+		}
+		sink.Flush();
+		ReportSink(sink);
+		if (elideZeros && !sink.IsSynthetic())
+		{
+			emit ServerPrintableStatusReady(QString("-%1 is %2 MB on disk")
+				.arg(filePath).arg(QFileInfo(filePath).size() / (1024.0 * 1024.0), 0, 'f', 1));
 		}
 		packetsReceived += bytesReadTotal / expectedPacketSize;
 		emit PacketReceived(expectedPacketSize, packetsReceived);
 		closesocket (clientSocket);
 	} 
-	free(packetBuffer);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION StopPolling
+-- FUNCTION EchoUdpPackets
 --
--- DATE: Feb 10, 2018
+-- DATE: Oct 18, 2026
 --
 -- DESIGNER: Alex Xia
 --
 -- PROGRAMMER: Alex Xia
 --
--- INTERFACE: void StopPolling()
+-- INTERFACE: void EchoUdpPackets(SOCKET serverSocket, const bool busyPoll)
+		- serverSocket : SOCKET, bound UDP socket
+		- busyPoll : bool, spin on recvfrom instead of waiting in select
 
 -- RETURNS: void.
 --
 -- NOTES:
--- Stops loop.
--- When user disconnects on MainWindow, a signal is set to WSASocketManager, which in turn calls this. 
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Ping-pong server: every datagram goes straight back to whoever sent it, nothing is written.
+-- An empty socket is waited on with select rather than a sleep, which would add up to a timer
+-- tick to every round trip.
 ----------------------------------------------------------------------------------------------------------------------*/
-void Server::StopPolling()
+void Server::EchoUdpPackets(SOCKET serverSocket, const bool busyPoll)
 {
-	keepPolling = false;
+	size_t MAX_BUFFER_SIZE = 65536;
+	char* packetBuffer = arena.Allocate(MAX_BUFFER_SIZE * sizeof(char));
+	size_t packetsEchoed = 0;
+	size_t unreportedBytes = 0;
+	auto lastReport = std::chrono::steady_clock::now();
+	while (keepPolling)
+	{
+		struct sockaddr_storage client;
+		int clientLength = sizeof(client);
+		int bytesRead = recvfrom(serverSocket, packetBuffer, (int)MAX_BUFFER_SIZE, 0, (struct sockaddr*)&client, &clientLength);
+		if (bytesRead < 0)
+		{
+			//a port unreachable from an earlier echo shows up here too, just go on
+			if (WSAGetLastError() == WSAEWOULDBLOCK)
+			{
+				ReportReceived(unreportedBytes, packetsEchoed, lastReport, true);
+				if (!busyPoll)
+					WaitForReadable(serverSocket, PING_POLL_US);
+			}
+			continue;
+		}
+		sendto(serverSocket, packetBuffer, bytesRead, 0, (struct sockaddr*)&client, clientLength);
+		++packetsEchoed;
+		unreportedBytes += bytesRead;
+		CountReceived(bytesRead, 1);
+		ReportReceived(unreportedBytes, packetsEchoed, lastReport, false);
+	}
+	ReportReceived(unreportedBytes, packetsEchoed, lastReport, true);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION EchoTcpPackets
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void EchoTcpPackets(SOCKET serverSocket, const size_t expectedPacketSize, const bool busyPoll)
+		- serverSocket : SOCKET, socket to listen for connections on
+		- expectedPacketSize : unsigned int, the client's message size, used to count messages
+		- busyPoll : bool, spin on recv instead of waiting in select
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Ping-pong server over TCP: accepts connections one after another like ReceiveTcpPackets and
+-- sends every byte back as soon as it is read, with Nagle off so an echo isnt held back waiting
+-- for more. The stream keeps the messages in order, so it doesnt need to know where they start.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::EchoTcpPackets(SOCKET serverSocket, const size_t expectedPacketSize, const bool busyPoll)
+{
+	size_t MAX_BUFFER_SIZE = POOL_LARGE_SIZE;
+	char* packetBuffer = arena.Allocate(MAX_BUFFER_SIZE * sizeof(char));
+	size_t messageSize = std::max<size_t>(expectedPacketSize, 1);
+	size_t bytesEchoed = 0;
+	while (keepPolling)
+	{
+		if (listen(serverSocket, 5) < 0)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+		SOCKET clientSocket;
+		struct sockaddr_storage client;
+		int client_len = sizeof(client);
+		if ((clientSocket = accept(serverSocket, (struct sockaddr*)&client, &client_len)) == -1)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+		emit PacketReceived(-1, -1);
+		BOOL noDelay = TRUE;
+		setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+		size_t unreportedBytes = 0;
+		auto lastReport = std::chrono::steady_clock::now();
+		while (keepPolling)
+		{
+			int bytesRead = recv(clientSocket, packetBuffer, (int)MAX_BUFFER_SIZE, 0);
+			if (bytesRead == 0)
+				break;
+			if (bytesRead < 0)
+			{
+				if (WSAGetLastError() != WSAEWOULDBLOCK)
+					break;
+				ReportReceived(unreportedBytes, bytesEchoed / messageSize, lastReport, true);
+				if (!busyPoll)
+					WaitForReadable(clientSocket, PING_POLL_US);
+				continue;
+			}
+			if (!SendExact(clientSocket, packetBuffer, bytesRead))
+				break;
+			bytesEchoed += bytesRead;
+			unreportedBytes += bytesRead;
+			CountReceived(bytesRead, 1);
+			ReportReceived(unreportedBytes, bytesEchoed / messageSize, lastReport, false);
+		}
+		ReportReceived(unreportedBytes, bytesEchoed / messageSize, lastReport, true);
+		closesocket(clientSocket);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveTcpBatch
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveTcpBatch(SOCKET serverSocket, const QString& outputDir)
+		- serverSocket : SOCKET, socket to listen for connections on 
+		- outputDir : QString, directory the batch's files are recreated under
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function assumes all parameters are pre-validated in WSASocketManager.
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Accepts a connection, then reads header + content pairs (see BatchProtocol.cpp) until the end marker,
+-- writing each file under outputDir in binary. PacketReceived is emitted per file with its size
+-- and the running file count, so results on MainWindow count files instead of packets.
+-- Packed frames of small files are handed to ReceivePackFrame, which reports once per frame.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveTcpBatch(SOCKET serverSocket, const QString& outputDir)
+{
+	QDir root(outputDir);
+	char* chunkBuffer = arena.Allocate(BATCH_CHUNK_SIZE * sizeof(char));
+	std::vector<char> packBuffer; //grows to the biggest frame seen, reused after
+
+	while(keepPolling)
+	{
+		if (listen(serverSocket, 5) < 0)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+
+		SOCKET clientSocket;
+		struct sockaddr_storage client; //server socket may be IPv6
+		int client_len = sizeof(client); 
+		if ((clientSocket = accept (serverSocket, (struct sockaddr *)&client, &client_len)) == INVALID_SOCKET)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+		//connection accepted, start timing
+		emit PacketReceived(-1, -1);
+
+		size_t filesReceived = 0;
+		size_t bytesReceived = 0;
+		bool batchComplete = false;
+		while (keepPolling)
+		{
+			char header[BATCH_HEADER_SIZE];
+			bool isPack;
+			uint16_t nameLength;
+			uint64_t fileSize;
+			if (!ReceiveExact(clientSocket, header, BATCH_HEADER_SIZE) || !DecodeBatchHeader(header, isPack, nameLength, fileSize))
+				break;
+			if (isPack)
+			{
+				if (!ReceivePackFrame(clientSocket, root, packBuffer, nameLength, fileSize, filesReceived, bytesReceived))
+					break;
+				continue;
+			}
+			if (nameLength == 0)
+			{
+				batchComplete = true;
+				break;
+			}
+			std::string name(nameLength, 0);
+			if (!ReceiveExact(clientSocket, &name[0], nameLength))
+				break;
+			QString relativeName = QString::fromUtf8(name.c_str(), nameLength);
+			if (!IsSafeRelativePath(relativeName))
+			{
+				//cant skip the content without trusting the sender, so drop the whole connection
+				emit ServerPrintableStatusReady(QString("-rejected unsafe path %1, dropping batch").arg(relativeName));
+				break;
+			}
+			size_t fileBytes = (size_t)fileSize;
+			QFileInfo target(root.absoluteFilePath(relativeName));
+			root.mkpath(target.absolutePath());
+			QFile outputFile(target.absoluteFilePath());
+			if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+			{
+				emit ServerPrintableStatusReady(QString("-could not write %1, dropping batch").arg(relativeName));
+				break;
+			}
+			if (!ReceiveBatchFile(clientSocket, outputFile, chunkBuffer, fileBytes))
+				break;
+			outputFile.close();
+			++filesReceived;
+			bytesReceived += fileBytes;
+			emit PacketReceived(fileBytes, filesReceived);
+			emit ServerPrintableStatusReady(QString("-received %1 (%2 bytes)").arg(relativeName).arg(fileBytes));
+		}
+		emit ServerPrintableStatusReady(QString("-Batch %1: %2 files, %3 bytes.")
+			.arg(batchComplete ? "complete" : "interrupted").arg(filesReceived).arg(bytesReceived));
+		closesocket (clientSocket);
+	} 
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceivePackFrame
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReceivePackFrame(SOCKET clientSocket, const QDir& root, std::vector<char>& packBuffer,
+	const uint16_t entryCount, const uint64_t bodyLength, size_t& filesReceived, size_t& bytesReceived)
+		- clientSocket : SOCKET, accepted connection
+		- root : QDir, output folder of the batch
+		- packBuffer : reused buffer the whole frame body is read into
+		- entryCount : files in the frame, from its header
+		- bodyLength : bytes of index + content, from its header
+		- filesReceived : running file count, increased by entryCount
+		- bytesReceived : running content byte count
+
+-- RETURNS: bool : false if the frame is bad or the connection dropped, batch is dropped
+--
+-- NOTES:
+-- Reads the whole frame in, checks every name and that the sizes add up before touching the disk,
+-- then writes the files straight out of the one buffer. Parent folders are only made when
+-- the folder changes from the previous file, since packed files are usually siblings.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::ReceivePackFrame(SOCKET clientSocket, const QDir& root, std::vector<char>& packBuffer, const uint16_t entryCount,
+	const uint64_t bodyLength, size_t& filesReceived, size_t& bytesReceived)
+{
+	if (bodyLength > PACK_MAX_FRAME_SIZE)
+	{
+		emit ServerPrintableStatusReady(QString("-packed frame of %1 bytes too big, dropping batch").arg(bodyLength));
+		return false;
+	}
+	size_t frameLength = (size_t)bodyLength;
+	if (packBuffer.size() < frameLength)
+		packBuffer.resize(frameLength);
+	if (!ReceiveExact(clientSocket, packBuffer.data(), frameLength))
+		return false;
+
+	//index first, content for every entry follows in the same order
+	std::vector<std::pair<QString, size_t>> entries;
+	entries.reserve(entryCount);
+	size_t offset = 0;
+	size_t contentLength = 0;
+	for (int i = 0; i < entryCount; i++)
+	{
+		std::string name;
+		uint64_t fileSize;
+		if (!DecodePackEntry(packBuffer.data(), frameLength, offset, name, fileSize) || fileSize > frameLength)
+		{
+			emit ServerPrintableStatusReady("-packed frame index is corrupt, dropping batch");
+			return false;
+		}
+		QString relativeName = QString::fromUtf8(name.c_str(), (int)name.size());
+		if (!IsSafeRelativePath(relativeName))
+		{
+			emit ServerPrintableStatusReady(QString("-rejected unsafe path %1, dropping batch").arg(relativeName));
+			return false;
+		}
+		contentLength += (size_t)fileSize;
+		entries.push_back(std::make_pair(relativeName, (size_t)fileSize));
+	}
+	if (offset + contentLength != frameLength)
+	{
+		emit ServerPrintableStatusReady("-packed frame sizes dont add up, dropping batch");
+		return false;
+	}
+
+	const char* content = packBuffer.data() + offset;
+	QString lastFolder;
+	for (const auto& entry : entries)
+	{
+		QFileInfo target(root.absoluteFilePath(entry.first));
+		if (target.absolutePath() != lastFolder)
+		{
+			lastFolder = target.absolutePath();
+			root.mkpath(lastFolder);
+		}
+		QFile outputFile(target.absoluteFilePath());
+		if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+			|| outputFile.write(content, (qint64)entry.second) != (qint64)entry.second)
+		{
+			emit ServerPrintableStatusReady(QString("-could not write %1, dropping batch").arg(entry.first));
+			return false;
+		}
+		outputFile.close();
+		content += entry.second;
+	}
+	filesReceived += entryCount;
+	bytesReceived += contentLength;
+	emit PacketReceived(contentLength, filesReceived);
+	emit ServerPrintableStatusReady(QString("-received frame of %1 packed files (%2 bytes)").arg(entryCount).arg(contentLength));
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StopPolling
+--
+-- DATE: Feb 10, 2018
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void StopPolling()
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Stops loop.
+-- When user disconnects on MainWindow, a signal is set to WSASocketManager, which in turn calls this. 
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::StopPolling()
+{
+	keepPolling = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION UsePayloadSink
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void UsePayloadSink(const TransferOptions& options)
+		- options : TransferOptions, payloadSink, payloadSource, payloadSeed and encryptionKey are kept
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called before the receive starts. The single file receives (not Measure or shards) then
+-- discard or verify what they get instead of writing it to their file.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::UsePayloadSink(const TransferOptions& options)
+{
+	sinkOptions = options;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION OpenSink
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool OpenSink(ReceiveSink& sink, const QString& filePath, const size_t streamPacketSize)
+		- sink : ReceiveSink, opened with sinkOptions
+		- filePath : QString, file a File sink appends to
+		- streamPacketSize : TCP packet size, 0 for datagrams
+
+-- RETURNS: bool : false if the receive cant go on, the reason is printed
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::OpenSink(ReceiveSink& sink, const QString& filePath, const size_t streamPacketSize)
+{
+	if (!sink.Open(filePath, sinkOptions, arena, streamPacketSize))
+	{
+		emit ServerPrintableStatusReady("-verify needs a generated payload to compare against, and memory for one packet of it");
+		return false;
+	}
+	if (sink.IsSynthetic())
+		emit ServerPrintableStatusReady(QString("-%1").arg(sink.Summary()));
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReportSink
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReportSink(ReceiveSink& sink)
+		- sink : ReceiveSink, of the receive loop calling
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called where the loops flush. A Discard or Verify sink that took something since the last call
+-- sends its counts out with SinkStatsReady, with the mismatches so far on their own for the
+-- benchmark. A File sink never does.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReportSink(ReceiveSink& sink)
+{
+	if (sink.TakeNewResults())
+		emit SinkStatsReady(sink.Summary(), sink.GetMismatches());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveExact
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReceiveExact(SOCKET clientSocket, char* buffer, const size_t length)
+		- clientSocket : SOCKET, accepted connection, non blocking
+		- buffer : where the bytes go
+		- length : number of bytes to read
+
+-- RETURNS: bool : false if the connection closed, errored, or polling stopped first
+--
+-- NOTES:
+-- Waits on select in 100ms steps so a disconnect on MainWindow still gets noticed mid file.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::ReceiveExact(SOCKET clientSocket, char* buffer, const size_t length)
+{
+	size_t offset = 0;
+	while (offset < length)
+	{
+		if (!keepPolling)
+			return false;
+		TraceScope trace(TraceStage::Receive);
+		int bytesRead = recv(clientSocket, buffer + offset, (int)(length - offset), 0);
+		if (bytesRead > 0)
+			trace.SetBytes(bytesRead);
+		else
+			trace.Discard();
+		trace.End();
+		if (bytesRead == 0)
+			return false;
+		if (bytesRead < 0)
+		{
+			if (WSAGetLastError() != WSAEWOULDBLOCK)
+				return false;
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(clientSocket, &readSet);
+			struct timeval timeout = { 0, 100000 };
+			select(0, &readSet, NULL, NULL, &timeout);
+			continue;
+		}
+		offset += bytesRead;
+		CountReceived(bytesRead, 1);
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveSealed
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReceiveSealed(SOCKET clientSocket, ReceiveSink& sink, char* buffer, const size_t bufferSize,
+	size_t& plainBytes)
+		- clientSocket : SOCKET, accepted connection, non blocking
+		- sink : ReceiveSink, already open, the plaintext goes here
+		- buffer : scratch, bufferSize bytes, much bigger than a record
+		- bufferSize : its size
+		- plainBytes : decrypted bytes are added to this
+
+-- RETURNS: bool : false if the handshake failed, a record didnt decrypt or the stream ended mid record
+--
+-- NOTES:
+-- Swaps hellos and finished values with the client (see SecureChannel), the shared key is the one
+-- UsePayloadSink was given. Then opens records as they complete in the
+-- buffer, whatever is left of the last one is moved to the front for the next recv.
+-- Each record goes to the sink like a plaintext recv would, a file sink writes it up to its first 0 byte.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::ReceiveSealed(SOCKET clientSocket, ReceiveSink& sink, char* buffer, const size_t bufferSize, size_t& plainBytes)
+{
+	SecureChannel channel(false, sinkOptions.encryptionKey);
+	char clientHello[SECURE_HELLO_SIZE];
+	char serverHello[SECURE_HELLO_SIZE];
+	if (!ReceiveExact(clientSocket, clientHello, SECURE_HELLO_SIZE) || !channel.WriteHello(serverHello)
+		|| !channel.ReadHello(clientHello) || !SendExact(clientSocket, serverHello, SECURE_HELLO_SIZE))
+	{
+		emit ServerPrintableStatusReady("-encrypted handshake failed, is the client set to encrypt too?");
+		return false;
+	}
+	//client goes first, one without the shared key gets nothing back to guess against
+	char finished[SECURE_FINISHED_SIZE];
+	if (!ReceiveExact(clientSocket, finished, SECURE_FINISHED_SIZE) || !channel.CheckFinished(finished))
+	{
+		emit ServerPrintableStatusReady("-client couldnt prove it has the shared key, dropping the connection");
+		return false;
+	}
+	channel.WriteFinished(finished);
+	if (!SendExact(clientSocket, finished, SECURE_FINISHED_SIZE))
+		return false;
+
+	size_t buffered = 0;
+	while (true)
+	{
+		int bytesRead = recv(clientSocket, buffer + buffered, (int)(bufferSize - buffered), 0);
+		if (bytesRead == 0)
+			return buffered == 0;
+		if (bytesRead < 0)
+		{
+			if (WSAGetLastError() == WSAEWOULDBLOCK && keepPolling)
+			{
+				QThread::msleep(1);
+				continue;
+			}
+			return false;
+		}
+		buffered += bytesRead;
+		CountReceived(bytesRead, 1);
+
+		size_t consumed = 0;
+		while (buffered - consumed >= SECURE_RECORD_HEADER_SIZE)
+		{
+			char* record = buffer + consumed;
+			size_t recordLength = SECURE_RECORD_HEADER_SIZE + (size_t)ReadLittleEndian(record, SECURE_RECORD_HEADER_SIZE);
+			if (buffered - consumed < recordLength && recordLength <= SECURE_RECORD_MAX + SECURE_RECORD_OVERHEAD)
+				break;
+			if (!channel.Open(record, recordLength))
+			{
+				emit ServerPrintableStatusReady("-encrypted record didnt check out, dropping the connection");
+				return false;
+			}
+			size_t plainLength = recordLength - SECURE_RECORD_OVERHEAD;
+			char* plain = record + SECURE_RECORD_HEADER_SIZE;
+			sink.Write(plain, plainLength);
+			plainBytes += plainLength;
+			consumed += recordLength;
+		}
+		memmove(buffer, buffer + consumed, buffered - consumed);
+		buffered -= consumed;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveElided
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReceiveElided(SOCKET clientSocket, ReceiveSink& sink, char* buffer, const size_t bufferSize,
+	const size_t packetSize, size_t& plainBytes)
+		- clientSocket : SOCKET, accepted connection, non blocking
+		- sink : ReceiveSink, already open, the packets go here
+		- buffer : scratch, bufferSize bytes
+		- bufferSize : its size, an extent's data doesnt have to fit
+		- packetSize : what the server was set to, the client has to send the same
+		- plainBytes : packet bytes, holes included, are added to this
+
+-- RETURNS: bool : false if the stream isnt elided, is for another packet size, or breaks off mid packet
+--
+-- NOTES:
+-- Reads the extents (see ZeroRuns.cpp) as they come in, data goes to the sink piece by piece as it
+-- arrives and each hole goes to it as one WriteHole, so no zeros are ever made on this side.
+-- Prints the bytes on the wire against the bytes of packets once the connection ends.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::ReceiveElided(SOCKET clientSocket, ReceiveSink& sink, char* buffer, const size_t bufferSize, const size_t packetSize, size_t& plainBytes)
+{
+	char header[ZERO_STREAM_HEADER_SIZE];
+	uint32_t clientPacketSize;
+	if (!ReceiveExact(clientSocket, header, ZERO_STREAM_HEADER_SIZE) || !ReadZeroStreamHeader(header, clientPacketSize))
+	{
+		emit ServerPrintableStatusReady("-stream doesnt start with zero runs, is the client set to elide zeros too?");
+		return false;
+	}
+	if (clientPacketSize != packetSize)
+	{
+		emit ServerPrintableStatusReady(QString("-client sends %1B packets, this server expects %2B").arg(clientPacketSize).arg(packetSize));
+		return false;
+	}
+
+	uint64_t wireBytes = ZERO_STREAM_HEADER_SIZE;
+	uint64_t packetBytes = 0;
+	uint64_t holeBytes = 0;
+	size_t packetPosition = 0; //where the next extent starts in its packet
+	size_t dataLeft = 0; //data of the current extent still to come
+	size_t holePending = 0; //its hole, handed over once the data is
+	size_t buffered = 0;
+	bool complete = false;
+	bool valid = true;
+	while (valid)
+	{
+		int bytesRead = recv(clientSocket, buffer + buffered, (int)(bufferSize - buffered), 0);
+		if (bytesRead == 0)
+		{
+			complete = (buffered == 0 && dataLeft == 0 && packetPosition == 0);
+			break;
+		}
+		if (bytesRead < 0)
+		{
+			if (WSAGetLastError() == WSAEWOULDBLOCK && keepPolling)
+			{
+				QThread::msleep(1);
+				continue;
+			}
+			break;
+		}
+		buffered += bytesRead;
+		wireBytes += bytesRead;
+		CountReceived(bytesRead, 1);
+
+		size_t consumed = 0;
+		while (true)
+		{
+			if (dataLeft == 0 && holePending > 0)
+			{
+				sink.WriteHole(holePending);
+				packetBytes += holePending;
+				holeBytes += holePending;
+				holePending = 0;
+			}
+			if (dataLeft > 0)
+			{
+				size_t piece = std::min(dataLeft, buffered - consumed);
+				if (piece == 0)
+					break;
+				sink.Write(buffer + consumed, piece);
+				packetBytes += piece;
+				dataLeft -= piece;
+				consumed += piece;
+				continue;
+			}
+			if (buffered - consumed < ZERO_EXTENT_HEADER_SIZE)
+				break;
+			dataLeft = (size_t)ReadLittleEndian(buffer + consumed, 4);
+			holePending = (size_t)ReadLittleEndian(buffer + consumed + 4, 4);
+			consumed += ZERO_EXTENT_HEADER_SIZE;
+			packetPosition += dataLeft + holePending;
+			if (dataLeft + holePending == 0 || packetPosition > packetSize)
+			{
+				emit ServerPrintableStatusReady("-zero run extent doesnt fit its packet, dropping the connection");
+				valid = false;
+				break;
+			}
+			if (packetPosition == packetSize)
+				packetPosition = 0;
+		}
+		memmove(buffer, buffer + consumed, buffered - consumed);
+		buffered -= consumed;
+	}
+	plainBytes += (size_t)packetBytes;
+	double megabytes = 1024.0 * 1024.0;
+	emit ServerPrintableStatusReady(QString("-zero runs: %1 MB of packets came as %2 MB on the wire, %3 MB of them holes")
+		.arg(packetBytes / megabytes, 0, 'f', 1).arg(wireBytes / megabytes, 0, 'f', 1).arg(holeBytes / megabytes, 0, 'f', 1));
+	return complete;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveBatchFile
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReceiveBatchFile(SOCKET clientSocket, QFile& outputFile, char* chunkBuffer, const size_t fileSize)
+		- clientSocket : SOCKET, accepted connection
+		- outputFile : QFile, already open for writing
+		- chunkBuffer : BATCH_CHUNK_SIZE bytes of scratch
+		- fileSize : number of content bytes to copy from the socket to the file
+
+-- RETURNS: bool : false if the connection dropped or the disk write failed
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::ReceiveBatchFile(SOCKET clientSocket, QFile& outputFile, char* chunkBuffer, const size_t fileSize)
+{
+	size_t remaining = fileSize;
+	while (remaining > 0)
+	{
+		size_t chunkLength = std::min<size_t>(remaining, BATCH_CHUNK_SIZE);
+		if (!ReceiveExact(clientSocket, chunkBuffer, chunkLength))
+			return false;
+		TraceScope trace(TraceStage::Write, chunkLength);
+		if (outputFile.write(chunkBuffer, chunkLength) != (qint64)chunkLength)
+		{
+			emit ServerPrintableStatusReady(QString("-write failed on %1").arg(outputFile.fileName()));
+			return false;
+		}
+		remaining -= chunkLength;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveTcpDelta
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveTcpDelta(SOCKET serverSocket, const QString& filePath)
+		- serverSocket : SOCKET, socket to listen for connections on 
+		- filePath : QString, this side's copy of the file, updated in place (made if missing)
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function assumes all parameters are pre-validated in WSASocketManager.
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- For every connection: sends signatures of the current copy, rebuilds the new version from
+-- copy/literal ops (see DeltaSync.cpp) and swaps it in if the whole file hash checks out.
+-- PacketReceived is emitted with the bytes that crossed the wire and the number of updates so far.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveTcpDelta(SOCKET serverSocket, const QString& filePath)
+{
+	size_t filesUpdated = 0;
+	char* chunkBuffer = arena.Allocate(BATCH_CHUNK_SIZE * sizeof(char));
+
+	while(keepPolling)
+	{
+		if (listen(serverSocket, 5) < 0)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+
+		SOCKET clientSocket;
+		struct sockaddr_storage client; //server socket may be IPv6
+		int client_len = sizeof(client); 
+		if ((clientSocket = accept (serverSocket, (struct sockaddr *)&client, &client_len)) == INVALID_SOCKET)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+		//connection accepted, start timing
+		emit PacketReceived(-1, -1);
+
+		size_t wireBytes = 0;
+		uint64_t newSize = 0;
+		if (ApplyDelta(clientSocket, filePath, chunkBuffer, wireBytes, newSize))
+		{
+			++filesUpdated;
+			emit PacketReceived(wireBytes, filesUpdated);
+			emit ServerPrintableStatusReady(QString("-Delta applied: %1 bytes on wire for a %2 byte file.").arg(wireBytes).arg(newSize));
+		}
+		else
+		{
+			emit ServerPrintableStatusReady("-Delta failed, old copy kept.");
+		}
+		closesocket (clientSocket);
+	} 
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ApplyDelta
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ApplyDelta(SOCKET clientSocket, const QString& filePath, char* chunkBuffer, size_t& wireBytes,
+	uint64_t& newSize)
+		- clientSocket : SOCKET, accepted connection
+		- filePath : QString, this side's copy
+		- chunkBuffer : BATCH_CHUNK_SIZE bytes of scratch
+		- wireBytes : set to bytes sent + received for this update
+		- newSize : set to the size the client announced
+
+-- RETURNS: bool : whether the new version was written over filePath
+--
+-- NOTES:
+-- New version is built in filePath.delta next to the old one, every op is bounds checked against
+-- the announced size and the old copy's block count, and the old copy is only replaced once the
+-- hash of what was written matches the client's. The replace is a single MoveFileEx, so theres
+-- always either the old or the new copy on disk.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::ApplyDelta(SOCKET clientSocket, const QString& filePath, char* chunkBuffer, size_t& wireBytes, uint64_t& newSize)
+{
+	char request[DELTA_HEADER_SIZE];
+	if (!ReceiveExact(clientSocket, request, DELTA_HEADER_SIZE) || ReadLittleEndian(request, 4) != DELTA_REQUEST_MAGIC)
+		return false;
+	wireBytes += DELTA_HEADER_SIZE;
+	newSize = ReadLittleEndian(request + 8, 8);
+
+	QFile basis(filePath);
+	uint64_t basisSize = basis.open(QIODevice::ReadOnly) ? basis.size() : 0;
+	uint32_t blockSize = ChooseBlockSize(basisSize, (uint32_t)ReadLittleEndian(request + 4, 4));
+	uint64_t blockCount = 0;
+	if (!SendSignatures(clientSocket, basis, blockSize, blockCount, wireBytes))
+		return false;
+
+	QString tempPath = filePath + ".delta";
+	QFile output(tempPath);
+	if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		emit ServerPrintableStatusReady(QString("-could not write %1").arg(tempPath));
+		return false;
+	}
+	StrongHasher hasher;
+	uint64_t written = 0;
+	bool verified = false;
+	bool opFailed = false;
+	while (keepPolling && !opFailed && !verified)
+	{
+		char op;
+		if (!ReceiveExact(clientSocket, &op, 1))
+			break;
+		if (op == DELTA_OP_LITERAL)
+		{
+			char lengthField[4];
+			if (!ReceiveExact(clientSocket, lengthField, 4))
+				break;
+			uint32_t length = (uint32_t)ReadLittleEndian(lengthField, 4);
+			if (length > DELTA_MAX_LITERAL || length > newSize - written || !ReceiveExact(clientSocket, chunkBuffer, length))
+				break;
+			opFailed = (output.write(chunkBuffer, length) != (qint64)length);
+			hasher.Update(chunkBuffer, length);
+			written += length;
+			wireBytes += 5 + length;
+		}
+		else if (op == DELTA_OP_COPY)
+		{
+			char fields[DELTA_COPY_OP_SIZE - 1];
+			if (!ReceiveExact(clientSocket, fields, sizeof(fields)))
+				break;
+			uint64_t firstBlock = ReadLittleEndian(fields, 8);
+			uint64_t copyCount = ReadLittleEndian(fields + 8, 4);
+			if (firstBlock >= blockCount || copyCount > blockCount - firstBlock || copyCount * blockSize > newSize - written
+				|| !basis.seek(firstBlock * blockSize))
+				break;
+			for (uint64_t remaining = copyCount * blockSize; remaining > 0 && !opFailed; )
+			{
+				qint64 length = (qint64)std::min<uint64_t>(remaining, BATCH_CHUNK_SIZE);
+				opFailed = (basis.read(chunkBuffer, length) != length) || (output.write(chunkBuffer, length) != length);
+				hasher.Update(chunkBuffer, (size_t)length);
+				remaining -= length;
+				written += length;
+			}
+			wireBytes += DELTA_COPY_OP_SIZE;
+		}
+		else if (op == DELTA_OP_END)
+		{
+			char fields[DELTA_END_OP_SIZE - 1];
+			if (!ReceiveExact(clientSocket, fields, sizeof(fields)))
+				break;
+			wireBytes += DELTA_END_OP_SIZE;
+			if (ReadLittleEndian(fields, 8) != newSize || written != newSize || ReadLittleEndian(fields + 8, 8) != hasher.Final())
+			{
+				emit ServerPrintableStatusReady("-delta result doesnt match the client's hash");
+				break;
+			}
+			verified = true;
+		}
+		else
+		{
+			emit ServerPrintableStatusReady(QString("-unknown delta op %1").arg((int)op));
+			break;
+		}
+	}
+	output.close();
+	basis.close();
+	if (!verified)
+	{
+		QFile::remove(tempPath);
+		return false;
+	}
+	if (!ReplaceWithTempFile(tempPath, filePath))
+	{
+		emit ServerPrintableStatusReady(QString("-could not replace %1, result left in %2").arg(filePath).arg(tempPath));
+		return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendSignatures
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SendSignatures(SOCKET clientSocket, QFile& basis, const uint32_t blockSize, uint64_t& blockCount,
+	size_t& wireBytes)
+		- clientSocket : SOCKET, accepted connection
+		- basis : QFile, this side's copy, may not be open if there wasnt one
+		- blockSize : bytes per block
+		- blockCount : set to the number of blocks signed
+		- wireBytes : bytes sent are added to this
+
+-- RETURNS: bool : false if the connection dropped or the copy couldnt be read
+--
+-- NOTES:
+-- Only whole blocks are signed, a short tail block will just come back as literals.
+-- Signatures are sent as they are computed so the client isnt idle for the whole hashing pass.
+-- Each 4MB read is signed in parallel on the scheduler, every block's signature has its own slot in reply.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::SendSignatures(SOCKET clientSocket, QFile& basis, const uint32_t blockSize, uint64_t& blockCount, size_t& wireBytes)
+{
+	blockCount = basis.isOpen() ? std::min<uint64_t>(basis.size() / blockSize, DELTA_MAX_BLOCKS) : 0;
+	std::vector<char> reply(DELTA_HEADER_SIZE);
+	WriteLittleEndian(&reply[0], DELTA_SIGNATURE_MAGIC, 4);
+	WriteLittleEndian(&reply[4], blockSize, 4);
+	WriteLittleEndian(&reply[8], blockCount, 8);
+
+	std::vector<char> readBuffer((blockCount > 0) ? DELTA_SIGNATURE_READ : 0);
+	uint64_t blocksPerRead = DELTA_SIGNATURE_READ / blockSize;
+	uint64_t blocksPerTask = std::max<uint64_t>(1, DELTA_SIGNATURE_TASK_BYTES / blockSize);
+	for (uint64_t block = 0; block < blockCount; )
+	{
+		uint64_t blocksRead = std::min<uint64_t>(blockCount - block, blocksPerRead);
+		qint64 readLength = (qint64)(blocksRead * blockSize);
+		if (basis.read(readBuffer.data(), readLength) != readLength)
+			return false;
+		size_t replyStart = reply.size();
+		reply.resize(replyStart + blocksRead * DELTA_SIGNATURE_SIZE);
+		TaskScheduler::Shared().ParallelFor((size_t)((blocksRead + blocksPerTask - 1) / blocksPerTask), [&](size_t task) {
+			uint64_t last = std::min<uint64_t>(blocksRead, (task + 1) * blocksPerTask);
+			for (uint64_t i = task * blocksPerTask; i < last; i++)
+			{
+				const unsigned char* blockData = (const unsigned char*)readBuffer.data() + i * blockSize;
+				char* signature = &reply[replyStart + i * DELTA_SIGNATURE_SIZE];
+				uint32_t a, b;
+				WriteLittleEndian(signature, WeakChecksum(blockData, blockSize, a, b), 4);
+				WriteLittleEndian(signature + 4, StrongHash(blockData, blockSize), 8);
+			}
+		});
+		block += blocksRead;
+		if (reply.size() >= BATCH_CHUNK_SIZE)
+		{
+			if (!SendExact(clientSocket, reply.data(), reply.size()))
+				return false;
+			wireBytes += reply.size();
+			reply.clear();
+		}
+	}
+	if (!SendExact(clientSocket, reply.data(), reply.size()))
+		return false;
+	wireBytes += reply.size();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SendExact
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SendExact(SOCKET clientSocket, const char* data, const size_t length)
+		- clientSocket : SOCKET, accepted connection, non blocking
+		- data : bytes to send
+		- length : number of bytes to send
+
+-- RETURNS: bool : false on a socket error or if polling stopped first
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::SendExact(SOCKET clientSocket, const char* data, const size_t length)
+{
+	size_t offset = 0;
+	while (offset < length)
+	{
+		if (!keepPolling)
+			return false;
+		int bytesSent = send(clientSocket, data + offset, (int)std::min<size_t>(length - offset, BATCH_CHUNK_SIZE), 0);
+		if (bytesSent < 0)
+		{
+			if (WSAGetLastError() != WSAEWOULDBLOCK)
+				return false;
+			fd_set writeSet;
+			FD_ZERO(&writeSet);
+			FD_SET(clientSocket, &writeSet);
+			struct timeval timeout = { 0, 100000 };
+			select(0, NULL, &writeSet, NULL, &timeout);
+			continue;
+		}
+		offset += bytesSent;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveTcpDedup
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveTcpDedup(SOCKET serverSocket, const QString& filePath)
+		- serverSocket : SOCKET, bound TCP socket
+		- filePath : QString, where received files are written
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Accepts connections until stopped, each one sends a file as a list of chunk hashes and only the
+-- chunks the store in .asn2_chunks (next to filePath) doesnt have yet. The store lives across
+-- connections and across runs, so the same template sent again costs little more than its chunk list.
+-- Prints the session's and the store's dedup ratio after every file.
+-- If the store cant be opened the transfers still go through, as plain ones: see ApplyDedup.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveTcpDedup(SOCKET serverSocket, const QString& filePath)
+{
+	size_t filesReceived = 0;
+	char* chunkBuffer = arena.Allocate(CDC_MAX_CHUNK * sizeof(char));
+	ChunkStore store(QFileInfo(filePath).absoluteDir().filePath(DEDUP_STORE_DIR), DEDUP_STORE_MAX_BYTES);
+	if (!store.Open())
+	{
+		emit ServerPrintableStatusReady("-could not open the chunk store, every chunk will be sent and none kept");
+	}
+
+	while(keepPolling)
+	{
+		if (listen(serverSocket, 5) < 0)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+
+		SOCKET clientSocket;
+		struct sockaddr_storage client; //server socket may be IPv6
+		int client_len = sizeof(client); 
+		if ((clientSocket = accept (serverSocket, (struct sockaddr *)&client, &client_len)) == INVALID_SOCKET)
+		{
+			QThread::msleep(100);
+			continue;
+		}
+		//connection accepted, start timing
+		emit PacketReceived(-1, -1);
+
+		size_t wireBytes = 0;
+		uint64_t fileSize = 0;
+		uint64_t storedBytes = 0;
+		if (ApplyDedup(clientSocket, filePath, store, chunkBuffer, wireBytes, fileSize, storedBytes))
+		{
+			++filesReceived;
+			emit PacketReceived(wireBytes, filesReceived);
+			double reused = (fileSize > 0) ? 100.0 * storedBytes / fileSize : 0;
+			emit ServerPrintableStatusReady(QString("-Dedup: %1 of %2 bytes came from the chunk store (%3%), %4 bytes on wire.")
+				.arg(storedBytes).arg(fileSize).arg(reused, 0, 'f', 1).arg(wireBytes));
+			if (store.IsOpen())
+				emit ServerPrintableStatusReady(QString("-Chunk store: %1 chunks, %2 MB, %3x dedup over all sessions.")
+					.arg(store.GetChunkCount()).arg(store.GetStoredBytes() / (1024.0 * 1024.0), 0, 'f', 1)
+					.arg(store.GetDedupRatio(), 0, 'f', 2));
+		}
+		else
+		{
+			emit ServerPrintableStatusReady("-Dedup transfer failed, nothing written.");
+		}
+		closesocket (clientSocket);
+	} 
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ApplyDedup
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ApplyDedup(SOCKET clientSocket, const QString& filePath, ChunkStore& store, char* chunkBuffer,
+	size_t& wireBytes, uint64_t& fileSize, uint64_t& storedBytes)
+		- clientSocket : SOCKET, accepted connection
+		- filePath : QString, where the file is written
+		- store : ChunkStore, Open already called on it
+		- chunkBuffer : CDC_MAX_CHUNK bytes of scratch
+		- wireBytes : set to bytes sent + received for this file
+		- fileSize : set to the size the client announced
+		- storedBytes : set to bytes of the file that came out of the store
+
+-- RETURNS: bool : whether the file was written and its hash checked out
+--
+-- NOTES:
+-- A chunk that shows up more than once in the same file is only asked for the first time, by the
+-- time the repeat is reached its already in the store. Every received chunk's SHA-256 is checked
+-- against the one offered before it goes into the store, so a client can only store a chunk under
+-- its real hash and cant plant one for later sessions to be handed.
+-- File is built in filePath.dedup and moved over filePath in one MoveFileEx once verified.
+-- When the store didnt open, every chunk is asked for, repeats too, and goes straight to the file
+-- without touching the store: a plain transfer with a chunk list in front.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Server::ApplyDedup(SOCKET clientSocket, const QString& filePath, ChunkStore& store, char* chunkBuffer, size_t& wireBytes,
+	uint64_t& fileSize, uint64_t& storedBytes)
+{
+	char header[DEDUP_HEADER_SIZE];
+	if (!ReceiveExact(clientSocket, header, DEDUP_HEADER_SIZE) || ReadLittleEndian(header, 4) != DEDUP_OFFER_MAGIC)
+		return false;
+	size_t chunkCount = (size_t)ReadLittleEndian(header + 4, 4);
+	fileSize = ReadLittleEndian(header + 8, 8);
+	if (chunkCount > DEDUP_MAX_CHUNKS)
+		return false;
+	std::vector<char> offer(chunkCount * DEDUP_ENTRY_SIZE);
+	if (!ReceiveExact(clientSocket, offer.data(), offer.size()))
+		return false;
+	wireBytes += DEDUP_HEADER_SIZE + offer.size();
+
+	std::vector<char> reply(DEDUP_REPLY_HEADER_SIZE + (chunkCount + 7) / 8, 0);
+	WriteLittleEndian(&reply[0], DEDUP_MISSING_MAGIC, 4);
+	WriteLittleEndian(&reply[4], chunkCount, 4);
+	bool useStore = store.IsOpen();
+	std::set<std::pair<ChunkHash, uint32_t>> requested; //same key as the store, a hash offered at two lengths is two chunks
+	uint64_t offeredBytes = 0;
+	ChunkHash hash;
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		memcpy(hash.data(), &offer[i * DEDUP_ENTRY_SIZE], DEDUP_CHUNK_HASH_SIZE);
+		uint32_t length = (uint32_t)ReadLittleEndian(&offer[i * DEDUP_ENTRY_SIZE + DEDUP_CHUNK_HASH_SIZE], 4);
+		if (length == 0 || length > CDC_MAX_CHUNK)
+			return false;
+		offeredBytes += length;
+		if (!useStore || (!store.Contains(hash, length) && requested.insert({ hash, length }).second))
+			reply[DEDUP_REPLY_HEADER_SIZE + i / 8] |= (char)(1 << (i % 8));
+	}
+	if (offeredBytes != fileSize || !SendExact(clientSocket, reply.data(), reply.size()))
+		return false;
+	wireBytes += reply.size();
+
+	QString tempPath = filePath + ".dedup";
+	QFile output(tempPath);
+	if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		emit ServerPrintableStatusReady(QString("-could not write %1").arg(tempPath));
+		return false;
+	}
+	StrongHasher hasher;
+	uint64_t receivedBytes = 0;
+	bool chunkFailed = false;
+	ChunkHash receivedHash;
+	for (size_t i = 0; i < chunkCount && !chunkFailed; i++)
+	{
+		memcpy(hash.data(), &offer[i * DEDUP_ENTRY_SIZE], DEDUP_CHUNK_HASH_SIZE);
+		uint32_t length = (uint32_t)ReadLittleEndian(&offer[i * DEDUP_ENTRY_SIZE + DEDUP_CHUNK_HASH_SIZE], 4);
+		if (reply[DEDUP_REPLY_HEADER_SIZE + i / 8] & (1 << (i % 8)))
+		{
+			chunkFailed = !ReceiveExact(clientSocket, chunkBuffer, length)
+				|| !HashChunk((const unsigned char*)chunkBuffer, length, receivedHash) || receivedHash != hash
+				|| (useStore && !store.Write(hash, chunkBuffer, length));
+			receivedBytes += length;
+		}
+		else
+		{
+			chunkFailed = !store.Read(hash, length, chunkBuffer);
+			storedBytes += length;
+		}
+		chunkFailed = chunkFailed || output.write(chunkBuffer, length) != (qint64)length;
+		hasher.Update(chunkBuffer, length);
+	}
+	wireBytes += receivedBytes;
+
+	char endMarker[DEDUP_END_SIZE];
+	bool verified = !chunkFailed && ReceiveExact(clientSocket, endMarker, DEDUP_END_SIZE)
+		&& ReadLittleEndian(endMarker, 8) == fileSize && ReadLittleEndian(endMarker + 8, 8) == hasher.Final();
+	wireBytes += DEDUP_END_SIZE;
+	output.close();
+	//chunks that made it in are good either way, they were hashed on the way in
+	if (useStore)
+		store.Save(verified ? fileSize : 0, receivedBytes);
+	if (!verified)
+	{
+		emit ServerPrintableStatusReady("-dedup result doesnt match the client's hash");
+		QFile::remove(tempPath);
+		return false;
+	}
+	if (!ReplaceWithTempFile(tempPath, filePath))
+	{
+		emit ServerPrintableStatusReady(QString("-could not replace %1, result left in %2").arg(filePath).arg(tempPath));
+		return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveSharded
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ReceiveSharded(const std::vector<SOCKET>& shardSockets, const QString& filePath, const size_t tcpPacketSize)
+		- shardSockets : from OpenShardListeners, all UDP or all listening TCP. Caller closes them
+		- filePath : QString, absolute path to file to write data to
+		- tcpPacketSize : TCP packet size to count packets by, 0 for UDP
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- This function lies on a different thread than main: should be signaled, not directly called.
+--
+-- Single file receive over several ports. Every shard gets a std::thread of its own rather than a
+-- scheduler task, they block in select the whole time and are pinned to a core each.
+-- This thread is the merger: every SHARD_MERGE_MS it adds up the shards' counters and passes on
+-- PacketReceived with the bytes since the last one (like ReceiveTcpBatch does) and the total packets,
+-- and every SHARD_REPORT_MS the aggregate and per shard rates through ShardStatsReady.
+-- Once stopped, each shard's stats go to the console and their part files are appended to filePath.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::ReceiveSharded(const std::vector<SOCKET>& shardSockets, const QString& filePath, const size_t tcpPacketSize)
+{
+	std::vector<int> cores = GetShardCores((int)shardSockets.size());
+	std::vector<std::unique_ptr<ReceiveShard>> shards;
+	for (size_t shard = 0; shard < shardSockets.size(); ++shard)
+	{
+		shards.emplace_back(new ReceiveShard(shardSockets[shard], tcpPacketSize, QString("%1.shard%2").arg(filePath).arg(shard), cores[shard]));
+		shards.back()->Start(keepPolling);
+	}
+	emit ServerPrintableStatusReady(QString("-receiving on %1 shards").arg(shards.size()));
+
+	std::vector<ShardStats> stats(shards.size());
+	size_t lastBytes = 0;
+	size_t lastPackets = 0;
+	auto firstByteTime = std::chrono::steady_clock::now();
+	auto lastByteTime = firstByteTime;
+	auto lastReport = firstByteTime;
+	auto merge = [&]() {
+		size_t totalBytes = 0;
+		size_t totalPackets = 0;
+		for (size_t shard = 0; shard < shards.size(); ++shard)
+		{
+			stats[shard] = shards[shard]->GetStats();
+			totalBytes += stats[shard].bytes;
+			totalPackets += stats[shard].packets;
+		}
+		if (totalBytes == lastBytes)
+			return;
+		auto now = std::chrono::steady_clock::now();
+		if (lastBytes == 0)
+			firstByteTime = now;
+		lastByteTime = now;
+		emit PacketReceived(totalBytes - lastBytes, totalPackets);
+		CountReceived(totalBytes - lastBytes, totalPackets - lastPackets);
+		lastBytes = totalBytes;
+		lastPackets = totalPackets;
+	};
+	auto seconds = [&]() { return std::chrono::duration<double>(lastByteTime - firstByteTime).count(); };
+
+	while (keepPolling)
+	{
+		QThread::msleep(SHARD_MERGE_MS);
+		merge();
+		auto now = std::chrono::steady_clock::now();
+		if (lastBytes > 0 && now - lastReport >= std::chrono::milliseconds(SHARD_REPORT_MS))
+		{
+			emit ShardStatsReady(SummarizeShards(stats, seconds()));
+			lastReport = now;
+		}
+	}
+	for (auto& shard : shards)
+	{
+		shard->Join();
+	}
+	merge();
+	emit ShardStatsReady(SummarizeShards(stats, seconds()));
+	for (const ShardStats& shard : stats)
+	{
+		emit ServerPrintableStatusReady(QString("-shard port %1 core %2: %3 pkts, %4 bytes, %5s busy")
+			.arg(shard.port).arg(shard.core).arg(shard.packets).arg(shard.bytes).arg(shard.busySeconds, 0, 'f', 3));
+	}
+	MergeShardFiles(filePath, shards.size());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION MergeShardFiles
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void MergeShardFiles(const QString& filePath, const size_t shardCount)
+		- filePath : QString, file the shards' part files are appended to
+		- shardCount : number of part files, filePath.shard0 and up
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Single file mode sends the same packet over and over, so the order shards are appended in
+-- doesnt change the result. A part file is only removed once all of it was read and the output
+-- flushed fine; on the first one that wasnt, that part and the ones after it are kept and named.
+----------------------------------------------------------------------------------------------------------------------*/
+void Server::MergeShardFiles(const QString& filePath, const size_t shardCount)
+{
+	std::ofstream outputFile(filePath.toStdString(), std::ofstream::binary | std::ofstream::app);
+	std::vector<char> copyBuffer(SHARD_BUFFER_SIZE);
+	for (size_t shard = 0; shard < shardCount; ++shard)
+	{
+		QString partPath = QString("%1.shard%2").arg(filePath).arg(shard);
+		std::ifstream partFile(partPath.toStdString(), std::ifstream::binary);
+		if (!partFile.is_open())
+			continue; //shard never got anything
+		while (outputFile.good() && (partFile.read(copyBuffer.data(), copyBuffer.size()) || partFile.gcount() > 0))
+		{
+			outputFile.write(copyBuffer.data(), partFile.gcount());
+		}
+		bool appended = !partFile.bad() && partFile.eof() && outputFile.flush().good();
+		partFile.close();
+		if (!appended)
+		{
+			emit ServerPrintableStatusReady(QString("-could not append %1 to %2, kept it").arg(partPath).arg(filePath));
+			for (size_t kept = shard + 1; kept < shardCount; ++kept)
+			{
+				QString keptPath = QString("%1.shard%2").arg(filePath).arg(kept);
+				if (QFile::exists(keptPath))
+					emit ServerPrintableStatusReady(QString("-%1 not appended either, kept it").arg(keptPath));
+			}
+			return;
+		}
+		QFile::remove(partPath);
+	}
 }
@@ -2,24 +2,95 @@
 #pragma comment(lib, "ws2_32.lib")
 
 #include <QObject>
+#include <QMetaMethod>
 #include <QThread>
 #include <iostream>
 #include <fstream>
 #include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <set>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include "BatchProtocol.h"
+#include "DeltaSync.h"
+#include "DedupStore.h"
+#include "TaskScheduler.h"
+#include "UdpMeasure.h"
+#include "SocketShards.h"
+#include "UdpOffload.h"
+#include "RioUdp.h"
+#include "BufferPool.h"
+#include "SecureChannel.h"
+#include "UdpFec.h"
+#include "UdpMulticast.h"
+#include "SyntheticPayload.h"
+#include "ZeroRuns.h"
+#include "PingPong.h"
+#include "FlightRecorder.h"
+#include "TransferOptions.h"
+#include "LiveSeries.h"
+
+#define RECEIVE_REPORT_MS 10 //PacketReceived goes out at most this often while datagrams keep coming
 
 class Server : public QObject
 {
 	Q_OBJECT
 
 public:
+	Server();
 	virtual ~Server();
-	void ReceiveUdpPackets(SOCKET, const QString&);
-	void ReceiveTcpPackets(SOCKET, const QString&, const size_t);
+	void ReceiveUdpPackets(SOCKET, const QString&, const bool = false);
+	void ReceiveUdpRio(SOCKET, const QString&);
+	void ReceiveUdpMeasure(SOCKET, const QString&);
+	void ReceiveUdpFec(SOCKET, const QString&);
+	void ReceiveUdpMulticast(SOCKET, const QString&);
+	void ReceiveTcpPackets(SOCKET, const QString&, const size_t, const bool = false, const bool = false);
+	void ReceiveTcpBatch(SOCKET, const QString&);
+	void EchoUdpPackets(SOCKET, const bool);
+	void EchoTcpPackets(SOCKET, const size_t, const bool);
+	void ReceiveTcpDelta(SOCKET, const QString&);
+	void ReceiveTcpDedup(SOCKET, const QString&);
+	void ReceiveSharded(const std::vector<SOCKET>&, const QString&, const size_t);
+	void UsePayloadSink(const TransferOptions&);
 	void StopPolling();
+	void ReadLiveTotals(LiveTotals&) const;
 
 signals:
 	void PacketReceived(const size_t, const size_t);
+	void ServerPrintableStatusReady(const QString&);
+	void MeasureStatsReady(const QString&);
+	void ShardStatsReady(const QString&);
+	void FecStatsReady(const QString&);
+	void MulticastStatsReady(const QString&);
+	void SinkStatsReady(const QString&, const quint64);
 	
 private:	
-	bool keepPolling;
+	std::atomic<bool> keepPolling;
+	SessionArena arena; //receive buffers, back to the pool when the session's Server goes
+	TransferOptions sinkOptions; //payloadSink, what Verify expects and the shared key, for the single file receives
+	std::atomic<uint64_t> liveBytes; //bumped by the receive loop as data comes in, sampled from the main thread for the chart
+	std::atomic<uint64_t> livePackets;
+	std::atomic<uint64_t> liveLossChecked; //Measure and FEC receives only, see CountLoss
+	std::atomic<uint64_t> liveLost;
+
+	bool ReceiveExact(SOCKET, char*, const size_t);
+	bool ReceiveSealed(SOCKET, ReceiveSink&, char*, const size_t, size_t&);
+	bool ReceiveElided(SOCKET, ReceiveSink&, char*, const size_t, const size_t, size_t&);
+	bool OpenSink(ReceiveSink&, const QString&, const size_t);
+	void ReportSink(ReceiveSink&);
+	bool ReceiveBatchFile(SOCKET, QFile&, char*, const size_t);
+	bool ReceivePackFrame(SOCKET, const QDir&, std::vector<char>&, const uint16_t, const uint64_t, size_t&, size_t&);
+	bool SendExact(SOCKET, const char*, const size_t);
+	bool SendSignatures(SOCKET, QFile&, const uint32_t, uint64_t&, size_t&);
+	bool ApplyDelta(SOCKET, const QString&, char*, size_t&, uint64_t&);
+	bool ApplyDedup(SOCKET, const QString&, ChunkStore&, char*, size_t&, uint64_t&, uint64_t&);
+	void MergeShardFiles(const QString&, const size_t);
+	void ReportReceived(size_t&, const size_t, std::chrono::steady_clock::time_point&, const bool);
+	void CountReceived(const size_t, const size_t);
+	void CountLoss(const uint64_t, const uint64_t);
 };
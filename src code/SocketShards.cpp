@@ -0,0 +1,417 @@
+#include "SocketShards.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SocketShards.cpp - Spreading one single file transfer over several ports, a socket and thread each
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	bool ShardAddress(struct sockaddr_storage&, const int);
+	bool OpenShardListeners(SOCKET, const int, std::vector<SOCKET>&);
+	bool ConnectShards(SOCKET, const int, std::vector<SOCKET>&);
+	std::vector<int> GetShardCores(const int);
+	QString SummarizeShards(const std::vector<ShardStats>&, const double);
+	void Start(const std::atomic<bool>&);
+	void Join();
+	ShardStats GetStats() const;
+	void Run(const std::atomic<bool>&);
+	bool WaitReadable(SOCKET);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- ReceiveUdpPackets drains one socket on one thread, so one core caps the packet rate.
+-- A sharded receive has N sockets instead, each drained by its own thread pinned to its own core,
+-- writing to its own part file, and Server::ReceiveSharded merges their counters.
+--
+-- On Linux the N sockets would share one port with SO_REUSEPORT and the kernel would hash flows
+-- across them. WinSock has no such option (SO_REUSEADDR on a unicast UDP port hands every datagram
+-- to just one of the sockets), so shards take consecutive ports from the one picked instead, and
+-- the client spreads its packets over them round robin. Spreading the NIC's interrupts is left to RSS.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ShardAddress
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ShardAddress(struct sockaddr_storage& address, const int shard)
+		- address : IPv4 or IPv6 address of shard 0, changed to the address of the given shard
+		- shard : 0 based shard number
+
+-- RETURNS: bool : false if the port would go past 65535 or the family isnt IP
+----------------------------------------------------------------------------------------------------------------------*/
+bool ShardAddress(struct sockaddr_storage& address, const int shard)
+{
+	u_short* port = nullptr;
+	if (address.ss_family == AF_INET)
+		port = &((struct sockaddr_in*)&address)->sin_port;
+	else if (address.ss_family == AF_INET6)
+		port = &((struct sockaddr_in6*)&address)->sin6_port;
+	if (port == nullptr || ntohs(*port) + shard > 65535)
+		return false;
+	*port = htons((u_short)(ntohs(*port) + shard));
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION OpenShardListeners
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool OpenShardListeners(SOCKET first, const int shardCount, std::vector<SOCKET>& shards)
+		- first : SOCKET, bound server socket, becomes shard 0
+		- shardCount : total shards wanted, first included
+		- shards : set to first followed by the sockets made here
+
+-- RETURNS: bool : whether every shard port could be bound. If not, the sockets made here are closed
+--                 and shards is left empty, first stays open
+--
+-- NOTES:
+-- New sockets copy the family, type, address and non blocking mode of first, on the next ports up.
+-- TCP shards are put in listen right away, so clients can connect before the receive loop starts.
+----------------------------------------------------------------------------------------------------------------------*/
+bool OpenShardListeners(SOCKET first, const int shardCount, std::vector<SOCKET>& shards)
+{
+	struct sockaddr_storage base;
+	int baseLength = sizeof(base);
+	int type = 0;
+	int typeLength = sizeof(type);
+	shards.clear();
+	if (getsockname(first, (struct sockaddr*)&base, &baseLength) != 0
+		|| getsockopt(first, SOL_SOCKET, SO_TYPE, (char*)&type, &typeLength) != 0)
+	{
+		return false;
+	}
+	if (type == SOCK_STREAM && listen(first, 5) != 0)
+		return false;
+
+	shards.push_back(first);
+	for (int shard = 1; shard < shardCount; ++shard)
+	{
+		struct sockaddr_storage address = base;
+		SOCKET shardSocket = ShardAddress(address, shard) ? ::socket(base.ss_family, type, 0) : INVALID_SOCKET;
+		if (shardSocket == INVALID_SOCKET)
+			break;
+		if (base.ss_family == AF_INET6)
+		{
+			int off = 0;
+			setsockopt(shardSocket, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&off, sizeof(off));
+		}
+		unsigned long on = 1;
+		ioctlsocket(shardSocket, FIONBIO, &on);
+		if (bind(shardSocket, (struct sockaddr*)&address, baseLength) != 0
+			|| (type == SOCK_STREAM && listen(shardSocket, 5) != 0))
+		{
+			closesocket(shardSocket);
+			break;
+		}
+		shards.push_back(shardSocket);
+	}
+	if ((int)shards.size() == shardCount)
+		return true;
+
+	for (size_t shard = 1; shard < shards.size(); ++shard)
+		closesocket(shards[shard]);
+	shards.clear();
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ConnectShards
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ConnectShards(SOCKET connected, const int shardCount, std::vector<SOCKET>& shards)
+		- connected : SOCKET, TCP socket already connected to shard 0 (by HostConnector)
+		- shardCount : total connections wanted, connected included
+		- shards : set to connected followed by a connection to each next port up
+
+-- RETURNS: bool : whether every shard connected. Connections that did are kept either way,
+--                 stopping at the first one that didnt
+--
+-- NOTES:
+-- Connects are non blocking with a select timeout, like HostConnector's, and the sockets are
+-- left non blocking like the one it hands over.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ConnectShards(SOCKET connected, const int shardCount, std::vector<SOCKET>& shards)
+{
+	struct sockaddr_storage base;
+	int baseLength = sizeof(base);
+	shards.assign(1, connected);
+	if (getpeername(connected, (struct sockaddr*)&base, &baseLength) != 0)
+		return shardCount <= 1;
+
+	for (int shard = 1; shard < shardCount; ++shard)
+	{
+		struct sockaddr_storage address = base;
+		SOCKET shardSocket = ShardAddress(address, shard) ? ::socket(base.ss_family, SOCK_STREAM, 0) : INVALID_SOCKET;
+		if (shardSocket == INVALID_SOCKET)
+			return false;
+		unsigned long on = 1;
+		ioctlsocket(shardSocket, FIONBIO, &on);
+		bool isConnected = (::connect(shardSocket, (struct sockaddr*)&address, baseLength) == 0);
+		if (!isConnected && WSAGetLastError() == WSAEWOULDBLOCK)
+		{
+			fd_set writable;
+			FD_ZERO(&writable);
+			FD_SET(shardSocket, &writable);
+			struct timeval timeout = { SHARD_CONNECT_TIMEOUT_MS / 1000, (SHARD_CONNECT_TIMEOUT_MS % 1000) * 1000 };
+			int error = 0;
+			int errorLength = sizeof(error);
+			isConnected = select(0, nullptr, &writable, nullptr, &timeout) == 1
+				&& getsockopt(shardSocket, SOL_SOCKET, SO_ERROR, (char*)&error, &errorLength) == 0 && error == 0;
+		}
+		if (!isConnected)
+		{
+			closesocket(shardSocket);
+			return false;
+		}
+		shards.push_back(shardSocket);
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetShardCores
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: std::vector<int> GetShardCores(const int shardCount)
+		- shardCount : number of shard threads
+
+-- RETURNS: std::vector<int> : core for each shard, -1 when it shouldnt be pinned
+--
+-- NOTES:
+-- Goes round the cores this process may run on (which --worker-cores doesnt change), one per shard.
+-- A single shard isnt pinned, it would just be the plain receive on a thread of its own.
+----------------------------------------------------------------------------------------------------------------------*/
+std::vector<int> GetShardCores(const int shardCount)
+{
+	std::vector<int> cores;
+	DWORD_PTR processMask = 0;
+	DWORD_PTR systemMask = 0;
+	if (shardCount > 1 && GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+	{
+		for (int core = 0; core < (int)(sizeof(DWORD_PTR) * 8); ++core)
+		{
+			if (processMask & ((DWORD_PTR)1 << core))
+				cores.push_back(core);
+		}
+	}
+	std::vector<int> shardCores(shardCount, -1);
+	for (int shard = 0; shard < shardCount && !cores.empty(); ++shard)
+		shardCores[shard] = cores[shard % cores.size()];
+	return shardCores;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SummarizeShards
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString SummarizeShards(const std::vector<ShardStats>& stats, const double seconds)
+		- stats : every shard's counters
+		- seconds : time since the first byte arrived
+
+-- RETURNS: QString : one line, aggregate MB/s then each shard's, and the busiest shard's busy time
+--
+-- NOTES:
+-- A shard near 100% busy is the one capping the rate, more shards (or cores) would help.
+----------------------------------------------------------------------------------------------------------------------*/
+QString SummarizeShards(const std::vector<ShardStats>& stats, const double seconds)
+{
+	size_t totalBytes = 0;
+	size_t totalPackets = 0;
+	double busiest = 0;
+	QString perShard;
+	for (const ShardStats& shard : stats)
+	{
+		totalBytes += shard.bytes;
+		totalPackets += shard.packets;
+		busiest = std::max(busiest, (seconds > 0) ? shard.busySeconds / seconds : 0.0);
+		perShard += QString(perShard.isEmpty() ? "%1" : " / %1").arg((seconds > 0) ? shard.bytes / 1048576.0 / seconds : 0, 0, 'f', 1);
+	}
+	return QString("%1 shards: %2 pkts, %3 MB/s (%4), busiest shard %5% busy")
+		.arg(stats.size())
+		.arg(totalPackets)
+		.arg((seconds > 0) ? totalBytes / 1048576.0 / seconds : 0, 0, 'f', 1)
+		.arg(perShard)
+		.arg(std::min(busiest, 1.0) * 100, 0, 'f', 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReceiveShard Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: ReceiveShard(SOCKET shardSocket, const size_t packetSize, const QString& path, const int pinnedCore)
+		- shardSocket : SOCKET, bound UDP socket or listening TCP socket, non blocking. Caller closes it
+		- packetSize : TCP packet size to count packets by, 0 for UDP
+		- path : part file this shard writes to
+		- pinnedCore : core to pin the thread to, -1 for none
+
+-- RETURNS: N/A
+----------------------------------------------------------------------------------------------------------------------*/
+ReceiveShard::ReceiveShard(SOCKET shardSocket, const size_t packetSize, const QString& path, const int pinnedCore)
+	: socket(shardSocket)
+	, tcpPacketSize(packetSize)
+	, partPath(path)
+	, core(pinnedCore)
+	, port(0)
+	, packets(0)
+	, bytes(0)
+	, busyNs(0)
+{
+	struct sockaddr_storage address;
+	int addressLength = sizeof(address);
+	if (getsockname(socket, (struct sockaddr*)&address, &addressLength) == 0)
+	{
+		port = ntohs((address.ss_family == AF_INET6) ? ((struct sockaddr_in6*)&address)->sin6_port
+			: ((struct sockaddr_in*)&address)->sin_port);
+	}
+}
+
+ReceiveShard::~ReceiveShard()
+{
+	Join();
+}
+
+//keepPolling is the Server's flag, it has to outlive the thread
+void ReceiveShard::Start(const std::atomic<bool>& keepPolling)
+{
+	thread = std::thread([this, &keepPolling]() { Run(keepPolling); });
+}
+
+void ReceiveShard::Join()
+{
+	if (thread.joinable())
+		thread.join();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetStats
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: ShardStats GetStats(void) const
+--
+-- RETURNS: ShardStats : this shard's counters so far, safe to call while its thread runs
+----------------------------------------------------------------------------------------------------------------------*/
+ShardStats ReceiveShard::GetStats() const
+{
+	ShardStats stats;
+	stats.port = port;
+	stats.core = core;
+	stats.bytes = bytes;
+	stats.packets = (tcpPacketSize > 0) ? stats.bytes / tcpPacketSize : packets.load();
+	stats.busySeconds = busyNs / 1e9;
+	return stats;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Run
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Run(const std::atomic<bool>& keepPolling)
+		- keepPolling : Server's flag, the loop returns soon after it goes false
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- UDP: every datagram already queued is drained before going back to select.
+-- TCP: one connection at a time is accepted and read until the client closes it, then the next.
+-- Bytes go to the part file as they are, ReceiveUdpPackets stops at the first 0 byte instead.
+----------------------------------------------------------------------------------------------------------------------*/
+void ReceiveShard::Run(const std::atomic<bool>& keepPolling)
+{
+	if (core >= 0)
+		SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core);
+	std::vector<char> buffer(SHARD_BUFFER_SIZE);
+	std::ofstream partFile(partPath.toStdString(), std::ofstream::binary | std::ofstream::trunc);
+	SOCKET connection = INVALID_SOCKET;
+	while (keepPolling)
+	{
+		if (!WaitReadable((connection != INVALID_SOCKET) ? connection : socket))
+			continue;
+		auto busyStart = std::chrono::steady_clock::now();
+		if (tcpPacketSize > 0 && connection == INVALID_SOCKET)
+		{
+			connection = accept(socket, nullptr, nullptr);
+		}
+		else if (tcpPacketSize > 0)
+		{
+			int bytesRead = recv(connection, buffer.data(), (int)buffer.size(), 0);
+			if (bytesRead > 0)
+			{
+				partFile.write(buffer.data(), bytesRead);
+				bytes += bytesRead;
+			}
+			else if (bytesRead == 0 || WSAGetLastError() != WSAEWOULDBLOCK)
+			{
+				closesocket(connection);
+				connection = INVALID_SOCKET;
+			}
+		}
+		else
+		{
+			int bytesRead;
+			while (keepPolling && (bytesRead = recv(socket, buffer.data(), (int)buffer.size(), 0)) > 0)
+			{
+				partFile.write(buffer.data(), bytesRead);
+				bytes += bytesRead;
+				++packets;
+			}
+		}
+		busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - busyStart).count();
+	}
+	if (connection != INVALID_SOCKET)
+		closesocket(connection);
+}
+
+//select on one socket for SHARD_POLL_US
+bool ReceiveShard::WaitReadable(SOCKET waitSocket)
+{
+	fd_set readable;
+	FD_ZERO(&readable);
+	FD_SET(waitSocket, &readable);
+	struct timeval timeout = { 0, SHARD_POLL_US };
+	return select(0, &readable, nullptr, nullptr, &timeout) > 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <Windows.h>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#define SHARD_MAX_COUNT 64 //consecutive ports one sharded transfer can take
+#define SHARD_BUFFER_SIZE 1048576 //per shard receive buffer, replaces the 2GB one of ReceiveTcpPackets
+#define SHARD_POLL_US 100000 //select timeout, how quickly a stop is noticed
+#define SHARD_MERGE_MS 10 //how often the merger adds up the shards' counters
+#define SHARD_REPORT_MS 500 //how often the merged stats go out as text
+#define SHARD_CONNECT_TIMEOUT_MS 2000
+
+struct ShardStats
+{
+	int port;
+	int core; //pinned core, -1 if it can run anywhere
+	size_t packets; //datagrams for UDP, bytes / packet size for TCP
+	size_t bytes;
+	double busySeconds; //in recv and writing, not waiting in select
+};
+
+bool ShardAddress(struct sockaddr_storage&, const int);
+bool OpenShardListeners(SOCKET, const int, std::vector<SOCKET>&);
+bool ConnectShards(SOCKET, const int, std::vector<SOCKET>&);
+std::vector<int> GetShardCores(const int);
+QString SummarizeShards(const std::vector<ShardStats>&, const double);
+
+//one socket of a sharded receive, drained by its own thread into its own part file
+class ReceiveShard
+{
+public:
+	ReceiveShard(SOCKET, const size_t, const QString&, const int);
+	virtual ~ReceiveShard();
+	void Start(const std::atomic<bool>&);
+	void Join();
+	ShardStats GetStats() const;
+
+private:
+	SOCKET socket;
+	size_t tcpPacketSize; //0 for UDP
+	QString partPath;
+	int core;
+	int port;
+	std::thread thread;
+	std::atomic<size_t> packets;
+	std::atomic<size_t> bytes;
+	std::atomic<uint64_t> busyNs;
+
+	void Run(const std::atomic<bool>&);
+	bool WaitReadable(SOCKET);
+};
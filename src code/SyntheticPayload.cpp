@@ -0,0 +1,350 @@
+#include "SyntheticPayload.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SyntheticPayload.cpp - Generated packets and disk free receive sinks for single file runs
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void FillSyntheticPayload(char*, const size_t, const PayloadSource, const uint32_t);
+	QString PayloadSourceName(const PayloadSource, const uint32_t);
+	bool Open(const QString&, const TransferOptions&, SessionArena&, const size_t);
+	void StartStream();
+	void Write(const char*, const size_t);
+	void WriteHole(const size_t);
+	void Flush();
+	bool IsSynthetic() const;
+	bool TakeNewResults();
+	uint64_t GetMismatches() const;
+	QString Summary() const;
+	bool MatchesStream(const char*, const size_t);
+	void CountWrite(const bool);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- A single file run reads its packet from a file on the client and appends every packet to a
+-- file on the server, so what it measures is partly the disk. With a generated source the client
+-- needs no file at all, and with a Discard or Verify sink the server never opens one; what is
+-- left is the network stack.
+--
+-- Verify regenerates the same packet from the same source and seed on the server. Datagrams are
+-- each a whole packet, so each is compared from the start of it. TCP is a stream of packets cut
+-- wherever recv returns, so it's compared by where it is in the stream. Only counts are kept,
+-- a bad byte doesnt stop the run.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION FillSyntheticPayload
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void FillSyntheticPayload(char* payload, const size_t length, const PayloadSource source, const uint32_t seed)
+		- payload : filled with length bytes
+		- length : bytes to make
+		- source : Zeros, Pattern or Random, File leaves it alone
+		- seed : Random only, 0 is taken as 1
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Any length is the start of a longer one with the same source and seed, the sink counts on it.
+----------------------------------------------------------------------------------------------------------------------*/
+void FillSyntheticPayload(char* payload, const size_t length, const PayloadSource source, const uint32_t seed)
+{
+	if (source == PayloadSource::Zeros)
+	{
+		memset(payload, 0, length);
+	}
+	else if (source == PayloadSource::Pattern)
+	{
+		for (size_t i = 0; i < length; ++i)
+		{
+			payload[i] = (char)(i % PAYLOAD_PATTERN_PERIOD);
+		}
+	}
+	else if (source == PayloadSource::Random)
+	{
+		uint64_t state = 0x9E3779B97F4A7C15ULL * (seed != 0 ? seed : 1);
+		for (size_t i = 0; i < length; i += 8)
+		{
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			uint64_t word = state * 0x2545F4914F6CDD1DULL;
+			size_t bytes = std::min<size_t>(8, length - i);
+			for (size_t b = 0; b < bytes; ++b)
+			{
+				payload[i + b] = (char)(word >> (8 * b));
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PayloadSourceName
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString PayloadSourceName(const PayloadSource source, const uint32_t seed)
+		- source : any
+		- seed : printed for Random
+
+-- RETURNS: QString : for the console
+----------------------------------------------------------------------------------------------------------------------*/
+QString PayloadSourceName(const PayloadSource source, const uint32_t seed)
+{
+	switch (source)
+	{
+	case PayloadSource::Zeros:
+		return "zeros";
+	case PayloadSource::Pattern:
+		return "pattern";
+	case PayloadSource::Random:
+		return QString("random, seed %1").arg(seed);
+	default:
+		return "file";
+	}
+}
+
+ReceiveSink::ReceiveSink()
+	: mode(PayloadSink::File), expected(nullptr), period(0), streamOffset(0), writes(0), bytes(0),
+	mismatches(0), firstMismatch(0), reportedWrites(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(const QString& filePath, const TransferOptions& options, SessionArena& arena, const size_t streamPacketSize)
+		- filePath : QString, file a File sink appends to
+		- options : TransferOptions, payloadSink, and payloadSource/payloadSeed for Verify
+		- arena : the Server's, holds the expected packet
+		- streamPacketSize : TCP packet size for a stream sink, 0 for datagrams
+
+-- RETURNS: bool : false if Verify has nothing to compare against or no memory for it
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReceiveSink::Open(const QString& filePath, const TransferOptions& options, SessionArena& arena, const size_t streamPacketSize)
+{
+	mode = options.payloadSink;
+	sourceName = PayloadSourceName(options.payloadSource, options.payloadSeed);
+	if (mode == PayloadSink::File)
+	{
+		outputFile.open(filePath.toStdString(), std::ofstream::app);
+		return true;
+	}
+	if (mode == PayloadSink::Discard)
+		return true;
+	if (options.payloadSource == PayloadSource::File)
+		return false;
+	period = streamPacketSize;
+	size_t expectedLength = (period > 0) ? period : PAYLOAD_DATAGRAM_MAX;
+	expected = arena.Allocate(expectedLength);
+	if (expected == nullptr)
+		return false;
+	FillSyntheticPayload(expected, expectedLength, options.payloadSource, options.payloadSeed);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StartStream
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void StartStream(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- A new TCP connection starts at the beginning of a packet again.
+----------------------------------------------------------------------------------------------------------------------*/
+void ReceiveSink::StartStream()
+{
+	streamOffset = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Write
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Write(const char* data, const size_t length)
+		- data : one datagram's payload, or the next piece of a stream
+		- length : its size
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- A File sink writes up to the first 0, which is what the receive loops always did.
+----------------------------------------------------------------------------------------------------------------------*/
+void ReceiveSink::Write(const char* data, const size_t length)
+{
+	++writes;
+	bytes += length;
+	if (mode == PayloadSink::File)
+	{
+		TraceScope trace(TraceStage::Write, length);
+		outputFile.write(data, strnlen(data, length));
+		return;
+	}
+	if (mode == PayloadSink::Discard)
+		return;
+	if (period == 0)
+		CountWrite(length <= PAYLOAD_DATAGRAM_MAX && memcmp(data, expected, length) == 0);
+	else
+		CountWrite(MatchesStream(data, length));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteHole
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void WriteHole(const size_t length)
+		- length : zero bytes of the stream that werent sent
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Stream sinks only, for an elided zero run. A File sink cuts every write at its first 0, so it
+-- would never have written these; nothing is written or seeked over for them. Verify checks the
+-- generated payload really is 0 there.
+----------------------------------------------------------------------------------------------------------------------*/
+void ReceiveSink::WriteHole(const size_t length)
+{
+	++writes;
+	bytes += length;
+	if (mode == PayloadSink::Verify)
+		CountWrite(MatchesStream(nullptr, length));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION MatchesStream
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool MatchesStream(const char* data, const size_t length)
+		- data : the next piece of the stream, nullptr for length zeros
+		- length : its size
+
+-- RETURNS: bool : whether it is what the expected packet has at this point of the stream
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReceiveSink::MatchesStream(const char* data, const size_t length)
+{
+	bool matches = true;
+	size_t position = (size_t)(streamOffset % period);
+	for (size_t done = 0; done < length && matches; )
+	{
+		size_t piece = std::min(length - done, period - position);
+		matches = (data == nullptr) ? IsAllZero(expected + position, piece) : memcmp(data + done, expected + position, piece) == 0;
+		done += piece;
+		position = 0;
+	}
+	streamOffset += length;
+	return matches;
+}
+
+void ReceiveSink::CountWrite(const bool matches)
+{
+	if (matches)
+		return;
+	if (mismatches == 0)
+		firstMismatch = writes;
+	++mismatches;
+}
+
+void ReceiveSink::Flush()
+{
+	if (mode == PayloadSink::File)
+		outputFile.flush();
+}
+
+bool ReceiveSink::IsSynthetic() const
+{
+	return mode != PayloadSink::File;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION TakeNewResults
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool TakeNewResults(void)
+--
+-- RETURNS: bool : true if a Discard or Verify sink took writes since the last time this said true
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReceiveSink::TakeNewResults()
+{
+	if (!IsSynthetic() || writes == reportedWrites)
+		return false;
+	reportedWrites = writes;
+	return true;
+}
+
+uint64_t ReceiveSink::GetMismatches() const
+{
+	return mismatches;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Summary
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString Summary(void) const
+--
+-- RETURNS: QString : one line of what the sink took, and for Verify how much of it was wrong
+----------------------------------------------------------------------------------------------------------------------*/
+QString ReceiveSink::Summary() const
+{
+	double megabytes = bytes / (1024.0 * 1024.0);
+	if (mode == PayloadSink::Discard)
+		return QString("discard: %1 MB in %2 writes, nothing kept").arg(megabytes, 0, 'f', 1).arg(writes);
+	QString summary = QString("verify (%1): %2 MB in %3 writes, %4 mismatched")
+		.arg(sourceName).arg(megabytes, 0, 'f', 1).arg(writes).arg(mismatches);
+	if (mismatches > 0)
+		summary += QString(", first at write %1").arg(firstMismatch);
+	return summary;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QString>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "TransferOptions.h"
+#include "BufferPool.h"
+#include "ZeroRuns.h"
+#include "FlightRecorder.h"
+
+#define PAYLOAD_PATTERN_PERIOD 251 //Pattern repeats every this many bytes, prime so it never lines up with a packet size
+#define PAYLOAD_DATAGRAM_MAX POOL_SMALL_SIZE //expected bytes a datagram sink keeps, any datagram fits
+
+void FillSyntheticPayload(char*, const size_t, const PayloadSource, const uint32_t);
+QString PayloadSourceName(const PayloadSource, const uint32_t);
+
+//where a single file receive puts what it got: the file like always, nowhere, or checked against
+//the payload the client generated
+class ReceiveSink
+{
+public:
+	ReceiveSink();
+	virtual ~ReceiveSink() = default;
+	bool Open(const QString&, const TransferOptions&, SessionArena&, const size_t);
+	void StartStream();
+	void Write(const char*, const size_t);
+	void WriteHole(const size_t);
+	void Flush();
+	bool IsSynthetic() const;
+	bool TakeNewResults();
+	uint64_t GetMismatches() const;
+	QString Summary() const;
+
+private:
+	bool MatchesStream(const char*, const size_t);
+	void CountWrite(const bool);
+
+	PayloadSink mode;
+	QString sourceName;
+	std::ofstream outputFile;
+	char* expected; //one packet of what the client sends, or PAYLOAD_DATAGRAM_MAX bytes of it for datagrams
+	size_t period; //stream sinks: the packet size, the stream is expected over and over. 0 for datagrams
+	uint64_t streamOffset;
+	uint64_t writes; //datagrams, or recvs for a stream
+	uint64_t bytes;
+	uint64_t mismatches; //writes with at least one wrong byte
+	uint64_t firstMismatch; //write number of the first one
+	uint64_t reportedWrites; //writes when TakeNewResults last said yes
+};
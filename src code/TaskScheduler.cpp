@@ -0,0 +1,533 @@
+#include "TaskScheduler.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: TaskScheduler.cpp - Work stealing pool for session loops and cpu jobs like hashing
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	static TaskScheduler& Shared();
+	static bool ParseCoreList(const QString&, uint64_t&);
+	void Submit(std::function<void()>);
+	void ParallelFor(const size_t, const std::function<void(size_t)>&);
+	void SetAffinity(const uint64_t);
+	void WaitForIdle();
+	int GetWorkerCount() const;
+	std::vector<WorkerStats> GetWorkerStats() const;
+	size_t GetQueuedTaskCount() const;
+	size_t GetRunningTaskCount() const;
+	QString GetLoadSummary();
+	void WorkerLoop(const int);
+	bool TakeTask(const int, std::function<void()>&);
+	void ApplyAffinity(const int);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Every worker has its own deque. A worker runs its own newest task first (the data is likely still
+-- in cache) and when its deque is empty it steals the oldest task from the next worker that has one.
+-- Tasks submitted from outside the pool are dealt round robin, tasks submitted from a worker (the
+-- ParallelFor helpers of a hashing pass inside a send loop for example) go on that worker's deque.
+--
+-- Session loops are long and mostly blocked on sockets, so there are at least SCHEDULER_MIN_WORKERS
+-- workers even on small machines. ParallelFor never waits on a queued helper, the caller works
+-- through the indices itself, so it still finishes if every other worker is stuck in a receive loop.
+--
+-- Workers can be pinned with SetAffinity, to keep them off the cores taking NIC interrupts.
+-- Each worker goes to one core of the mask, round robin. Only the first 64 cores are handled.
+----------------------------------------------------------------------------------------------------------------------*/
+
+namespace
+{
+	thread_local TaskScheduler* currentScheduler = nullptr;
+	thread_local int currentWorker = -1;
+
+	//one ParallelFor call, shared with its helper tasks which can outlive the call
+	struct ParallelRange
+	{
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> done{ 0 };
+		size_t count = 0;
+		std::function<void(size_t)> body;
+		std::mutex doneLock;
+		std::condition_variable allDone;
+	};
+
+	void RunParallelRange(ParallelRange& range)
+	{
+		for (size_t index = range.next++; index < range.count; index = range.next++)
+		{
+			range.body(index);
+			if (++range.done == range.count)
+			{
+				std::lock_guard<std::mutex> lock(range.doneLock);
+				range.allDone.notify_all();
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION TaskScheduler Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: TaskScheduler(const int workerCount)
+		- workerCount : number of worker threads, at least 1
+
+-- RETURNS: N/A
+----------------------------------------------------------------------------------------------------------------------*/
+TaskScheduler::TaskScheduler(const int workerCount)
+	: queuedTasks(0)
+	, runningTasks(0)
+	, nextQueue(0)
+	, affinityMask(0)
+	, affinityGeneration(0)
+	, stopping(false)
+{
+	startTime = std::chrono::steady_clock::now();
+	lastSummaryTime = startTime;
+	int count = std::max(workerCount, 1);
+	for (int i = 0; i < count; i++)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+	lastBusyNs.assign(count, 0);
+	//all workers exist before any thread starts stealing from them
+	for (int i = 0; i < count; i++)
+	{
+		workers[i]->thread = std::thread(&TaskScheduler::WorkerLoop, this, i);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION TaskScheduler Destructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: ~TaskScheduler(void)
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+-- Queued tasks are still run before the workers exit. Anything blocking (a receive loop) has to be
+-- stopped first, WSASocketManager does that in its destructor.
+----------------------------------------------------------------------------------------------------------------------*/
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		stopping = true;
+	}
+	taskAvailable.notify_all();
+	for (auto& worker : workers)
+	{
+		worker->thread.join();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Shared
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: static TaskScheduler& Shared(void)
+--
+-- RETURNS: TaskScheduler& : the one pool the whole program uses, made on first call
+----------------------------------------------------------------------------------------------------------------------*/
+TaskScheduler& TaskScheduler::Shared()
+{
+	static TaskScheduler scheduler(std::max((int)std::thread::hardware_concurrency(), SCHEDULER_MIN_WORKERS));
+	return scheduler;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ParseCoreList
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: static bool ParseCoreList(const QString& coreList, uint64_t& mask)
+		- coreList : cores like "2-7,9", or a hex mask like "0xFC"
+		- mask : set to one bit per core
+
+-- RETURNS: bool : false if the list couldnt be read or names a core past 63
+----------------------------------------------------------------------------------------------------------------------*/
+bool TaskScheduler::ParseCoreList(const QString& coreList, uint64_t& mask)
+{
+	QString text = coreList.trimmed();
+	bool valid = false;
+	if (text.startsWith("0x"))
+	{
+		mask = text.mid(2).toULongLong(&valid, 16);
+		return valid && mask != 0;
+	}
+	mask = 0;
+	for (const QString& part : text.split(","))
+	{
+		QStringList bounds = part.split("-");
+		bool firstValid = false;
+		bool lastValid = false;
+		int first = bounds[0].trimmed().toInt(&firstValid);
+		int last = (bounds.size() > 1) ? bounds[1].trimmed().toInt(&lastValid) : first;
+		if (bounds.size() == 1)
+			lastValid = firstValid;
+		if (!firstValid || !lastValid || bounds.size() > 2 || first < 0 || last > 63 || first > last)
+			return false;
+		for (int core = first; core <= last; core++)
+		{
+			mask |= 1ULL << core;
+		}
+	}
+	return mask != 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Submit
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Submit(std::function<void()> task)
+		- task : runs once on some worker
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void TaskScheduler::Submit(std::function<void()> task)
+{
+	size_t target = (currentScheduler == this) ? (size_t)currentWorker : nextQueue++ % workers.size();
+	{
+		std::lock_guard<std::mutex> lock(workers[target]->queueLock);
+		workers[target]->tasks.push_back(std::move(task));
+		//counted under the queue's lock, TakeTask uncounts under it too, so queuedTasks never goes below
+		//what is really queued (or wraps around) because a worker took the task before it was counted
+		queuedTasks++;
+	}
+	//taken so a worker between checking queuedTasks and sleeping cant miss this
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+	}
+	taskAvailable.notify_one();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ParallelFor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ParallelFor(const size_t count, const std::function<void(size_t)>& body)
+		- count : number of indices
+		- body : called once per index in [0, count), from any thread, in any order
+
+-- RETURNS: void. Once every index is done
+--
+-- NOTES:
+-- Helpers are submitted, then the caller takes indices too. Indices are handed out one at a time,
+-- so callers should make each one a decent amount of work (a group of blocks, not a single byte).
+----------------------------------------------------------------------------------------------------------------------*/
+void TaskScheduler::ParallelFor(const size_t count, const std::function<void(size_t)>& body)
+{
+	if (count == 0)
+		return;
+	if (count == 1)
+	{
+		body(0);
+		return;
+	}
+	auto range = std::make_shared<ParallelRange>();
+	range->count = count;
+	range->body = body;
+	size_t helpers = std::min(count - 1, workers.size());
+	for (size_t i = 0; i < helpers; i++)
+	{
+		Submit([range]() { RunParallelRange(*range); });
+	}
+	RunParallelRange(*range);
+	std::unique_lock<std::mutex> lock(range->doneLock);
+	range->allDone.wait(lock, [&range, count]() { return range->done == count; });
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SetAffinity
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SetAffinity(const uint64_t coreMask)
+		- coreMask : cores workers may run on, 0 lets them run anywhere the process can
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Workers pick the change up before their next task, or right away if idle.
+----------------------------------------------------------------------------------------------------------------------*/
+void TaskScheduler::SetAffinity(const uint64_t coreMask)
+{
+	affinityMask = coreMask;
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		affinityGeneration++;
+	}
+	taskAvailable.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WaitForIdle
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void WaitForIdle(void)
+--
+-- RETURNS: void. Once nothing is queued or running
+--
+-- NOTES:
+-- Dont call from a worker, it would wait on itself.
+----------------------------------------------------------------------------------------------------------------------*/
+void TaskScheduler::WaitForIdle()
+{
+	std::unique_lock<std::mutex> lock(sleepLock);
+	allIdle.wait(lock, [this]() { return queuedTasks == 0 && runningTasks == 0; });
+}
+
+int TaskScheduler::GetWorkerCount() const
+{
+	return (int)workers.size();
+}
+
+std::vector<WorkerStats> TaskScheduler::GetWorkerStats() const
+{
+	double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	std::vector<WorkerStats> stats;
+	for (auto& worker : workers)
+	{
+		stats.push_back({ worker->tasksRun, worker->tasksStolen, worker->busyNs / 1e9, uptime, worker->core });
+	}
+	return stats;
+}
+
+//tasks submitted that no worker has taken yet, sessions waiting for a free worker among them
+size_t TaskScheduler::GetQueuedTaskCount() const
+{
+	return queuedTasks;
+}
+
+size_t TaskScheduler::GetRunningTaskCount() const
+{
+	return runningTasks;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GetLoadSummary
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString GetLoadSummary(void)
+--
+-- RETURNS: QString : each worker's busy % since the last call, and tasks run/stolen so far
+--
+-- NOTES:
+-- Busy time is only added when a task finishes, so a worker in a long session loop shows 0%
+-- until that session ends. Its the short jobs this is for. Only call from one thread.
+----------------------------------------------------------------------------------------------------------------------*/
+QString TaskScheduler::GetLoadSummary()
+{
+	auto now = std::chrono::steady_clock::now();
+	double wallNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastSummaryTime).count();
+	lastSummaryTime = now;
+	uint64_t tasksRun = 0;
+	uint64_t tasksStolen = 0;
+	QString load;
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		uint64_t busy = workers[i]->busyNs;
+		int percent = (wallNs > 0) ? (int)std::min(100.0, 100.0 * (busy - lastBusyNs[i]) / wallNs) : 0;
+		lastBusyNs[i] = busy;
+		load += QString(" %1%").arg(percent);
+		tasksRun += workers[i]->tasksRun;
+		tasksStolen += workers[i]->tasksStolen;
+	}
+	return QString("Workers %1 (%2 running):%3  tasks %4, stolen %5").arg(workers.size()).arg((size_t)runningTasks)
+		.arg(load).arg(tasksRun).arg(tasksStolen);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WorkerLoop
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void WorkerLoop(const int index)
+		- index : this worker's slot in workers
+
+-- RETURNS: void. When the scheduler is destroyed and the queues are empty
+----------------------------------------------------------------------------------------------------------------------*/
+void TaskScheduler::WorkerLoop(const int index)
+{
+	currentScheduler = this;
+	currentWorker = index;
+	Worker& worker = *workers[index];
+	for (;;)
+	{
+		if (worker.affinityGeneration != affinityGeneration)
+		{
+			ApplyAffinity(index);
+		}
+		std::function<void()> task;
+		if (TakeTask(index, task))
+		{
+			auto taskStart = std::chrono::steady_clock::now();
+			task();
+			worker.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - taskStart).count();
+			worker.tasksRun++;
+			if (--runningTasks == 0 && queuedTasks == 0)
+			{
+				std::lock_guard<std::mutex> lock(sleepLock);
+				allIdle.notify_all();
+			}
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepLock);
+		taskAvailable.wait(lock, [this, &worker]() {
+			return stopping || queuedTasks > 0 || worker.affinityGeneration != affinityGeneration;
+		});
+		if (stopping && queuedTasks == 0)
+			return;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION TakeTask
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool TakeTask(const int index, std::function<void()>& task)
+		- index : worker looking for work
+		- task : set to the task taken
+
+-- RETURNS: bool : false if every queue was empty
+--
+-- NOTES:
+-- Own queue from the back, other queues from the front, so owner and thief rarely want the same end.
+----------------------------------------------------------------------------------------------------------------------*/
+bool TaskScheduler::TakeTask(const int index, std::function<void()>& task)
+{
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		bool stealing = (i != 0);
+		Worker& victim = *workers[(index + i) % workers.size()];
+		std::lock_guard<std::mutex> lock(victim.queueLock);
+		if (victim.tasks.empty())
+			continue;
+		if (stealing)
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			workers[index]->tasksStolen++;
+		}
+		else
+		{
+			task = std::move(victim.tasks.back());
+			victim.tasks.pop_back();
+		}
+		//running goes up first so WaitForIdle never sees both at 0 in between
+		runningTasks++;
+		queuedTasks--;
+		return true;
+	}
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ApplyAffinity
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void ApplyAffinity(const int index)
+		- index : worker to pin, called on that worker's own thread
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Cores outside the process's own affinity are dropped from the mask. If nothing is left,
+-- or the mask is 0, the worker goes back to the process's mask.
+----------------------------------------------------------------------------------------------------------------------*/
+void TaskScheduler::ApplyAffinity(const int index)
+{
+	Worker& worker = *workers[index];
+	worker.affinityGeneration = affinityGeneration;
+	DWORD_PTR processMask = 0;
+	DWORD_PTR systemMask = 0;
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+		return;
+	uint64_t mask = affinityMask & (uint64_t)processMask;
+	if (mask == 0)
+	{
+		SetThreadAffinityMask(GetCurrentThread(), processMask);
+		worker.core = -1;
+		return;
+	}
+	int allowedCores = 0;
+	for (int core = 0; core < 64; core++)
+	{
+		if (mask & (1ULL << core))
+			allowedCores++;
+	}
+	int pick = index % allowedCores;
+	for (int core = 0; core < 64; core++)
+	{
+		if ((mask & (1ULL << core)) && pick-- == 0)
+		{
+			SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)(1ULL << core));
+			worker.core = core;
+			return;
+		}
+	}
+}
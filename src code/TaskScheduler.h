@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Windows.h>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define SCHEDULER_MIN_WORKERS 8 //receive sessions hold a worker until stopped, keep some for everything else
+
+struct WorkerStats
+{
+	uint64_t tasksRun;
+	uint64_t tasksStolen; //taken from another worker's queue
+	double busySeconds;
+	double uptimeSeconds;
+	int core; //pinned core, -1 if it can run anywhere
+};
+
+//work stealing pool, one task queue per worker
+class TaskScheduler
+{
+public:
+	TaskScheduler(const int);
+	virtual ~TaskScheduler();
+	static TaskScheduler& Shared();
+	static bool ParseCoreList(const QString&, uint64_t&);
+	void Submit(std::function<void()>);
+	void ParallelFor(const size_t, const std::function<void(size_t)>&);
+	void SetAffinity(const uint64_t);
+	void WaitForIdle();
+	int GetWorkerCount() const;
+	std::vector<WorkerStats> GetWorkerStats() const;
+	size_t GetQueuedTaskCount() const;
+	size_t GetRunningTaskCount() const;
+	QString GetLoadSummary();
+
+private:
+	struct Worker
+	{
+		std::deque<std::function<void()>> tasks;
+		std::mutex queueLock;
+		std::thread thread;
+		std::atomic<uint64_t> tasksRun{ 0 };
+		std::atomic<uint64_t> tasksStolen{ 0 };
+		std::atomic<uint64_t> busyNs{ 0 };
+		std::atomic<int> core{ -1 };
+		int affinityGeneration = 0;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::mutex sleepLock;
+	std::condition_variable taskAvailable;
+	std::condition_variable allIdle;
+	std::atomic<size_t> queuedTasks;
+	std::atomic<size_t> runningTasks;
+	std::atomic<size_t> nextQueue; //round robin for tasks submitted from outside the pool
+	std::atomic<uint64_t> affinityMask; //0 is no pinning
+	std::atomic<int> affinityGeneration;
+	bool stopping;
+	std::chrono::steady_clock::time_point startTime;
+	std::vector<uint64_t> lastBusyNs; //for GetLoadSummary, busy time at the previous call
+	std::chrono::steady_clock::time_point lastSummaryTime;
+
+	void WorkerLoop(const int);
+	bool TakeTask(const int, std::function<void()>&);
+	void ApplyAffinity(const int);
+};
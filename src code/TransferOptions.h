@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <QString>
+
+enum class TransferMode
+{
+	SingleFile, //one packet built from the file, sent packetCount times
+	Batch, //every file in a directory or manifest, over one TCP connection
+	Delta, //only the parts of one file that differ from the server's copy, over TCP
+	Dedup, //one file as content defined chunks, only chunks the server's store lacks cross the wire, over TCP
+	Measure, //like SingleFile over UDP, but every datagram carries a sequence number and send time for loss/jitter stats
+	PingPong //packetCount messages one at a time, each echoed back by the server before the next, for round trip times
+};
+
+//what a single file client sends: the packet read from its file, or one generated in memory
+enum class PayloadSource
+{
+	File,
+	Zeros, //every byte 0
+	Pattern, //0 to 250 over and over
+	Random //xorshift64* from payloadSeed, the same for the same seed
+};
+
+//what a single file server does with what it receives
+enum class PayloadSink
+{
+	File, //appended to the file, up to the first 0 of each packet, like always
+	Discard, //counted and dropped, no disk at all
+	Verify //compared against payloadSource/payloadSeed, only mismatches are counted
+};
+
+//settings picked on MainWindow that ride along with a send/receive signal,
+//copied through queued connections so each thread owns its own copy
+struct TransferOptions
+{
+	size_t targetRate = 0; //bytes per second, 0 means send as fast as the loop runs
+	size_t targetPacketRate = 0; //the pkt/s targetRate was worked out from, 0 when it was entered in KB/s
+	TransferMode mode = TransferMode::SingleFile;
+	size_t packFrameSize = 0; //batch only, small files are packed into frames up to this size, 0 = one header per file
+	size_t deltaBlockSize = 0; //delta only, 0 lets the server pick about sqrt(file size)
+	int shardCount = 1; //single file only, packets are spread over this many consecutive ports from the one picked
+	bool udpOffload = false; //UDP single file only, segmentation offload on sends and coalescing on receives
+	bool registeredIo = false; //UDP single file only, sends and receives go through Registered I/O queues
+	int fecRepair = 0; //UDP single file only, repair datagrams sent per FEC_BLOCK_DATA data datagrams, 0 turns FEC off
+	bool encrypted = false; //TCP single file only, unsharded, the stream is AES-GCM records after an ECDH handshake
+	QString encryptionKey; //encrypted only, passphrase both ends share, it authenticates the handshake
+	QString multicastGroup; //UDP single file receive only, the group the server joins, empty for unicast
+	PayloadSource payloadSource = PayloadSource::File; //single file only, on a server it's what Verify expects
+	PayloadSink payloadSink = PayloadSink::File; //single file receive only, unsharded
+	uint32_t payloadSeed = 1; //Random payloads only
+	bool elideZeros = false; //TCP single file only, unsharded and unencrypted, zero runs go as hole descriptors
+	bool busyPoll = false; //PingPong only, spin on the socket instead of waiting in select
+};
@@ -0,0 +1,612 @@
+#include "TransferSession.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: TransferSession.cpp - One send or receive, with its own socket, worker and stats
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void StartReceiving(TaskScheduler&, SOCKET, const size_t, const TransferOptions&, const std::vector<SOCKET>&);
+	void PrepareSending(const size_t, const size_t, const TransferOptions&);
+	void StartSending(TaskScheduler&, SOCKET, struct sockaddr_storage);
+	void Stop();
+	void MarkFailed();
+	SessionSnapshot TakeSnapshot();
+	void SampleLive();
+	const LiveSeries& GetLiveSeries() const;
+	void RecordReceived(const size_t, const size_t);
+	void MarkRunning();
+	void RecordResultDetails(const QString&);
+	void FinishTask();
+	void Launch(TaskScheduler&, std::function<void()>);
+	QString StateToString() const;
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- WSASocketManager used to own one Server and one Client on fixed threads, so only one transfer could
+-- exist at a time. Now every send/receive is a TransferSession: it lives on the main thread, makes its
+-- own Server or Client, and runs that worker's loop as a task on the shared TaskScheduler.
+-- The worker's signals come back queued from the scheduler thread, same as they did from the fixed threads.
+--
+-- Receive stats (packet size/count/time) are worked out per session the way UpdateTimer used to do
+-- for the one server. Send progress is read from the Client's byte counter when a snapshot is taken.
+----------------------------------------------------------------------------------------------------------------------*/
+
+TransferSession::TransferSession(const int sessionId, const bool isSending, const QString& protocolStr, const QString& path,
+	const TransferMode transferMode, QObject* parent)
+	: QObject(parent)
+	, id(sessionId)
+	, sending(isSending)
+	, protocol(protocolStr)
+	, filePath(path)
+	, mode(transferMode)
+	, state(isSending ? SessionState::Connecting : SessionState::Queued)
+	, socket(INVALID_SOCKET)
+	, sendPacketSize(0)
+	, sendPacketCount(0)
+	, server(nullptr)
+	, client(nullptr)
+	, resultPacketSize(0)
+	, resultPacketsReceived(0)
+	, bytes(0)
+	, sendErrors(0)
+	, sendRetransmits(0)
+	, sampleBytes(0)
+	, liveTotals()
+	, liveStarted(false)
+{
+	startTime = std::chrono::steady_clock::now();
+	endTime = startTime;
+	sampleTime = startTime;
+	connect(this, &TransferSession::TaskStarted, this, &TransferSession::MarkRunning);
+	connect(this, &TransferSession::TaskFinished, this, &TransferSession::FinishTask);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION TransferSession Destructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: ~TransferSession(void)
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+-- WSASocketManager waits for the scheduler before sessions are destroyed, so the worker isnt running anymore,
+-- its just the queued FinishTask that never got to clean up.
+----------------------------------------------------------------------------------------------------------------------*/
+TransferSession::~TransferSession()
+{
+	delete server;
+	delete client;
+	if (!sending && socket != INVALID_SOCKET)
+	{
+		closesocket(socket);
+	}
+	for (size_t shard = 1; shard < shardSockets.size(); ++shard)
+	{
+		closesocket(shardSockets[shard]);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StartReceiving
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void StartReceiving(TaskScheduler& scheduler, SOCKET serverSocket, const size_t expectedPacketSize,
+--	const TransferOptions& options, const std::vector<SOCKET>& shards)
+--			- scheduler : TaskScheduler, shared pool to run on
+--			- serverSocket : SOCKET, bound server socket, this session closes it when done
+--			- expectedPacketSize : unsigned int, TCP single file packet size
+--			- options : TransferOptions, receive side settings picked on MainWindow
+--			- shards : from OpenShardListeners, serverSocket first, for a sharded single file receive.
+--			           Empty otherwise. This session closes them when done
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Picks the Server receive loop for the protocol and mode, like ReceivePackets used to.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::StartReceiving(TaskScheduler& scheduler, SOCKET serverSocket, const size_t expectedPacketSize,
+	const TransferOptions& options, const std::vector<SOCKET>& shards)
+{
+	socket = serverSocket;
+	transferOptions = options;
+	shardSockets = shards;
+	server = new Server;
+	connect(server, &Server::PacketReceived, this, &TransferSession::RecordReceived);
+	connect(server, &Server::MeasureStatsReady, this, &TransferSession::RecordResultDetails);
+	connect(server, &Server::ShardStatsReady, this, &TransferSession::RecordResultDetails);
+	connect(server, &Server::FecStatsReady, this, &TransferSession::RecordResultDetails);
+	connect(server, &Server::MulticastStatsReady, this, &TransferSession::RecordResultDetails);
+	connect(server, &Server::SinkStatsReady, this, &TransferSession::RecordResultDetails);
+	connect(server, &Server::ServerPrintableStatusReady, this, &TransferSession::SessionStatusReady);
+	emit SessionResultsReady(0, 0, "0", protocol, ""); //clear results fields
+
+	server->UsePayloadSink(options);
+	Server* worker = server;
+	QString path = filePath;
+	if (shards.size() > 1)
+	{
+		size_t tcpPacketSize = (protocol == "TCP") ? expectedPacketSize : 0;
+		Launch(scheduler, [worker, shards, path, tcpPacketSize]() { worker->ReceiveSharded(shards, path, tcpPacketSize); });
+	}
+	else if (protocol == "UDP" && mode == TransferMode::Measure)
+		Launch(scheduler, [worker, serverSocket, path]() { worker->ReceiveUdpMeasure(serverSocket, path); });
+	else if (mode == TransferMode::PingPong)
+	{
+		bool busyPoll = options.busyPoll;
+		if (protocol == "UDP")
+			Launch(scheduler, [worker, serverSocket, busyPoll]() { worker->EchoUdpPackets(serverSocket, busyPoll); });
+		else
+			Launch(scheduler, [worker, serverSocket, expectedPacketSize, busyPoll]() { worker->EchoTcpPackets(serverSocket, expectedPacketSize, busyPoll); });
+	}
+	else if (protocol == "UDP" && !options.multicastGroup.isEmpty())
+		Launch(scheduler, [worker, serverSocket, path]() { worker->ReceiveUdpMulticast(serverSocket, path); });
+	else if (protocol == "UDP" && options.fecRepair > 0)
+		Launch(scheduler, [worker, serverSocket, path]() { worker->ReceiveUdpFec(serverSocket, path); });
+	else if (protocol == "UDP" && options.registeredIo)
+	{
+		socket = INVALID_SOCKET; //ReceiveUdpRio closes it, before its registered buffer goes
+		Launch(scheduler, [worker, serverSocket, path]() { worker->ReceiveUdpRio(serverSocket, path); });
+	}
+	else if (protocol == "UDP")
+	{
+		bool coalesce = options.udpOffload;
+		Launch(scheduler, [worker, serverSocket, path, coalesce]() { worker->ReceiveUdpPackets(serverSocket, path, coalesce); });
+	}
+	else if (mode == TransferMode::Batch)
+		Launch(scheduler, [worker, serverSocket, path]() { worker->ReceiveTcpBatch(serverSocket, path); });
+	else if (mode == TransferMode::Delta)
+		Launch(scheduler, [worker, serverSocket, path]() { worker->ReceiveTcpDelta(serverSocket, path); });
+	else if (mode == TransferMode::Dedup)
+		Launch(scheduler, [worker, serverSocket, path]() { worker->ReceiveTcpDedup(serverSocket, path); });
+	else
+	{
+		bool encrypted = options.encrypted;
+		bool elideZeros = options.elideZeros;
+		Launch(scheduler, [worker, serverSocket, path, expectedPacketSize, encrypted, elideZeros]() { worker->ReceiveTcpPackets(serverSocket, path, expectedPacketSize, encrypted, elideZeros); });
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PrepareSending
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void PrepareSending(const size_t packetSize, const size_t packetCount, const TransferOptions& options)
+--			- packetSize : unsigned int, single file packet size
+--			- packetCount : unsigned int, single file packet count
+--			- options : TransferOptions, pacing and mode settings
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Kept until HostConnector has a socket for this session, replaces WSASocketManager's pending* members.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::PrepareSending(const size_t packetSize, const size_t packetCount, const TransferOptions& options)
+{
+	sendPacketSize = packetSize;
+	sendPacketCount = packetCount;
+	transferOptions = options;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StartSending
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void StartSending(TaskScheduler& scheduler, SOCKET connectedSocket, struct sockaddr_storage serverAddress)
+--			- scheduler : TaskScheduler, shared pool to run on
+--			- connectedSocket : SOCKET, from HostConnector, connected if TCP. The Client closes it
+--			- serverAddress : struct sockaddr_storage, IPv4 or IPv6 address of server
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Picks the Client send loop for the protocol and mode, like SendToConnectedHost used to.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::StartSending(TaskScheduler& scheduler, SOCKET connectedSocket, struct sockaddr_storage serverAddress)
+{
+	if (state != SessionState::Connecting)
+	{
+		//stopped while connecting
+		closesocket(connectedSocket);
+		return;
+	}
+	socket = connectedSocket;
+	state = SessionState::Queued;
+	client = new Client;
+	connect(client, &Client::ClientPrintableStatusReady, this, &TransferSession::SessionStatusReady);
+	connect(client, &Client::ClientAlertableErrorOccured, this, &TransferSession::SessionAlertOccured);
+	connect(client, &Client::PingStatsReady, this, &TransferSession::RecordResultDetails);
+
+	Client* worker = client;
+	QString path = filePath;
+	size_t packetSize = sendPacketSize;
+	size_t packetCount = sendPacketCount;
+	TransferOptions options = transferOptions;
+	bool tcp = (protocol == "TCP");
+	if (mode == TransferMode::PingPong)
+		Launch(scheduler, [=]() { worker->SendPingPong(connectedSocket, tcp, path, packetSize, packetCount, serverAddress, options); });
+	else if (protocol == "UDP")
+		Launch(scheduler, [=]() { worker->SendUdpPackets(connectedSocket, path, packetSize, packetCount, serverAddress, options); });
+	else if (mode == TransferMode::Batch)
+		Launch(scheduler, [=]() { worker->SendTcpBatch(connectedSocket, path, options); });
+	else if (mode == TransferMode::Delta)
+		Launch(scheduler, [=]() { worker->SendTcpDelta(connectedSocket, path, options); });
+	else if (mode == TransferMode::Dedup)
+		Launch(scheduler, [=]() { worker->SendTcpDedup(connectedSocket, path, options); });
+	else
+		Launch(scheduler, [=]() { worker->SendTcpPackets(connectedSocket, path, packetSize, packetCount, options); });
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Stop
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Stop(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Asks the worker to stop, it finishes on its own thread and FinishTask cleans up after.
+-- A worker still queued in the scheduler sees the flag as soon as it starts and returns right away.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::Stop()
+{
+	if (IsDone())
+		return;
+	if (state == SessionState::Connecting)
+	{
+		state = SessionState::Stopped;
+		return;
+	}
+	state = SessionState::Stopped;
+	if (server != nullptr)
+		server->StopPolling();
+	if (client != nullptr)
+		client->Cancel();
+}
+
+//HostConnector couldnt connect this session's send
+void TransferSession::MarkFailed()
+{
+	state = SessionState::Failed;
+}
+
+int TransferSession::GetId() const
+{
+	return id;
+}
+
+bool TransferSession::IsSending() const
+{
+	return sending;
+}
+
+//stopped sessions count as done once their worker let go of the scheduler thread
+bool TransferSession::IsDone() const
+{
+	return state == SessionState::Finished || state == SessionState::Failed
+		|| (state == SessionState::Stopped && server == nullptr && client == nullptr);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION TakeSnapshot
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: SessionSnapshot TakeSnapshot(void)
+--
+-- RETURNS: SessionSnapshot : what the session list shows for this session right now
+--
+-- NOTES:
+-- Throughput is bytes since the last snapshot over the time since the last snapshot, so its
+-- live rather than an average over the whole session.
+----------------------------------------------------------------------------------------------------------------------*/
+SessionSnapshot TransferSession::TakeSnapshot()
+{
+	auto now = std::chrono::steady_clock::now();
+	if (client != nullptr)
+	{
+		bytes = client->GetBytesSent();
+		resultPacketsReceived = client->GetPacketsSent();
+		sendErrors = client->GetSendErrors();
+		sendRetransmits = client->GetRetransmits();
+	}
+	double sampleSeconds = std::chrono::duration<double>(now - sampleTime).count();
+
+	SessionSnapshot snapshot;
+	snapshot.id = id;
+	snapshot.description = QString("%1 %2 %3").arg(sending ? "send" : "recv").arg(protocol)
+		.arg((mode == TransferMode::Batch) ? "batch" : (mode == TransferMode::Delta) ? "delta"
+			: (mode == TransferMode::Dedup) ? "dedup" : (mode == TransferMode::Measure) ? "measure"
+			: (mode == TransferMode::PingPong) ? "ping-pong" : "file");
+	int shardCount = sending ? transferOptions.shardCount : (int)shardSockets.size();
+	if (shardCount > 1)
+		snapshot.description += QString(" x%1").arg(shardCount);
+	snapshot.state = StateToString();
+	snapshot.bytes = bytes;
+	snapshot.count = (resultPacketsReceived == (size_t)-1) ? 0 : resultPacketsReceived;
+	snapshot.errors = sendErrors;
+	snapshot.retransmits = sendRetransmits;
+	snapshot.bytesPerSec = (sampleSeconds > 0 && !IsDone()) ? (bytes - sampleBytes) / sampleSeconds : 0;
+	auto lastActive = IsDone() ? endTime : now;
+	snapshot.elapsedMs = (state == SessionState::Connecting || state == SessionState::Queued) ? 0
+		: std::chrono::duration_cast<std::chrono::milliseconds>(lastActive - startTime).count();
+	sampleBytes = bytes;
+	sampleTime = now;
+	return snapshot;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SampleLive
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SampleLive(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called every LIVE_SAMPLE_MS by WSASocketManager, and once more by FinishTask. Reads the worker's
+-- counters and adds the rates since the last call to liveSeries. Nothing is signaled per packet,
+-- the worker only bumps its atomics. The first call just takes the starting counts.
+--
+-- Totals can go down between samples (the Client takes back a hello packet, a reordered datagram
+-- fills a Measure gap), a rate never shows below 0 for it.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::SampleLive()
+{
+	if (state == SessionState::Connecting || state == SessionState::Queued || (server == nullptr && client == nullptr))
+		return;
+	LiveTotals totals = {};
+	if (client != nullptr)
+		client->ReadLiveTotals(totals);
+	else
+		server->ReadLiveTotals(totals);
+	auto now = std::chrono::steady_clock::now();
+	if (!liveStarted)
+	{
+		liveStarted = true;
+		liveOrigin = now;
+		liveTime = now;
+		liveTotals = totals;
+		return;
+	}
+	double seconds = std::chrono::duration<double>(now - liveTime).count();
+	if (seconds <= 0)
+		return;
+	auto rise = [](const uint64_t after, const uint64_t before) { return (after > before) ? (double)(after - before) : 0.0; };
+	double checked = rise(totals.lossChecked, liveTotals.lossChecked);
+	double roundTrips = rise(totals.rttCount, liveTotals.rttCount);
+
+	LiveSample sample;
+	sample.seconds = std::chrono::duration<double>(now - liveOrigin).count();
+	sample.bytesPerSec = rise(totals.bytes, liveTotals.bytes) / seconds;
+	sample.packetsPerSec = rise(totals.packets, liveTotals.packets) / seconds;
+	sample.lossPercent = (checked > 0) ? std::min(100.0, 100.0 * rise(totals.lost, liveTotals.lost) / checked) : LIVE_NO_VALUE;
+	sample.rttUs = (roundTrips > 0) ? rise(totals.rttTotalNs, liveTotals.rttTotalNs) / roundTrips / 1000.0 : LIVE_NO_VALUE;
+	liveSeries.Add(sample);
+	liveTotals = totals;
+	liveTime = now;
+}
+
+const LiveSeries& TransferSession::GetLiveSeries() const
+{
+	return liveSeries;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RecordReceived
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void RecordReceived(const size_t updatedPacketSize, const size_t updatedPacketsReceived)
+--			- updatedPacketSize : unsigned int, size of packet just received
+--			- updatedPacketsReceived : unsigned int, total number of packets received so far during connection
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Signaled by this session's Server. Same timing as the old WSASocketManager::UpdateTimer: the first
+-- packet (or the tcp accept marker) starts the clock, every packet after moves the end of it.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::RecordReceived(const size_t updatedPacketSize, const size_t updatedPacketsReceived)
+{
+	if (resultPacketsReceived == 0)
+	{
+		startTime = std::chrono::steady_clock::now();
+		endTime = startTime;
+	}
+	//already got some packets
+	else
+	{
+		endTime = std::chrono::steady_clock::now();
+	}
+	resultPacketSize = updatedPacketSize;
+	resultPacketsReceived = updatedPacketsReceived;
+	if (updatedPacketSize == (size_t)-1 && updatedPacketsReceived == (size_t)-1) //tcp start timer calls this with -1, an otherwise impossible number
+		return;
+	bytes += updatedPacketSize;
+	long long deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+	emit SessionResultsReady(resultPacketSize, resultPacketsReceived, QString::number(deltaTime), protocol, resultDetails);
+	emit SessionStatusReady("-received packet(s)");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION RecordResultDetails
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void RecordResultDetails(const QString& summary)
+--			- summary : loss/duplicate/reorder/jitter line from Server::ReceiveUdpMeasure,
+--			            received/repaired/lost line from Server::ReceiveUdpFec or ReceiveUdpMulticast,
+--			            aggregate and per shard rates from Server::ReceiveSharded,
+--			            what a discard/verify sink took,
+--			            or the RTT histogram from Client::SendPingPong
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Kept so every results update after this carries it along with the packet size/count/time.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::RecordResultDetails(const QString& summary)
+{
+	resultDetails = summary;
+	long long deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+	emit SessionResultsReady(resultPacketSize, resultPacketsReceived, QString::number(deltaTime), protocol, resultDetails);
+}
+
+void TransferSession::MarkRunning()
+{
+	if (state == SessionState::Queued)
+	{
+		state = SessionState::Running;
+		startTime = std::chrono::steady_clock::now();
+		endTime = startTime;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION FinishTask
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void FinishTask(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Signaled (queued) once the worker's loop returned on its scheduler thread. Takes the final counts,
+-- prints the receive results one last time and drops the worker. Receive sessions close their
+-- server socket here, the Client already closed its own.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::FinishTask()
+{
+	SampleLive();
+	if (client != nullptr)
+	{
+		bytes = client->GetBytesSent();
+		resultPacketsReceived = client->GetPacketsSent();
+		sendErrors = client->GetSendErrors();
+		sendRetransmits = client->GetRetransmits();
+		endTime = std::chrono::steady_clock::now();
+		client->deleteLater();
+		client = nullptr;
+	}
+	if (server != nullptr)
+	{
+		long long deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+		emit SessionStatusReady("-Receive finished");
+		emit SessionResultsReady(resultPacketSize, resultPacketsReceived, QString::number(deltaTime), protocol, resultDetails);
+		server->deleteLater();
+		server = nullptr;
+		closesocket(socket);
+		socket = INVALID_SOCKET;
+		for (size_t shard = 1; shard < shardSockets.size(); ++shard)
+		{
+			closesocket(shardSockets[shard]);
+		}
+		shardSockets.clear();
+	}
+	if (state != SessionState::Stopped)
+	{
+		state = SessionState::Finished;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Launch
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Launch(TaskScheduler& scheduler, std::function<void()> workerLoop)
+--			- scheduler : TaskScheduler, shared pool to run on
+--			- workerLoop : the Server/Client call to make on a scheduler thread
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- TaskStarted/TaskFinished are emitted from the scheduler thread and land queued on this session.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferSession::Launch(TaskScheduler& scheduler, std::function<void()> workerLoop)
+{
+	state = SessionState::Queued;
+	scheduler.Submit([this, workerLoop]() {
+		emit TaskStarted();
+		workerLoop();
+		emit TaskFinished();
+	});
+}
+
+QString TransferSession::StateToString() const
+{
+	switch (state)
+	{
+	case SessionState::Connecting:
+		return "connecting";
+	case SessionState::Queued:
+		return "queued";
+	case SessionState::Running:
+		return "running";
+	case SessionState::Finished:
+		return "done";
+	case SessionState::Failed:
+		return "failed";
+	default:
+		return IsDone() ? "stopped" : "stopping";
+	}
+}
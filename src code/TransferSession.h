@@ -0,0 +1,106 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <QObject>
+#include <QString>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "Server.h"
+#include "Client.h"
+#include "TransferOptions.h"
+#include "TaskScheduler.h"
+#include "LiveSeries.h"
+
+#define SESSION_KEEP_FINISHED 20 //finished sessions left in the list before the oldest go
+
+enum class SessionState
+{
+	Connecting, //send waiting on HostConnector
+	Queued, //handed to the scheduler, no free worker yet
+	Running,
+	Finished,
+	Failed,
+	Stopped
+};
+
+//one row of the GUI's session list
+struct SessionSnapshot
+{
+	int id;
+	QString description;
+	QString state;
+	size_t bytes;
+	size_t count;
+	size_t errors; //sends given up on, 0 for receives
+	size_t retransmits; //TCP single file sends tried again, 0 for receives
+	double bytesPerSec;
+	long long elapsedMs;
+};
+
+class TransferSession : public QObject
+{
+	Q_OBJECT
+
+public:
+	TransferSession(const int, const bool, const QString&, const QString&, const TransferMode, QObject*);
+	virtual ~TransferSession();
+	void StartReceiving(TaskScheduler&, SOCKET, const size_t, const TransferOptions&, const std::vector<SOCKET>& = std::vector<SOCKET>());
+	void PrepareSending(const size_t, const size_t, const TransferOptions&);
+	void StartSending(TaskScheduler&, SOCKET, struct sockaddr_storage);
+	void Stop();
+	void MarkFailed();
+	int GetId() const;
+	bool IsSending() const;
+	bool IsDone() const;
+	SessionSnapshot TakeSnapshot();
+	void SampleLive();
+	const LiveSeries& GetLiveSeries() const;
+	//slot functions, dont call directly
+	void RecordReceived(const size_t, const size_t);
+	void MarkRunning();
+	void RecordResultDetails(const QString&);
+	void FinishTask();
+
+signals:
+	void SessionStatusReady(const QString&);
+	void SessionAlertOccured(const QString&);
+	void SessionResultsReady(const size_t, const size_t, const QString&, const QString&, const QString&);
+	void TaskStarted();
+	void TaskFinished();
+
+private:
+	int id;
+	bool sending;
+	QString protocol;
+	QString filePath;
+	TransferMode mode;
+	SessionState state;
+	SOCKET socket; //listening socket for receive sessions, client closes its own
+	std::vector<SOCKET> shardSockets; //sharded receive only, socket is the first of these
+	size_t sendPacketSize; //send settings, held while HostConnector connects
+	size_t sendPacketCount;
+	TransferOptions transferOptions; //send settings held while HostConnector connects, or the receive settings
+	Server* server;
+	Client* client;
+	size_t resultPacketSize;
+	size_t resultPacketsReceived;
+	QString resultDetails; //Measure mode loss/jitter line or sharded rates, empty otherwise
+	size_t bytes;
+	size_t sendErrors; //from the Client, kept once it goes
+	size_t sendRetransmits;
+	size_t sampleBytes; //bytes at the last snapshot, for live throughput
+	std::chrono::steady_clock::time_point sampleTime;
+	std::chrono::steady_clock::time_point startTime;
+	std::chrono::steady_clock::time_point endTime;
+	LiveSeries liveSeries; //the chart's history of this session
+	LiveTotals liveTotals; //the worker's counters at the last SampleLive
+	std::chrono::steady_clock::time_point liveTime; //when that was
+	std::chrono::steady_clock::time_point liveOrigin; //first SampleLive, second 0 of the chart
+	bool liveStarted;
+
+	void Launch(TaskScheduler&, std::function<void()>);
+	QString StateToString() const;
+};
@@ -0,0 +1,631 @@
+#include "UdpFec.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: UdpFec.cpp - Reed-Solomon style forward error correction for UDP single file transfers
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	void WriteFecHeader(char*, const uint32_t, const int, const int, const int);
+	bool ReadFecHeader(const char*, const size_t, uint32_t&, int&, int&, int&);
+	bool Open(SessionArena&, const size_t, const int);
+	void Add(const char*, const size_t, const int);
+	char* RepairDatagram(const int) const;
+	void Reset();
+	bool Open(SessionArena&);
+	void Add(const char*, const size_t, const std::function<void(const char*, const size_t)>&);
+	void Finish(const std::function<void(const char*, const size_t)>&);
+	uint64_t GetRecovered() const;
+	uint64_t GetLost() const;
+	QString Summary() const;
+	void StartBlock(const uint32_t, const int, const int);
+	void CloseBlock(const std::function<void(const char*, const size_t)>&);
+	bool Recover(const int);
+	char* Slot(const int) const;
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- UDP has no retransmits here, a lost datagram is just gone. With FEC on, the client sends its
+-- datagrams in blocks of up to FEC_BLOCK_DATA, each with an FEC header, and after every block a
+-- few repair datagrams. Repair j is the sum over the block's data i of C(j, i) * data i, in GF(2^8),
+-- where C is a Cauchy matrix: C(j, i) = 1 / ((128 + j) xor i). Any square piece of a Cauchy matrix
+-- can be inverted, so any e repair datagrams rebuild any e missing data datagrams of their block,
+-- same as a Reed-Solomon erasure code.
+--
+-- All the time goes into "add c times this buffer to that one" over whole datagrams. That's done
+-- 32 bytes at a time with AVX2 or 16 with SSSE3, when the CPU has them: a product c * x splits into
+-- c * (low 4 bits of x) xor c * (high 4 bits of x), and PSHUFB looks both up in 16 entry tables
+-- made for c. The scalar loop uses the same tables.
+--
+-- The receiver holds one block at a time. Data is handed on in order once the block has all of
+-- it, or enough to rebuild the rest, or the next block starts; a datagram for a block already
+-- done is counted late and dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+
+//log/antilog tables of GF(2^8) over x^8 + x^4 + x^3 + x^2 + 1 (0x11D)
+struct GaloisTables
+{
+	uint8_t exp[512];
+	uint8_t log[256];
+
+	GaloisTables()
+	{
+		int x = 1;
+		for (int i = 0; i < 255; ++i)
+		{
+			exp[i] = (uint8_t)x;
+			log[x] = (uint8_t)i;
+			x <<= 1;
+			if (x & 0x100)
+				x ^= 0x11D;
+		}
+		for (int i = 255; i < 512; ++i)
+			exp[i] = exp[i - 255];
+		log[0] = 0;
+	}
+};
+
+static const GaloisTables galois;
+
+static uint8_t GaloisMultiply(const uint8_t a, const uint8_t b)
+{
+	return (a == 0 || b == 0) ? 0 : galois.exp[galois.log[a] + galois.log[b]];
+}
+
+static uint8_t GaloisInverse(const uint8_t a)
+{
+	return galois.exp[255 - galois.log[a]];
+}
+
+static uint8_t CauchyCoefficient(const int repair, const int data)
+{
+	return GaloisInverse((uint8_t)((128 + repair) ^ data));
+}
+
+//2 for AVX2, 1 for SSSE3, 0 for neither
+static int DetectSimdLevel()
+{
+	int registers[4] = { 0 };
+	__cpuid(registers, 0);
+	int maxLeaf = registers[0];
+	__cpuid(registers, 1);
+	bool ssse3 = (registers[2] & (1 << 9)) != 0;
+	bool avxSaved = (registers[2] & (1 << 27)) && (registers[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+	bool avx2 = false;
+	if (avxSaved && maxLeaf >= 7)
+	{
+		__cpuidex(registers, 7, 0);
+		avx2 = (registers[1] & (1 << 5)) != 0;
+	}
+	return avx2 ? 2 : (ssse3 ? 1 : 0);
+}
+
+static const int simdLevel = DetectSimdLevel();
+
+//destination ^= factor * source, over length bytes
+static void GaloisMultiplyAdd(char* destination, const char* source, const uint8_t factor, const size_t length)
+{
+	if (factor == 0)
+		return;
+	alignas(16) uint8_t lowTable[16];
+	alignas(16) uint8_t highTable[16];
+	for (int x = 0; x < 16; ++x)
+	{
+		lowTable[x] = GaloisMultiply(factor, (uint8_t)x);
+		highTable[x] = GaloisMultiply(factor, (uint8_t)(x << 4));
+	}
+
+	size_t i = 0;
+	if (simdLevel >= 2)
+	{
+		__m256i low = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)lowTable));
+		__m256i high = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)highTable));
+		__m256i nibble = _mm256_set1_epi8(0x0F);
+		for (; i + 32 <= length; i += 32)
+		{
+			__m256i in = _mm256_loadu_si256((const __m256i*)(source + i));
+			__m256i product = _mm256_xor_si256(
+				_mm256_shuffle_epi8(low, _mm256_and_si256(in, nibble)),
+				_mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi64(in, 4), nibble)));
+			__m256i out = _mm256_loadu_si256((const __m256i*)(destination + i));
+			_mm256_storeu_si256((__m256i*)(destination + i), _mm256_xor_si256(out, product));
+		}
+	}
+	if (simdLevel >= 1)
+	{
+		__m128i low = _mm_load_si128((const __m128i*)lowTable);
+		__m128i high = _mm_load_si128((const __m128i*)highTable);
+		__m128i nibble = _mm_set1_epi8(0x0F);
+		for (; i + 16 <= length; i += 16)
+		{
+			__m128i in = _mm_loadu_si128((const __m128i*)(source + i));
+			__m128i product = _mm_xor_si128(
+				_mm_shuffle_epi8(low, _mm_and_si128(in, nibble)),
+				_mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi64(in, 4), nibble)));
+			__m128i out = _mm_loadu_si128((const __m128i*)(destination + i));
+			_mm_storeu_si128((__m128i*)(destination + i), _mm_xor_si128(out, product));
+		}
+	}
+	for (; i < length; ++i)
+	{
+		uint8_t in = (uint8_t)source[i];
+		destination[i] ^= (char)(lowTable[in & 0x0F] ^ highTable[in >> 4]);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteFecHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void WriteFecHeader(char* datagram, const uint32_t block, const int index, const int dataCount,
+	const int repairCount)
+		- datagram : first FEC_HEADER_SIZE bytes are written
+		- block : block number, counting up from 0
+		- index : datagram in the block, data first then repairs
+		- dataCount : data datagrams in the block
+		- repairCount : repair datagrams after them
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void WriteFecHeader(char* datagram, const uint32_t block, const int index, const int dataCount, const int repairCount)
+{
+	WriteLittleEndian(datagram, FEC_MAGIC, 4);
+	WriteLittleEndian(datagram + 4, block, 4);
+	datagram[8] = (char)index;
+	datagram[9] = (char)dataCount;
+	datagram[10] = (char)repairCount;
+	datagram[11] = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadFecHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReadFecHeader(const char* datagram, const size_t length, uint32_t& block, int& index,
+	int& dataCount, int& repairCount)
+		- datagram : as received
+		- length : its size
+		- block, index, dataCount, repairCount : filled in, see WriteFecHeader
+
+-- RETURNS: bool : false if it has no FEC header or the counts are out of range
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReadFecHeader(const char* datagram, const size_t length, uint32_t& block, int& index, int& dataCount, int& repairCount)
+{
+	if (length < FEC_HEADER_SIZE || ReadLittleEndian(datagram, 4) != FEC_MAGIC)
+		return false;
+	block = (uint32_t)ReadLittleEndian(datagram + 4, 4);
+	index = (uint8_t)datagram[8];
+	dataCount = (uint8_t)datagram[9];
+	repairCount = (uint8_t)datagram[10];
+	return dataCount >= 1 && dataCount <= FEC_BLOCK_DATA && repairCount <= FEC_MAX_REPAIR && index < dataCount + repairCount
+		&& length - FEC_HEADER_SIZE <= FEC_MAX_PAYLOAD;
+}
+
+UdpFecEncoder::UdpFecEncoder()
+	: repairs(nullptr)
+	, payloadSize(0)
+	, repairCount(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(SessionArena& arena, const size_t size, const int count)
+		- arena : SessionArena, where the repair datagrams are kept
+		- size : payload size of every data datagram, up to FEC_MAX_PAYLOAD
+		- count : repair datagrams per block, 1 to FEC_MAX_REPAIR
+
+-- RETURNS: bool : false if there wasnt memory for them
+----------------------------------------------------------------------------------------------------------------------*/
+bool UdpFecEncoder::Open(SessionArena& arena, const size_t size, const int count)
+{
+	payloadSize = size;
+	repairCount = count;
+	repairs = arena.Allocate(repairCount * (FEC_HEADER_SIZE + payloadSize));
+	if (repairs == nullptr)
+		return false;
+	Reset();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Add
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Add(const char* payload, const size_t length, const int index)
+		- payload : a data datagram's payload, after its header
+		- length : its size, shorter payloads count as zero padded
+		- index : where it is in the block
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void UdpFecEncoder::Add(const char* payload, const size_t length, const int index)
+{
+	for (int repair = 0; repair < repairCount; ++repair)
+	{
+		GaloisMultiplyAdd(RepairDatagram(repair) + FEC_HEADER_SIZE, payload, CauchyCoefficient(repair, index),
+			std::min(length, payloadSize));
+	}
+}
+
+char* UdpFecEncoder::RepairDatagram(const int repair) const
+{
+	return repairs + repair * (FEC_HEADER_SIZE + payloadSize);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Reset
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Reset(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called once a block's repair datagrams are sent, so the next block starts from zero.
+----------------------------------------------------------------------------------------------------------------------*/
+void UdpFecEncoder::Reset()
+{
+	memset(repairs, 0, repairCount * (FEC_HEADER_SIZE + payloadSize));
+}
+
+UdpFecDecoder::UdpFecDecoder()
+	: blockBuffer(nullptr)
+	, block(0)
+	, inBlock(false)
+	, delivered(false)
+	, dataCount(0)
+	, repairCount(0)
+	, blocks(0)
+	, recovered(0)
+	, lost(0)
+	, late(0)
+	, foreign(0)
+{
+	memset(lengths, 0, sizeof(lengths));
+	memset(present, 0, sizeof(present));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(SessionArena& arena)
+		- arena : SessionArena, where the block being put together is kept
+
+-- RETURNS: bool : false if there wasnt memory for it
+----------------------------------------------------------------------------------------------------------------------*/
+bool UdpFecDecoder::Open(SessionArena& arena)
+{
+	blockBuffer = arena.Allocate((FEC_BLOCK_DATA + FEC_MAX_REPAIR) * FEC_MAX_PAYLOAD);
+	return blockBuffer != nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Add
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Add(const char* datagram, const size_t length,
+	const std::function<void(const char*, const size_t)>& deliver)
+		- datagram : as received, FEC header first
+		- length : its size
+		- deliver : called with each data payload, in order, when its block is done
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- A block is closed as soon as it has as many datagrams as it has data, rebuilding any missing
+-- data then, so a block with nothing lost goes on without waiting for its repairs.
+----------------------------------------------------------------------------------------------------------------------*/
+void UdpFecDecoder::Add(const char* datagram, const size_t length, const std::function<void(const char*, const size_t)>& deliver)
+{
+	uint32_t datagramBlock;
+	int index, data, repair;
+	if (!ReadFecHeader(datagram, length, datagramBlock, index, data, repair))
+	{
+		++foreign;
+		return;
+	}
+	if (inBlock && datagramBlock != block)
+	{
+		if ((int32_t)(datagramBlock - block) < 0)
+		{
+			++late;
+			return;
+		}
+		CloseBlock(deliver);
+		inBlock = false;
+	}
+	if (!inBlock)
+		StartBlock(datagramBlock, data, repair);
+	if (delivered)
+		return;
+	if (data != dataCount || repair != repairCount)
+	{
+		++foreign;
+		return;
+	}
+
+	int slot = (index < dataCount) ? index : FEC_BLOCK_DATA + (index - dataCount);
+	if (present[slot])
+		return; //duplicate
+	lengths[slot] = length - FEC_HEADER_SIZE;
+	memcpy(Slot(slot), datagram + FEC_HEADER_SIZE, lengths[slot]);
+	present[slot] = true;
+
+	int received = 0;
+	for (int i = 0; i < FEC_BLOCK_DATA + FEC_MAX_REPAIR; ++i)
+		received += present[i] ? 1 : 0;
+	if (received >= dataCount)
+		CloseBlock(deliver);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Finish
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Finish(const std::function<void(const char*, const size_t)>& deliver)
+		- deliver : as for Add
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- For when the datagrams stop: the block being held is closed with whatever it has.
+----------------------------------------------------------------------------------------------------------------------*/
+void UdpFecDecoder::Finish(const std::function<void(const char*, const size_t)>& deliver)
+{
+	if (inBlock)
+		CloseBlock(deliver);
+}
+
+uint64_t UdpFecDecoder::GetRecovered() const
+{
+	return recovered;
+}
+
+uint64_t UdpFecDecoder::GetLost() const
+{
+	return lost;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Summary
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString Summary(void) const
+--
+-- RETURNS: QString : one line of recovered vs lost counts, for the console and the session list
+----------------------------------------------------------------------------------------------------------------------*/
+QString UdpFecDecoder::Summary() const
+{
+	QString summary = QString("FEC: %1 blocks, %2 datagrams rebuilt, %3 lost for good")
+		.arg(blocks).arg(recovered).arg(lost);
+	if (late > 0)
+		summary += QString(", %1 late").arg(late);
+	if (foreign > 0)
+		summary += QString(", %1 without an FEC header").arg(foreign);
+	return summary;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StartBlock
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void StartBlock(const uint32_t number, const int data, const int repair)
+		- number : the block's number
+		- data : its data datagrams
+		- repair : its repair datagrams
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void UdpFecDecoder::StartBlock(const uint32_t number, const int data, const int repair)
+{
+	block = number;
+	dataCount = data;
+	repairCount = repair;
+	inBlock = true;
+	delivered = false;
+	memset(present, 0, sizeof(present));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION CloseBlock
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void CloseBlock(const std::function<void(const char*, const size_t)>& deliver)
+		- deliver : as for Add
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Missing data is rebuilt if enough repairs came, otherwise it's counted lost and the rest of the
+-- block is handed on without it.
+----------------------------------------------------------------------------------------------------------------------*/
+void UdpFecDecoder::CloseBlock(const std::function<void(const char*, const size_t)>& deliver)
+{
+	if (delivered)
+		return;
+	int missing = 0;
+	int repairsReceived = 0;
+	for (int i = 0; i < dataCount; ++i)
+		missing += present[i] ? 0 : 1;
+	for (int i = 0; i < repairCount; ++i)
+		repairsReceived += present[FEC_BLOCK_DATA + i] ? 1 : 0;
+	if (missing > 0)
+	{
+		if (repairsReceived >= missing && Recover(missing))
+			recovered += missing;
+		else
+			lost += missing;
+	}
+	for (int i = 0; i < dataCount; ++i)
+	{
+		if (present[i])
+			deliver(Slot(i), lengths[i]);
+	}
+	delivered = true;
+	++blocks;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Recover
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Recover(const int missing)
+		- missing : data datagrams to rebuild, no more than the repairs received
+
+-- RETURNS: bool : whether they were rebuilt, their slots are filled and marked present
+--
+-- NOTES:
+-- The data that did arrive is taken back out of the first missing repairs, leaving
+-- A * lost data = what's left, where A is the Cauchy matrix cut down to those repairs and the
+-- lost columns. A is inverted with Gauss-Jordan (at most 20x20), then each lost datagram is
+-- its row of the inverse times the leftovers.
+----------------------------------------------------------------------------------------------------------------------*/
+bool UdpFecDecoder::Recover(const int missing)
+{
+	int lostIndex[FEC_BLOCK_DATA];
+	int repairIndex[FEC_BLOCK_DATA];
+	int found = 0;
+	for (int i = 0; i < dataCount; ++i)
+	{
+		if (!present[i])
+			lostIndex[found++] = i;
+	}
+	found = 0;
+	for (int i = 0; i < repairCount && found < missing; ++i)
+	{
+		if (present[FEC_BLOCK_DATA + i])
+			repairIndex[found++] = i;
+	}
+	size_t length = lengths[FEC_BLOCK_DATA + repairIndex[0]];
+
+	for (int row = 0; row < missing; ++row)
+	{
+		char* leftover = Slot(FEC_BLOCK_DATA + repairIndex[row]);
+		for (int i = 0; i < dataCount; ++i)
+		{
+			if (present[i])
+				GaloisMultiplyAdd(leftover, Slot(i), CauchyCoefficient(repairIndex[row], i), std::min(lengths[i], length));
+		}
+	}
+
+	uint8_t matrix[FEC_BLOCK_DATA][2 * FEC_BLOCK_DATA];
+	for (int row = 0; row < missing; ++row)
+	{
+		for (int column = 0; column < missing; ++column)
+		{
+			matrix[row][column] = CauchyCoefficient(repairIndex[row], lostIndex[column]);
+			matrix[row][missing + column] = (row == column) ? 1 : 0;
+		}
+	}
+	for (int column = 0; column < missing; ++column)
+	{
+		int pivot = column;
+		while (pivot < missing && matrix[pivot][column] == 0)
+			++pivot;
+		if (pivot == missing)
+			return false;
+		if (pivot != column)
+		{
+			for (int k = 0; k < 2 * missing; ++k)
+				std::swap(matrix[pivot][k], matrix[column][k]);
+		}
+		uint8_t scale = GaloisInverse(matrix[column][column]);
+		for (int k = 0; k < 2 * missing; ++k)
+			matrix[column][k] = GaloisMultiply(matrix[column][k], scale);
+		for (int row = 0; row < missing; ++row)
+		{
+			uint8_t factor = matrix[row][column];
+			if (row == column || factor == 0)
+				continue;
+			for (int k = 0; k < 2 * missing; ++k)
+				matrix[row][k] ^= GaloisMultiply(factor, matrix[column][k]);
+		}
+	}
+
+	for (int lostRow = 0; lostRow < missing; ++lostRow)
+	{
+		char* rebuilt = Slot(lostIndex[lostRow]);
+		memset(rebuilt, 0, length);
+		for (int row = 0; row < missing; ++row)
+		{
+			GaloisMultiplyAdd(rebuilt, Slot(FEC_BLOCK_DATA + repairIndex[row]), matrix[lostRow][missing + row], length);
+		}
+		lengths[lostIndex[lostRow]] = length;
+		present[lostIndex[lostRow]] = true;
+	}
+	return true;
+}
+
+char* UdpFecDecoder::Slot(const int slot) const
+{
+	return blockBuffer + (size_t)slot * FEC_MAX_PAYLOAD;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QString>
+#include <intrin.h>
+#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include "BatchProtocol.h"
+#include "BufferPool.h"
+
+#define FEC_MAGIC 0x464E5341 //"ASNF", first bytes of every datagram of an FEC transfer
+#define FEC_HEADER_SIZE 12 //magic(4) + block(4) + index(1) + data datagrams in the block(1) + repair datagrams(1) + reserved(1)
+#define FEC_BLOCK_DATA 20 //data datagrams per block, the last block can have fewer
+#define FEC_MAX_REPAIR 20 //repair datagrams per block, 2 is 10% extra
+#define FEC_MAX_PAYLOAD (65507 - FEC_HEADER_SIZE) //biggest packet an FEC datagram can carry
+#define FEC_IDLE_FINISH_MS 500 //no datagrams for this long and the receiver closes the block it holds
+
+void WriteFecHeader(char*, const uint32_t, const int, const int, const int);
+bool ReadFecHeader(const char*, const size_t, uint32_t&, int&, int&, int&);
+
+//builds a block's repair datagrams as its data goes out, without keeping the data
+class UdpFecEncoder
+{
+public:
+	UdpFecEncoder();
+	virtual ~UdpFecEncoder() = default;
+	bool Open(SessionArena&, const size_t, const int);
+	void Add(const char*, const size_t, const int);
+	char* RepairDatagram(const int) const;
+	void Reset();
+
+private:
+	char* repairs; //repairCount datagrams of FEC_HEADER_SIZE + payloadSize, header left for the caller
+	size_t payloadSize;
+	int repairCount;
+};
+
+//holds one block's datagrams, rebuilds what went missing from its repair datagrams, and hands the
+//data on in order once the block is done
+class UdpFecDecoder
+{
+public:
+	UdpFecDecoder();
+	virtual ~UdpFecDecoder() = default;
+	bool Open(SessionArena&);
+	void Add(const char*, const size_t, const std::function<void(const char*, const size_t)>&);
+	void Finish(const std::function<void(const char*, const size_t)>&);
+	uint64_t GetRecovered() const;
+	uint64_t GetLost() const;
+	QString Summary() const;
+
+private:
+	char* blockBuffer; //FEC_BLOCK_DATA + FEC_MAX_REPAIR payloads of FEC_MAX_PAYLOAD
+	size_t lengths[FEC_BLOCK_DATA + FEC_MAX_REPAIR];
+	bool present[FEC_BLOCK_DATA + FEC_MAX_REPAIR];
+	uint32_t block;
+	bool inBlock;
+	bool delivered; //every data datagram of the block is out, the rest of it is ignored
+	int dataCount;
+	int repairCount;
+	uint64_t blocks;
+	uint64_t recovered;
+	uint64_t lost; //data datagrams that were missing and couldnt be rebuilt
+	uint64_t late; //datagrams of a block already closed
+	uint64_t foreign; //datagrams without an FEC header
+
+	void StartBlock(const uint32_t, const int, const int);
+	void CloseBlock(const std::function<void(const char*, const size_t)>&);
+	bool Recover(const int);
+	char* Slot(const int) const;
+};
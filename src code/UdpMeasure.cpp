@@ -0,0 +1,374 @@
+#include "UdpMeasure.h"
+#include "BatchProtocol.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: UdpMeasure.cpp - Sequence/timestamp header for UDP measurement runs, and the stats kept from it
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	uint64_t MeasureClockNs();
+	void WriteMeasureHeader(char*, const uint64_t, const uint64_t);
+	bool ReadMeasureHeader(const char*, const size_t, uint64_t&, uint64_t&, uint64_t&);
+	int Receive(char*, const size_t, uint64_t&);
+	bool HasKernelTimestamps() const;
+	uint64_t GetKernelStampedCount() const;
+	void Record(const uint64_t, const uint64_t, const uint64_t, const uint64_t);
+	void RecordForeign();
+	QString Summary(const bool) const;
+	uint64_t GetLost() const;
+	uint64_t GetSpan() const;
+	uint64_t GetGaps() const;
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Plain UDP mode cant tell a dropped datagram from one that was never sent, and its timing comes
+-- from steady_clock after up to a 100ms sleep. In Measure mode the client stamps every datagram with
+-- a sequence number, its send time and how many datagrams the run has, so the server knows about
+-- losses at the tail too.
+--
+-- Times are QueryPerformanceCounter in ns. The server asks for kernel receive timestamps with
+-- SIO_TIMESTAMPING (Windows 10 2004 and up, the WinSock version of SO_TIMESTAMPNS), those come back
+-- as QPC ticks in an SO_TIMESTAMP control message of WSARecvMsg. Older systems fall back to reading
+-- the clock right after recv.
+--
+-- The two hosts' clocks arent synced, so one way delay itself isnt known, only how much it varies:
+-- the spread of (receive - send) and the RFC 3550 jitter of it.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION MeasureClockNs
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: uint64_t MeasureClockNs(void)
+--
+-- RETURNS: uint64_t : QueryPerformanceCounter in ns, same clock as the kernel receive timestamps
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t MeasureClockNs()
+{
+	static const double nsPerTick = []() {
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		return 1e9 / (double)frequency.QuadPart;
+	}();
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return (uint64_t)(now.QuadPart * nsPerTick);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteMeasureHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void WriteMeasureHeader(char* datagram, const uint64_t sequence, const uint64_t datagramCount)
+		- datagram : at least UDP_MEASURE_HEADER_SIZE bytes, header goes at the front
+		- sequence : 0 based number of this datagram
+		- datagramCount : datagrams in the whole run
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- Send time is read last so it is as close to sendto as it can be.
+----------------------------------------------------------------------------------------------------------------------*/
+void WriteMeasureHeader(char* datagram, const uint64_t sequence, const uint64_t datagramCount)
+{
+	WriteLittleEndian(datagram, UDP_MEASURE_MAGIC, 4);
+	WriteLittleEndian(datagram + 4, sequence, 8);
+	WriteLittleEndian(datagram + 20, datagramCount, 8);
+	WriteLittleEndian(datagram + 12, MeasureClockNs(), 8);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadMeasureHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReadMeasureHeader(const char* datagram, const size_t length, uint64_t& sequence,
+	uint64_t& sendNs, uint64_t& datagramCount)
+		- datagram : bytes received
+		- length : bytes received
+		- sequence, sendNs, datagramCount : set from the header
+
+-- RETURNS: bool : false if the datagram isnt from a measurement run
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReadMeasureHeader(const char* datagram, const size_t length, uint64_t& sequence, uint64_t& sendNs, uint64_t& datagramCount)
+{
+	if (length < UDP_MEASURE_HEADER_SIZE || ReadLittleEndian(datagram, 4) != UDP_MEASURE_MAGIC)
+		return false;
+	sequence = ReadLittleEndian(datagram + 4, 8);
+	sendNs = ReadLittleEndian(datagram + 12, 8);
+	datagramCount = ReadLittleEndian(datagram + 20, 8);
+	return sequence < datagramCount;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION UdpTimestampReceiver Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: UdpTimestampReceiver(SOCKET serverSocket)
+		- serverSocket : SOCKET, bound UDP socket
+
+-- RETURNS: N/A
+--
+-- NOTES:
+-- WSARecvMsg is an extension function, it has to be looked up through the socket.
+-- If either that or SIO_TIMESTAMPING fails, Receive uses plain recv.
+----------------------------------------------------------------------------------------------------------------------*/
+UdpTimestampReceiver::UdpTimestampReceiver(SOCKET serverSocket)
+	: socket(serverSocket)
+	, recvMsg(nullptr)
+	, kernelTimestamps(false)
+	, kernelStamped(0)
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	nsPerTick = 1e9 / (double)frequency.QuadPart;
+
+	GUID recvMsgId = WSAID_WSARECVMSG;
+	DWORD bytesReturned = 0;
+	if (WSAIoctl(socket, SIO_GET_EXTENSION_FUNCTION_POINTER, &recvMsgId, sizeof(recvMsgId),
+		&recvMsg, sizeof(recvMsg), &bytesReturned, nullptr, nullptr) != 0)
+	{
+		recvMsg = nullptr;
+	}
+#ifdef SIO_TIMESTAMPING
+	TIMESTAMPING_CONFIG config = {};
+	config.Flags = TIMESTAMPING_FLAG_RX;
+	kernelTimestamps = (recvMsg != nullptr)
+		&& WSAIoctl(socket, SIO_TIMESTAMPING, &config, sizeof(config), nullptr, 0, &bytesReturned, nullptr, nullptr) == 0;
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Receive
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int Receive(char* buffer, const size_t bufferSize, uint64_t& receiveNs)
+		- buffer : where the datagram goes
+		- bufferSize : size of buffer
+		- receiveNs : set to the receive time, same clock as MeasureClockNs
+
+-- RETURNS: int : bytes received, or -1 like recv (WSAGetLastError has the reason)
+--
+-- NOTES:
+-- A datagram can still come back without a timestamp (the NIC/driver may skip it), then the
+-- user space clock is used for that one.
+----------------------------------------------------------------------------------------------------------------------*/
+int UdpTimestampReceiver::Receive(char* buffer, const size_t bufferSize, uint64_t& receiveNs)
+{
+	if (!kernelTimestamps)
+	{
+		int bytesRead = recv(socket, buffer, (int)bufferSize, 0);
+		receiveNs = MeasureClockNs();
+		return bytesRead;
+	}
+	WSABUF data;
+	data.buf = buffer;
+	data.len = (ULONG)bufferSize;
+	char control[WSA_CMSG_SPACE(sizeof(UINT64))];
+	struct sockaddr_storage sender;
+	WSAMSG message = {};
+	message.name = (LPSOCKADDR)&sender;
+	message.namelen = sizeof(sender);
+	message.lpBuffers = &data;
+	message.dwBufferCount = 1;
+	message.Control.buf = control;
+	message.Control.len = sizeof(control);
+	DWORD bytesRead = 0;
+	if (recvMsg(socket, &message, &bytesRead, nullptr, nullptr) != 0)
+		return -1;
+	receiveNs = MeasureClockNs();
+#ifdef SIO_TIMESTAMPING
+	for (WSACMSGHDR* header = WSA_CMSG_FIRSTHDR(&message); header != nullptr; header = WSA_CMSG_NXTHDR(&message, header))
+	{
+		if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SO_TIMESTAMP)
+		{
+			UINT64 ticks;
+			memcpy(&ticks, WSA_CMSG_DATA(header), sizeof(ticks));
+			receiveNs = (uint64_t)(ticks * nsPerTick);
+			++kernelStamped;
+		}
+	}
+#endif
+	return (int)bytesRead;
+}
+
+bool UdpTimestampReceiver::HasKernelTimestamps() const
+{
+	return kernelTimestamps;
+}
+
+uint64_t UdpTimestampReceiver::GetKernelStampedCount() const
+{
+	return kernelStamped;
+}
+
+UdpMeasureStats::UdpMeasureStats()
+	: expected(0)
+	, unique(0)
+	, duplicates(0)
+	, reordered(0)
+	, reorderDistanceSum(0)
+	, maxReorderDistance(0)
+	, highestSequence(0)
+	, foreign(0)
+	, anyReceived(false)
+	, lastTransit(0)
+	, minTransit(0)
+	, maxTransit(0)
+	, jitterNs(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Record
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void Record(const uint64_t sequence, const uint64_t datagramCount, const uint64_t sendNs, const uint64_t receiveNs)
+		- sequence, datagramCount, sendNs : from the datagram's header
+		- receiveNs : when it arrived
+
+-- RETURNS: void.
+--
+-- NOTES:
+-- A datagram is reordered when a higher sequence number got here first, its distance is how much
+-- higher (RFC 4737 style). Duplicates dont count towards reordering or delay.
+-- The duplicate bitmap is sized once from the first datagram's run length, so it never grows (and
+-- allocates) part way through a run. Sequence numbers past it are counted but not checked for duplicates.
+----------------------------------------------------------------------------------------------------------------------*/
+void UdpMeasureStats::Record(const uint64_t sequence, const uint64_t datagramCount, const uint64_t sendNs, const uint64_t receiveNs)
+{
+	expected = std::max(expected, datagramCount);
+	if (seen.empty() && datagramCount > 0)
+	{
+		seen.assign((size_t)((std::min<uint64_t>(datagramCount, UDP_MEASURE_MAX_TRACKED) + 63) / 64), 0);
+	}
+	size_t word = (size_t)(sequence / 64);
+	if (sequence < UDP_MEASURE_MAX_TRACKED && word < seen.size())
+	{
+		uint64_t bit = 1ULL << (sequence % 64);
+		if (seen[word] & bit)
+		{
+			++duplicates;
+			return;
+		}
+		seen[word] |= bit;
+	}
+	++unique;
+
+	if (anyReceived && sequence < highestSequence)
+	{
+		uint64_t distance = highestSequence - sequence;
+		++reordered;
+		reorderDistanceSum += distance;
+		maxReorderDistance = std::max(maxReorderDistance, distance);
+	}
+
+	int64_t transit = (int64_t)(receiveNs - sendNs);
+	if (!anyReceived)
+	{
+		highestSequence = sequence;
+		minTransit = transit;
+		maxTransit = transit;
+	}
+	else
+	{
+		highestSequence = std::max(highestSequence, sequence);
+		int64_t difference = transit - lastTransit;
+		jitterNs += ((double)std::llabs(difference) - jitterNs) / 16;
+		minTransit = std::min(minTransit, transit);
+		maxTransit = std::max(maxTransit, transit);
+	}
+	lastTransit = transit;
+	anyReceived = true;
+}
+
+//datagram without a measurement header, plain UDP sent to a measuring server
+void UdpMeasureStats::RecordForeign()
+{
+	++foreign;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Summary
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString Summary(const bool kernelTimestamps) const
+		- kernelTimestamps : whether receive times came from the kernel, shown so numbers arent misread
+
+-- RETURNS: QString : one line of stats for the results panel
+--
+-- NOTES:
+-- Loss is only final once the run is over, while receiving it includes datagrams still on the way.
+----------------------------------------------------------------------------------------------------------------------*/
+QString UdpMeasureStats::Summary(const bool kernelTimestamps) const
+{
+	double lossPercent = (expected > 0) ? 100.0 * GetLost() / expected : 0;
+	double meanDistance = (reordered > 0) ? (double)reorderDistanceSum / reordered : 0;
+	QString summary = QString("lost %1/%2 (%3%), dup %4, reordered %5 (max dist %6, mean %7), jitter %8 us, delay var %9 us")
+		.arg(GetLost()).arg(expected).arg(lossPercent, 0, 'f', 2).arg(duplicates).arg(reordered)
+		.arg(maxReorderDistance).arg(meanDistance, 0, 'f', 1).arg(jitterNs / 1000, 0, 'f', 1)
+		.arg((maxTransit - minTransit) / 1000.0, 0, 'f', 1);
+	summary += kernelTimestamps ? " [kernel rx time]" : " [user rx time]";
+	if (foreign > 0)
+	{
+		summary += QString(", %1 unstamped").arg(foreign);
+	}
+	return summary;
+}
+
+uint64_t UdpMeasureStats::GetLost() const
+{
+	return (expected > unique) ? expected - unique : 0;
+}
+
+//sequence numbers up to the highest one seen, the part of the run whose loss can be told already
+uint64_t UdpMeasureStats::GetSpan() const
+{
+	return anyReceived ? highestSequence + 1 : 0;
+}
+
+//sequence numbers below the highest one seen that havent come, lost or still to come reordered
+uint64_t UdpMeasureStats::GetGaps() const
+{
+	return (GetSpan() > unique) ? GetSpan() - unique : 0;
+}
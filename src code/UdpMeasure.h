@@ -0,0 +1,69 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <Windows.h>
+#include <mswsock.h>
+#include <QString>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#define UDP_MEASURE_MAGIC 0x554E5341 //"ASNU", first bytes of every measurement datagram
+#define UDP_MEASURE_HEADER_SIZE 28 //magic(4) + sequence(8) + send time ns(8) + datagrams in the run(8)
+#define UDP_MEASURE_MAX_TRACKED 134217728 //sequence numbers checked for duplicates, 16MB bitmap
+#define UDP_MEASURE_REPORT_MS 500 //how often the server passes out its stats while receiving
+#define UDP_MEASURE_POLL_US 100000 //select timeout, how quickly a stop is noticed
+
+uint64_t MeasureClockNs();
+void WriteMeasureHeader(char*, const uint64_t, const uint64_t);
+bool ReadMeasureHeader(const char*, const size_t, uint64_t&, uint64_t&, uint64_t&);
+
+//recv with a receive time, from the kernel if the socket can give one
+class UdpTimestampReceiver
+{
+public:
+	UdpTimestampReceiver(SOCKET);
+	virtual ~UdpTimestampReceiver() = default;
+	int Receive(char*, const size_t, uint64_t&);
+	bool HasKernelTimestamps() const;
+	uint64_t GetKernelStampedCount() const;
+
+private:
+	SOCKET socket;
+	LPFN_WSARECVMSG recvMsg;
+	bool kernelTimestamps;
+	uint64_t kernelStamped;
+	double nsPerTick;
+};
+
+//loss, duplicates, reordering and delay variation of one measurement run
+class UdpMeasureStats
+{
+public:
+	UdpMeasureStats();
+	virtual ~UdpMeasureStats() = default;
+	void Record(const uint64_t, const uint64_t, const uint64_t, const uint64_t);
+	void RecordForeign();
+	QString Summary(const bool) const;
+	uint64_t GetLost() const;
+	uint64_t GetSpan() const;
+	uint64_t GetGaps() const;
+
+private:
+	std::vector<uint64_t> seen; //one bit per sequence number in the run, up to UDP_MEASURE_MAX_TRACKED, sized once
+	uint64_t expected; //datagrams the client said it would send
+	uint64_t unique;
+	uint64_t duplicates;
+	uint64_t reordered; //arrived after a higher sequence number
+	uint64_t reorderDistanceSum;
+	uint64_t maxReorderDistance;
+	uint64_t highestSequence;
+	uint64_t foreign; //datagrams without a measurement header
+	bool anyReceived;
+	int64_t lastTransit; //receive - send time, includes the unknown clock offset between hosts
+	int64_t minTransit;
+	int64_t maxTransit;
+	double jitterNs; //RFC 3550 interarrival jitter
+};
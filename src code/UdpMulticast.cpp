@@ -0,0 +1,567 @@
+#include "UdpMulticast.h"
+#include <intrin.h>
+#include <algorithm>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: UdpMulticast.cpp - One sender, many receivers: UDP single file runs sent to a multicast group
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	bool IsMulticastAddress(const struct sockaddr_storage&);
+	bool ParseMulticastGroup(const QString&, struct sockaddr_storage&);
+	bool JoinMulticastGroup(SOCKET, const struct sockaddr_storage&);
+	bool EnableMulticastSend(SOCKET, const int);
+	void WriteMulticastHeader(char*, const uint64_t, const uint64_t);
+	bool ReadMulticastHeader(const char*, const size_t, uint64_t&, uint64_t&);
+	bool Open(SessionArena&, const uint64_t);
+	bool IsOpen() const;
+	bool Add(const uint64_t);
+	size_t BuildNack(char*, const bool);
+	void RecordForeign();
+	void GiveUp();
+	bool IsComplete() const;
+	int GetQuietRounds() const;
+	uint64_t GetExpected() const;
+	QString Summary() const;
+	uint64_t AddNack(const char*, const size_t);
+	bool Next(uint64_t&);
+	uint64_t GetPending() const;
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- A unicast UDP run to n receivers costs the sender n full streams. When the client's host is a
+-- multicast group instead, each datagram goes out once and every server that joined the group
+-- gets a copy, so the sender's rate doesnt depend on how many are listening.
+--
+-- Every datagram carries a sequence number and the run's length. A receiver keeps a bitmap of what
+-- it has; gaps more than MULTICAST_REORDER_SLACK below the highest sequence seen, and the end of
+-- the run once the sender has gone quiet, are NACKed every MULTICAST_NACK_MS, unicast to the
+-- address the datagrams came from. The sender queues what it is asked for in a bitmap of its own,
+-- so a datagram lost on the way to every receiver is sent again once, not once per NACK, and
+-- sends repairs to the group ahead of new datagrams. It keeps answering NACKs for
+-- MULTICAST_LINGER_MS after its last send before it closes.
+--
+-- There is no join/leave handshake with the sender, receivers that join late just NACK the
+-- whole start of the run.
+----------------------------------------------------------------------------------------------------------------------*/
+
+//first sequence number from "from" up to "end" whose bit is clear (or set, for findSet)
+static uint64_t ScanBits(const uint64_t* bits, uint64_t from, const uint64_t end, const bool findSet)
+{
+	while (from < end)
+	{
+		uint64_t word = findSet ? bits[from / 64] : ~bits[from / 64];
+		word >>= (from % 64);
+		if (word != 0)
+		{
+			unsigned long offset;
+			_BitScanForward64(&offset, word);
+			return std::min<uint64_t>(from + offset, end);
+		}
+		from = (from / 64 + 1) * 64;
+	}
+	return end;
+}
+
+static bool TestBit(const uint64_t* bits, const uint64_t index)
+{
+	return (bits[index / 64] >> (index % 64)) & 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION IsMulticastAddress
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool IsMulticastAddress(const struct sockaddr_storage& address)
+		- address : IPv4 or IPv6 address
+
+-- RETURNS: bool : whether it's in 224.0.0.0/4 or ff00::/8
+----------------------------------------------------------------------------------------------------------------------*/
+bool IsMulticastAddress(const struct sockaddr_storage& address)
+{
+	if (address.ss_family == AF_INET)
+	{
+		uint32_t ipv4 = ntohl(((const struct sockaddr_in*)&address)->sin_addr.s_addr);
+		return (ipv4 & 0xF0000000) == 0xE0000000;
+	}
+	if (address.ss_family == AF_INET6)
+	{
+		return ((const struct sockaddr_in6*)&address)->sin6_addr.s6_addr[0] == 0xFF;
+	}
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ParseMulticastGroup
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ParseMulticastGroup(const QString& text, struct sockaddr_storage& group)
+		- text : numeric IPv4 or IPv6 group address, as typed on MainWindow
+		- group : set to it, port left 0
+
+-- RETURNS: bool : false if it isnt a numeric multicast address
+----------------------------------------------------------------------------------------------------------------------*/
+bool ParseMulticastGroup(const QString& text, struct sockaddr_storage& group)
+{
+	memset(&group, 0, sizeof(group));
+	std::string numeric = text.trimmed().toStdString();
+	struct sockaddr_in* ipv4 = (struct sockaddr_in*)&group;
+	struct sockaddr_in6* ipv6 = (struct sockaddr_in6*)&group;
+	if (inet_pton(AF_INET, numeric.c_str(), &ipv4->sin_addr) == 1)
+		group.ss_family = AF_INET;
+	else if (inet_pton(AF_INET6, numeric.c_str(), &ipv6->sin6_addr) == 1)
+		group.ss_family = AF_INET6;
+	return IsMulticastAddress(group);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION JoinMulticastGroup
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool JoinMulticastGroup(SOCKET receiveSocket, const struct sockaddr_storage& group)
+		- receiveSocket : bound UDP socket, IPv4 or dual stack IPv6
+		- group : from ParseMulticastGroup
+
+-- RETURNS: bool : whether the socket joined, on the interface the stack picks
+--
+-- NOTES:
+-- The server socket is IPv6 with V6ONLY off; Windows takes IPPROTO_IP memberships on those too,
+-- so an IPv4 group is joined the same way either way. Closing the socket leaves the group.
+----------------------------------------------------------------------------------------------------------------------*/
+bool JoinMulticastGroup(SOCKET receiveSocket, const struct sockaddr_storage& group)
+{
+	if (group.ss_family == AF_INET)
+	{
+		struct ip_mreq request;
+		memset(&request, 0, sizeof(request));
+		request.imr_multiaddr = ((const struct sockaddr_in*)&group)->sin_addr;
+		request.imr_interface.s_addr = htonl(INADDR_ANY);
+		return setsockopt(receiveSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&request, sizeof(request)) == 0;
+	}
+	struct ipv6_mreq request;
+	memset(&request, 0, sizeof(request));
+	request.ipv6mr_multiaddr = ((const struct sockaddr_in6*)&group)->sin6_addr;
+	request.ipv6mr_interface = 0;
+	return setsockopt(receiveSocket, IPPROTO_IPV6, IPV6_ADD_MEMBERSHIP, (const char*)&request, sizeof(request)) == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION EnableMulticastSend
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool EnableMulticastSend(SOCKET sendSocket, const int family)
+		- sendSocket : UDP socket the group is sent to from
+		- family : AF_INET or AF_INET6, the group's
+
+-- RETURNS: bool : whether both options took
+--
+-- NOTES:
+-- MULTICAST_TTL hops, and loopback on so receivers on the sending host get the datagrams too.
+----------------------------------------------------------------------------------------------------------------------*/
+bool EnableMulticastSend(SOCKET sendSocket, const int family)
+{
+	DWORD hops = MULTICAST_TTL;
+	DWORD loop = 1;
+	if (family == AF_INET)
+	{
+		return setsockopt(sendSocket, IPPROTO_IP, IP_MULTICAST_TTL, (const char*)&hops, sizeof(hops)) == 0
+			&& setsockopt(sendSocket, IPPROTO_IP, IP_MULTICAST_LOOP, (const char*)&loop, sizeof(loop)) == 0;
+	}
+	return setsockopt(sendSocket, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, (const char*)&hops, sizeof(hops)) == 0
+		&& setsockopt(sendSocket, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, (const char*)&loop, sizeof(loop)) == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION WriteMulticastHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void WriteMulticastHeader(char* datagram, const uint64_t sequence, const uint64_t datagramCount)
+		- datagram : first MULTICAST_HEADER_SIZE bytes are written
+		- sequence : this datagram's number, counting up from 0
+		- datagramCount : datagrams in the run
+
+-- RETURNS: void.
+----------------------------------------------------------------------------------------------------------------------*/
+void WriteMulticastHeader(char* datagram, const uint64_t sequence, const uint64_t datagramCount)
+{
+	WriteLittleEndian(datagram, MULTICAST_MAGIC, 4);
+	WriteLittleEndian(datagram + 4, sequence, 8);
+	WriteLittleEndian(datagram + 12, datagramCount, 8);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadMulticastHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReadMulticastHeader(const char* datagram, const size_t length, uint64_t& sequence, uint64_t& datagramCount)
+		- datagram : as received
+		- length : its size
+		- sequence, datagramCount : filled in, see WriteMulticastHeader
+
+-- RETURNS: bool : false if it has no multicast header or the numbers are out of range
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReadMulticastHeader(const char* datagram, const size_t length, uint64_t& sequence, uint64_t& datagramCount)
+{
+	if (length < MULTICAST_HEADER_SIZE || ReadLittleEndian(datagram, 4) != MULTICAST_MAGIC)
+		return false;
+	sequence = ReadLittleEndian(datagram + 4, 8);
+	datagramCount = ReadLittleEndian(datagram + 12, 8);
+	return datagramCount > 0 && datagramCount <= MULTICAST_MAX_DATAGRAMS && sequence < datagramCount;
+}
+
+MulticastGapTracker::MulticastGapTracker()
+	: seen(nullptr), seenWords(0), expected(0), received(0), contiguous(0), highest(0), duplicates(0),
+	filled(0), nacksSent(0), lost(0), foreign(0), quietRounds(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(SessionArena& arena, const uint64_t datagramCount)
+		- arena : the Server's, holds the bitmap
+		- datagramCount : datagrams in the run, from its first datagram's header
+
+-- RETURNS: bool : false if the run is too long to track or the bitmap doesnt fit in memory
+--
+-- NOTES:
+-- Starts a new run, counts from the last one are dropped. The bitmap is reused if it's big enough.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MulticastGapTracker::Open(SessionArena& arena, const uint64_t datagramCount)
+{
+	if (datagramCount == 0 || datagramCount > MULTICAST_MAX_DATAGRAMS)
+		return false;
+	uint64_t words = (datagramCount + 63) / 64;
+	if (words > seenWords)
+	{
+		seen = (uint64_t*)arena.Allocate(words * sizeof(uint64_t));
+		seenWords = (seen != nullptr) ? words : 0;
+		if (seen == nullptr)
+			return false;
+	}
+	memset(seen, 0, words * sizeof(uint64_t));
+	expected = datagramCount;
+	received = 0;
+	contiguous = 0;
+	highest = 0;
+	duplicates = 0;
+	filled = 0;
+	nacksSent = 0;
+	lost = 0;
+	quietRounds = 0;
+	return true;
+}
+
+bool MulticastGapTracker::IsOpen() const
+{
+	return expected > 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Add
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Add(const uint64_t sequence)
+		- sequence : from the datagram's header, below the run's datagram count
+
+-- RETURNS: bool : true the first time this sequence number is seen, the datagram should be kept
+----------------------------------------------------------------------------------------------------------------------*/
+bool MulticastGapTracker::Add(const uint64_t sequence)
+{
+	if (sequence >= expected || TestBit(seen, sequence))
+	{
+		++duplicates;
+		return false;
+	}
+	seen[sequence / 64] |= (uint64_t)1 << (sequence % 64);
+	++received;
+	quietRounds = 0;
+	if (sequence < highest)
+		++filled;
+	else
+		highest = sequence + 1;
+	if (sequence == contiguous)
+		contiguous = ScanBits(seen, contiguous, expected, false);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION BuildNack
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: size_t BuildNack(char* nack, const bool toEnd)
+		- nack : MULTICAST_NACK_SIZE bytes, the datagram to send is written here
+		- toEnd : the sender has gone quiet, ask for everything up to the end of the run
+
+-- RETURNS: size_t : bytes of nack to send, 0 if there is nothing to ask for
+--
+-- NOTES:
+-- Otherwise only gaps MULTICAST_REORDER_SLACK below the highest sequence seen are asked for.
+-- The lowest MULTICAST_NACK_RANGES gaps go out, the rest are asked for once those are filled.
+-- An end of run NACK counts as a quiet round until a new datagram comes in.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t MulticastGapTracker::BuildNack(char* nack, const bool toEnd)
+{
+	uint64_t horizon = toEnd ? expected : ((highest > MULTICAST_REORDER_SLACK) ? highest - MULTICAST_REORDER_SLACK : 0);
+	uint32_t ranges = 0;
+	uint64_t sequence = contiguous;
+	while (ranges < MULTICAST_NACK_RANGES)
+	{
+		uint64_t first = ScanBits(seen, sequence, horizon, false);
+		if (first >= horizon)
+			break;
+		sequence = ScanBits(seen, first, std::min<uint64_t>(horizon, first + UINT32_MAX), true);
+		char* range = nack + 8 + ranges * 12;
+		WriteLittleEndian(range, first, 8);
+		WriteLittleEndian(range + 8, sequence - first, 4);
+		++ranges;
+	}
+	if (ranges == 0)
+		return 0;
+	WriteLittleEndian(nack, MULTICAST_NACK_MAGIC, 4);
+	WriteLittleEndian(nack + 4, ranges, 4);
+	++nacksSent;
+	if (toEnd)
+		++quietRounds;
+	return 8 + ranges * 12;
+}
+
+void MulticastGapTracker::RecordForeign()
+{
+	++foreign;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION GiveUp
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void GiveUp(void)
+--
+-- RETURNS: void.
+--
+-- NOTES:
+-- Called once MULTICAST_GIVE_UP_ROUNDS end of run NACKs went unanswered, whatever is still
+-- missing counts as lost.
+----------------------------------------------------------------------------------------------------------------------*/
+void MulticastGapTracker::GiveUp()
+{
+	lost = expected - received;
+	quietRounds = 0;
+}
+
+bool MulticastGapTracker::IsComplete() const
+{
+	return expected > 0 && received == expected;
+}
+
+int MulticastGapTracker::GetQuietRounds() const
+{
+	return quietRounds;
+}
+
+uint64_t MulticastGapTracker::GetExpected() const
+{
+	return expected;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Summary
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: QString Summary(void) const
+--
+-- RETURNS: QString : one line of received, repaired and lost counts, for the console and the session list
+----------------------------------------------------------------------------------------------------------------------*/
+QString MulticastGapTracker::Summary() const
+{
+	QString summary = QString("multicast: %1/%2 datagrams, %3 filled in late or by repair, %4 duplicates, %5 NACKs sent")
+		.arg(received).arg(expected).arg(filled).arg(duplicates).arg(nacksSent);
+	if (lost > 0)
+		summary += QString(", %1 lost for good").arg(lost);
+	if (foreign > 0)
+		summary += QString(", %1 without a multicast header").arg(foreign);
+	return summary;
+}
+
+MulticastRepairQueue::MulticastRepairQueue()
+	: queued(nullptr), count(0), cursor(0), pending(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Open
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Open(SessionArena& arena, const uint64_t datagramCount)
+		- arena : the Client's, holds the bitmap
+		- datagramCount : datagrams in the run
+
+-- RETURNS: bool : false if the run is too long to track or the bitmap doesnt fit in memory
+----------------------------------------------------------------------------------------------------------------------*/
+bool MulticastRepairQueue::Open(SessionArena& arena, const uint64_t datagramCount)
+{
+	if (datagramCount == 0 || datagramCount > MULTICAST_MAX_DATAGRAMS)
+		return false;
+	uint64_t words = (datagramCount + 63) / 64;
+	queued = (uint64_t*)arena.Allocate(words * sizeof(uint64_t));
+	if (queued == nullptr)
+		return false;
+	memset(queued, 0, words * sizeof(uint64_t));
+	count = datagramCount;
+	cursor = datagramCount;
+	pending = 0;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION AddNack
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: uint64_t AddNack(const char* nack, const size_t length)
+		- nack : datagram from a receiver, see MulticastGapTracker::BuildNack
+		- length : its size
+
+-- RETURNS: uint64_t : sequence numbers newly queued, ones already waiting arent counted twice
+--
+-- NOTES:
+-- Anything that isnt a well formed NACK for this run is ignored.
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t MulticastRepairQueue::AddNack(const char* nack, const size_t length)
+{
+	if (length < 8 || ReadLittleEndian(nack, 4) != MULTICAST_NACK_MAGIC)
+		return 0;
+	uint64_t ranges = ReadLittleEndian(nack + 4, 4);
+	if (ranges > MULTICAST_NACK_RANGES || length < 8 + ranges * 12)
+		return 0;
+	uint64_t added = 0;
+	for (uint64_t range = 0; range < ranges; ++range)
+	{
+		uint64_t first = ReadLittleEndian(nack + 8 + range * 12, 8);
+		uint64_t rangeLength = ReadLittleEndian(nack + 16 + range * 12, 4);
+		if (first >= count)
+			continue;
+		uint64_t end = std::min<uint64_t>(first + rangeLength, count);
+		for (uint64_t sequence = first; sequence < end; ++sequence)
+		{
+			if (!TestBit(queued, sequence))
+			{
+				queued[sequence / 64] |= (uint64_t)1 << (sequence % 64);
+				++added;
+			}
+		}
+		cursor = std::min(cursor, first);
+	}
+	pending += added;
+	return added;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Next
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool Next(uint64_t& sequence)
+		- sequence : set to the lowest sequence number queued, which is taken off the queue
+
+-- RETURNS: bool : false if nothing is queued
+--
+-- NOTES:
+-- Once taken it can be queued again, if the repair is lost too the receivers will NACK it again.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MulticastRepairQueue::Next(uint64_t& sequence)
+{
+	if (pending == 0)
+		return false;
+	cursor = ScanBits(queued, cursor, count, true);
+	if (cursor >= count)
+	{
+		pending = 0;
+		return false;
+	}
+	sequence = cursor;
+	queued[sequence / 64] &= ~((uint64_t)1 << (sequence % 64));
+	--pending;
+	++cursor;
+	return true;
+}
+
+uint64_t MulticastRepairQueue::GetPending() const
+{
+	return pending;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <QString>
+#include <cstdint>
+#include <cstring>
+#include "BatchProtocol.h"
+#include "BufferPool.h"
+
+#define MULTICAST_MAGIC 0x4D4E5341 //"ASNM", first bytes of every datagram sent to a group
+#define MULTICAST_HEADER_SIZE 20 //magic(4) + sequence(8) + datagrams in the run(8)
+#define MULTICAST_MAX_PAYLOAD (65507 - MULTICAST_HEADER_SIZE) //biggest packet a multicast datagram can carry
+#define MULTICAST_NACK_MAGIC 0x4B4E5341 //"ASNK", a receiver's list of gaps, unicast back to the sender
+#define MULTICAST_NACK_RANGES 64 //gaps per NACK, first sequence(8) + count(4) each
+#define MULTICAST_NACK_SIZE (8 + MULTICAST_NACK_RANGES * 12) //magic(4) + range count(4) + the ranges
+#define MULTICAST_MAX_DATAGRAMS 1073741824 //sequence numbers a run can have, 128MB bitmap at each end
+#define MULTICAST_TTL 1 //hops, the group stays on the local network
+#define MULTICAST_NACK_MS 50 //how often a receiver asks again for what it is still missing
+#define MULTICAST_REORDER_SLACK 64 //a gap this far below the highest sequence seen is NACKed, closer ones may just be late
+#define MULTICAST_TAIL_WAIT_MS 200 //sender silent this long, the end of the run is NACKed too
+#define MULTICAST_GIVE_UP_ROUNDS 40 //end of run NACKs in a row that brought nothing back, the rest counts as lost
+#define MULTICAST_LINGER_MS 1000 //sender keeps answering NACKs this long after its last datagram went out
+#define MULTICAST_POLL_DATAGRAMS 64 //datagrams the sender sends between checks for NACKs
+
+bool IsMulticastAddress(const struct sockaddr_storage&);
+bool ParseMulticastGroup(const QString&, struct sockaddr_storage&);
+bool JoinMulticastGroup(SOCKET, const struct sockaddr_storage&);
+bool EnableMulticastSend(SOCKET, const int);
+void WriteMulticastHeader(char*, const uint64_t, const uint64_t);
+bool ReadMulticastHeader(const char*, const size_t, uint64_t&, uint64_t&);
+
+//which datagrams of a run a receiver has, and the NACKs asking for the ones it hasnt
+class MulticastGapTracker
+{
+public:
+	MulticastGapTracker();
+	virtual ~MulticastGapTracker() = default;
+	bool Open(SessionArena&, const uint64_t);
+	bool IsOpen() const;
+	bool Add(const uint64_t);
+	size_t BuildNack(char*, const bool);
+	void RecordForeign();
+	void GiveUp();
+	bool IsComplete() const;
+	int GetQuietRounds() const;
+	uint64_t GetExpected() const;
+	QString Summary() const;
+
+private:
+	uint64_t* seen; //one bit per sequence number of the run
+	uint64_t seenWords; //bitmap capacity in 64 bit words, kept for the next run
+	uint64_t expected;
+	uint64_t received;
+	uint64_t contiguous; //every sequence number below this is in
+	uint64_t highest; //one past the highest sequence number in
+	uint64_t duplicates; //repairs asked for by other receivers land here too
+	uint64_t filled; //arrived after a higher sequence number, a repair or just reordered
+	uint64_t nacksSent;
+	uint64_t lost; //still missing when the receiver gave up
+	uint64_t foreign; //datagrams without a multicast header
+	int quietRounds;
+};
+
+//sequence numbers receivers NACKed, each queued once however many receivers ask for it
+class MulticastRepairQueue
+{
+public:
+	MulticastRepairQueue();
+	virtual ~MulticastRepairQueue() = default;
+	bool Open(SessionArena&, const uint64_t);
+	uint64_t AddNack(const char*, const size_t);
+	bool Next(uint64_t&);
+	uint64_t GetPending() const;
+
+private:
+	uint64_t* queued; //one bit per sequence number of the run
+	uint64_t count;
+	uint64_t cursor; //nothing queued below this
+	uint64_t pending;
+};
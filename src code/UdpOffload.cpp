@@ -0,0 +1,147 @@
+#include "UdpOffload.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: UdpOffload.cpp - UDP segmentation offload for sends and receive coalescing
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	bool EnableSendOffload(SOCKET, const size_t);
+	int Receive(char*, const size_t, size_t&);
+	bool IsCoalescing() const;
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- Every datagram going through sendto/recv on its own pays a full trip through the stack.
+-- Linux cuts that with UDP_SEGMENT (GSO) and UDP_GRO; WinSock's versions are USO and URO:
+-- UDP_SEND_MSG_SIZE makes one send of many datagrams' worth of bytes go out as datagrams of that
+-- size (split by the NIC, or by the stack if the NIC cant), and UDP_RECV_MAX_COALESCED_SIZE lets one
+-- receive return several datagrams of the same flow back to back, with their size in a
+-- UDP_COALESCED_INFO control message of WSARecvMsg.
+--
+-- Both are probed by just setting the option: older Windows turns it down, and the caller falls
+-- back to one datagram per call.
+----------------------------------------------------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION EnableSendOffload
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool EnableSendOffload(SOCKET clientSocket, const size_t datagramSize)
+		- clientSocket : SOCKET, UDP socket to send on
+		- datagramSize : size every datagram cut from a send should be
+
+-- RETURNS: bool : whether the stack took it, if so every send after is cut up into datagramSize pieces
+----------------------------------------------------------------------------------------------------------------------*/
+bool EnableSendOffload(SOCKET clientSocket, const size_t datagramSize)
+{
+	DWORD segmentSize = (DWORD)datagramSize;
+	return setsockopt(clientSocket, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (const char*)&segmentSize, sizeof(segmentSize)) == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION UdpCoalescedReceiver Constructor
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: UdpCoalescedReceiver(SOCKET serverSocket, const bool coalesce)
+		- serverSocket : SOCKET, bound UDP socket
+		- coalesce : bool, ask for receive coalescing, false makes Receive a plain recv
+
+-- RETURNS: N/A
+--
+-- NOTES:
+-- Coalescing is only turned on if WSARecvMsg could be found too, without it the datagram size
+-- of a coalesced receive cant be known.
+----------------------------------------------------------------------------------------------------------------------*/
+UdpCoalescedReceiver::UdpCoalescedReceiver(SOCKET serverSocket, const bool coalesce)
+	: socket(serverSocket)
+	, recvMsg(nullptr)
+	, coalescing(false)
+{
+	if (!coalesce)
+		return;
+	GUID recvMsgId = WSAID_WSARECVMSG;
+	DWORD bytesReturned = 0;
+	if (WSAIoctl(socket, SIO_GET_EXTENSION_FUNCTION_POINTER, &recvMsgId, sizeof(recvMsgId),
+		&recvMsg, sizeof(recvMsg), &bytesReturned, nullptr, nullptr) != 0)
+	{
+		recvMsg = nullptr;
+		return;
+	}
+	DWORD maxCoalesced = UDP_OFFLOAD_MAX_BYTES;
+	coalescing = setsockopt(socket, IPPROTO_UDP, UDP_RECV_MAX_COALESCED_SIZE, (const char*)&maxCoalesced, sizeof(maxCoalesced)) == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION Receive
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: int Receive(char* buffer, const size_t bufferSize, size_t& datagramSize)
+		- buffer : where the datagram(s) go, should hold UDP_OFFLOAD_MAX_BYTES when coalescing
+		- bufferSize : size of buffer
+		- datagramSize : set to the size of each datagram received, the last one may be shorter
+
+-- RETURNS: int : bytes received, or -1 like recv (WSAGetLastError has the reason)
+----------------------------------------------------------------------------------------------------------------------*/
+int UdpCoalescedReceiver::Receive(char* buffer, const size_t bufferSize, size_t& datagramSize)
+{
+	if (!coalescing)
+	{
+		int bytesRead = recv(socket, buffer, (int)bufferSize, 0);
+		datagramSize = (bytesRead > 0) ? bytesRead : 0;
+		return bytesRead;
+	}
+	WSABUF data;
+	data.buf = buffer;
+	data.len = (ULONG)bufferSize;
+	char control[WSA_CMSG_SPACE(sizeof(DWORD))];
+	struct sockaddr_storage sender;
+	WSAMSG message = {};
+	message.name = (LPSOCKADDR)&sender;
+	message.namelen = sizeof(sender);
+	message.lpBuffers = &data;
+	message.dwBufferCount = 1;
+	message.Control.buf = control;
+	message.Control.len = sizeof(control);
+
+	DWORD bytesRead = 0;
+	if (recvMsg(socket, &message, &bytesRead, nullptr, nullptr) != 0)
+		return -1;
+	datagramSize = bytesRead;
+	for (WSACMSGHDR* header = WSA_CMSG_FIRSTHDR(&message); header != nullptr; header = WSA_CMSG_NXTHDR(&message, header))
+	{
+		if (header->cmsg_level == IPPROTO_UDP && header->cmsg_type == UDP_COALESCED_INFO)
+		{
+			DWORD coalescedSize;
+			memcpy(&coalescedSize, WSA_CMSG_DATA(header), sizeof(coalescedSize));
+			if (coalescedSize > 0)
+				datagramSize = coalescedSize;
+		}
+	}
+	return (int)bytesRead;
+}
+
+bool UdpCoalescedReceiver::IsCoalescing() const
+{
+	return coalescing;
+}
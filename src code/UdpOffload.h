@@ -0,0 +1,38 @@
+#pragma once
+#pragma comment(lib, "ws2_32.lib")
+
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#include <Windows.h>
+#include <mswsock.h>
+#include <cstring>
+
+#define UDP_OFFLOAD_MAX_BYTES 65000 //biggest send handed to the kernel for segmenting, and biggest coalesced receive
+
+//ws2ipdef.h only has these from the Windows 10 1903 SDK on
+#ifndef UDP_SEND_MSG_SIZE
+#define UDP_SEND_MSG_SIZE 2
+#endif
+#ifndef UDP_RECV_MAX_COALESCED_SIZE
+#define UDP_RECV_MAX_COALESCED_SIZE 3
+#endif
+#ifndef UDP_COALESCED_INFO
+#define UDP_COALESCED_INFO 3
+#endif
+
+bool EnableSendOffload(SOCKET, const size_t);
+
+//recv that takes several coalesced datagrams at once where the stack can, and says how big each was
+class UdpCoalescedReceiver
+{
+public:
+	UdpCoalescedReceiver(SOCKET, const bool);
+	virtual ~UdpCoalescedReceiver() = default;
+	int Receive(char*, const size_t, size_t&);
+	bool IsCoalescing() const;
+
+private:
+	SOCKET socket;
+	LPFN_WSARECVMSG recvMsg;
+	bool coalescing;
+};
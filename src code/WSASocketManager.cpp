@@ -6,20 +6,30 @@
 --
 -- FUNCTIONS:
 		bool CheckIPFormat(const QString&);
-		bool SetupSendingByName(const QString&, const QString&, const int, const QString&);
-		bool SetupSendingByIp(const QString&, const QString&, const int, const QString&);
-		bool SetupReceiving(const QString&, const int, const QString&, size_t = 0);
-		void SendPackets(const size_t, const size_t);
+		bool SetupSendingByName(const QString&, const QString&, const int, const QString&, const TransferOptions& = TransferOptions());
+		bool SetupSendingByIp(const QString&, const QString&, const int, const QString&, const TransferOptions& = TransferOptions());
+		bool SetupReceiving(const QString&, const int, const QString&, size_t = 0, const TransferOptions& = TransferOptions());
+		void SendPackets(const size_t, const size_t, const TransferOptions&);
 		void ReceivePackets();
 		void FinishReceivePackets();
 		void PrintClientStatus(const QString&);
 		void DisplayClientAlert(const QString&);
-		QString GetErrorString();		
+		void StopSession(const int);
+		void SendToConnectedHost(SOCKET, struct sockaddr_storage, const int);
+		void DisplayConnectFailure(const int, const int);
+		void PublishSessions();
+		void SampleLiveSessions();
+		bool GetLiveSeries(const int, LiveSeries&) const;
+		QString GetErrorString(const int);
+		bool SetupSending(const QString&, const QString&, const int, const QString&, const bool, const TransferOptions&);
 		bool SetupSocket(const int);
 		bool SetupPacketFile(const QString&);
+		bool SetupBatchPath(const QString&, const bool);
+		bool SetupDeltaFile(const QString&, const bool);
 		bool CreateSocket(const QString&);
 		bool ConnectToSocket(const int);
-		void UpdateTimer(const size_t, const size_t);
+		TransferSession* CreateSession(const bool);
+		void PruneFinishedSessions();
 --
 -- DATE: Feb 10, 2018
 --
@@ -31,7 +41,8 @@
 -- This class uses various functions in the Windows Sockets 2 API to perform setup and validation
 -- work with sockets and socket addresses (socket_addr structs). This class acts like a controller
 -- between the UI view, and the WinSock2 API, so that the UI class never directly calls any API calls.
--- It also acts as the controller between the main thread, and the client and server threads;
+-- It also acts as the controller between the main thread, and the transfer sessions, which each run
+-- their own Server or Client on the shared TaskScheduler so several sends/receives can go at once;
 ----------------------------------------------------------------------------------------------------------------------*/
 #include "WSASocketManager.h"
 
@@ -43,53 +54,59 @@ WSASocketManager::WSASocketManager(QObject *parent)
 	WSAStartup(wVersionRequested, &wsaData);
 	qRegisterMetaType<SOCKET>("SOCKET");
 	qRegisterMetaType<struct sockaddr_in>("struct sockaddr_in");
+	qRegisterMetaType<struct sockaddr_storage>("struct sockaddr_storage");
 	qRegisterMetaType<size_t>("size_t"); //wtf qt? u dont know size_t???
+	qRegisterMetaType<TransferOptions>("TransferOptions");
 
 	QThread::currentThread()->setObjectName("mainThread");
-    
-    serverThread = new QThread; //this does not start the thread 
-	serverThread->setObjectName("serverThread");
-	
-	clientThread = new QThread;
-	serverThread->setObjectName("clientThread");
-
-	client = new Client;
-	client->moveToThread(clientThread);
-	connect(clientThread, &QThread::finished, client, &QObject::deleteLater);
-    connect(this, &WSASocketManager::UdpPacketSendSelected, client, &Client::SendUdpPackets);
-    connect(this, &WSASocketManager::TcpPacketSendSelected, client, &Client::SendTcpPackets);
-	connect(client, &Client::ClientAlertableErrorOccured, this, &WSASocketManager::DisplayClientAlert);
-	connect(client, &Client::ClientPrintableStatusReady, this, &WSASocketManager::PrintClientStatus);
-	clientThread->start();
-
-	server = new Server;
-	server->moveToThread(serverThread);
-	connect(serverThread, &QThread::finished, server, &QObject::deleteLater);
-	connect(server, &Server::PacketReceived, this, &WSASocketManager::UpdateTimer);
-    connect(this, &WSASocketManager::UdpPacketRecvSelected, server, &Server::ReceiveUdpPackets);
-    connect(this, &WSASocketManager::TcpPacketRecvSelected, server, &Server::ReceiveTcpPackets);
-    connect(this, &WSASocketManager::Disconnected, server, &Server::StopPolling);
-	serverThread->start();
 
+	scheduler = &TaskScheduler::Shared();
+	nextSessionId = 1;
+	sessionStatsTimer = new QTimer(this);
+	connect(sessionStatsTimer, &QTimer::timeout, this, &WSASocketManager::PublishSessions);
+	sessionStatsTimer->start(SESSION_STATS_INTERVAL_MS);
+	liveSampleTimer = new QTimer(this);
+	connect(liveSampleTimer, &QTimer::timeout, this, &WSASocketManager::SampleLiveSessions);
+	liveSampleTimer->start(LIVE_SAMPLE_MS);
+
+	transferMode = TransferMode::SingleFile;
+	pendingPort = 0;
+	pendingNumericOnly = false;
+	connectorThread = new QThread;
+	connectorThread->setObjectName("connectorThread");
+	connector = new HostConnector;
+	connector->moveToThread(connectorThread);
+	connect(connectorThread, &QThread::finished, connector, &QObject::deleteLater);
+	connect(this, &WSASocketManager::HostConnectSelected, connector, &HostConnector::ResolveAndConnect);
+	connect(connector, &HostConnector::HostConnected, this, &WSASocketManager::SendToConnectedHost);
+	connect(connector, &HostConnector::HostConnectFailed, this, &WSASocketManager::DisplayConnectFailure);
+	connect(connector, &HostConnector::ConnectorStatusReady, this, &WSASocketManager::PrintClientStatus);
+	connectorThread->start();
 }
 
 WSASocketManager::~WSASocketManager()
 {
-	// recommended way to clean up qt thread
-	if (serverThread->isRunning())
+	sessionStatsTimer->stop();
+	liveSampleTimer->stop();
+	for (auto& entry : sessions)
 	{
-		server->StopPolling();
-		serverThread->quit(); 
-		serverThread->wait();
+		entry.second->Stop();
 	}
-	if (clientThread->isRunning())
+	scheduler->WaitForIdle();
+	//sessions close their sockets, so they go before WSACleanup
+	for (auto& entry : sessions)
 	{
-		clientThread->quit(); 
-		clientThread->wait();
+		delete entry.second;
+	}
+	sessions.clear();
+	// recommended way to clean up qt thread
+	if (connectorThread->isRunning())
+	{
+		connectorThread->quit();
+		connectorThread->wait();
 	}
 	//thread objects auto deleted once QThread finished
-	delete serverThread;
-	delete clientThread;
+	delete connectorThread;
 	WSACleanup();
 }
 
@@ -103,21 +120,22 @@ WSASocketManager::~WSASocketManager()
 -- PROGRAMMER: Alex Xia
 --
 -- INTERFACE: bool CheckIPFormat (const QString& IPAddrStr)
-			const QString& IPAddrStr : string of IPv4 address in dotted decimal format
+			const QString& IPAddrStr : string of IPv4 address in dotted decimal format, or IPv6 address
 --
--- RETURNS: bool : whether the passed in argument is a valid IPv4 address string or not
+-- RETURNS: bool : whether the passed in argument is a valid IPv4 or IPv6 address string or not
 --
 -- NOTES:
 -- From assignment 1:
 --
 -- This function attempts to verify if the string passed in is an IP address in dotted decimal format.
--- It converts it to an IPv4 address long usable for the in_addr structure of the WinSock2 API. Then 
--- it returns whether the converted address is equal to the constant INADDR_NONE; all invalid addresses are
--- converted into this constant.
+-- inet_pton is tried for both address families; it returns 1 only for a well formed address.
 ----------------------------------------------------------------------------------------------------------------------*/
 bool WSASocketManager::CheckIPFormat(const QString& IPAddrStr)
 {
-	return inet_addr(IPAddrStr.toStdString().c_str()) != INADDR_NONE;
+	std::string address = IPAddrStr.toStdString();
+	struct in6_addr parsed; //big enough for either family
+	return inet_pton(AF_INET, address.c_str(), &parsed) == 1
+		|| inet_pton(AF_INET6, address.c_str(), &parsed) == 1;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -133,24 +151,16 @@ bool WSASocketManager::CheckIPFormat(const QString& IPAddrStr)
 --
 -- NOTES:
 -- Called after input from MainWindowController is validated, and in serverMode.
--- This is the starting point of the server thread; 
+-- Hands the socket SetupReceiving made to a new receive session, which runs on the scheduler.
+-- Another port can be set up and received on while this one is still going.
 ----------------------------------------------------------------------------------------------------------------------*/
 void WSASocketManager::ReceivePackets()
 {
-	resultPacketSize = 0;
-	resultPacketsReceived = 0;
-	startTime = std::chrono::steady_clock::now();
-	endTime = startTime;
-	emit ServerResultsReady(0, 0, "0", protocol); //clear results fields
-	if (protocol == "UDP")
-	{
-		emit UdpPacketRecvSelected(transmit_socket, filePath);
-	}	
-	if (protocol == "TCP")
-	{
-		emit TcpPacketRecvSelected(transmit_socket, filePath, expectedPacketSize);
-	}
-	emit PrintableStatusReady("-Server receiving in background");
+	TransferSession* session = CreateSession(false);
+	session->StartReceiving(*scheduler, transmit_socket, expectedPacketSize, receiveOptions, shardSockets);
+	transmit_socket = INVALID_SOCKET;
+	shardSockets.clear();
+	emit PrintableStatusReady(QString("#%1 -Server receiving in background").arg(session->GetId()));
 	emit DisconnectAllowed(true);
 }
 
@@ -163,64 +173,78 @@ void WSASocketManager::ReceivePackets()
 --
 -- PROGRAMMER: Alex Xia
 --
--- INTERFACE: void SendPackets(const size_t packetSize, const size_t packetCount)
+-- INTERFACE: void SendPackets(const size_t packetSize, const size_t packetCount, const TransferOptions& options)
 --			- packetSize : unsigned int, size of packet to be created 
 --			- packetCount : unsigned int, number of times to send packet
+--			- options : TransferOptions, target send rate, passed through to client thread
 --
 -- NOTES:
 -- Called after input from MainWindowController is validated, and in clientMode.
--- This is the starting point of the client thread; 
+-- Makes a send session for the host SetupSending checked, and has the connector thread resolve/connect it.
+-- SendToConnectedHost starts the session once a socket is ready.
 ----------------------------------------------------------------------------------------------------------------------*/
-void WSASocketManager::SendPackets(const size_t packetSize, const size_t packetCount)
+void WSASocketManager::SendPackets(const size_t packetSize, const size_t packetCount, const TransferOptions& options)
 {
-	if (protocol == "TCP")
-	{
-		emit TcpPacketSendSelected(transmit_socket, filePath, packetSize, packetCount);
-		//(transmit_socket, filePath, packetSize, packetCount); 
-	}
-	if (protocol == "UDP")
-	{
-		emit UdpPacketSendSelected(transmit_socket, filePath, packetSize, packetCount, server_socketaddr); 
-	}
-	emit PrintableStatusReady("-Client sending in background");
+	TransferSession* session = CreateSession(true);
+	session->PrepareSending(packetSize, packetCount, options);
+	emit HostConnectSelected(pendingHost, protocol, pendingPort, pendingNumericOnly, session->GetId());
+	emit PrintableStatusReady(QString("#%1 -Connecting in background").arg(session->GetId()));
 }
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION UpdateTimer
+-- FUNCTION SendToConnectedHost
 --
--- DATE: Feb 10, 2018
+-- DATE: Oct 18, 2026
 --
 -- DESIGNER: Alex Xia
 --
 -- PROGRAMMER: Alex Xia
 --
--- INTERFACE: void WSASocketManager::UpdateTimer(const size_t updatedPacketSize, const size_t updatedPacketsReceived)
---			- updatedPacketSize : unsigned int, size of packet just received
---			- updatedPacketsReceived : unsigned int, total number of packets received so far during connection
+-- INTERFACE: void SendToConnectedHost(SOCKET connectedSocket, struct sockaddr_storage serverAddress, const int sessionId)
+--			- connectedSocket : SOCKET, non blocking socket from HostConnector, connected if TCP
+--			- serverAddress : struct sockaddr_storage, IPv4 or IPv6 address of server
+--			- sessionId : int, send session the connect was for
 --
 -- NOTES:
--- Signaled when Server receives packet and needs to start/update timer.
--- When called with no prior packets, starts the timer, otherwise updates endpoint of timer.
+-- Signaled by HostConnector once it has a socket ready.
+-- Starts the session's Client on the scheduler.
 ----------------------------------------------------------------------------------------------------------------------*/
-void WSASocketManager::UpdateTimer(const size_t updatedPacketSize, const size_t updatedPacketsReceived)
+void WSASocketManager::SendToConnectedHost(SOCKET connectedSocket, struct sockaddr_storage serverAddress, const int sessionId)
 {
-	if (resultPacketsReceived == 0)
+	auto found = sessions.find(sessionId);
+	if (found == sessions.end())
 	{
-		startTime = std::chrono::steady_clock::now();
-		endTime = startTime;
+		closesocket(connectedSocket);
+		return;
 	}
-	//already got some packets
-	else
+	found->second->StartSending(*scheduler, connectedSocket, serverAddress);
+	emit PrintableStatusReady(QString("#%1 -Client sending in background").arg(sessionId));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION DisplayConnectFailure
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void DisplayConnectFailure(const int errorCode, const int sessionId)
+--			- errorCode : int, WinSock error from getaddrinfo or connect
+--			- sessionId : int, send session the connect was for
+--
+-- NOTES:
+-- Signaled by HostConnector when the host cant be resolved or nothing it resolved to accepts a connection.
+----------------------------------------------------------------------------------------------------------------------*/
+void WSASocketManager::DisplayConnectFailure(const int errorCode, const int sessionId)
+{
+	auto found = sessions.find(sessionId);
+	if (found != sessions.end())
 	{
-		endTime = std::chrono::steady_clock::now();
+		found->second->MarkFailed();
 	}
-	resultPacketSize = updatedPacketSize;
-	resultPacketsReceived = updatedPacketsReceived;
-	if ( updatedPacketSize == -1 && updatedPacketsReceived == -1) //tcp start timer calls this with -1, an otherwise impossible number
-		return;
-	long long deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
-	emit ServerResultsReady(resultPacketSize, resultPacketsReceived, QString::number(deltaTime), protocol);
-	emit PrintableStatusReady("-received packet(s)");
+	emit AlertableErrorOccured(QString("#%1 ").arg(sessionId) + GetErrorString(errorCode));
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -236,18 +260,183 @@ void WSASocketManager::UpdateTimer(const size_t updatedPacketSize, const size_t
 --
 -- NOTES:
 -- Signaled when user clicks Disconnect on MainWindowController. 
--- Stops the loop in server thread, and passes out final packets info to MainWindowController to display.
+-- Stops every receive session; each one passes out its final packets info once its loop has returned.
+-- Sends are left alone, they can be stopped one at a time from the session list.
 ----------------------------------------------------------------------------------------------------------------------*/
 void WSASocketManager::FinishReceivePackets()
 {
-	server->StopPolling();
-	long long deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
-	emit PrintableStatusReady("-Receive finished");
-	emit ServerResultsReady(resultPacketSize, resultPacketsReceived, QString::number(deltaTime), protocol);
-	closesocket(transmit_socket);
+	for (auto& entry : sessions)
+	{
+		if (!entry.second->IsSending())
+		{
+			entry.second->Stop();
+		}
+	}
 	emit DisconnectAllowed(false);
 }
 
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION StopSession
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void StopSession(const int sessionId)
+--			- sessionId : int, id shown in the session list
+--
+-- NOTES:
+-- Called by MainWindowController's Stop button. Sends still connecting never start.
+----------------------------------------------------------------------------------------------------------------------*/
+void WSASocketManager::StopSession(const int sessionId)
+{
+	auto found = sessions.find(sessionId);
+	if (found == sessions.end() || found->second->IsDone())
+	{
+		return;
+	}
+	found->second->Stop();
+	emit PrintableStatusReady(QString("#%1 -Stopping").arg(sessionId));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PublishSessions
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void PublishSessions(void)
+--
+-- NOTES:
+-- Signaled by sessionStatsTimer. Sends every session's live stats to MainWindowController, oldest first,
+-- and the scheduler's per worker load so its balance can be checked while transfers run.
+-- The same snapshots go to the metrics endpoint, if main started one.
+----------------------------------------------------------------------------------------------------------------------*/
+void WSASocketManager::PublishSessions()
+{
+	PruneFinishedSessions();
+	std::vector<SessionSnapshot> snapshots;
+	snapshots.reserve(sessions.size());
+	for (auto& entry : sessions)
+	{
+		snapshots.push_back(entry.second->TakeSnapshot());
+	}
+	emit SessionListReady(snapshots);
+	emit SchedulerLoadReady(scheduler->GetLoadSummary());
+	MetricsEndpoint::Shared().Publish(snapshots, *scheduler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SampleLiveSessions
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void SampleLiveSessions(void)
+--
+-- NOTES:
+-- Signaled by liveSampleTimer. Every session still running adds a sample to its live series, then
+-- MainWindowController is told so it can redraw the chart. Finished sessions keep what they had.
+----------------------------------------------------------------------------------------------------------------------*/
+void WSASocketManager::SampleLiveSessions()
+{
+	for (auto& entry : sessions)
+	{
+		if (!entry.second->IsDone())
+			entry.second->SampleLive();
+	}
+	emit LiveSamplesTaken();
+}
+
+//copies the live series of a session still in the list, false if there is no such session
+bool WSASocketManager::GetLiveSeries(const int sessionId, LiveSeries& series) const
+{
+	auto found = sessions.find(sessionId);
+	if (found == sessions.end())
+		return false;
+	series = found->second->GetLiveSeries();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION CreateSession
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: TransferSession* CreateSession(const bool sending)
+--			- sending : bool, true for client
+--
+-- RETURNS: TransferSession* : new session, owned by this and kept in sessions
+--
+-- NOTES:
+-- Takes protocol/filePath/mode from the last Setup call. Session messages get its id in front
+-- so the console can be told apart when several run at once.
+----------------------------------------------------------------------------------------------------------------------*/
+TransferSession* WSASocketManager::CreateSession(const bool sending)
+{
+	int sessionId = nextSessionId++;
+	TransferSession* session = new TransferSession(sessionId, sending, protocol, filePath, transferMode, this);
+	QString prefix = QString("#%1 ").arg(sessionId);
+	connect(session, &TransferSession::SessionStatusReady, this, [this, prefix](const QString& status) {
+		emit PrintableStatusReady(prefix + status);
+	});
+	connect(session, &TransferSession::SessionAlertOccured, this, [this, prefix](const QString& alertMsg) {
+		emit AlertableErrorOccured(prefix + alertMsg);
+	});
+	connect(session, &TransferSession::SessionResultsReady, this, &WSASocketManager::ServerResultsReady);
+	sessions[sessionId] = session;
+	return session;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION PruneFinishedSessions
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: void PruneFinishedSessions(void)
+--
+-- NOTES:
+-- Keeps the last SESSION_KEEP_FINISHED done sessions around for the list, older ones are deleted.
+----------------------------------------------------------------------------------------------------------------------*/
+void WSASocketManager::PruneFinishedSessions()
+{
+	size_t finished = 0;
+	for (auto& entry : sessions)
+	{
+		if (entry.second->IsDone())
+			finished++;
+	}
+	for (auto it = sessions.begin(); it != sessions.end() && finished > SESSION_KEEP_FINISHED;)
+	{
+		if (it->second->IsDone())
+		{
+			it->second->deleteLater();
+			it = sessions.erase(it);
+			finished--;
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION SetupReceiving(
 --
@@ -258,26 +447,64 @@ void WSASocketManager::FinishReceivePackets()
 -- PROGRAMMER: Alex Xia
 --
 -- INTERFACE: bool SetupReceiving(const QString& protocolStr, const int port, const QString& filePathStr,
-			 size_t packetSize)
+			 size_t packetSize, const TransferOptions& options)
 			 - protocolStr : QString
 			 - port : int
-			 - filePath : QString
+			 - filePath : QString, output file, or output folder in Batch mode
 			 - packetSize : unsigned int
+			 - options : TransferOptions, mode, shards and the other receive side settings
 --
 -- RETURNS: bool : whether all arguments are valid and usable 
 --
 -- NOTES:
 -- Passes arguments off to validate if suitable for server.
 -- Setsup socket & filePath;
+-- Shard ports are bound here rather than in the session, so a port in use is reported right away.
+-- A multicast group is joined here too, for the same reason.
 ----------------------------------------------------------------------------------------------------------------------*/
-bool WSASocketManager::SetupReceiving(const QString& protocolStr, const int port, const QString& filePathStr, size_t packetSize)
+bool WSASocketManager::SetupReceiving(const QString& protocolStr, const int port, const QString& filePathStr, size_t packetSize, const TransferOptions& options)
 {
 	//func only exist to provide public interface to MainWindowController
 	//didnt want it to be able
 	protocol = protocolStr;
 	filePath = filePathStr;
 	expectedPacketSize = packetSize;
-	return SetupSocket(port) && SetupPacketFile(filePath);
+	transferMode = options.mode;
+	receiveOptions = options;
+	if (transferMode == TransferMode::Batch)
+	{
+		return SetupBatchPath(filePath, false) && SetupSocket(port);
+	}
+	if (transferMode == TransferMode::Delta || transferMode == TransferMode::Dedup)
+	{
+		return SetupDeltaFile(filePath, false) && SetupSocket(port);
+	}
+	//Measure writes its per datagram log to filePath, same file checks as plain UDP
+	//a discard or verify sink never opens the file, it doesnt have to be there, and ping-pong only echoes
+	bool needsFile = (transferMode == TransferMode::Measure
+		|| (transferMode != TransferMode::PingPong && options.payloadSink == PayloadSink::File));
+	if (!SetupSocket(port) || (needsFile && !SetupPacketFile(filePath)))
+	{
+		return false;
+	}
+	shardSockets.clear();
+	struct sockaddr_storage group;
+	if (!options.multicastGroup.isEmpty()
+		&& (!ParseMulticastGroup(options.multicastGroup, group) || !JoinMulticastGroup(transmit_socket, group)))
+	{
+		emit AlertableErrorOccured(QString("Can't join multicast group %1, error code: %2").arg(options.multicastGroup).arg(WSAGetLastError()));
+		closesocket(transmit_socket);
+		transmit_socket = INVALID_SOCKET;
+		return false;
+	}
+	if (options.shardCount > 1 && !OpenShardListeners(transmit_socket, options.shardCount, shardSockets))
+	{
+		emit AlertableErrorOccured(QString("Can't bind ports %1 to %2 for shards").arg(port).arg(port + options.shardCount - 1));
+		closesocket(transmit_socket);
+		transmit_socket = INVALID_SOCKET;
+		return false;
+	}
+	return true;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -290,29 +517,22 @@ bool WSASocketManager::SetupReceiving(const QString& protocolStr, const int port
 -- PROGRAMMER: Alex Xia
 --
 -- INTERFACE: bool SetupSendingByName(const QString& hostName, const QString& protocolStr, const int port, 
-		const QString& filePathStr)
+		const QString& filePathStr, const TransferOptions& options)
 			 - hostName : QString
 			 - protocolStr : QString
 			 - port : int
 			 - filePathStr : QString
+			 - options : TransferOptions, mode and payload source
 --
 -- RETURNS: bool : whether all arguments are valid and usable 
 --
 -- NOTES:
 -- Call by MainWindowController to check if arguments can be used for client.
--- Checks host as well as Setsup socket & filePath.
+-- Checks filePath, then hands the host lookup & connect to the connector thread.
 ----------------------------------------------------------------------------------------------------------------------*/
-bool WSASocketManager::SetupSendingByName(const QString& hostName, const QString& protocolStr, const int port, const QString& filePathStr)
+bool WSASocketManager::SetupSendingByName(const QString& hostName, const QString& protocolStr, const int port, const QString& filePathStr, const TransferOptions& options)
 {
-	host = gethostbyname(hostName.toStdString().c_str());
-	protocol = protocolStr;
-	filePath = filePathStr;
-	if (host == NULL)
-	{
-		emit AlertableErrorOccured(GetErrorString());
-		return false;
-	}
-	return SetupSocket(port) && SetupPacketFile(filePath);
+	return SetupSending(hostName, protocolStr, port, filePathStr, false, options);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -325,32 +545,65 @@ bool WSASocketManager::SetupSendingByName(const QString& hostName, const QString
 -- PROGRAMMER: Alex Xia
 --
 -- INTERFACE: bool SetupSendingByIp(const QString& ipAddr,, const QString& protocolStr, const int port, 
-		const QString& filePathStr)
+		const QString& filePathStr, const TransferOptions& options)
 			 - ipAddr : QString
 			 - protocolStr : QString
 			 - port : int
 			 - filePathStr : QString
+			 - options : TransferOptions, mode and payload source
 --
 -- RETURNS: bool : whether all arguments are valid and usable 
 --
 -- NOTES:
 -- Call by MainWindowController after SetupSendingByName has failed, to check if ip can be used to connect.
--- Checks host as well as Setsup socket & filePath.
+-- Checks filePath, then hands the connect to the connector thread. No reverse lookup is done.
 ----------------------------------------------------------------------------------------------------------------------*/
-bool WSASocketManager::SetupSendingByIp(const QString& ipAddr, const QString& protocolStr, const int port, const QString& filePathStr)
+bool WSASocketManager::SetupSendingByIp(const QString& ipAddr, const QString& protocolStr, const int port, const QString& filePathStr, const TransferOptions& options)
+{
+	return SetupSending(ipAddr, protocolStr, port, filePathStr, true, options);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SetupSending
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SetupSending(const QString& host, const QString& protocolStr, const int port, 
+		const QString& filePathStr, const bool numericOnly, const TransferOptions& options)
+			 - host : QString, host name or IP address
+			 - protocolStr : QString
+			 - port : int
+			 - filePathStr : QString, file to send, or folder/manifest in Batch mode
+			 - numericOnly : bool, host is an IP address
+			 - options : TransferOptions, mode and payload source
+--
+-- RETURNS: bool : whether file is usable. Host problems are reported later through DisplayConnectFailure
+--
+-- NOTES:
+-- Resolving and connecting used to block the GUI thread for up to 2s, now HostConnector does it on its own thread.
+-- Only remembers the host here, SendPackets starts the connect for the session it makes.
+-- A generated payload needs no file, so the path isnt checked then.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WSASocketManager::SetupSending(const QString& host, const QString& protocolStr, const int port, const QString& filePathStr, const bool numericOnly, const TransferOptions& options)
 {
-	struct in_addr *ipv4_addr = (struct in_addr*)malloc(sizeof(struct in_addr));
-	ipv4_addr->s_addr = inet_addr(ipAddr.toStdString().c_str());
-	host = gethostbyaddr((char*)ipv4_addr, PF_INET, sizeof(struct in_addr));
-	free(ipv4_addr); //this is not used anymore, ever
 	protocol = protocolStr;
 	filePath = filePathStr;
-	if (host == NULL)
+	transferMode = options.mode;
+	bool pathUsable = (transferMode == TransferMode::Batch) ? SetupBatchPath(filePath, true)
+		: (transferMode == TransferMode::Delta || transferMode == TransferMode::Dedup) ? SetupDeltaFile(filePath, true)
+		: (options.payloadSource != PayloadSource::File) || SetupPacketFile(filePath);
+	if (!pathUsable)
 	{
-		emit AlertableErrorOccured(GetErrorString());
 		return false;
 	}
-	return SetupSocket(port) && SetupPacketFile(filePath);
+	pendingHost = host;
+	pendingPort = port;
+	pendingNumericOnly = numericOnly;
+	return true;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -385,6 +638,92 @@ bool WSASocketManager::SetupPacketFile(const QString& filePath)
 	return true;
 }
 
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SetupBatchPath
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SetupBatchPath(const QString& batchPath, const bool sending)
+			 - batchPath : QString, folder or manifest to send, or folder to receive into
+			 - sending : bool, true for client
+--
+-- RETURNS: bool : whether the path can be used for a batch
+--
+-- NOTES:
+-- Batch counterpart of SetupPacketFile. Client needs an existing folder or readable manifest,
+-- server's output folder is created if it isnt there yet.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WSASocketManager::SetupBatchPath(const QString& batchPath, const bool sending)
+{
+	if (protocol != "TCP")
+	{
+		emit AlertableErrorOccured("Batch transfers need TCP.");
+		return false;
+	}
+	QFileInfo pathInfo(batchPath);
+	if (batchPath.isEmpty())
+	{
+		emit AlertableErrorOccured("Please choose a folder for the batch.");
+		return false;
+	}
+	if (sending && !pathInfo.isDir() && !(pathInfo.isFile() && pathInfo.isReadable()))
+	{
+		emit AlertableErrorOccured(QString("Can't open folder or manifest at:\n") + batchPath);
+		return false;
+	}
+	if (!sending && !QDir().mkpath(batchPath))
+	{
+		emit AlertableErrorOccured(QString("Can't create folder at:\n") + batchPath);
+		return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION SetupDeltaFile
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool SetupDeltaFile(const QString& deltaPath, const bool sending)
+			 - deltaPath : QString, new version to send, or copy to update
+			 - sending : bool, true for client
+--
+-- RETURNS: bool : whether the file can be used for a delta sync or dedup transfer
+--
+-- NOTES:
+-- Client needs the new version to exist. Server's copy is made empty if missing,
+-- the first sync then just sends everything as literals.
+-- Dedup uses the same checks, its chunk store goes in the server file's folder.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WSASocketManager::SetupDeltaFile(const QString& deltaPath, const bool sending)
+{
+	if (protocol != "TCP")
+	{
+		emit AlertableErrorOccured("Delta and dedup transfers need TCP.");
+		return false;
+	}
+	if (sending)
+	{
+		return SetupPacketFile(deltaPath);
+	}
+	QFile copy(deltaPath);
+	if (deltaPath.isEmpty() || !copy.open(QIODevice::ReadWrite))
+	{
+		emit AlertableErrorOccured(QString("Can't open file at:\n") + deltaPath);
+		return false;
+	}
+	copy.close();
+	return true;
+}
+
 bool WSASocketManager::SetupSocket(const int port)
 {
 	if ( CreateSocket(protocol) == false)
@@ -416,16 +755,45 @@ bool WSASocketManager::SetupSocket(const int port)
 --
 -- NOTES:
 -- Calls WinSock socket function depeneding on passed in selected protocol, to get available socket
+-- Server socket is IPv6 with V6ONLY off so it takes IPv4 clients too. Falls back to IPv4 only
+-- if IPv6 is disabled on this machine.
+-- A UDP receive with receiveOptions.registeredIo gets a socket RIO can use, RIO cant be turned
+-- on later. Windows before 8 doesnt know the flag, then it's a plain socket and the receive falls back.
+-- A multicast receive sets SO_REUSEADDR before the bind, so several servers on one host can join
+-- the same group on the same port.
 ----------------------------------------------------------------------------------------------------------------------*/
 bool WSASocketManager::CreateSocket(const QString& protocol)
 {
 	int protocCode = (protocol == "UDP") ? SOCK_DGRAM : SOCK_STREAM ; 
+	bool registeredIo = (protocol == "UDP" && receiveOptions.registeredIo);
+	auto openSocket = [protocCode, registeredIo](const int family) {
+		SOCKET created = INVALID_SOCKET;
+		if (registeredIo)
+			created = WSASocket(family, protocCode, 0, nullptr, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+		return (created != INVALID_SOCKET) ? created : socket(family, protocCode, 0);
+	};
 	// if ((transmit_socket = socket(PF_INET, protocCode|O_NONBLOCK, 0)) == -1)
-	transmit_socket = socket(PF_INET, protocCode, 0);
+	serverFamily = PF_INET6;
+	transmit_socket = openSocket(serverFamily);
+	if (transmit_socket != INVALID_SOCKET)
+	{
+		int off = 0;
+		setsockopt(transmit_socket, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&off, sizeof(off));
+	}
+	else
+	{
+		serverFamily = PF_INET;
+		transmit_socket = openSocket(serverFamily);
+	}
 	bool socketCreated = (transmit_socket != -1);
 	
 	if (socketCreated)
 	{
+		if (protocol == "UDP" && !receiveOptions.multicastGroup.isEmpty())
+		{
+			BOOL reuse = TRUE;
+			setsockopt(transmit_socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+		}
 		unsigned long on = 1;
 		//winsock equivalent of fcnctl O_NODELAY
 		if (ioctlsocket(transmit_socket, FIONBIO, &on) != 0)
@@ -452,38 +820,31 @@ bool WSASocketManager::CreateSocket(const QString& protocol)
 -- RETURNS: bool : whether can connect to socket or not  
 --
 -- NOTES:
--- Binds socket depending on if client or server.
--- Connect is also called here if is TCP client.
+-- Binds server socket to any address of the socket's family.
+-- Client sockets are made & connected by HostConnector instead.
 ----------------------------------------------------------------------------------------------------------------------*/
 bool WSASocketManager::ConnectToSocket(const int port)
 {
-	memset((char* )&server_socketaddr, 0, sizeof(struct sockaddr_in));
-	server_socketaddr.sin_family = AF_INET;
-	server_socketaddr.sin_port = htons(port);
-	// server side
-	if (host == NULL)
-	{
-		server_socketaddr.sin_addr.s_addr = htonl(INADDR_ANY);
-		int bindStatus = bind(transmit_socket, (struct sockaddr *)&server_socketaddr, sizeof(server_socketaddr));
-		return (bindStatus == -1) ? false : true ;	
-	}
-	// client side
-	else 
-	{
-		memcpy((char* )&server_socketaddr.sin_addr, host->h_addr, host->h_length);
-		char* t = (char*)(&server_socketaddr.sin_addr); //used for debugging
-		if( protocol == "TCP" )
-		{
-			return WinApiConnectToSocket(transmit_socket, server_socketaddr);
-		}
-		//dont need to call connect (or bind) for just udp send
-		memset((char *)&client_socketaddr, 0, sizeof(client_socketaddr));
-		client_socketaddr.sin_family = AF_INET;
-		client_socketaddr.sin_port = htons(0);  // bind to any available port
-		client_socketaddr.sin_addr.s_addr = htonl(INADDR_ANY);
-		int bindStatusClient = bind(transmit_socket, (struct sockaddr *)&client_socketaddr, sizeof(client_socketaddr));
-		return (bindStatusClient == -1) ? false : true;
+	int addressLength;
+	memset((char* )&server_socketaddr, 0, sizeof(server_socketaddr));
+	if (serverFamily == PF_INET6)
+	{
+		struct sockaddr_in6* ipv6_addr = (struct sockaddr_in6*)&server_socketaddr;
+		ipv6_addr->sin6_family = AF_INET6;
+		ipv6_addr->sin6_port = htons(port);
+		ipv6_addr->sin6_addr = in6addr_any;
+		addressLength = sizeof(struct sockaddr_in6);
 	}
+	else
+	{
+		struct sockaddr_in* ipv4_addr = (struct sockaddr_in*)&server_socketaddr;
+		ipv4_addr->sin_family = AF_INET;
+		ipv4_addr->sin_port = htons(port);
+		ipv4_addr->sin_addr.s_addr = htonl(INADDR_ANY);
+		addressLength = sizeof(struct sockaddr_in);
+	}
+	int bindStatus = bind(transmit_socket, (struct sockaddr *)&server_socketaddr, addressLength);
+	return (bindStatus == -1) ? false : true ;	
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -504,19 +865,30 @@ bool WSASocketManager::ConnectToSocket(const int port)
 -- This function is a global function called by client.
 -- Connect is a WinSock function, but Qt also has a function named connect, which overrides the WinSock one. 
 -- This function is a workaround to call the WinSock version of connect.
+-- Blocks for up to 2s. The GUI no longer uses this (see HostConnector), only the loopback benchmark does.
+-- A timeout (select returns 0) or refused connect (except set on windows, SO_ERROR elsewhere) is a failure.
 ----------------------------------------------------------------------------------------------------------------------*/
 bool WinApiConnectToSocket(SOCKET& socket, struct sockaddr_in& socket_address)
 {
 	connect(socket, (struct sockaddr*) &socket_address, sizeof(socket_address));
 	struct timeval tv;
-	fd_set socketOptions;
-	FD_ZERO(&socketOptions);
-	FD_SET(socket, &socketOptions);
+	fd_set writable;
+	fd_set failed;
+	FD_ZERO(&writable);
+	FD_ZERO(&failed);
+	FD_SET(socket, &writable);
+	FD_SET(socket, &failed);
 	tv.tv_sec = 2;             /* 2 second timeout */
 	tv.tv_usec = 0;
-	int connect_status = select(socket, NULL, &socketOptions, NULL, &tv);
-	
-	return (connect_status == -1) ? false : true;
+	//nfds is ignored by winsock, but must be highest socket + 1 everywhere else
+	int connect_status = select((int)socket + 1, NULL, &writable, &failed, &tv);
+	if (connect_status <= 0 || FD_ISSET(socket, &failed))
+		return false;
+
+	int socketError = 0;
+	int errorLength = sizeof(socketError);
+	getsockopt(socket, SOL_SOCKET, SO_ERROR, (char*)&socketError, &errorLength);
+	return socketError == 0;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -573,20 +945,20 @@ void WSASocketManager::DisplayClientAlert(const QString& alertMsg)
 --
 -- PROGRAMMER: Alex Xia
 --
--- INTERFACE: QString GetErrorString (void)
+-- INTERFACE: QString GetErrorString (const int errorCode)
+--			- errorCode : int, WinSock error code from getaddrinfo, connect or WSAGetLastError
 --
 -- RETURNS: QString : a error message string
 --
 -- NOTES:
 -- - From assignment 1:
 
--- Call this function when a DNS lookup(gethostbyname/byip) is unsuccessful. The WinSock2 api will store the cause of the last 
--- unsuccessful query in memory as an integer error code. This decodes some of those error codes, and either returns
+-- Call this function when a DNS lookup(getaddrinfo) or connect is unsuccessful. getaddrinfo returns WinSock2
+-- error codes directly. This decodes some of those error codes, and either returns
 -- a specific message(most of the cases), of a generic "unexpected error occured" message. 
 ----------------------------------------------------------------------------------------------------------------------*/
-QString WSASocketManager::GetErrorString()
+QString WSASocketManager::GetErrorString(const int errorCode)
 {
-	int errorCode = WSAGetLastError();
 	switch (errorCode)
 	{
 		//same as WSANO_DATA
@@ -600,6 +972,10 @@ QString WSASocketManager::GetErrorString()
 			return QString("API Error: A callback function is blocking WinSocket calls.");
 		case WSAENETDOWN :
 			return QString("API Error: Network subsystem failed.");
+		case WSAECONNREFUSED :
+			return QString("API Error: Server refused connection.");
+		case WSAETIMEDOUT :
+			return QString("API Error: Timed out connecting to server.");
 		default : 
 			return QString("API Error: Unexpected error.");
 	}
@@ -3,14 +3,25 @@
 
 #include <cstdio>
 #include <WinSock2.h>
+#include <ws2tcpip.h>
 #include <iostream>
 #include <fstream>
 #include <QObject>
 #include <QThread>
+#include <QTimer>
 #include <QEvent>
 #include <chrono>
+#include <algorithm>
+#include <map>
+#include <vector>
 #include "Server.h"
 #include "Client.h"
+#include "TransferOptions.h"
+#include "TransferSession.h"
+#include "HostConnector.h"
+#include "MetricsEndpoint.h"
+
+#define SESSION_STATS_INTERVAL_MS 500 //how often the session list is refreshed
 
 bool WinApiConnectToSocket(SOCKET&, struct sockaddr_in&);
 
@@ -22,52 +33,66 @@ public:
 	WSASocketManager(QObject *parent);
 	virtual ~WSASocketManager();
 	bool CheckIPFormat(const QString&);
-	bool SetupSendingByName(const QString&, const QString&, const int, const QString&);
-	bool SetupSendingByIp(const QString&, const QString&, const int, const QString&);
-	bool SetupReceiving(const QString&, const int, const QString&, size_t = 0);
-	void SendPackets(const size_t, const size_t);
+	bool SetupSendingByName(const QString&, const QString&, const int, const QString&, const TransferOptions& = TransferOptions());
+	bool SetupSendingByIp(const QString&, const QString&, const int, const QString&, const TransferOptions& = TransferOptions());
+	bool SetupReceiving(const QString&, const int, const QString&, size_t = 0, const TransferOptions& = TransferOptions());
+	void SendPackets(const size_t, const size_t, const TransferOptions&);
 	void ReceivePackets();
+	void StopSession(const int);
+	bool GetLiveSeries(const int, LiveSeries&) const;
 	//slot function, dont call directly
 	void FinishReceivePackets();
 	void PrintClientStatus(const QString&);
 	void DisplayClientAlert(const QString&);
+	void SendToConnectedHost(SOCKET, struct sockaddr_storage, const int);
+	void DisplayConnectFailure(const int, const int);
+	void PublishSessions();
+	void SampleLiveSessions();
 
 signals:
 	void AlertableErrorOccured(const QString&);
 	void PrintableStatusReady(const QString&);
-	void ServerResultsReady(const size_t, const size_t, const QString&, const QString&);
-
-	void UdpPacketRecvSelected(SOCKET, const QString&);
-	void TcpPacketRecvSelected(SOCKET, const QString&, const size_t);
+	void ServerResultsReady(const size_t, const size_t, const QString&, const QString&, const QString&);
+	void SessionListReady(const std::vector<SessionSnapshot>&);
+	void SchedulerLoadReady(const QString&);
+	void LiveSamplesTaken();
 
-	void UdpPacketSendSelected(SOCKET, const QString&, const size_t, const size_t, struct sockaddr_in);
-	void TcpPacketSendSelected(SOCKET, const QString&, const size_t, const size_t);
+	void HostConnectSelected(const QString&, const QString&, const int, const bool, const int);
 
-	void Disconnected();
 	void DisconnectAllowed(const bool);
 
 private:
-	SOCKET transmit_socket;
-	struct hostent* host = NULL;
-	struct sockaddr_in server_socketaddr;
-	struct sockaddr_in client_socketaddr;
+	SOCKET transmit_socket; //server socket being set up, handed to a session by ReceivePackets
+	std::vector<SOCKET> shardSockets; //transmit_socket and the ports after it, when receiving sharded
+	struct sockaddr_storage server_socketaddr;
+	int serverFamily; //PF_INET6 if dual stack server socket could be made
 	
 	QString protocol;
 	QString filePath;
-	size_t resultPacketSize; //to print as result
+	TransferMode transferMode; //Batch: filePath is a folder/manifest (client) or output folder (server)
+	                           //Delta: filePath is the new version (client) or the copy to update (server)
+	                           //Dedup: filePath is the file to send (client) or where it's written (server)
 	size_t expectedPacketSize; //get from mainwindow user input
-	size_t resultPacketsReceived;
-	QThread* serverThread;
-	Server* server;
-	QThread* clientThread;
-	Client* client;
-	std::chrono::steady_clock::time_point startTime;
-	std::chrono::steady_clock::time_point endTime;
+	TransferOptions receiveOptions; //from SetupReceiving, used by the next ReceivePackets
+	QString pendingHost; //from SetupSending, used by the next SendPackets
+	int pendingPort;
+	bool pendingNumericOnly;
+	QThread* connectorThread;
+	HostConnector* connector;
+	TaskScheduler* scheduler; //every session's Server/Client loop runs here, shared with hashing jobs
+	std::map<int, TransferSession*> sessions; //by id, oldest first
+	int nextSessionId;
+	QTimer* sessionStatsTimer;
+	QTimer* liveSampleTimer; //every LIVE_SAMPLE_MS, for the live chart
 
-	QString GetErrorString();
+	QString GetErrorString(const int);
+	bool SetupSending(const QString&, const QString&, const int, const QString&, const bool, const TransferOptions&);
 	bool SetupSocket(const int);
 	bool SetupPacketFile(const QString&);
+	bool SetupBatchPath(const QString&, const bool);
+	bool SetupDeltaFile(const QString&, const bool);
 	bool CreateSocket(const QString&);
 	bool ConnectToSocket(const int);
-	void UpdateTimer(const size_t, const size_t);
+	TransferSession* CreateSession(const bool);
+	void PruneFinishedSessions();
 };
@@ -0,0 +1,174 @@
+#include "ZeroRuns.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ZeroRuns.cpp - Zero run detection and the hole descriptors TCP single file sends them as
+--
+-- PROGRAM: TcpUdpFileTransfer/PacketLogger
+--
+-- FUNCTIONS:
+	size_t FindZeroRun(const char*, const size_t, const size_t, size_t&);
+	bool IsAllZero(const char*, const size_t);
+	std::vector<char> EncodeZeroRuns(const char*, const size_t);
+	void WriteZeroStreamHeader(char*, const uint32_t);
+	bool ReadZeroStreamHeader(const char*, uint32_t&);
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- NOTES:
+-- BuildPacket pads a packet past the end of its file with 0s, so a small file sent at a big packet
+-- size is mostly zeros on the wire. With elision the client sends ZERO_MAGIC and the packet size
+-- once, then every packet as extents:
+--
+--	data length(4) | hole length(4) | data length bytes of packet
+--
+-- repeated until the extents add up to the packet size. A hole is a run of at least ZERO_MIN_HOLE
+-- zeros that isnt sent at all. Lengths are little endian like the batch headers.
+--
+-- The scans look at 16 bytes per compare with SSE2, the same baseline DeltaSync's checksum uses.
+----------------------------------------------------------------------------------------------------------------------*/
+
+//first zero byte at or after from, length if there is none
+static size_t NextZeroByte(const char* data, const size_t length, size_t position)
+{
+	const __m128i zero = _mm_setzero_si128();
+	for (; position + 16 <= length; position += 16)
+	{
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + position)), zero));
+		if (mask != 0)
+		{
+			unsigned long index;
+			_BitScanForward(&index, (unsigned long)mask);
+			return position + index;
+		}
+	}
+	for (; position < length && data[position] != 0; ++position);
+	return position;
+}
+
+//first non zero byte at or after from, length if the rest is all zeros
+static size_t NextDataByte(const char* data, const size_t length, size_t position)
+{
+	const __m128i zero = _mm_setzero_si128();
+	for (; position + 16 <= length; position += 16)
+	{
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + position)), zero)) ^ 0xFFFF;
+		if (mask != 0)
+		{
+			unsigned long index;
+			_BitScanForward(&index, (unsigned long)mask);
+			return position + index;
+		}
+	}
+	for (; position < length && data[position] == 0; ++position);
+	return position;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION FindZeroRun
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: size_t FindZeroRun(const char* data, const size_t length, const size_t from, size_t& runLength)
+		- data : bytes to scan
+		- length : their count
+		- from : where to start
+		- runLength : set to the run's length, 0 if there isnt one
+
+-- RETURNS: size_t : where the first run of at least ZERO_MIN_HOLE zeros at or after from starts, length if none
+----------------------------------------------------------------------------------------------------------------------*/
+size_t FindZeroRun(const char* data, const size_t length, const size_t from, size_t& runLength)
+{
+	size_t position = from;
+	while (position < length)
+	{
+		position = NextZeroByte(data, length, position);
+		size_t end = NextDataByte(data, length, position);
+		if (end - position >= ZERO_MIN_HOLE)
+		{
+			runLength = end - position;
+			return position;
+		}
+		position = end;
+	}
+	runLength = 0;
+	return length;
+}
+
+bool IsAllZero(const char* data, const size_t length)
+{
+	return NextDataByte(data, length, 0) == length;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION EncodeZeroRuns
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: std::vector<char> EncodeZeroRuns(const char* packet, const size_t packetSize)
+		- packet : one packet as BuildPacket made it
+		- packetSize : its size, at most 4GB
+
+-- RETURNS: std::vector<char> : the packet as extents, what goes on the wire for it
+--
+-- NOTES:
+-- A packet without a long enough zero run is one extent with a 0 hole, 8 bytes more than the packet.
+----------------------------------------------------------------------------------------------------------------------*/
+std::vector<char> EncodeZeroRuns(const char* packet, const size_t packetSize)
+{
+	std::vector<char> encoded;
+	size_t position = 0;
+	do
+	{
+		size_t holeLength;
+		size_t holeStart = FindZeroRun(packet, packetSize, position, holeLength);
+		size_t dataLength = holeStart - position;
+		size_t offset = encoded.size();
+		encoded.resize(offset + ZERO_EXTENT_HEADER_SIZE + dataLength);
+		WriteLittleEndian(encoded.data() + offset, dataLength, 4);
+		WriteLittleEndian(encoded.data() + offset + 4, holeLength, 4);
+		memcpy(encoded.data() + offset + ZERO_EXTENT_HEADER_SIZE, packet + position, dataLength);
+		position = holeStart + holeLength;
+	} while (position < packetSize);
+	return encoded;
+}
+
+void WriteZeroStreamHeader(char* header, const uint32_t packetSize)
+{
+	WriteLittleEndian(header, ZERO_MAGIC, 4);
+	WriteLittleEndian(header + 4, packetSize, 4);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION ReadZeroStreamHeader
+--
+-- DATE: Oct 18, 2026
+--
+-- DESIGNER: Alex Xia
+--
+-- PROGRAMMER: Alex Xia
+--
+-- INTERFACE: bool ReadZeroStreamHeader(const char* header, uint32_t& packetSize)
+		- header : ZERO_STREAM_HEADER_SIZE bytes from the start of the stream
+		- packetSize : set to the packet size the client sends
+
+-- RETURNS: bool : false if the stream doesnt start with ZERO_MAGIC, the client isnt eliding
+----------------------------------------------------------------------------------------------------------------------*/
+bool ReadZeroStreamHeader(const char* header, uint32_t& packetSize)
+{
+	if ((uint32_t)ReadLittleEndian(header, 4) != ZERO_MAGIC)
+		return false;
+	packetSize = (uint32_t)ReadLittleEndian(header + 4, 4);
+	return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <intrin.h>
+#include <emmintrin.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "BatchProtocol.h"
+
+#define ZERO_MAGIC 0x5A4E5341 //"ASNZ", starts a TCP single file stream with zero runs elided
+#define ZERO_STREAM_HEADER_SIZE 8 //magic(4) + packet size(4)
+#define ZERO_EXTENT_HEADER_SIZE 8 //data length(4) + hole length(4), the data bytes follow
+#define ZERO_MIN_HOLE 64 //shorter zero runs are sent as data, a descriptor for them saves next to nothing
+
+size_t FindZeroRun(const char*, const size_t, const size_t, size_t&);
+bool IsAllZero(const char*, const size_t);
+std::vector<char> EncodeZeroRuns(const char*, const size_t);
+void WriteZeroStreamHeader(char*, const uint32_t);
+bool ReadZeroStreamHeader(const char*, uint32_t&);
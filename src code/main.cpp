@@ -1,4 +1,8 @@
 #include "MainWindowController.h"
+#include "LoopbackBenchmark.h"
+#include "TaskScheduler.h"
+#include "MetricsEndpoint.h"
+#include "ConsoleLog.h"
 #include <QtWidgets/QApplication>
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -24,11 +28,64 @@
 -- 
 -- If a user did not enter necessary information correctly, a alert message box will popup. Or if the send/receive
 -- was not successful, the result printed becomes an error message instead. 		
+--
+-- Started with --benchmark, no window is shown. A loopback throughput sweep is run instead,
+-- see LoopbackBenchmark.cpp.
+--
+-- --worker-cores 2-7 (or a hex mask like 0xFC) pins the TaskScheduler's workers to those cores,
+-- so the cores taking NIC interrupts can be left out.
+--
+-- --metrics-port 9464 serves every session's counters on http://127.0.0.1:9464/metrics in Prometheus
+-- text format while the window is up, see MetricsEndpoint.cpp.
+--
+-- --console-stress [count] pumps count (10M if left out) statuses through the console's model and view
+-- instead of showing the window, and exits nonzero if memory kept growing or the UI stalled, see ConsoleLog.cpp.
 ----------------------------------------------------------------------------------------------------------------------*/
 int main(int argc, char *argv[])
 {
 	QApplication a(argc, argv);
+	int coresIndex = a.arguments().indexOf("--worker-cores");
+	if (coresIndex >= 0)
+	{
+		uint64_t coreMask = 0;
+		if (coresIndex + 1 >= a.arguments().size() || !TaskScheduler::ParseCoreList(a.arguments().at(coresIndex + 1), coreMask))
+		{
+			std::cout << "usage: --worker-cores 2-7,9 or --worker-cores 0xFC" << std::endl;
+			return -1;
+		}
+		TaskScheduler::Shared().SetAffinity(coreMask);
+	}
+	int stressIndex = a.arguments().indexOf("--console-stress");
+	if (stressIndex >= 0)
+	{
+		size_t messageCount = CONSOLE_STRESS_DEFAULT_COUNT;
+		if (stressIndex + 1 < a.arguments().size() && !a.arguments().at(stressIndex + 1).startsWith("--"))
+			messageCount = a.arguments().at(stressIndex + 1).toULongLong();
+		return RunConsoleStress(messageCount);
+	}
+	if (a.arguments().contains("--benchmark"))
+	{
+		LoopbackBenchmark benchmark;
+		return benchmark.Run(a.arguments());
+	}
+	int metricsIndex = a.arguments().indexOf("--metrics-port");
+	if (metricsIndex >= 0)
+	{
+		int metricsPort = (metricsIndex + 1 < a.arguments().size()) ? a.arguments().at(metricsIndex + 1).toInt() : 0;
+		if (metricsPort <= 0 || metricsPort > 65535)
+		{
+			std::cout << "usage: --metrics-port 9464" << std::endl;
+			return -1;
+		}
+		if (!MetricsEndpoint::Shared().Start(metricsPort))
+		{
+			std::cout << "could not serve metrics on 127.0.0.1:" << metricsPort << ", error " << WSAGetLastError() << std::endl;
+			return -1;
+		}
+	}
 	MainWindowController w;
 	w.show();
-	return a.exec();
+	int exitCode = a.exec();
+	MetricsEndpoint::Shared().Stop();
+	return exitCode;
 }